@@ -455,6 +455,12 @@ public:
     std::vector<double> ComputeDouble(const std::vector<double>& inputData);
     std::vector<float> ComputeFloat(const std::vector<float>& inputData);
 
+    // Batched version of the above, requires the map to be compiled with emitPredictBatchFunction. The input holds
+    // 'count' consecutive input vectors, and the result holds 'count' consecutive output vectors. The inputs are still
+    // evaluated one at a time, so this only saves the per-call overhead.
+    std::vector<double> ComputeBatchDouble(const std::vector<double>& inputData, int count);
+    std::vector<float> ComputeBatchFloat(const std::vector<float>& inputData, int count);
+
 private:
     template <typename ElementType>
     ell::api::CallbackForwarder<ElementType, ElementType>& GetCallbackForwarder();
@@ -480,6 +486,9 @@ struct MapCompilerOptions
 {
     bool useBlas = true;
     bool profile = false;
+    bool reusePortBuffers = false;
+    bool emitPredictBatchFunction = false;
+    std::string jitCacheDirectory; // if set, jitted code is stored in (and reloaded from) this directory
 };
 
 //
@@ -488,6 +497,7 @@ struct MapCompilerOptions
 struct ModelOptimizerOptions
 {
     bool fuseLinearFunctionNodes = true;
+    bool fuseConvolutionNodes = false;
 };
 
 } // end namespace
@@ -135,6 +135,34 @@ def CompiledMap_Compute(self, inputData: 'Vector', dtype: 'numpy.dtype') -> "std
 
 CompiledMap.Compute = CompiledMap_Compute
 
+# CompiledMap.ComputeBatch, parameterized on numpy.dtype
+def CompiledMap_ComputeBatch(self, inputData: 'numpy.ndarray', dtype: 'numpy.dtype') -> "numpy.ndarray":
+    """
+    ComputeBatch(CompiledMap self, numpy.ndarray inputData, numpy.dtype dtype) -> numpy.ndarray
+
+    Computes the outputs for a batch of inputs (one input per row) with a single call to the
+    batch predict function, which evaluates the inputs one at a time. The map must be compiled with
+    MapCompilerOptions.emitPredictBatchFunction set.
+
+    Parameters
+    ----------
+    inputData: numpy.ndarray
+    dtype: numpy.dtype
+
+    """
+    import ell
+    batch = np.asarray(inputData).astype(dtype)
+    count = batch.shape[0]
+    if dtype is np.float:
+        results = self.ComputeBatchDouble(ell.math.DoubleVector(batch.ravel()), count)
+    elif dtype is np.float32:
+        results = self.ComputeBatchFloat(ell.math.FloatVector(batch.ravel()), count)
+    else:
+        raise TypeError("Invalid type, expected numpy.float or numpy.float32")
+    return np.array(results).reshape(count, -1)
+
+CompiledMap.ComputeBatch = CompiledMap_ComputeBatch
+
 # Map.Compute, parameterized on numpy.dtype
 def Map_Compute(self, inputData: 'Vector<ElementType>', dtype: 'numpy.dtype') -> "std::vector< ElementType,std::allocator< ElementType > >":
     """
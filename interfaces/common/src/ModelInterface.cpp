@@ -785,7 +785,11 @@ CompiledMap Map::Compile(const std::string& targetDevice,
     settings.sinkFunctionName = sinkFunctionName;
     settings.compilerSettings.targetDevice.deviceName = targetDevice;
     settings.compilerSettings.useBlas = compilerSettings.useBlas;
+    settings.reusePortBuffers = compilerSettings.reusePortBuffers;
+    settings.emitPredictBatchFunction = compilerSettings.emitPredictBatchFunction;
+    settings.jitCacheDirectory = compilerSettings.jitCacheDirectory;
     settings.optimizerSettings.fuseLinearFunctionNodes = optimizerSettings.fuseLinearFunctionNodes;
+    settings.optimizerSettings.fuseConvolutionNodes = optimizerSettings.fuseConvolutionNodes;
 
     ell::model::IRMapCompiler compiler(settings);
 
@@ -852,6 +856,24 @@ std::vector<float> CompiledMap::ComputeFloat(const std::vector<float>& inputData
     return {};
 }
 
+std::vector<double> CompiledMap::ComputeBatchDouble(const std::vector<double>& inputData, int count)
+{
+    if (_map != nullptr)
+    {
+        return _map->ComputeBatch<double, double>(inputData, count);
+    }
+    return {};
+}
+
+std::vector<float> CompiledMap::ComputeBatchFloat(const std::vector<float>& inputData, int count)
+{
+    if (_map != nullptr)
+    {
+        return _map->ComputeBatch<float, float>(inputData, count);
+    }
+    return {};
+}
+
 void CompiledMap::WriteIR(const std::string& filePath)
 {
     if (_map != nullptr)
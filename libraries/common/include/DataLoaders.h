@@ -65,6 +65,30 @@ namespace common
     /// <returns> The dataset. </returns>
     data::AutoSupervisedMultiClassDataset GetMultiClassDataset(std::istream& stream);
 
+    /// <summary>
+    /// Loads an AutoSupervisedDataset from a file. The file is memory-mapped and parsed on several threads,
+    /// and the examples are in the same order as the lines of the file. Files in the binary dataset format
+    /// (see data::WriteBinaryDataset) are read directly, without parsing.
+    /// </summary>
+    ///
+    /// <param name="filename"> The name of the data file. </param>
+    /// <param name="numThreads"> The number of threads used to parse the file, or zero to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedDataset LoadDataset(const std::string& filename, size_t numThreads = 0);
+
+    /// <summary>
+    /// Loads an AutoSupervisedMultiClassDataset from a file. The file is memory-mapped and parsed on several
+    /// threads, and the examples are in the same order as the lines of the file. Files in the binary dataset
+    /// format are read directly, and their labels are used as class indices.
+    /// </summary>
+    ///
+    /// <param name="filename"> The name of the data file. </param>
+    /// <param name="numThreads"> The number of threads used to parse the file, or zero to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    data::AutoSupervisedMultiClassDataset LoadMultiClassDataset(const std::string& filename, size_t numThreads = 0);
+
     /// <summary>
     /// Gets a new dataset by running an existing dataset through a map.
     /// </summary>
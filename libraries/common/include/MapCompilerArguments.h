@@ -33,6 +33,7 @@ namespace common
     struct MapCompilerArguments
     {
         using PreferredConvolutionMethod = model::PreferredConvolutionMethod;
+        using ForestLoweringStrategy = model::ForestLoweringStrategy;
 
         std::string compiledFunctionName; // defaults to output filename
         std::string compiledModuleName;
@@ -40,15 +41,24 @@ namespace common
         // ELL codegen options
         bool profile = false;
         bool optimize = true;
+        emitters::OptimizationProfile optimizationProfile = emitters::OptimizationProfile::latency;
+        bool reportOptimizationPasses = false;
         bool useBlas = false;
         bool fuseLinearOperations = true;
+        bool fuseConvolutionOperations = false;
         bool enableVectorization = true;
-        int vectorWidth = 4;
+        int vectorWidth = 0;
         bool parallelize = true;
         bool useThreadPool = true;
         int maxThreads = 4;
+        emitters::ThreadPoolSchedulingPolicy threadPoolPolicy = emitters::ThreadPoolSchedulingPolicy::block;
         bool debug = false;
-        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd
+        bool reusePortBuffers = false;
+        bool emitPredictBatchFunction = false;
+        bool parallelizeNodes = false;
+        ForestLoweringStrategy forestLowering = ForestLoweringStrategy::dataflow; // known strategies: dataflow, branching, flattened, quickScorer
+        PreferredConvolutionMethod convolutionMethod = PreferredConvolutionMethod::automatic; // known methods: auto, unrolled, simple, diagonal, winograd, autotune
+        std::string convolutionTuningDatabase = ""; // file caching the methods chosen by autotuning
         utilities::Optional<bool> positionIndependentCode = false; // for generating -fPIC object code
 
         // target machine options
@@ -9,9 +9,12 @@
 #include "DataLoaders.h"
 
 // utilities
+#include "Exception.h"
 #include "Files.h"
+#include "MemoryMappedFile.h"
 
 // data
+#include "BinaryDataset.h"
 #include "Dataset.h"
 #include "SequentialLineIterator.h"
 
@@ -19,6 +22,7 @@
 #include "AutoDataVector.h"
 #include "WeightLabel.h"
 #include "GeneralizedSparseParsingIterator.h"
+#include "ParallelDatasetParser.h"
 
 // stl
 #include <memory>
@@ -48,5 +52,38 @@ namespace common
     {
         return data::MakeDataset(GetExampleIterator<data::SequentialLineIterator, data::ClassIndexParser, data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>>(stream));
     }
+
+    data::AutoSupervisedDataset LoadDataset(const std::string& filename, size_t numThreads)
+    {
+        utilities::MemoryMappedFile file(filename);
+        if (data::IsBinaryDataset(file.Begin(), file.End()))
+        {
+            return data::ReadBinaryDataset(file.Begin(), file.End());
+        }
+        return data::ParseDatasetInParallel(file.Begin(), file.End(), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), numThreads);
+    }
+
+    data::AutoSupervisedMultiClassDataset LoadMultiClassDataset(const std::string& filename, size_t numThreads)
+    {
+        utilities::MemoryMappedFile file(filename);
+        if (data::IsBinaryDataset(file.Begin(), file.End()))
+        {
+            // binary datasets store labels, which are converted to class indices
+            auto binaryDataset = data::ReadBinaryDataset(file.Begin(), file.End());
+            data::AutoSupervisedMultiClassDataset dataset;
+            for (size_t index = 0; index < binaryDataset.NumExamples(); ++index)
+            {
+                const auto& example = binaryDataset.GetExample(index);
+                auto label = example.GetMetadata().label;
+                if (label < 0 || label != static_cast<double>(static_cast<size_t>(label)))
+                {
+                    throw utilities::DataFormatException(utilities::DataFormatErrors::illegalValue, "binary dataset label is not a class index");
+                }
+                dataset.AddExample(data::AutoSupervisedMultiClassExample(example.GetSharedDataVector(), data::WeightClassIndex{ example.GetMetadata().weight, static_cast<size_t>(label) }));
+            }
+            return dataset;
+        }
+        return data::ParseDatasetInParallel(file.Begin(), file.End(), data::ClassIndexParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), numThreads);
+    }
 }
 }
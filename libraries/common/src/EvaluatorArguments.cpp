@@ -27,6 +27,13 @@ namespace common
             "aze",
             "Add an evaluation using the constant zero predictor",
             true);
+
+        parser.AddOption(
+            numThreads,
+            "numEvaluationThreads",
+            "net",
+            "The number of threads that each evaluation splits the dataset between, or 0 to use all hardware threads",
+            1);
     }
 }
 }
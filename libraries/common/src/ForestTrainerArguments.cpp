@@ -47,8 +47,14 @@ namespace common
         parser.AddOption(candidatesPerInput,
                          "candidatesPerInput",
                          "cpi",
-                         "The number of split candidates to create per input element",
-                         8);
+                         "The maximal number of split candidates (histogram bin boundaries) per input element, or 0 for no limit (the default was 8 before the candidates became histogram bins)",
+                         255);
+
+        parser.AddOption(numThreads,
+                         "numThreads",
+                         "nt",
+                         "The number of threads used to search for splits (0 means one per hardware thread)",
+                         1);
 
         parser.AddOption(sortingTrainer,
                          "sortingTrainer",
@@ -35,6 +35,7 @@
 #include "FFTNode.h"
 #include "FilterBankNode.h"
 #include "ForestPredictorNode.h"
+#include "FusedConvolutionNode.h"
 #include "GRUNode.h"
 #include "HammingWindowNode.h"
 #include "IIRFilterNode.h"
@@ -48,6 +49,7 @@
 #include "MultiplexerNode.h"
 #include "NeuralNetworkPredictorNode.h"
 #include "ProtoNNPredictorNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
 #include "ReceptiveFieldMatrixNode.h"
 #include "ReorderDataNode.h"
 #include "RNNNode.h"
@@ -114,6 +116,7 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::DotProductNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::DTWDistanceNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::FFTNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::FusedConvolutionNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::GRUNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::HammingWindowNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::L2NormSquaredNode<ElementType>>();
@@ -128,6 +131,7 @@ namespace common
         context.GetTypeFactory().AddType<model::Node, nodes::MovingAverageNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::MovingVarianceNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::NeuralNetworkPredictorNode<ElementType>>();
+        context.GetTypeFactory().AddType<model::Node, nodes::QuantizedMatrixMultiplyNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReceptiveFieldMatrixNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::ReorderDataNode<ElementType>>();
         context.GetTypeFactory().AddType<model::Node, nodes::RNNNode<ElementType>>();
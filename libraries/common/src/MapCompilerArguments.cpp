@@ -43,6 +43,23 @@ namespace common
             "Optimize output code",
             true);
 
+        parser.AddOption(
+            optimizationProfile,
+            "optimizationProfile",
+            "op",
+            "Optimization profile: optimize for speed, for code size, or for fast compilation (if optimize enabled)",
+            { { "latency", emitters::OptimizationProfile::latency },
+              { "size", emitters::OptimizationProfile::size },
+              { "compileSpeed", emitters::OptimizationProfile::compileSpeed } },
+            "latency");
+
+        parser.AddOption(
+            reportOptimizationPasses,
+            "optimizationReport",
+            "optr",
+            "Report the compile time and IR size of each optimization pass (if optimize enabled)",
+            false);
+
         parser.AddOption(
             useBlas,
             "blas",
@@ -57,6 +74,13 @@ namespace common
             "Fuse sequences of linear operations with constant coefficients into a single operation",
             true);
 
+        parser.AddOption(
+            fuseConvolutionOperations,
+            "fuseConvOps",
+            "",
+            "Fuse convolutions with the bias, batch normalization, and activation operations that follow them",
+            false);
+
         parser.AddOption(
             convolutionMethod,
             "convolutionMethod",
@@ -66,9 +90,17 @@ namespace common
               { "simple", PreferredConvolutionMethod::simple },
               { "diagonal", PreferredConvolutionMethod::diagonal },
               { "winograd", PreferredConvolutionMethod::winograd },
+              { "autotune", PreferredConvolutionMethod::autotune },
               { "auto", PreferredConvolutionMethod::automatic } },
             "auto");
 
+        parser.AddOption(
+            convolutionTuningDatabase,
+            "convolutionTuningDatabase",
+            "",
+            "File where the convolution methods chosen by '--convolutionMethod autotune' are stored and reused",
+            "");
+
         parser.AddOption(
             enableVectorization,
             "vectorize",
@@ -80,8 +112,8 @@ namespace common
             vectorWidth,
             "vectorWidth",
             "vw",
-            "Size of vector units",
-            4);
+            "Size of vector units (0 = derive from the target device's SIMD features)",
+            0);
 
         parser.AddOption(
             parallelize,
@@ -104,6 +136,15 @@ namespace common
             "Maximum num of parallel threads",
             4);
 
+        parser.AddOption(
+            threadPoolPolicy,
+            "threadPoolPolicy",
+            "tpp",
+            "Scheduling policy for the thread pool (if thread pool enabled)",
+            { { "block", emitters::ThreadPoolSchedulingPolicy::block },
+              { "workStealing", emitters::ThreadPoolSchedulingPolicy::workStealing } },
+            "block");
+
         parser.AddOption(
             debug,
             "debug",
@@ -111,6 +152,38 @@ namespace common
             "Emit debug code",
             false);
 
+        parser.AddOption(
+            reusePortBuffers,
+            "reusePortBuffers",
+            "rpb",
+            "Share memory between node outputs whose lifetimes don't overlap",
+            false);
+
+        parser.AddOption(
+            emitPredictBatchFunction,
+            "predictBatch",
+            "pb",
+            "Also emit a convenience function that calls the predict function on each of several inputs",
+            false);
+
+        parser.AddOption(
+            parallelizeNodes,
+            "parallelizeNodes",
+            "pn",
+            "Run independent branches of the model concurrently (if parallelize enabled)",
+            false);
+
+        parser.AddOption(
+            forestLowering,
+            "forestLowering",
+            "",
+            "Set how decision forests are compiled",
+            { { "dataflow", ForestLoweringStrategy::dataflow },
+              { "branching", ForestLoweringStrategy::branching },
+              { "flattened", ForestLoweringStrategy::flattened },
+              { "quickScorer", ForestLoweringStrategy::quickScorer } },
+            "dataflow");
+
         parser.AddDocumentationString("");
         parser.AddDocumentationString("Target device options");
         parser.AddOption(
@@ -198,13 +271,24 @@ namespace common
         settings.moduleName = namespacePrefix;
         settings.mapFunctionName = functionName;
         settings.compilerSettings.optimize = optimize;
+        settings.compilerSettings.optimizationProfile = optimizationProfile;
+        settings.compilerSettings.reportOptimizationPasses = reportOptimizationPasses;
         settings.compilerSettings.useBlas = useBlas;
         settings.compilerSettings.allowVectorInstructions = enableVectorization;
         settings.compilerSettings.parallelize = parallelize;
+        settings.compilerSettings.useThreadPool = useThreadPool;
+        settings.compilerSettings.maxThreads = maxThreads;
+        settings.compilerSettings.threadPoolPolicy = threadPoolPolicy;
         settings.compilerSettings.vectorWidth = vectorWidth;
         settings.optimizerSettings.fuseLinearFunctionNodes = fuseLinearOperations;
+        settings.optimizerSettings.fuseConvolutionNodes = fuseConvolutionOperations;
         settings.optimizerSettings.preferredConvolutionMethod = convolutionMethod;
+        settings.optimizerSettings.convolutionTuningDatabase = convolutionTuningDatabase;
         settings.profile = profile;
+        settings.reusePortBuffers = reusePortBuffers;
+        settings.emitPredictBatchFunction = emitPredictBatchFunction;
+        settings.parallelizeNodes = parallelizeNodes;
+        settings.forestLowering = forestLowering;
         settings.compilerSettings.profile = profile;
         settings.compilerSettings.positionIndependentCode = positionIndependentCode;
 
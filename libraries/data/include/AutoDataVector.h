@@ -68,6 +68,14 @@ namespace data
         /// <param name="list"> The vector of values. </param>
         AutoDataVectorBase(std::vector<double> vec);
 
+        /// <summary>
+        /// Constructs an auto data vector around an existing internal data vector, keeping its
+        /// representation as is instead of searching for the best one.
+        /// </summary>
+        ///
+        /// <param name="internalVector"> The internal data vector, which can't itself be an auto data vector. </param>
+        explicit AutoDataVectorBase(std::unique_ptr<IDataVector> internalVector);
+
         /// <summary> Not Implemented. </summary>
         void AppendElement(size_t index, double value) override;
 
@@ -81,6 +89,11 @@ namespace data
         /// <returns> The internal data vector type. </returns>
         IDataVector::Type GetInternalType() const { return _pInternal->GetType(); }
 
+        /// <summary> Gets the internal data vector stored inside the auto data vector. </summary>
+        ///
+        /// <returns> The internal data vector, whose concrete type is given by GetInternalType. </returns>
+        const IDataVector& GetInternal() const { return *_pInternal; }
+
         /// <summary>
         /// A data vector has infinite dimension and ends with a suffix of zeros. This function returns
         /// the first index in this suffix. Equivalently, the returned value is one plus the index of the
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+
+// stl
+#include <ostream>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Writes a dataset in the binary dataset format. Each example is stored as its weight and label
+    /// followed by the internal storage of its data vector (dense values, or compressed indices and
+    /// nonzero values), so reading it back requires no per-element parsing. The format uses the byte
+    /// order of the machine that writes it.
+    /// </summary>
+    ///
+    /// <param name="dataset"> The dataset. </param>
+    /// <param name="stream"> The binary output stream. </param>
+    void WriteBinaryDataset(const AutoSupervisedDataset& dataset, std::ostream& stream);
+
+    /// <summary> Checks if a range of memory starts with the header of the binary dataset format. </summary>
+    ///
+    /// <param name="begin"> Pointer to the first byte. </param>
+    /// <param name="end"> Pointer one past the last byte. </param>
+    ///
+    /// <returns> true if the range holds a binary dataset. </returns>
+    bool IsBinaryDataset(const char* begin, const char* end);
+
+    /// <summary>
+    /// Reads a dataset in the binary dataset format from memory (such as a memory-mapped file). The
+    /// data vectors are restored with their original representation by copying their storage.
+    /// </summary>
+    ///
+    /// <param name="begin"> Pointer to the first byte. </param>
+    /// <param name="end"> Pointer one past the last byte. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    AutoSupervisedDataset ReadBinaryDataset(const char* begin, const char* end);
+}
+}
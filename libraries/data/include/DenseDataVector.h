@@ -73,6 +73,12 @@ namespace data
         /// <param name="list"> The vector of values. </param>
         DenseDataVector(std::vector<float> vec);
 
+        /// <summary> Constructs a data vector directly from its element storage, as returned by GetValues. </summary>
+        ///
+        /// <param name="values"> The stored values, which must not end with a zero. </param>
+        /// <param name="numNonzeros"> The number of nonzero values. </param>
+        DenseDataVector(std::vector<ElementType> values, size_t numNonzeros);
+
         /// <summary> Array indexer operator. </summary>
         ///
         /// <param name="index"> Zero-based index of the desired element. </param>
@@ -128,6 +134,16 @@ namespace data
 
         static IDataVector::Type GetStaticType();
 
+        /// <summary> Returns the element storage of this vector. </summary>
+        ///
+        /// <returns> The stored values, up to the last nonzero. </returns>
+        const std::vector<ElementType>& GetValues() const { return _data; }
+
+        /// <summary> Returns the number of nonzero elements in this vector. </summary>
+        ///
+        /// <returns> The number of nonzeros. </returns>
+        size_t NumNonzeros() const { return _numNonzeros; }
+
     private:
         using DataVectorBase<DenseDataVector<ElementType>>::AppendElements;
         size_t _numNonzeros = 0;
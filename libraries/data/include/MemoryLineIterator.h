@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryLineIterator.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextLine.h"
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary> An iterator that reads a range of characters in memory (such as a memory-mapped file) line by line. </summary>
+    class MemoryLineIterator
+    {
+    public:
+        /// <summary> Constructs a memory line iterator. </summary>
+        ///
+        /// <param name="begin"> Pointer to the first character. </param>
+        /// <param name="end"> Pointer one past the last character. </param>
+        /// <param name="delim"> The delimiter. </param>
+        MemoryLineIterator(const char* begin, const char* end, char delim = '\n');
+
+        /// <summary> Returns true if the iterator is currently pointing to a valid iterate. </summary>
+        ///
+        /// <returns> true if it succeeds, false if it fails. </returns>
+        bool IsValid() const { return _isValid; }
+
+        /// <summary> Proceeds to the next row. </summary>
+        void Next();
+
+        /// <summary> Returns a TextLine that contains the current line. </summary>
+        ///
+        /// <returns> A TextLine </returns>
+        TextLine GetTextLine() const { return _currentLine; }
+
+    private:
+        const char* _next;
+        const char* _end;
+        bool _isValid = true;
+        TextLine _currentLine;
+        char _delim;
+    };
+
+    /// <summary> Splits a range of characters into chunks of roughly equal size that each contain whole lines. </summary>
+    ///
+    /// <param name="begin"> Pointer to the first character. </param>
+    /// <param name="end"> Pointer one past the last character. </param>
+    /// <param name="numChunks"> The maximal number of chunks. </param>
+    /// <param name="delim"> The line delimiter. </param>
+    ///
+    /// <returns> The chunk boundaries, starting with `begin` and ending with `end`. Chunk `i` is the range between boundaries `i` and `i + 1`. </returns>
+    std::vector<const char*> SplitAtLineBoundaries(const char* begin, const char* end, size_t numChunks, char delim = '\n');
+}
+}
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelDatasetParser.h (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Dataset.h"
+#include "Example.h"
+
+// stl
+#include <cstddef>
+
+namespace ell
+{
+namespace data
+{
+    /// <summary>
+    /// Parses a range of text in memory (such as a memory-mapped file) into a dataset, using several threads.
+    /// The text is split into chunks of whole lines, each chunk is parsed line by line exactly as
+    /// SingleLineParsingExampleIterator would parse it, and the examples are added to the dataset in the
+    /// order of the lines they came from.
+    /// </summary>
+    ///
+    /// <typeparam name="MetadataParserType"> Metadata parser type. </typeparam>
+    /// <typeparam name="DataVectorParserType"> DataVector parser type. </typeparam>
+    /// <param name="begin"> Pointer to the first character of the text. </param>
+    /// <param name="end"> Pointer one past the last character of the text. </param>
+    /// <param name="metadataParser"> The metadata parser, copied for each thread. </param>
+    /// <param name="dataVectorParser"> The data vector parser, copied for each thread. </param>
+    /// <param name="numThreads"> The number of threads to use, or zero to use one per hardware thread. </param>
+    ///
+    /// <returns> The dataset. </returns>
+    template <typename MetadataParserType, typename DataVectorParserType>
+    Dataset<ParserExample<DataVectorParserType, MetadataParserType>> ParseDatasetInParallel(const char* begin, const char* end, const MetadataParserType& metadataParser, const DataVectorParserType& dataVectorParser, size_t numThreads = 0);
+}
+}
+
+#include "../tcc/ParallelDatasetParser.tcc"
@@ -144,6 +144,11 @@ namespace data
         /// <param name="list"> The initializer list of values. </param>
         SparseBinaryDataVectorBase(std::vector<double> vec);
 
+        /// <summary> Constructs a data vector directly from its index storage, as returned by GetIndexList. </summary>
+        ///
+        /// <param name="indexList"> The list of indices of the nonzero elements. </param>
+        explicit SparseBinaryDataVectorBase(IndexListType indexList);
+
         template <IterationPolicy policy>
         using Iterator = SparseBinaryDataVectorIterator<policy, IndexListType>;
 
@@ -203,6 +208,11 @@ namespace data
         /// <param name="vector"> [in,out] The vector that this DataVector is added to. </param>
         void AddTo(math::RowVectorReference<double> vector) const override;
 
+        /// <summary> Returns the list of indices of the nonzero elements. </summary>
+        ///
+        /// <returns> The index list. </returns>
+        const IndexListType& GetIndexList() const { return _indexList; }
+
     private:
         using DataVectorBase<SparseBinaryDataVectorBase<IndexListType>>::AppendElements;
         IndexListType _indexList;
@@ -148,6 +148,12 @@ namespace data
         /// <param name="list"> The initializer list of values. </param>
         SparseDataVector(std::vector<double> vec);
 
+        /// <summary> Constructs a data vector directly from its index and value storage, as returned by GetIndexList and GetValues. </summary>
+        ///
+        /// <param name="indexList"> The list of indices of the nonzero elements. </param>
+        /// <param name="values"> The nonzero values, one per index. </param>
+        SparseDataVector(IndexListType indexList, std::vector<ElementType> values);
+
         template <IterationPolicy policy>
         using Iterator = SparseDataVectorIterator<policy, ElementType, IndexListType>;
 
@@ -202,6 +208,16 @@ namespace data
 
         static IDataVector::Type GetStaticType();
 
+        /// <summary> Returns the list of indices of the nonzero elements. </summary>
+        ///
+        /// <returns> The index list. </returns>
+        const IndexListType& GetIndexList() const { return _indexList; }
+
+        /// <summary> Returns the nonzero values, in the order of the index list. </summary>
+        ///
+        /// <returns> The values. </returns>
+        const std::vector<ElementType>& GetValues() const { return _values; }
+
     private:
         using DataVectorBase<SparseDataVector<ElementType, IndexListType>>::AppendElements;
         IndexListType _indexList;
@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinaryDataset.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinaryDataset.h"
+#include "AutoDataVector.h"
+#include "DenseDataVector.h"
+#include "SparseBinaryDataVector.h"
+#include "SparseDataVector.h"
+
+// utilities
+#include "CompressedIntegerList.h"
+#include "Exception.h"
+
+// stl
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        const char binaryDatasetMagic[8] = { 'E', 'L', 'L', 'B', 'D', 'A', 'T', 'A' };
+        const uint64_t binaryDatasetVersion = 1;
+
+        // all sections of the file start at multiples of this alignment
+        const size_t binaryDatasetAlignment = 8;
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint64_t version;
+            uint64_t numExamples;
+        };
+
+        // each example is this header, followed by the encoded index list and then by the stored values
+        struct ExampleHeader
+        {
+            double weight;
+            double label;
+            uint64_t vectorType;
+            uint64_t numValues;
+            uint64_t numNonzeros;
+            uint64_t maxIndex;
+            uint64_t numIndexBytes;
+        };
+
+        size_t PaddingSize(size_t size)
+        {
+            return (binaryDatasetAlignment - size % binaryDatasetAlignment) % binaryDatasetAlignment;
+        }
+
+        class BinaryWriter
+        {
+        public:
+            BinaryWriter(std::ostream& stream)
+                : _stream(stream)
+            {
+            }
+
+            void Write(const void* data, size_t size)
+            {
+                _stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                const char padding[binaryDatasetAlignment] = {};
+                _stream.write(padding, static_cast<std::streamsize>(PaddingSize(size)));
+            }
+
+        private:
+            std::ostream& _stream;
+        };
+
+        class BinaryReader
+        {
+        public:
+            BinaryReader(const char* begin, const char* end)
+                : _position(begin), _end(end)
+            {
+            }
+
+            // returns a pointer to the next `size` bytes, and skips them and their padding
+            const char* Read(size_t size)
+            {
+                // sizes come from the file, so avoid computing anything that can overflow
+                auto remaining = static_cast<size_t>(_end - _position);
+                if (size > remaining || PaddingSize(size) > remaining - size)
+                {
+                    ThrowAbruptEnd();
+                }
+
+                auto data = _position;
+                _position += size + PaddingSize(size);
+                return data;
+            }
+
+            template <typename ValueType>
+            ValueType ReadValue()
+            {
+                ValueType value;
+                std::memcpy(&value, Read(sizeof(ValueType)), sizeof(ValueType));
+                return value;
+            }
+
+            template <typename ElementType>
+            std::vector<ElementType> ReadVector(size_t size)
+            {
+                // check the size before allocating the vector
+                if (size > static_cast<size_t>(_end - _position) / sizeof(ElementType))
+                {
+                    ThrowAbruptEnd();
+                }
+
+                std::vector<ElementType> values(size);
+                if (size > 0)
+                {
+                    std::memcpy(values.data(), Read(size * sizeof(ElementType)), size * sizeof(ElementType));
+                }
+                return values;
+            }
+
+        private:
+            [[noreturn]] void ThrowAbruptEnd()
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::abruptEnd, "binary dataset ends in the middle of an example");
+            }
+
+            const char* _position;
+            const char* _end;
+        };
+
+        template <typename ElementType>
+        void WriteDenseDataVector(const IDataVector& dataVector, ExampleHeader& header, BinaryWriter& writer)
+        {
+            const auto& values = static_cast<const DenseDataVector<ElementType>&>(dataVector).GetValues();
+            header.numValues = values.size();
+            header.numNonzeros = static_cast<const DenseDataVector<ElementType>&>(dataVector).NumNonzeros();
+            writer.Write(&header, sizeof(header));
+            writer.Write(values.data(), values.size() * sizeof(ElementType));
+        }
+
+        template <typename ElementType>
+        void WriteSparseDataVector(const IDataVector& dataVector, ExampleHeader& header, BinaryWriter& writer)
+        {
+            const auto& sparseDataVector = static_cast<const SparseDataVector<ElementType, utilities::CompressedIntegerList>&>(dataVector);
+            const auto& indexData = sparseDataVector.GetIndexList().GetEncodedData();
+            const auto& values = sparseDataVector.GetValues();
+            header.numValues = values.size();
+            header.numNonzeros = values.size();
+            header.maxIndex = values.empty() ? 0 : sparseDataVector.GetIndexList().Max();
+            header.numIndexBytes = indexData.size();
+            writer.Write(&header, sizeof(header));
+            writer.Write(indexData.data(), indexData.size());
+            writer.Write(values.data(), values.size() * sizeof(ElementType));
+        }
+
+        void WriteSparseBinaryDataVector(const IDataVector& dataVector, ExampleHeader& header, BinaryWriter& writer)
+        {
+            const auto& indexList = static_cast<const SparseBinaryDataVector&>(dataVector).GetIndexList();
+            const auto& indexData = indexList.GetEncodedData();
+            header.numNonzeros = indexList.Size();
+            header.maxIndex = indexList.Size() == 0 ? 0 : indexList.Max();
+            header.numIndexBytes = indexData.size();
+            writer.Write(&header, sizeof(header));
+            writer.Write(indexData.data(), indexData.size());
+        }
+
+        // Checks that an encoded index list holds exactly `numNonzeros` increasing indices, the last of which is
+        // `maxIndex`, so that iterating over the list stays inside its data. Each index is stored as the delta from
+        // the previous one, in 1, 2, 4 or 8 bytes, as given by the top 2 bits of its first byte (see CompressedIntegerList).
+        bool IsValidIndexList(const std::vector<uint8_t>& indexData, uint64_t numNonzeros, uint64_t maxIndex)
+        {
+            size_t position = 0;
+            uint64_t index = 0;
+            for (uint64_t count = 0; count < numNonzeros; ++count)
+            {
+                if (position >= indexData.size())
+                {
+                    return false;
+                }
+
+                auto firstByte = indexData[position];
+                size_t numBytes = size_t{ 1 } << ((firstByte >> 6) & 0x03);
+                if (numBytes > indexData.size() - position)
+                {
+                    return false;
+                }
+
+                uint64_t delta = firstByte & 0x3f;
+                for (size_t byteIndex = 1; byteIndex < numBytes; ++byteIndex)
+                {
+                    delta |= static_cast<uint64_t>(indexData[position + byteIndex]) << (6 + 8 * (byteIndex - 1));
+                }
+                if ((count > 0 && delta == 0) || delta > maxIndex - index)
+                {
+                    return false;
+                }
+
+                index += delta;
+                position += numBytes;
+            }
+            return position == indexData.size() && (numNonzeros == 0 || index == maxIndex);
+        }
+
+        utilities::CompressedIntegerList ReadIndexList(const ExampleHeader& header, BinaryReader& reader)
+        {
+            auto indexData = reader.ReadVector<uint8_t>(header.numIndexBytes);
+            if (!IsValidIndexList(indexData, header.numNonzeros, header.maxIndex))
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "binary dataset contains an invalid index list");
+            }
+            return utilities::CompressedIntegerList(std::move(indexData), header.numNonzeros, header.maxIndex);
+        }
+
+        template <typename ElementType>
+        std::unique_ptr<IDataVector> ReadDenseDataVector(const ExampleHeader& header, BinaryReader& reader)
+        {
+            auto values = reader.ReadVector<ElementType>(header.numValues);
+            return std::make_unique<DenseDataVector<ElementType>>(std::move(values), header.numNonzeros);
+        }
+
+        template <typename ElementType>
+        std::unique_ptr<IDataVector> ReadSparseDataVector(const ExampleHeader& header, BinaryReader& reader)
+        {
+            if (header.numValues != header.numNonzeros)
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "binary dataset contains a sparse vector whose index and value counts differ");
+            }
+
+            auto indexList = ReadIndexList(header, reader);
+            auto values = reader.ReadVector<ElementType>(header.numValues);
+            return std::make_unique<SparseDataVector<ElementType, utilities::CompressedIntegerList>>(std::move(indexList), std::move(values));
+        }
+
+        std::unique_ptr<IDataVector> ReadSparseBinaryDataVector(const ExampleHeader& header, BinaryReader& reader)
+        {
+            return std::make_unique<SparseBinaryDataVector>(ReadIndexList(header, reader));
+        }
+    }
+
+    void WriteBinaryDataset(const AutoSupervisedDataset& dataset, std::ostream& stream)
+    {
+        BinaryWriter writer(stream);
+
+        FileHeader fileHeader;
+        std::memcpy(fileHeader.magic, binaryDatasetMagic, sizeof(binaryDatasetMagic));
+        fileHeader.version = binaryDatasetVersion;
+        fileHeader.numExamples = dataset.NumExamples();
+        writer.Write(&fileHeader, sizeof(fileHeader));
+
+        for (size_t index = 0; index < dataset.NumExamples(); ++index)
+        {
+            const auto& example = dataset.GetExample(index);
+            const auto& dataVector = example.GetDataVector();
+            const auto& internalDataVector = dataVector.GetInternal();
+
+            ExampleHeader header = {};
+            header.weight = example.GetMetadata().weight;
+            header.label = example.GetMetadata().label;
+            header.vectorType = static_cast<uint64_t>(dataVector.GetInternalType());
+
+            switch (dataVector.GetInternalType())
+            {
+            case IDataVector::Type::DoubleDataVector:
+                WriteDenseDataVector<double>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::FloatDataVector:
+                WriteDenseDataVector<float>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::ShortDataVector:
+                WriteDenseDataVector<short>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::ByteDataVector:
+                WriteDenseDataVector<char>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::SparseDoubleDataVector:
+                WriteSparseDataVector<double>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::SparseFloatDataVector:
+                WriteSparseDataVector<float>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::SparseShortDataVector:
+                WriteSparseDataVector<short>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::SparseByteDataVector:
+                WriteSparseDataVector<char>(internalDataVector, header, writer);
+                break;
+            case IDataVector::Type::SparseBinaryDataVector:
+                WriteSparseBinaryDataVector(internalDataVector, header, writer);
+                break;
+            default:
+                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "data vector type not supported by the binary dataset format");
+            }
+        }
+
+        if (!stream)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "error writing binary dataset");
+        }
+    }
+
+    bool IsBinaryDataset(const char* begin, const char* end)
+    {
+        return static_cast<size_t>(end - begin) >= sizeof(FileHeader) && std::memcmp(begin, binaryDatasetMagic, sizeof(binaryDatasetMagic)) == 0;
+    }
+
+    AutoSupervisedDataset ReadBinaryDataset(const char* begin, const char* end)
+    {
+        if (!IsBinaryDataset(begin, end))
+        {
+            throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "not a binary dataset");
+        }
+
+        BinaryReader reader(begin, end);
+        auto fileHeader = reader.ReadValue<FileHeader>();
+        if (fileHeader.version != binaryDatasetVersion)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::versionMismatch, "unsupported binary dataset version " + std::to_string(fileHeader.version));
+        }
+
+        AutoSupervisedDataset dataset;
+        for (uint64_t index = 0; index < fileHeader.numExamples; ++index)
+        {
+            auto header = reader.ReadValue<ExampleHeader>();
+
+            std::unique_ptr<IDataVector> dataVector;
+            switch (static_cast<IDataVector::Type>(header.vectorType))
+            {
+            case IDataVector::Type::DoubleDataVector:
+                dataVector = ReadDenseDataVector<double>(header, reader);
+                break;
+            case IDataVector::Type::FloatDataVector:
+                dataVector = ReadDenseDataVector<float>(header, reader);
+                break;
+            case IDataVector::Type::ShortDataVector:
+                dataVector = ReadDenseDataVector<short>(header, reader);
+                break;
+            case IDataVector::Type::ByteDataVector:
+                dataVector = ReadDenseDataVector<char>(header, reader);
+                break;
+            case IDataVector::Type::SparseDoubleDataVector:
+                dataVector = ReadSparseDataVector<double>(header, reader);
+                break;
+            case IDataVector::Type::SparseFloatDataVector:
+                dataVector = ReadSparseDataVector<float>(header, reader);
+                break;
+            case IDataVector::Type::SparseShortDataVector:
+                dataVector = ReadSparseDataVector<short>(header, reader);
+                break;
+            case IDataVector::Type::SparseByteDataVector:
+                dataVector = ReadSparseDataVector<char>(header, reader);
+                break;
+            case IDataVector::Type::SparseBinaryDataVector:
+                dataVector = ReadSparseBinaryDataVector(header, reader);
+                break;
+            default:
+                throw utilities::DataFormatException(utilities::DataFormatErrors::illegalValue, "unknown data vector type in binary dataset");
+            }
+
+            dataset.AddExample(AutoSupervisedExample(AutoDataVector(std::move(dataVector)), WeightLabel{ header.weight, header.label }));
+        }
+
+        return dataset;
+    }
+}
+}
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryLineIterator.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryLineIterator.h"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace ell
+{
+namespace data
+{
+    namespace
+    {
+        // returns a pointer to the first occurrence of the delimiter in the range, or to the end of the range
+        const char* FindDelimiter(const char* begin, const char* end, char delim)
+        {
+            auto position = static_cast<const char*>(std::memchr(begin, delim, static_cast<size_t>(end - begin)));
+            return position == nullptr ? end : position;
+        }
+    }
+
+    MemoryLineIterator::MemoryLineIterator(const char* begin, const char* end, char delim)
+        : _next(begin), _end(end), _delim(delim)
+    {
+        Next();
+    }
+
+    void MemoryLineIterator::Next()
+    {
+        if (_next == _end)
+        {
+            _isValid = false;
+            return;
+        }
+
+        auto lineEnd = FindDelimiter(_next, _end, _delim);
+        _currentLine = TextLine(std::string(_next, lineEnd));
+        _next = lineEnd == _end ? _end : lineEnd + 1;
+    }
+
+    std::vector<const char*> SplitAtLineBoundaries(const char* begin, const char* end, size_t numChunks, char delim)
+    {
+        std::vector<const char*> boundaries = { begin };
+        auto size = static_cast<size_t>(end - begin);
+        numChunks = std::max(numChunks, size_t{ 1 });
+        for (size_t chunkIndex = 1; chunkIndex < numChunks; ++chunkIndex)
+        {
+            // move each boundary forward to the start of the next line
+            auto boundary = std::max(begin + chunkIndex * (size / numChunks), boundaries.back());
+            if (boundary != begin && boundary[-1] != delim)
+            {
+                boundary = FindDelimiter(boundary, end, delim);
+                boundary = boundary == end ? end : boundary + 1;
+            }
+
+            if (boundary != boundaries.back())
+            {
+                boundaries.push_back(boundary);
+            }
+        }
+
+        if (boundaries.back() != end || boundaries.size() == 1)
+        {
+            boundaries.push_back(end);
+        }
+        return boundaries;
+    }
+}
+}
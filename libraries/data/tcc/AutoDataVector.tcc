@@ -59,6 +59,16 @@ namespace data
         FindBestRepresentation(std::move(defaultDataVector));
     }
 
+    template <typename DefaultDataVectorType>
+    AutoDataVectorBase<DefaultDataVectorType>::AutoDataVectorBase(std::unique_ptr<IDataVector> internalVector)
+        : _pInternal(std::move(internalVector))
+    {
+        if (_pInternal == nullptr || _pInternal->GetType() == IDataVector::Type::AutoDataVector)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "internal data vector must be a concrete data vector");
+        }
+    }
+
     template <typename DefaultDataVectorType>
     void AutoDataVectorBase<DefaultDataVectorType>::AppendElement(size_t /*index*/, double /*value*/)
     {
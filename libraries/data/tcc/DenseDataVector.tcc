@@ -63,6 +63,12 @@ namespace data
         AppendElements(std::move(list));
     }
 
+    template <typename ElementType>
+    DenseDataVector<ElementType>::DenseDataVector(std::vector<ElementType> values, size_t numNonzeros)
+        : _numNonzeros(numNonzeros), _data(std::move(values))
+    {
+    }
+
     template <typename ElementType>
     double DenseDataVector<ElementType>::operator[](size_t index) const
     {
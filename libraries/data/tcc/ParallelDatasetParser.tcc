@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ParallelDatasetParser.tcc (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryLineIterator.h"
+#include "SingleLineParsingExampleIterator.h"
+
+// stl
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace data
+{
+    namespace detail
+    {
+        // chunks smaller than this aren't worth a thread of their own
+        constexpr size_t minParallelParsingChunkSize = 1 << 20;
+    }
+
+    template <typename MetadataParserType, typename DataVectorParserType>
+    Dataset<ParserExample<DataVectorParserType, MetadataParserType>> ParseDatasetInParallel(const char* begin, const char* end, const MetadataParserType& metadataParser, const DataVectorParserType& dataVectorParser, size_t numThreads)
+    {
+        using ExampleType = ParserExample<DataVectorParserType, MetadataParserType>;
+
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        auto numChunks = std::min(numThreads, std::max(static_cast<size_t>(end - begin) / detail::minParallelParsingChunkSize, size_t{ 1 }));
+        auto boundaries = SplitAtLineBoundaries(begin, end, numChunks);
+
+        auto parseChunk = [&metadataParser, &dataVectorParser](const char* chunkBegin, const char* chunkEnd) {
+            std::vector<ExampleType> examples;
+            auto exampleIterator = MakeSingleLineParsingExampleIterator(MemoryLineIterator(chunkBegin, chunkEnd), metadataParser, dataVectorParser);
+            while (exampleIterator.IsValid())
+            {
+                examples.push_back(exampleIterator.Get());
+                exampleIterator.Next();
+            }
+            return examples;
+        };
+
+        // parse the chunks after the first on other threads, and the first one on this thread
+        std::vector<std::future<std::vector<ExampleType>>> tasks;
+        for (size_t chunkIndex = 1; chunkIndex + 1 < boundaries.size(); ++chunkIndex)
+        {
+            tasks.emplace_back(std::async(std::launch::async, parseChunk, boundaries[chunkIndex], boundaries[chunkIndex + 1]));
+        }
+
+        // add the examples in the order of the chunks, rethrowing any exception a chunk's parser threw
+        Dataset<ExampleType> dataset;
+        for (auto& example : parseChunk(boundaries[0], boundaries[1]))
+        {
+            dataset.AddExample(std::move(example));
+        }
+
+        for (auto& task : tasks)
+        {
+            for (auto& example : task.get())
+            {
+                dataset.AddExample(std::move(example));
+            }
+        }
+
+        return dataset;
+    }
+}
+}
@@ -88,6 +88,12 @@ namespace data
         AppendElements(std::move(vec));
     }
 
+    template <typename IndexListType>
+    SparseBinaryDataVectorBase<IndexListType>::SparseBinaryDataVectorBase(IndexListType indexList)
+        : _indexList(std::move(indexList))
+    {
+    }
+
     template <typename IndexListType>
     void SparseBinaryDataVectorBase<IndexListType>::AppendElement(size_t index, double value)
     {
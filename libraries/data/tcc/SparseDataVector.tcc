@@ -113,6 +113,16 @@ namespace data
         AppendElements(std::move(vec));
     }
 
+    template <typename ElementType, typename IndexListType>
+    SparseDataVector<ElementType, IndexListType>::SparseDataVector(IndexListType indexList, std::vector<ElementType> values)
+        : _indexList(std::move(indexList)), _values(std::move(values))
+    {
+        if (_indexList.Size() != _values.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "number of indices must equal the number of values");
+        }
+    }
+
     template <typename ElementType, typename IndexListType>
     void SparseDataVector<ElementType, IndexListType>::AppendElement(size_t index, double value)
     {
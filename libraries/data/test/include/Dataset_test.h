@@ -12,4 +12,5 @@ namespace ell
 {
 void DatasetCastingTests();
 void DatasetSerializationTests();
+void BinaryDatasetTests();
 }
\ No newline at end of file
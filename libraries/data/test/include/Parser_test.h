@@ -12,4 +12,6 @@ namespace ell
     void DataVectorParseTest();
     void AutoDataVectorParseTest();
     void SingleFileParseTest();
+    void MemoryLineIteratorTest();
+    void ParallelParseTest();
 }
\ No newline at end of file
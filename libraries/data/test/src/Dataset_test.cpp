@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Dataset_test.h"
+#include "BinaryDataset.h"
 #include "Dataset.h"
 #include "DataLoaders.h"
 #include "Files.h"
@@ -16,6 +17,9 @@
 #include "testing.h"
 
 // stl
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
 namespace ell
@@ -118,4 +122,95 @@ void DatasetSerializationTests()
     }
     testing::ProcessTest(utilities::FormatString("DatasetSerializationTest data %d errors", errors), errors == 0);
 }
+
+void BinaryDatasetTests()
+{
+    // examples whose data vectors have different internal representations
+    data::AutoSupervisedDataset dataset1;
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 1.5, -2.25, 3.125, 0.0, 7.0 }, data::WeightLabel{ 1, 1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ 1, 2, 3, 4, 5, 6 }, data::WeightLabel{ 2, -1 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ data::IndexValue{ 3, 0.5 }, data::IndexValue{ 1000, -1.5 }, data::IndexValue{ 100000, 2.0 } }, data::WeightLabel{ 0.5, 3 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ data::IndexValue{ 2, 1 }, data::IndexValue{ 70, 1 }, data::IndexValue{ 5000, 1 } }, data::WeightLabel{ 1, 0 }));
+    dataset1.AddExample(data::AutoSupervisedExample(data::AutoDataVector(std::vector<double>{}), data::WeightLabel{ 1, 2 }));
+
+    std::stringstream stream;
+    data::WriteBinaryDataset(dataset1, stream);
+    auto buffer = stream.str();
+
+    testing::ProcessTest("BinaryDatasetTest header", data::IsBinaryDataset(buffer.data(), buffer.data() + buffer.size()) && !data::IsBinaryDataset(buffer.data() + 1, buffer.data() + buffer.size()));
+
+    auto dataset2 = data::ReadBinaryDataset(buffer.data(), buffer.data() + buffer.size());
+    testing::ProcessTest("BinaryDatasetTest size", dataset1.NumExamples() == dataset2.NumExamples());
+    int errors = 0;
+    if (dataset1.NumExamples() == dataset2.NumExamples())
+    {
+        for (size_t i = 0; i < dataset1.NumExamples(); i++)
+        {
+            const auto& e1 = dataset1.GetExample(i);
+            const auto& e2 = dataset2.GetExample(i);
+
+            auto sameType = e1.GetDataVector().GetInternalType() == e2.GetDataVector().GetInternalType();
+            auto sameVector = testing::IsEqual(e1.GetDataVector().ToArray(), e2.GetDataVector().ToArray());
+            auto sameMetadata = e1.GetMetadata().label == e2.GetMetadata().label && e1.GetMetadata().weight == e2.GetMetadata().weight;
+            if (!(sameType && sameVector && sameMetadata))
+            {
+                errors++;
+            }
+        }
+    }
+    testing::ProcessTest(utilities::FormatString("BinaryDatasetTest data %d errors", errors), errors == 0);
+
+    // a truncated file is rejected
+    bool threw = false;
+    try
+    {
+        data::ReadBinaryDataset(buffer.data(), buffer.data() + buffer.size() - 8);
+    }
+    catch (const utilities::DataFormatException&)
+    {
+        threw = true;
+    }
+    testing::ProcessTest("BinaryDatasetTest truncated", threw);
+
+    // corrupt headers are rejected before anything is allocated
+    auto isRejected = [](std::string corruptBuffer) {
+        try
+        {
+            data::ReadBinaryDataset(corruptBuffer.data(), corruptBuffer.data() + corruptBuffer.size());
+        }
+        catch (const utilities::DataFormatException&)
+        {
+            return true;
+        }
+        return false;
+    };
+    auto setHeaderField = [](std::string& corruptBuffer, size_t offset, uint64_t value) {
+        std::memcpy(&corruptBuffer[offset], &value, sizeof(value));
+    };
+
+    // the first example header starts after the 24-byte file header, and its fields are 8 bytes each:
+    // weight, label, vectorType, numValues, numNonzeros, maxIndex, numIndexBytes
+    const size_t numValuesOffset = 24 + 3 * 8;
+    const size_t numNonzerosOffset = 24 + 4 * 8;
+    const size_t maxIndexOffset = 24 + 5 * 8;
+    auto hugeSizeBuffer = buffer;
+    setHeaderField(hugeSizeBuffer, numValuesOffset, uint64_t{ 1 } << 62);
+    auto wrappingSizeBuffer = buffer;
+    setHeaderField(wrappingSizeBuffer, numValuesOffset, (std::numeric_limits<uint64_t>::max() / sizeof(double)) + 2);
+    testing::ProcessTest("BinaryDatasetTest corrupt sizes", isRejected(hugeSizeBuffer) && isRejected(wrappingSizeBuffer));
+
+    data::AutoSupervisedDataset sparseDataset;
+    sparseDataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector{ data::IndexValue{ 3, 0.5 }, data::IndexValue{ 1000, -1.5 }, data::IndexValue{ 100000, 2.0 } }, data::WeightLabel{ 1, 1 }));
+    std::stringstream sparseStream;
+    data::WriteBinaryDataset(sparseDataset, sparseStream);
+    auto sparseBuffer = sparseStream.str();
+    auto tooManyIndicesBuffer = sparseBuffer;
+    setHeaderField(tooManyIndicesBuffer, numValuesOffset, 4);
+    setHeaderField(tooManyIndicesBuffer, numNonzerosOffset, 4);
+    auto wrongMaxIndexBuffer = sparseBuffer;
+    setHeaderField(wrongMaxIndexBuffer, maxIndexOffset, 1 << 30);
+    auto mismatchedCountsBuffer = sparseBuffer;
+    setHeaderField(mismatchedCountsBuffer, numNonzerosOffset, 2);
+    testing::ProcessTest("BinaryDatasetTest corrupt index lists", !isRejected(sparseBuffer) && isRejected(tooManyIndicesBuffer) && isRejected(wrongMaxIndexBuffer) && isRejected(mismatchedCountsBuffer));
+}
 }
\ No newline at end of file
@@ -16,6 +16,8 @@
 #include "WeightLabel.h"
 #include "AutoDataVector.h"
 #include "Dataset.h"
+#include "MemoryLineIterator.h"
+#include "ParallelDatasetParser.h"
 
 // testing
 #include "testing.h"
@@ -147,4 +149,55 @@ namespace ell
         testing::ProcessTest("SingleFileParse test2", dataset[1].GetMetadata().label == -1 && testing::IsEqual(dataset[1].GetDataVector().ToArray(), { 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 3 }));
         testing::ProcessTest("SingleFileParse test3", dataset[2].GetMetadata().label == 1 && testing::IsEqual(dataset[2].GetDataVector().ToArray(), { 2.7, 0, 0, 0, -0.3, 0, 0, 0, 0, 0, 3.14 }));
     }
+
+    void MemoryLineIteratorTest()
+    {
+        std::string text = "line 1\n\nline 3\nline 4";
+        data::MemoryLineIterator iterator(text.data(), text.data() + text.size());
+        std::vector<std::string> lines;
+        while (iterator.IsValid())
+        {
+            lines.push_back(iterator.GetTextLine().GetString());
+            iterator.Next();
+        }
+        testing::ProcessTest("MemoryLineIterator test", lines == std::vector<std::string>{ "line 1", "", "line 3", "line 4" });
+
+        auto boundaries = data::SplitAtLineBoundaries(text.data(), text.data() + text.size(), 3);
+        bool ok = boundaries.front() == text.data() && boundaries.back() == text.data() + text.size();
+        for (size_t index = 1; index + 1 < boundaries.size(); ++index)
+        {
+            ok = ok && boundaries[index] > boundaries[index - 1] && boundaries[index][-1] == '\n';
+        }
+        testing::ProcessTest("SplitAtLineBoundaries test", ok && boundaries.size() > 2);
+    }
+
+    void ParallelParseTest()
+    {
+        // big enough to be split into several chunks
+        std::string text = "// header comment\n";
+        size_t numLines = 0;
+        while (text.size() < (4 << 20))
+        {
+            text += std::to_string(numLines % 2 == 0 ? 1 : -1) + " " + std::to_string(numLines % 50) + ":" + std::to_string(numLines % 7 + 0.5) + "\n";
+            if (numLines % 1000 == 0)
+            {
+                text += "\n# comment\n";
+            }
+            ++numLines;
+        }
+        text += "1 3 2 1"; // no trailing newline
+
+        std::stringstream stream(text);
+        auto sequentialDataset = data::MakeDataset(data::MakeSingleLineParsingExampleIterator(data::SequentialLineIterator(stream), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>()));
+        auto parallelDataset = data::ParseDatasetInParallel(text.data(), text.data() + text.size(), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), 4);
+
+        bool ok = sequentialDataset.NumExamples() == numLines + 1 && parallelDataset.NumExamples() == sequentialDataset.NumExamples();
+        for (size_t index = 0; ok && index < sequentialDataset.NumExamples(); ++index)
+        {
+            const auto& sequentialExample = sequentialDataset[index];
+            const auto& parallelExample = parallelDataset[index];
+            ok = sequentialExample.GetMetadata().label == parallelExample.GetMetadata().label && sequentialExample.GetDataVector().ToArray() == parallelExample.GetDataVector().ToArray();
+        }
+        testing::ProcessTest("ParallelParse test", ok);
+    }
 }
\ No newline at end of file
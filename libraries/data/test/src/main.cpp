@@ -28,9 +28,12 @@ int main()
     ExampleCopyAsTests();
     DatasetCastingTests();
     DatasetSerializationTests();
+    BinaryDatasetTests();
     DataVectorParseTest();
     AutoDataVectorParseTest();
     SingleFileParseTest();
+    MemoryLineIteratorTest();
+    ParallelParseTest();
 
     if (testing::DidTestFail())
     {
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (data)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// data
+#include "AutoDataVector.h"
+#include "Dataset.h"
+#include "GeneralizedSparseParsingIterator.h"
+#include "ParallelDatasetParser.h"
+#include "SequentialLineIterator.h"
+#include "SingleLineParsingExampleIterator.h"
+#include "WeightLabel.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ell;
+
+namespace
+{
+    // generates a sparse dataset in text format, with the given number of lines
+    std::string GenerateDatasetText(size_t numLines, size_t numNonzerosPerLine, size_t dimension)
+    {
+        std::string text;
+        for (size_t lineIndex = 0; lineIndex < numLines; ++lineIndex)
+        {
+            text += lineIndex % 2 == 0 ? "1" : "-1";
+            for (size_t nonzeroIndex = 0; nonzeroIndex < numNonzerosPerLine; ++nonzeroIndex)
+            {
+                // indices increase along each line
+                auto index = nonzeroIndex * (dimension / numNonzerosPerLine) + lineIndex % (dimension / numNonzerosPerLine);
+                text += " " + std::to_string(index) + ":" + std::to_string(0.25 * ((lineIndex + nonzeroIndex) % 17));
+            }
+            text += "\n";
+        }
+        return text;
+    }
+
+    double ToMegabytesPerSecond(size_t numBytes, std::chrono::milliseconds::rep milliseconds)
+    {
+        return (numBytes / 1048576.0) / (std::max(milliseconds, std::chrono::milliseconds::rep{ 1 }) / 1000.0);
+    }
+
+    void TimeSequentialParsing(const std::string& text)
+    {
+        utilities::MillisecondTimer timer;
+        std::istringstream stream(text);
+        auto exampleIterator = data::MakeSingleLineParsingExampleIterator(data::SequentialLineIterator(stream), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>());
+        auto dataset = data::MakeDataset(std::move(exampleIterator));
+        auto elapsed = timer.Elapsed();
+
+        std::cout << "Sequential parsing of " << dataset.NumExamples() << " examples:\t" << elapsed << " ms\t" << ToMegabytesPerSecond(text.size(), elapsed) << " MB/s" << std::endl;
+    }
+
+    void TimeParallelParsing(const std::string& text, size_t numThreads)
+    {
+        utilities::MillisecondTimer timer;
+        auto dataset = data::ParseDatasetInParallel(text.data(), text.data() + text.size(), data::LabelParser(), data::AutoDataVectorParser<data::GeneralizedSparseParsingIterator>(), numThreads);
+        auto elapsed = timer.Elapsed();
+
+        std::cout << "Parallel parsing with " << numThreads << " threads of " << dataset.NumExamples() << " examples:\t" << elapsed << " ms\t" << ToMegabytesPerSecond(text.size(), elapsed) << " MB/s" << std::endl;
+    }
+}
+
+int main()
+{
+    auto text = GenerateDatasetText(100000, 20, 1000);
+    std::cout << "Dataset text size: " << text.size() / 1048576.0 << " MB" << std::endl;
+
+    TimeSequentialParsing(text);
+    for (size_t numThreads : { 1, 2, 4, 8 })
+    {
+        TimeParallelParsing(text, numThreads);
+    }
+
+    return 0;
+}
@@ -6,6 +6,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#pragma once
+
+#include "FFT.h"
+
 // math
 #include "MathConstants.h"
 #include "Matrix.h"
@@ -17,12 +21,77 @@
 
 // stl
 #include <cmath>
+#include <complex>
 #include <vector>
 
 namespace ell
 {
 namespace dsp
 {
+    /// <summary>
+    /// A precomputed plan for computing the first few coefficients of the discrete cosine transform (DCT-II) of signals
+    /// of a fixed power-of-2 length N in O(N log N) time, instead of the O(N K) of multiplying by the K x N DCT matrix.
+    /// The signal is reordered into v = [x0, x2, x4, ..., x5, x3, x1], the spectrum V of v is computed with a real-valued
+    /// FFT, and each coefficient is X[k] = Re(e^(-pi i k / 2N) V[k]). A plan holds scratch buffers that `Transform` writes,
+    /// so it is not thread-safe: threads that transform signals at the same time need their own plans.
+    /// </summary>
+    template <typename ValueType>
+    class DCTPlan
+    {
+    public:
+        using ComplexType = std::complex<ValueType>;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="numFilters"> The number of DCT coefficients to compute. Must be at most `windowSize`. </param>
+        /// <param name="windowSize"> The size of the signal to be processed. Must be a power of 2, and at least 2. </param>
+        /// <param name="normalize"> A flag indicating if the transform should be orthonormal. </param>
+        DCTPlan(size_t numFilters, size_t windowSize, bool normalize = false);
+
+        /// <summary> Returns the number of DCT coefficients the plan computes. </summary>
+        size_t NumFilters() const { return _rotationFactors.size(); }
+
+        /// <summary> Returns the size of the signal the plan processes. </summary>
+        size_t WindowSize() const { return _fftPlan.Size(); }
+
+        /// <summary> Computes the DCT of a signal. </summary>
+        ///
+        /// <param name="signal"> Pointer to the `WindowSize()` values of the signal. </param>
+        /// <param name="result"> Pointer to the `NumFilters()` values of the result. </param>
+        void Transform(const ValueType* signal, ValueType* result);
+
+        /// <summary> Computes the DCT of a signal. </summary>
+        ///
+        /// <param name="signal"> The signal, whose size must equal `WindowSize()`. </param>
+        ///
+        /// <returns> The `NumFilters()` DCT coefficients of the signal. </returns>
+        math::ColumnVector<ValueType> Transform(math::ConstColumnVectorReference<ValueType> signal);
+
+        /// <summary> Returns the plan for the real-valued FFT of the reordered signal. </summary>
+        const RealFFTPlan<ValueType>& GetRealFFTPlan() const { return _fftPlan; }
+
+        /// <summary>
+        /// Returns the factors e^(-pi i k / 2N), k = 0, ..., NumFilters() - 1, that rotate the spectrum of the reordered signal into
+        /// the DCT coefficients, including the normalization scale if the plan is orthonormal.
+        /// </summary>
+        const std::vector<ComplexType>& GetRotationFactors() const { return _rotationFactors; }
+
+    private:
+        RealFFTPlan<ValueType> _fftPlan;
+        std::vector<ComplexType> _rotationFactors;
+        std::vector<ValueType> _reorderedSignal;
+        std::vector<ComplexType> _spectrum;
+    };
+
+    /// <summary>
+    /// Returns true if a DCT of the given size should be computed with a `DCTPlan` rather than with the DCT matrix:
+    /// that is, if the window size is a power of 2 and large enough that the FFT is cheaper than the matrix product.
+    /// </summary>
+    ///
+    /// <param name="numFilters"> The number of DCT coefficients to compute. </param>
+    /// <param name="windowSize"> The size of the signal to be processed. </param>
+    bool ShouldUseFastDCT(size_t numFilters, size_t windowSize);
+
     /// <summary> Compute the discrete cosine transform (DCT-II) coefficient matrix for a given size DCT. </summary>
     ///
     /// <param name="numFilters"> The number of DCT filters to generate --- the output dimension of a signal processed by this filter matrix. </param>
@@ -43,14 +112,18 @@ namespace dsp
     template <typename ValueType>
     math::ColumnVector<ValueType> DCT(math::ConstRowMatrixReference<ValueType> dctMatrix, math::ConstColumnVectorReference<ValueType> signal, bool normalize = false);
 
-    /// <summary> Compute the discrete cosine transform (DCT-II) of a vector of values. </summary>
+    /// <summary>
+    /// Compute the discrete cosine transform (DCT-II) of a vector of values. Uses a `DCTPlan` if `ShouldUseFastDCT` says so,
+    /// and the DCT matrix otherwise.
+    /// </summary>
     ///
     /// <param name="signal"> The vector to compute the DCT of. </param>
-    /// <param name="normalize"> A flag indicating if the resulting DCT matrix should be orthonormal. </param>
+    /// <param name="numFilters"> The number of DCT coefficients to compute. </param>
+    /// <param name="normalize"> A flag indicating if the transform should be orthonormal. </param>
     ///
     /// <returns> The DCT of the input signal. </returns>
     template <typename ValueType>
-    math::ColumnVector<ValueType> DCT(math::ConstColumnVectorReference<ValueType> signal, bool normalize = false);
+    math::ColumnVector<ValueType> DCT(math::ConstColumnVectorReference<ValueType> signal, size_t numFilters, bool normalize = false);
 }
 }
 
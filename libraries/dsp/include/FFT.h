@@ -6,21 +6,142 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#pragma once
+
 // math
 #include "MathConstants.h"
 #include "Vector.h"
 
 // utilities
-#include "Unused.h"
+#include "Exception.h"
 
 // stl
 #include <complex>
+#include <cstddef>
 #include <vector>
 
 namespace ell
 {
 namespace dsp
 {
+    /// <summary>
+    /// A precomputed plan for in-place complex discrete fourier transforms of a fixed power-of-2 length.
+    /// The transform is iterative: the signal is put in bit-reversed order and then combined in passes
+    /// of radix-4 butterflies (with one radix-2 pass first when the number of radix-2 stages is odd).
+    /// The bit-reversal swaps and each pass's twiddle factors are computed once, when the plan is created,
+    /// and stored contiguously in the order the passes read them.
+    /// The forward transform computes X[k] = sum_n x[n] e^(-2 pi i k n / N), and the inverse transform
+    /// computes x[n] = (1/N) sum_k X[k] e^(2 pi i k n / N).
+    /// </summary>
+    template <typename ValueType>
+    class FFTPlan
+    {
+    public:
+        using ComplexType = std::complex<ValueType>;
+
+        /// <summary> Describes one radix-4 pass of the transform. </summary>
+        struct Radix4Pass
+        {
+            /// <summary> The distance between the four inputs of each butterfly (a quarter of the block size). </summary>
+            size_t quarterBlockSize;
+
+            /// <summary> The index of the pass's first twiddle factor in the twiddle factor table. </summary>
+            size_t twiddleOffset;
+        };
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="length"> The length of the transform. Must be a power of 2. </param>
+        FFTPlan(size_t length);
+
+        /// <summary> Returns the length of the transform. </summary>
+        size_t Size() const { return _length; }
+
+        /// <summary> Computes the forward transform of a signal, in place. </summary>
+        ///
+        /// <param name="signal"> Pointer to the `Size()` complex values of the signal. </param>
+        void Forward(ComplexType* signal) const;
+
+        /// <summary> Computes the inverse transform of a spectrum, in place. </summary>
+        ///
+        /// <param name="signal"> Pointer to the `Size()` complex values of the spectrum. </param>
+        void Inverse(ComplexType* signal) const;
+
+        /// <summary> Computes the forward or inverse transform of a signal, in place. </summary>
+        ///
+        /// <param name="signal"> The signal, whose size must equal `Size()`. </param>
+        /// <param name="inverse"> A flag indicating if the inverse transform should be computed instead. </param>
+        void Transform(std::vector<ComplexType>& signal, bool inverse = false) const;
+
+        /// <summary> Returns the pairs of indices that are swapped to put the signal in bit-reversed order. </summary>
+        const std::vector<std::pair<int, int>>& GetBitReversalSwaps() const { return _bitReversalSwaps; }
+
+        /// <summary> Returns true if the transform starts with a radix-2 pass over adjacent pairs, before the radix-4 passes. </summary>
+        bool HasRadix2Pass() const { return _hasRadix2Pass; }
+
+        /// <summary> Returns the radix-4 passes, in the order they are performed. </summary>
+        const std::vector<Radix4Pass>& GetRadix4Passes() const { return _radix4Passes; }
+
+        /// <summary>
+        /// Returns the twiddle factors of the radix-4 passes. For the butterfly at offset j of a pass with quarter
+        /// block size q, entries `twiddleOffset + 2j` and `twiddleOffset + 2j + 1` hold e^(-2 pi i j / 4q) and
+        /// e^(-2 pi i 2j / 4q).
+        /// </summary>
+        const std::vector<ComplexType>& GetTwiddleFactors() const { return _twiddleFactors; }
+
+    private:
+        size_t _length;
+        std::vector<std::pair<int, int>> _bitReversalSwaps;
+        bool _hasRadix2Pass = false;
+        std::vector<Radix4Pass> _radix4Passes;
+        std::vector<ComplexType> _twiddleFactors;
+    };
+
+    /// <summary>
+    /// A precomputed plan for discrete fourier transforms of real-valued signals of a fixed power-of-2 length N.
+    /// The N real values are treated as N/2 complex values, transformed with a half-length complex plan, and the
+    /// result is split into the first N/2 + 1 entries of the spectrum (the rest are their complex conjugates). A plan holds
+    /// a scratch buffer that `Forward` and `Inverse` write, so it is not thread-safe.
+    /// </summary>
+    template <typename ValueType>
+    class RealFFTPlan
+    {
+    public:
+        using ComplexType = std::complex<ValueType>;
+
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="length"> The length of the real-valued signal. Must be a power of 2, and at least 2. </param>
+        RealFFTPlan(size_t length);
+
+        /// <summary> Returns the length of the real-valued signal. </summary>
+        size_t Size() const { return _length; }
+
+        /// <summary> Computes the first N/2 + 1 entries of the spectrum of a real-valued signal. </summary>
+        ///
+        /// <param name="signal"> Pointer to the N values of the signal. </param>
+        /// <param name="spectrum"> Pointer to the N/2 + 1 complex values of the result. </param>
+        void Forward(const ValueType* signal, ComplexType* spectrum);
+
+        /// <summary> Computes the real-valued signal whose spectrum starts with the given N/2 + 1 entries. </summary>
+        ///
+        /// <param name="spectrum"> Pointer to the N/2 + 1 complex values of the spectrum. </param>
+        /// <param name="signal"> Pointer to the N values of the result. </param>
+        void Inverse(const ComplexType* spectrum, ValueType* signal);
+
+        /// <summary> Returns the half-length complex plan. </summary>
+        const FFTPlan<ValueType>& GetComplexPlan() const { return _complexPlan; }
+
+        /// <summary> Returns the factors e^(-2 pi i k / N), k = 0, ..., N/2 - 1, used to split the half-length transform. </summary>
+        const std::vector<ComplexType>& GetSplitFactors() const { return _splitFactors; }
+
+    private:
+        size_t _length;
+        FFTPlan<ValueType> _complexPlan;
+        std::vector<ComplexType> _splitFactors;
+        std::vector<ComplexType> _buffer;
+    };
+
     /// <summary> Perform an in-place discrete ("fast") fourier transform (FFT) of a complex-valued input signal. </summary>
     ///
     /// <param name="signal"> The signal vector to process. Must be a power of 2 in length. </param>
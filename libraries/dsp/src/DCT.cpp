@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DCT.cpp (dsp)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DCT.h"
+
+namespace ell
+{
+namespace dsp
+{
+    namespace detail
+    {
+        // For window sizes from 16 to 1024, a DCTPlan costs about as much as multiplying by 6 rows of the DCT matrix
+        // with a plain loop, or by 12 rows with BLAS. Smaller windows aren't worth the extra code.
+        constexpr size_t minFastDCTNumFilters = 12;
+        constexpr size_t minFastDCTWindowSize = 32;
+    }
+
+    bool ShouldUseFastDCT(size_t numFilters, size_t windowSize)
+    {
+        return detail::IsPowerOfTwo(windowSize) && windowSize >= detail::minFastDCTWindowSize && numFilters >= detail::minFastDCTNumFilters && numFilters <= windowSize;
+    }
+}
+}
@@ -18,8 +18,82 @@ namespace dsp
     //        n=0
     //
     // If normalized, the x_0 term gets scaled by 1/sqrt(2), and then multiply the overall result by sqrt(2/N)
+    //
+    // DCTPlan
+    //
+
+    // With v[n] = x[2n] and v[N-1-n] = x[2n+1], for n < N/2, the sum for X[k] splits into the terms of the even and
+    // the odd samples, and the two halves together are Re(e^(-pi i k / 2N) sum_n v[n] e^(-2 pi i k n / N)).
+    template <typename ValueType>
+    DCTPlan<ValueType>::DCTPlan(size_t numFilters, size_t windowSize, bool normalize)
+        : _fftPlan(windowSize), _reorderedSignal(windowSize), _spectrum(windowSize / 2 + 1)
+    {
+        if (numFilters > windowSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "DCT can't have more filters than its window size");
+        }
+
+        const double pi = math::Constants<double>::pi;
+        const auto scale = std::sqrt(2.0 / windowSize);
+        _rotationFactors.reserve(numFilters);
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            auto angle = -pi * k / (2.0 * windowSize);
+            auto factorScale = normalize ? (k == 0 ? scale / std::sqrt(2.0) : scale) : 1.0;
+            _rotationFactors.emplace_back(static_cast<ValueType>(factorScale * std::cos(angle)), static_cast<ValueType>(factorScale * std::sin(angle)));
+        }
+    }
+
+    template <typename ValueType>
+    void DCTPlan<ValueType>::Transform(const ValueType* signal, ValueType* result)
+    {
+        auto windowSize = WindowSize();
+        auto halfWindowSize = windowSize / 2;
+        for (size_t n = 0; n < halfWindowSize; ++n)
+        {
+            _reorderedSignal[n] = signal[2 * n];
+            _reorderedSignal[windowSize - 1 - n] = signal[2 * n + 1];
+        }
+        _fftPlan.Forward(_reorderedSignal.data(), _spectrum.data());
+
+        // only the first N/2 + 1 entries of the spectrum are computed, the rest are V[k] = conj(V[N-k])
+        auto numFilters = NumFilters();
+        for (size_t k = 0; k < numFilters; ++k)
+        {
+            auto w = _rotationFactors[k];
+            if (k <= halfWindowSize)
+            {
+                auto v = _spectrum[k];
+                result[k] = w.real() * v.real() - w.imag() * v.imag();
+            }
+            else
+            {
+                auto v = _spectrum[windowSize - k];
+                result[k] = w.real() * v.real() + w.imag() * v.imag();
+            }
+        }
+    }
+
+    template <typename ValueType>
+    math::ColumnVector<ValueType> DCTPlan<ValueType>::Transform(math::ConstColumnVectorReference<ValueType> signal)
+    {
+        if (signal.Size() != WindowSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "signal size doesn't match the DCT plan");
+        }
+
+        auto signalValues = signal.ToArray();
+        math::ColumnVector<ValueType> result(NumFilters());
+        Transform(signalValues.data(), result.GetDataPointer());
+        return result;
+    }
+
+    //
+    // DCT functions
+    //
+
     template <typename ValueType>
-    math::RowMatrix<ValueType> GetDCTMatrix(size_t windowSize, size_t numFilters, bool normalize)
+    math::RowMatrix<ValueType> GetDCTMatrix(size_t numFilters, size_t windowSize, bool normalize)
     {
         const auto pi = math::Constants<ValueType>::pi;
         const auto one_sqrt2 = 1.0 / std::sqrt(2.0);
@@ -48,7 +122,7 @@ namespace dsp
     template <typename ValueType>
     math::ColumnVector<ValueType> DCT(math::ConstRowMatrixReference<ValueType> dctMatrix, math::ConstColumnVectorReference<ValueType> signal, bool normalize)
     {
-        math::ColumnVector<ValueType> result(signal.Size());
+        math::ColumnVector<ValueType> result(dctMatrix.NumRows());
         if (normalize)
         {
             throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
@@ -64,16 +138,14 @@ namespace dsp
     math::ColumnVector<ValueType> DCT(math::ConstColumnVectorReference<ValueType> signal, size_t numFilters, bool normalize)
     {
         auto windowSize = signal.Size();
-        auto dctMatrix = GetDCTMatrix<ValueType>(windowSize, numFilters);
-        math::ColumnVector<ValueType> result(numFilters);
-        if (normalize)
-        {
-            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
-        }
-        else
+        if (ShouldUseFastDCT(numFilters, windowSize))
         {
-            math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), dctMatrix, signal, static_cast<ValueType>(0.0), result);
+            return DCTPlan<ValueType>(numFilters, windowSize, normalize).Transform(signal);
         }
+
+        auto dctMatrix = GetDCTMatrix<ValueType>(numFilters, windowSize, normalize);
+        math::ColumnVector<ValueType> result(numFilters);
+        math::MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), dctMatrix, signal, static_cast<ValueType>(0.0), result);
         return result;
     }
 
@@ -6,151 +6,365 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// stl
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <utility>
+
 namespace ell
 {
 namespace dsp
 {
     namespace detail
     {
-        template <typename Iterator>
-        void Deinterleave(Iterator begin, Iterator end, Iterator scratch)
+        inline bool IsPowerOfTwo(size_t n)
         {
-            const auto size = end - begin;
-            const auto halfN = size / 2;
-            for (int index = 0; index < halfN; ++index)
-            {
-                scratch[index] = begin[2 * index + 1];
-                begin[index] = begin[2 * index];
-            }
-            for (int index = 0; index < halfN; ++index)
-            {
-                begin[index + halfN] = scratch[index];
-            }
+            return n != 0 && (n & (n - 1)) == 0;
         }
 
-        template <typename Iterator>
-        void FFT(Iterator begin, Iterator end, Iterator scratch, bool inverse)
+        // e^(-2 pi i numerator / denominator), computed in double precision
+        template <typename ValueType>
+        std::complex<ValueType> UnitRoot(size_t numerator, size_t denominator)
         {
-            if (inverse)
+            const double pi = math::Constants<double>::pi;
+            auto angle = -2.0 * pi * static_cast<double>(numerator) / static_cast<double>(denominator);
+            return { static_cast<ValueType>(std::cos(angle)), static_cast<ValueType>(std::sin(angle)) };
+        }
+
+        //
+        // The butterflies work on the interleaved real and imaginary parts of the complex values, and multiply
+        // without the special cases for infinities and NaNs that std::complex's operator* has, so that the compiler
+        // can keep them in registers and vectorize them.
+        //
+
+        // The first pass, when the number of radix-2 stages is odd: x[2m], x[2m+1] <- x[2m] + x[2m+1], x[2m] - x[2m+1]
+        template <typename ValueType>
+        void Radix2Pass(ValueType* data, size_t length)
+        {
+            for (size_t index = 0; index < 2 * length; index += 4)
             {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented);
+                auto aRe = data[index];
+                auto aIm = data[index + 1];
+                auto bRe = data[index + 2];
+                auto bIm = data[index + 3];
+                data[index] = aRe + bRe;
+                data[index + 1] = aIm + bIm;
+                data[index + 2] = aRe - bRe;
+                data[index + 3] = aIm - bIm;
             }
-            using ValueType = typename Iterator::value_type::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
+        }
 
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
+        // Two radix-2 stages at once. For blocks of size 4q, with a = x[j], b = x[j+q], c = x[j+2q], d = x[j+3q],
+        // w1 = e^(-2 pi i j / 4q) and w2 = w1^2, computes
+        //   t0 = a + w2 b, t1 = a - w2 b, t2 = c + w2 d, t3 = c - w2 d
+        //   x[j] = t0 + w1 t2, x[j+2q] = t0 - w1 t2, x[j+q] = t1 - i w1 t3, x[j+3q] = t1 + i w1 t3
+        template <typename ValueType>
+        void Radix4Pass(ValueType* data, size_t length, size_t quarterBlockSize, const ValueType* twiddles)
+        {
+            const auto q = quarterBlockSize;
+            for (size_t blockStart = 0; blockStart < length; blockStart += 4 * q)
             {
-                return; // done
+                ValueType* a = data + 2 * blockStart;
+                ValueType* b = a + 2 * q;
+                ValueType* c = b + 2 * q;
+                ValueType* d = c + 2 * q;
+                for (size_t j = 0; j < q; ++j)
+                {
+                    auto w1Re = twiddles[4 * j];
+                    auto w1Im = twiddles[4 * j + 1];
+                    auto w2Re = twiddles[4 * j + 2];
+                    auto w2Im = twiddles[4 * j + 3];
+
+                    auto aRe = a[2 * j];
+                    auto aIm = a[2 * j + 1];
+                    auto bRe = w2Re * b[2 * j] - w2Im * b[2 * j + 1];
+                    auto bIm = w2Re * b[2 * j + 1] + w2Im * b[2 * j];
+                    auto cRe = c[2 * j];
+                    auto cIm = c[2 * j + 1];
+                    auto dRe = w2Re * d[2 * j] - w2Im * d[2 * j + 1];
+                    auto dIm = w2Re * d[2 * j + 1] + w2Im * d[2 * j];
+
+                    auto t0Re = aRe + bRe;
+                    auto t0Im = aIm + bIm;
+                    auto t1Re = aRe - bRe;
+                    auto t1Im = aIm - bIm;
+                    auto t2Re = cRe + dRe;
+                    auto t2Im = cIm + dIm;
+                    auto t3Re = cRe - dRe;
+                    auto t3Im = cIm - dIm;
+
+                    // u2 = w1 t2, u3 = -i w1 t3
+                    auto u2Re = w1Re * t2Re - w1Im * t2Im;
+                    auto u2Im = w1Re * t2Im + w1Im * t2Re;
+                    auto u3Re = w1Re * t3Im + w1Im * t3Re;
+                    auto u3Im = -(w1Re * t3Re - w1Im * t3Im);
+
+                    a[2 * j] = t0Re + u2Re;
+                    a[2 * j + 1] = t0Im + u2Im;
+                    c[2 * j] = t0Re - u2Re;
+                    c[2 * j + 1] = t0Im - u2Im;
+                    b[2 * j] = t1Re + u3Re;
+                    b[2 * j + 1] = t1Im + u3Im;
+                    d[2 * j] = t1Re - u3Re;
+                    d[2 * j + 1] = t1Im - u3Im;
+                }
             }
+        }
 
-            Deinterleave(begin, end, scratch);
-            auto evens = begin;
-            auto odds = begin + halfN;
+        // The number of plans of each type that a thread keeps before it evicts the least recently used one
+        constexpr size_t c_maxCachedPlans = 8;
 
-            if (halfN > 1)
+        // Plans are cached per thread, so that repeated transforms of the same length don't recompute them,
+        // and transforms on different threads don't share a plan's buffers. The returned reference is only
+        // valid until the next call on the same thread.
+        template <typename PlanType>
+        PlanType& GetCachedPlan(size_t length)
+        {
+            // most recently used first
+            thread_local std::list<std::pair<size_t, PlanType>> plans;
+            auto iter = std::find_if(plans.begin(), plans.end(), [length](const auto& entry) { return entry.first == length; });
+            if (iter != plans.end())
             {
-                FFT(evens, evens + halfN, scratch, inverse);
-                FFT(odds, odds + halfN, scratch, inverse);
+                plans.splice(plans.begin(), plans, iter);
             }
-
-            for (int k = 0; k < halfN; k++)
+            else
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = evens[k];
-                auto o = odds[k];
-                auto wo = w * o;
-                evens[k] = e + wo; // even
-                odds[k] = e - wo; // odd
+                if (plans.size() >= c_maxCachedPlans)
+                {
+                    plans.pop_back();
+                }
+                plans.emplace_front(length, PlanType(length));
             }
+            return plans.front().second;
         }
 
-        template <typename Iterator, typename ComplexIterator>
-        void FFTReal(Iterator begin, Iterator end, Iterator scratch, ComplexIterator outputBegin, ComplexIterator outputEnd, bool inverse)
+        template <typename ValueType>
+        void RealFFTMagnitudes(ValueType* signal, size_t size, bool inverse)
         {
-            UNUSED(outputEnd);
-            if (inverse)
+            if (size < 2)
             {
-                throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "inverse must be false");
+                if (size == 1)
+                {
+                    signal[0] = std::abs(signal[0]);
+                }
+                return;
             }
 
-            using ValueType = typename Iterator::value_type;
-            const ValueType pi = math::Constants<ValueType>::pi;
+            // The magnitudes of the inverse transform of a real signal are the forward magnitudes divided by N
+            auto& plan = GetCachedPlan<RealFFTPlan<ValueType>>(size);
+            std::vector<std::complex<ValueType>> spectrum(size / 2 + 1);
+            plan.Forward(signal, spectrum.data());
 
-            auto halfN = (end - begin) / 2;
-            if (halfN < 1)
+            const ValueType scale = inverse ? static_cast<ValueType>(1) / static_cast<ValueType>(size) : static_cast<ValueType>(1);
+            for (size_t index = 0; index <= size / 2; ++index)
             {
-                return; // done
+                signal[index] = scale * std::abs(spectrum[index]);
             }
+            for (size_t index = size / 2 + 1; index < size; ++index)
+            {
+                signal[index] = signal[size - index];
+            }
+        }
+    }
 
-            Deinterleave(begin, end, scratch);
+    //
+    // FFTPlan
+    //
+    template <typename ValueType>
+    FFTPlan<ValueType>::FFTPlan(size_t length)
+        : _length(length)
+    {
+        if (!detail::IsPowerOfTwo(length))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FFT length must be a power of 2");
+        }
 
-            auto evens = begin;
-            auto odds = begin + halfN;
-            auto complexEvens = outputBegin;
-            auto complexOdds = outputBegin + halfN;
+        // bit-reversal permutation, as a list of swaps
+        size_t numBits = 0;
+        while ((size_t{ 1 } << numBits) < length)
+        {
+            ++numBits;
+        }
 
-            if (halfN > 1)
+        for (size_t index = 0; index < length; ++index)
+        {
+            size_t reversed = 0;
+            for (size_t bit = 0; bit < numBits; ++bit)
             {
-                FFTReal(evens, evens + halfN, scratch, complexEvens, complexEvens + halfN, inverse);
-                FFTReal(odds, odds + halfN, scratch, complexOdds, complexOdds + halfN, inverse);
+                reversed |= ((index >> bit) & 1) << (numBits - 1 - bit);
             }
-            else
+            if (index < reversed)
             {
-                // Base case: copy from real to complex
-                for (int index = 0; index < halfN; ++index)
-                {
-                    complexEvens[index] = evens[index];
-                    complexOdds[index] = odds[index];
-                }
+                _bitReversalSwaps.emplace_back(static_cast<int>(index), static_cast<int>(reversed));
             }
+        }
 
-            for (int k = 0; k < halfN; k++)
+        // an odd number of radix-2 stages starts with a single radix-2 pass, the rest are paired into radix-4 passes
+        _hasRadix2Pass = numBits % 2 == 1;
+        for (size_t quarterBlockSize = _hasRadix2Pass ? 2 : 1; 4 * quarterBlockSize <= length; quarterBlockSize *= 4)
+        {
+            _radix4Passes.push_back({ quarterBlockSize, _twiddleFactors.size() });
+            for (size_t j = 0; j < quarterBlockSize; ++j)
             {
-                // w = e^(2*pi*k/N)
-                std::complex<ValueType> w = std::exp(std::complex<ValueType>(0, pi * k / halfN));
-                auto e = complexEvens[k];
-                auto o = complexOdds[k];
-                auto wo = w * o;
-                complexEvens[k] = e + wo; // even
-                complexOdds[k] = e - wo; // odd
+                _twiddleFactors.push_back(detail::UnitRoot<ValueType>(j, 4 * quarterBlockSize));
+                _twiddleFactors.push_back(detail::UnitRoot<ValueType>(2 * j, 4 * quarterBlockSize));
             }
         }
     }
 
     template <typename ValueType>
-    void FFT(std::vector<std::complex<ValueType>>& input, bool inverse)
+    void FFTPlan<ValueType>::Forward(ComplexType* signal) const
     {
-        std::vector<std::complex<ValueType>> scratch(input.size() / 2);
-        detail::FFT(std::begin(input), std::end(input), std::begin(scratch), inverse);
+        for (const auto& swap : _bitReversalSwaps)
+        {
+            std::swap(signal[swap.first], signal[swap.second]);
+        }
+
+        auto data = reinterpret_cast<ValueType*>(signal);
+        if (_hasRadix2Pass)
+        {
+            detail::Radix2Pass(data, _length);
+        }
+
+        auto twiddles = reinterpret_cast<const ValueType*>(_twiddleFactors.data());
+        for (const auto& pass : _radix4Passes)
+        {
+            detail::Radix4Pass(data, _length, pass.quarterBlockSize, twiddles + 2 * pass.twiddleOffset);
+        }
     }
 
     template <typename ValueType>
-    void FFT(std::vector<ValueType>& input, bool inverse)
+    void FFTPlan<ValueType>::Inverse(ComplexType* signal) const
     {
-        auto size = input.size();
-        std::vector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(std::begin(input), std::end(input), std::begin(scratch), std::begin(output), std::end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        // inverse(X) = conj(forward(conj(X))) / N
+        auto data = reinterpret_cast<ValueType*>(signal);
+        for (size_t index = 0; index < _length; ++index)
         {
-            input[index] = std::abs(output[index]);
+            data[2 * index + 1] = -data[2 * index + 1];
+        }
+
+        Forward(signal);
+
+        const ValueType scale = static_cast<ValueType>(1) / static_cast<ValueType>(_length);
+        for (size_t index = 0; index < _length; ++index)
+        {
+            data[2 * index] *= scale;
+            data[2 * index + 1] *= -scale;
         }
     }
 
     template <typename ValueType>
-    void FFT(math::RowVector<ValueType>& input, bool inverse)
+    void FFTPlan<ValueType>::Transform(std::vector<ComplexType>& signal, bool inverse) const
+    {
+        if (signal.size() != _length)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "signal size doesn't match the FFT plan");
+        }
+
+        if (inverse)
+        {
+            Inverse(signal.data());
+        }
+        else
+        {
+            Forward(signal.data());
+        }
+    }
+
+    //
+    // RealFFTPlan
+    //
+    template <typename ValueType>
+    RealFFTPlan<ValueType>::RealFFTPlan(size_t length)
+        : _length(length), _complexPlan(length / 2), _buffer(length / 2)
+    {
+        // For odd lengths, length / 2 may still be a power of 2, so the complex plan doesn't catch them
+        if (!detail::IsPowerOfTwo(length) || length < 2)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Real-valued FFT length must be a power of 2, and at least 2");
+        }
+
+        auto halfLength = length / 2;
+        _splitFactors.reserve(halfLength);
+        for (size_t k = 0; k < halfLength; ++k)
+        {
+            _splitFactors.push_back(detail::UnitRoot<ValueType>(k, length));
+        }
+    }
+
+    template <typename ValueType>
+    void RealFFTPlan<ValueType>::Forward(const ValueType* signal, ComplexType* spectrum)
     {
-        using std::begin;
-        auto size = input.Size();
-        math::RowVector<ValueType> scratch(size / 2);
-        std::vector<std::complex<ValueType>> output(size);
-        detail::FFTReal(begin(input), end(input), begin(scratch), begin(output), end(output), inverse);
-        for (size_t index = 0; index < size; ++index)
+        // z[m] = x[2m] + i x[2m+1]
+        auto halfLength = _length / 2;
+        std::copy(signal, signal + _length, reinterpret_cast<ValueType*>(_buffer.data()));
+        _complexPlan.Forward(_buffer.data());
+
+        // with E and O the transforms of the even and odd samples, Z[k] = E[k] + i O[k], and since E and O are
+        // conjugate-symmetric, E[k] = (Z[k] + conj(Z[M-k])) / 2 and O[k] = -i (Z[k] - conj(Z[M-k])) / 2.
+        // Then X[k] = E[k] + w^k O[k].
+        const ValueType half = static_cast<ValueType>(0.5);
+        auto z0 = _buffer[0];
+        spectrum[0] = { z0.real() + z0.imag(), 0 };
+        spectrum[halfLength] = { z0.real() - z0.imag(), 0 };
+        for (size_t k = 1; k < halfLength; ++k)
+        {
+            auto z = _buffer[k];
+            auto zMirror = std::conj(_buffer[halfLength - k]);
+            auto even = half * (z + zMirror);
+            auto oddTimesI = half * (z - zMirror);
+            auto odd = ComplexType{ oddTimesI.imag(), -oddTimesI.real() };
+            auto w = _splitFactors[k];
+            spectrum[k] = { even.real() + w.real() * odd.real() - w.imag() * odd.imag(), even.imag() + w.real() * odd.imag() + w.imag() * odd.real() };
+        }
+    }
+
+    template <typename ValueType>
+    void RealFFTPlan<ValueType>::Inverse(const ComplexType* spectrum, ValueType* signal)
+    {
+        // E[k] = (X[k] + conj(X[M-k])) / 2, O[k] = conj(w^k) (X[k] - conj(X[M-k])) / 2, and Z[k] = E[k] + i O[k]
+        auto halfLength = _length / 2;
+        const ValueType half = static_cast<ValueType>(0.5);
+        for (size_t k = 0; k < halfLength; ++k)
         {
-            input[index] = std::abs(output[index]);
+            auto x = spectrum[k];
+            auto xMirror = std::conj(spectrum[halfLength - k]);
+            auto even = half * (x + xMirror);
+            auto difference = half * (x - xMirror);
+            auto w = _splitFactors[k];
+            auto odd = ComplexType{ w.real() * difference.real() + w.imag() * difference.imag(), w.real() * difference.imag() - w.imag() * difference.real() };
+            _buffer[k] = { even.real() - odd.imag(), even.imag() + odd.real() };
         }
+
+        _complexPlan.Inverse(_buffer.data());
+        auto data = reinterpret_cast<const ValueType*>(_buffer.data());
+        std::copy(data, data + _length, signal);
+    }
+
+    //
+    // FFT functions
+    //
+    template <typename ValueType>
+    void FFT(std::vector<std::complex<ValueType>>& input, bool inverse)
+    {
+        if (input.empty())
+        {
+            return;
+        }
+        detail::GetCachedPlan<FFTPlan<ValueType>>(input.size()).Transform(input, inverse);
+    }
+
+    template <typename ValueType>
+    void FFT(std::vector<ValueType>& input, bool inverse)
+    {
+        detail::RealFFTMagnitudes(input.data(), input.size(), inverse);
+    }
+
+    template <typename ValueType>
+    void FFT(math::RowVector<ValueType>& input, bool inverse)
+    {
+        detail::RealFFTMagnitudes(input.GetDataPointer(), input.Size(), inverse);
     }
 }
 }
@@ -0,0 +1,16 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DCTTiming.h (dsp)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+// DCT of a signal, through the DCT matrix and through a DCTPlan
+template <typename ValueType>
+void TimeDCT(size_t numFilters, size_t windowSize, size_t numIterations);
@@ -14,5 +14,14 @@
 template <typename ValueType>
 void TestFFT(size_t N);
 
+template <typename ValueType>
+void TestFFTPlan(size_t N);
+
 template <typename ValueType>
 void VerifyFFT();
+
+template <typename ValueType>
+void TestFFTPlanCache();
+
+template <typename ValueType>
+void TestFFTInvalidLength(size_t N);
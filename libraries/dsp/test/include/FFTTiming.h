@@ -0,0 +1,16 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FFTTiming.h (dsp)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+
+// Complex and real-valued FFTs of a signal, through the FFT functions and through a plan
+template <typename ValueType>
+void TimeFFT(size_t signalSize, size_t numIterations);
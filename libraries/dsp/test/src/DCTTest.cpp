@@ -18,8 +18,13 @@
 // testing
 #include "testing.h"
 
+// utilities
+#include "RandomEngines.h"
+
 // stl
 #include <iostream>
+#include <random>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -86,6 +91,29 @@ void TestDCTMatrix(const std::vector<std::vector<double>>& refMatrixValues, bool
     }
 }
 
+template <typename ValueType>
+void TestFastDCT(size_t numFilters, size_t windowSize, bool normalize)
+{
+    const double epsilon = std::is_same<ValueType, float>::value ? 1e-4 : 1e-10;
+
+    auto randomEngine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<ValueType> uniform(-1, 1);
+    ColumnVector<ValueType> signal(windowSize);
+    signal.Generate([&]() { return uniform(randomEngine); });
+
+    auto dctMatrix = GetDCTMatrix<ValueType>(numFilters, windowSize, normalize);
+    ColumnVector<ValueType> expected(numFilters);
+    MultiplyScaleAddUpdate(static_cast<ValueType>(1.0), dctMatrix, signal, static_cast<ValueType>(0.0), expected);
+
+    DCTPlan<ValueType> plan(numFilters, windowSize, normalize);
+    auto result = plan.Transform(signal);
+    auto description = std::to_string(numFilters) + " x " + std::to_string(windowSize) + (normalize ? ", normalized" : "");
+    testing::ProcessTest("Testing DCTPlan vs. DCT matrix, " + description, result.IsEqual(expected, static_cast<ValueType>(epsilon * windowSize)));
+
+    auto dispatched = DCT<ValueType>(signal, numFilters, normalize);
+    testing::ProcessTest("Testing DCT vs. DCT matrix, " + description, dispatched.IsEqual(expected, static_cast<ValueType>(epsilon * windowSize)));
+}
+
 void TestDCT()
 {
     TestDCTMatrix(dct_precomputed);
@@ -107,4 +135,17 @@ void TestDCT()
     // TestDCTMatrix(GetDCTReference_III_64_40());
     // TestDCTMatrix(GetDCTReference_III_128_13());
     // TestDCTMatrix(GetDCTReference_III_128_40());
+
+    // FFT-based DCT-II vs. the DCT matrix
+    for (size_t windowSize : { 2, 8, 32, 256 })
+    {
+        for (size_t numFilters : { size_t{ 1 }, windowSize / 2 + 1, windowSize })
+        {
+            for (bool normalize : { false, true })
+            {
+                TestFastDCT<float>(numFilters, windowSize, normalize);
+                TestFastDCT<double>(numFilters, windowSize, normalize);
+            }
+        }
+    }
 }
@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     DCTTiming.cpp (dsp)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DCTTiming.h"
+
+// dsp
+#include "DCT.h"
+
+// math
+#include "Vector.h"
+
+// utilities
+#include "MillisecondTimer.h"
+#include "TypeName.h"
+
+// stl
+#include <iostream>
+#include <vector>
+
+using namespace ell;
+
+//
+// Timing
+//
+template <typename ValueType>
+void TimeDCT(size_t numFilters, size_t windowSize, size_t numIterations)
+{
+    math::ColumnVector<ValueType> signal(windowSize);
+    for (size_t index = 0; index < windowSize; ++index)
+    {
+        signal[index] = static_cast<ValueType>(index % 7) - 3;
+    }
+
+    auto dctMatrix = dsp::GetDCTMatrix<ValueType>(numFilters, windowSize);
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        dsp::DCT<ValueType>(dctMatrix, signal);
+    }
+    auto matrixDuration = timer.Elapsed();
+
+    dsp::DCTPlan<ValueType> plan(numFilters, windowSize);
+    std::vector<ValueType> signalValues = signal.ToArray();
+    std::vector<ValueType> result(numFilters);
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        plan.Transform(signalValues.data(), result.data());
+    }
+    auto planDuration = timer.Elapsed();
+
+    std::cout << "Time to perform " << numIterations << " " << numFilters << "-filter DCTs of size-" << windowSize << " " << utilities::GetTypeName<ValueType>() << " signals: "
+              << "matrix " << matrixDuration << " ms, plan " << planDuration << " ms" << std::endl;
+}
+
+//
+// Explicit instantiation definitions
+//
+template void TimeDCT<float>(size_t, size_t, size_t);
+template void TimeDCT<double>(size_t, size_t, size_t);
@@ -13,6 +13,7 @@
 #include "FFT.h"
 
 // math
+#include "MathConstants.h"
 #include "Vector.h"
 #include "VectorOperations.h"
 
@@ -20,11 +21,14 @@
 #include "testing.h"
 
 // utilities
+#include "Exception.h"
 #include "RandomEngines.h"
 
 // stl
 #include <complex>
 #include <random>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace ell;
@@ -88,6 +92,80 @@ void TestFFT(size_t N)
     }
 }
 
+template <typename ValueType>
+void TestFFTPlan(size_t N)
+{
+    const double epsilon = std::is_same<ValueType, float>::value ? 1e-4 : 1e-10;
+    const double pi = math::Constants<double>::pi;
+
+    auto randomEngine = utilities::GetRandomEngine("123");
+    std::uniform_real_distribution<ValueType> uniform(-1, 1);
+    std::vector<std::complex<ValueType>> signal(N);
+    std::vector<ValueType> realSignal(N);
+    for (size_t index = 0; index < N; ++index)
+    {
+        signal[index] = { uniform(randomEngine), uniform(randomEngine) };
+        realSignal[index] = signal[index].real();
+    }
+
+    // the direct O(N^2) DFT of the complex and real signals
+    std::vector<std::complex<double>> reference(N);
+    std::vector<std::complex<double>> realReference(N);
+    for (size_t k = 0; k < N; ++k)
+    {
+        for (size_t n = 0; n < N; ++n)
+        {
+            auto w = std::polar(1.0, -2 * pi * static_cast<double>((k * n) % N) / N);
+            reference[k] += w * std::complex<double>(signal[n]);
+            realReference[k] += w * static_cast<double>(realSignal[n]);
+        }
+    }
+
+    auto isClose = [epsilon, N](std::complex<double> a, std::complex<ValueType> b) {
+        return std::abs(a - std::complex<double>(b)) <= epsilon * N;
+    };
+
+    dsp::FFTPlan<ValueType> plan(N);
+    auto transformed = signal;
+    plan.Forward(transformed.data());
+    bool ok = true;
+    for (size_t k = 0; k < N; ++k)
+    {
+        ok = ok && isClose(reference[k], transformed[k]);
+    }
+    testing::ProcessTest("Testing FFTPlan forward transform vs direct DFT, N = " + std::to_string(N), ok);
+
+    plan.Inverse(transformed.data());
+    ok = true;
+    for (size_t n = 0; n < N; ++n)
+    {
+        ok = ok && isClose(signal[n], transformed[n]);
+    }
+    testing::ProcessTest("Testing FFTPlan inverse transform, N = " + std::to_string(N), ok);
+
+    if (N >= 2)
+    {
+        dsp::RealFFTPlan<ValueType> realPlan(N);
+        std::vector<std::complex<ValueType>> spectrum(N / 2 + 1);
+        realPlan.Forward(realSignal.data(), spectrum.data());
+        ok = true;
+        for (size_t k = 0; k <= N / 2; ++k)
+        {
+            ok = ok && isClose(realReference[k], spectrum[k]);
+        }
+        testing::ProcessTest("Testing RealFFTPlan forward transform vs direct DFT, N = " + std::to_string(N), ok);
+
+        std::vector<ValueType> inverse(N);
+        realPlan.Inverse(spectrum.data(), inverse.data());
+        ok = true;
+        for (size_t n = 0; n < N; ++n)
+        {
+            ok = ok && std::abs(inverse[n] - realSignal[n]) <= epsilon * N;
+        }
+        testing::ProcessTest("Testing RealFFTPlan inverse transform, N = " + std::to_string(N), ok);
+    }
+}
+
 template <typename ValueType>
 void VerifyFFT(std::vector<ValueType> input, const std::vector<ValueType>& reference)
 {
@@ -109,11 +187,73 @@ void VerifyFFT()
     VerifyFFT(GetFFTTestData_1024(), GetRealFFT_1024());
 }
 
+template <typename ValueType>
+void TestFFTPlanCache()
+{
+    // Transforming more lengths than the per-thread plan cache holds evicts the first length's plans
+    const size_t N = 32;
+    std::vector<std::complex<ValueType>> complexSignal(N);
+    std::vector<ValueType> signal(N);
+    for (size_t index = 0; index < N; ++index)
+    {
+        complexSignal[index] = { static_cast<ValueType>(index % 5), static_cast<ValueType>(index % 3) };
+        signal[index] = static_cast<ValueType>(index % 7);
+    }
+    auto expectedComplex = complexSignal;
+    auto expectedReal = signal;
+    FFT(expectedComplex);
+    FFT(expectedReal);
+
+    for (size_t length = 2; length <= 4096; length *= 2)
+    {
+        std::vector<std::complex<ValueType>> otherComplexSignal(length, 1.0);
+        std::vector<ValueType> otherSignal(length, 1.0);
+        FFT(otherComplexSignal);
+        FFT(otherSignal);
+    }
+
+    FFT(complexSignal);
+    FFT(signal);
+    testing::ProcessTest("Testing FFT after its cached plan is evicted", complexSignal == expectedComplex);
+    testing::ProcessTest("Testing real-valued FFT after its cached plan is evicted", testing::IsEqual(signal, expectedReal));
+}
+
+template <typename ValueType>
+void TestFFTInvalidLength(size_t N)
+{
+    auto throwsInvalidArgument = [](auto&& function) {
+        try
+        {
+            function();
+        }
+        catch (const utilities::InputException& exception)
+        {
+            return exception.GetErrorCode() == utilities::InputExceptionErrors::invalidArgument;
+        }
+        return false;
+    };
+
+    std::vector<ValueType> signal(N);
+    std::vector<std::complex<ValueType>> complexSignal(N);
+    testing::ProcessTest("Testing real-valued FFT rejects length " + std::to_string(N), throwsInvalidArgument([&signal] { FFT(signal); }));
+    testing::ProcessTest("Testing FFT rejects length " + std::to_string(N), throwsInvalidArgument([&complexSignal] { FFT(complexSignal); }));
+    testing::ProcessTest("Testing RealFFTPlan rejects length " + std::to_string(N), throwsInvalidArgument([N] { dsp::RealFFTPlan<ValueType> plan(N); }));
+}
+
 //
 // Explicit instantiation definitions
 //
 template void TestFFT<float>(size_t);
 template void TestFFT<double>(size_t);
 
+template void TestFFTPlan<float>(size_t);
+template void TestFFTPlan<double>(size_t);
+
 template void VerifyFFT<float>();
 template void VerifyFFT<double>();
+
+template void TestFFTInvalidLength<float>(size_t);
+template void TestFFTInvalidLength<double>(size_t);
+
+template void TestFFTPlanCache<float>();
+template void TestFFTPlanCache<double>();
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FFTTiming.cpp (dsp)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FFTTiming.h"
+
+// dsp
+#include "FFT.h"
+
+// utilities
+#include "MillisecondTimer.h"
+#include "TypeName.h"
+
+// stl
+#include <complex>
+#include <iostream>
+#include <vector>
+
+using namespace ell;
+
+//
+// Timing
+//
+template <typename ValueType>
+void TimeFFT(size_t signalSize, size_t numIterations)
+{
+    std::vector<std::complex<ValueType>> complexSignal(signalSize);
+    std::vector<ValueType> realSignal(signalSize);
+    std::vector<std::complex<ValueType>> spectrum(signalSize / 2 + 1);
+    for (size_t index = 0; index < signalSize; ++index)
+    {
+        realSignal[index] = static_cast<ValueType>(index % 7) - 3;
+    }
+
+    utilities::MillisecondTimer timer;
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        complexSignal.assign(realSignal.begin(), realSignal.end());
+        dsp::FFT(complexSignal);
+    }
+    auto complexDuration = timer.Elapsed();
+
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        auto signal = realSignal;
+        dsp::FFT(signal);
+    }
+    auto realDuration = timer.Elapsed();
+
+    dsp::RealFFTPlan<ValueType> plan(signalSize);
+    timer.Reset();
+    for (size_t iter = 0; iter < numIterations; ++iter)
+    {
+        plan.Forward(realSignal.data(), spectrum.data());
+    }
+    auto planDuration = timer.Elapsed();
+
+    std::cout << "Time to perform " << numIterations << " size-" << signalSize << " FFTs on " << utilities::GetTypeName<ValueType>() << " data: "
+              << "complex " << complexDuration << " ms, real magnitudes " << realDuration << " ms, real-input plan " << planDuration << " ms" << std::endl;
+}
+
+//
+// Explicit instantiation definitions
+//
+template void TimeFFT<float>(size_t, size_t);
+template void TimeFFT<double>(size_t, size_t);
@@ -106,8 +106,20 @@ void DspTest(const std::string& path)
     // FFT
     TestFFT<float>(16);
     TestFFT<double>(16);
+    for (size_t N : { 1, 2, 4, 8, 32, 128, 512 })
+    {
+        TestFFTPlan<float>(N);
+        TestFFTPlan<double>(N);
+    }
     VerifyFFT<float>();
     VerifyFFT<double>();
+    TestFFTPlanCache<float>();
+    TestFFTPlanCache<double>();
+    for (size_t N : { 3, 5, 9, 17, 24 })
+    {
+        TestFFTInvalidLength<float>(N);
+        TestFFTInvalidLength<double>(N);
+    }
 
     // Filters
     TestIIRFilter<float>();
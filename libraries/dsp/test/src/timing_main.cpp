@@ -7,6 +7,8 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "ConvolutionTiming.h"
+#include "DCTTiming.h"
+#include "FFTTiming.h"
 
 // dsp
 #include "Convolution.h"
@@ -58,6 +60,20 @@ int main()
     // Timing
     //
 
+    // FFT timing
+    // void TimeFFT(size_t signalSize, size_t numIterations);
+    TimeFFT<float>(512, 10000);
+    TimeFFT<double>(512, 10000);
+    TimeFFT<float>(4096, 1000);
+    std::cout << "\n";
+
+    // DCT timing
+    // void TimeDCT(size_t numFilters, size_t windowSize, size_t numIterations);
+    TimeDCT<float>(13, 64, 100000);
+    TimeDCT<float>(40, 256, 10000);
+    TimeDCT<float>(13, 512, 10000);
+    std::cout << "\n";
+
     // 1D Convolution timing
     // void TimeConv1D(size_t signalSize, size_t filterSize, size_t numIterations, ell::dsp::ConvolutionMethodOption algorithm);
     TimeConv1D<float>(5000, 3, 1000, ell::dsp::ConvolutionMethodOption::simple);
@@ -25,21 +25,39 @@ namespace emitters
         atlas
     };
 
+    /// <summary> Scheduling policies for the thread pool emitted when `parallelize` and `useThreadPool` are set. </summary>
+    enum class ThreadPoolSchedulingPolicy
+    {
+        block = 0, // workers take tasks one at a time from a single shared queue
+        workStealing // each worker owns a deque of tasks, and steals from the other workers' deques when its own is empty
+    };
+
+    /// <summary> Named optimization profiles, trading compile time against the speed and size of the generated code. </summary>
+    enum class OptimizationProfile
+    {
+        latency = 0, // optimize for speed (like -O3, with loop and SLP vectorization)
+        size, // optimize for code size (like -Os)
+        compileSpeed // only cheap optimizations (like -O1), to minimize compile (and JIT) time
+    };
+
     /// <summary> Standard compiler switches. </summary>
     struct CompilerOptions
     {
         bool unrollLoops = false;
         bool inlineOperators = true;
         bool allowVectorInstructions = false;
-        int vectorWidth = 4;
+        int vectorWidth = 0; // number of elements per vector when emitting explicit vector code (0: derive from targetDevice's SIMD features, per element type)
         bool useBlas = true;
         BlasType blasType = BlasType::unknown;
         bool profile = false;
         bool optimize = true;
+        OptimizationProfile optimizationProfile = OptimizationProfile::latency;
+        bool reportOptimizationPasses = false; // record the time and IR size change of each optimization pass
         bool includeDiagnosticInfo = false;
         bool parallelize = false;
         bool useThreadPool = true;
         int maxThreads = 4;
+        ThreadPoolSchedulingPolicy threadPoolPolicy = ThreadPoolSchedulingPolicy::block;
         bool useFastMath = true;
         bool debug = false;
         utilities::Optional<bool> positionIndependentCode;
@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "CompilerOptions.h"
 #include "ModuleEmitter.h"
 #include "TargetDevice.h"
 
@@ -50,6 +51,9 @@ namespace emitters
         OutputRelocationModel relocModel = OutputRelocationModel::Static;
     };
 
+    /// <summary> Gets the code generation optimization level for the given compiler options (and their optimization profile) </summary>
+    OptimizationLevel GetOptimizationLevel(const CompilerOptions& options);
+
     /// <summary> Indicates if the requested output type is a machine code type (vs. IR) </summary>
     bool IsMachineCodeFormat(ModuleOutputFormat format);
 
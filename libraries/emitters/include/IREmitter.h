@@ -212,6 +212,13 @@ namespace emitters
         /// <returns> Pointer to an llvm::Constant that represents an array of bytes. </returns>
         llvm::Constant* Literal(const std::vector<uint8_t>& value);
 
+        /// <summary> Emit a literal array of Int8. </summary>
+        ///
+        /// <param name="value"> The literal value. </param>
+        ///
+        /// <returns> Pointer to an llvm::Constant that represents an array of Int8. </returns>
+        llvm::Constant* Literal(const std::vector<int8_t>& value);
+
         /// <summary> Emit a literal array of Int32. </summary>
         ///
         /// <param name="value"> The literal value. </param>
@@ -11,8 +11,12 @@
 
 // llvm
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
 
+// stl
+#include <memory>
+
 namespace ell
 {
 namespace emitters
@@ -73,6 +77,19 @@ namespace emitters
         /// <returns> The function address. </returns>
         uint64_t ResolveFunctionAddress(const std::string& name);
 
+        /// <summary>
+        /// Set the cache the execution engine uses to look up object code before generating it, and to store the
+        /// object code it generates. Must be called before any code is jitted.
+        /// </summary>
+        ///
+        /// <param name="objectCache"> The object cache. </param>
+        void SetObjectCache(std::unique_ptr<llvm::ObjectCache> objectCache);
+
+        /// <summary> Set the optimization level used to generate code. Must be called before any code is jitted. </summary>
+        ///
+        /// <param name="level"> The code generation optimization level. </param>
+        void SetOptimizationLevel(llvm::CodeGenOpt::Level level);
+
         /// <summary> Set the address of a named function. </summary>
         ///
         /// <param name="func"> The function being defined. </param>
@@ -101,6 +118,7 @@ namespace emitters
         void PerformFinalization();
 
         std::unique_ptr<llvm::EngineBuilder> _pBuilder;
+        std::unique_ptr<llvm::ObjectCache> _objectCache; // must outlive the engine
         std::unique_ptr<llvm::ExecutionEngine> _pEngine;
     };
 }
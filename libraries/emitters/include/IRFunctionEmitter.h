@@ -1591,6 +1591,9 @@ namespace emitters
         /// <summary> Tags the predict function to be included in the SWIG interface. </summary>
         void IncludeInPredictInterface();
 
+        /// <summary> Tags the batched predict function to be included in the C++ wrapper and SWIG interface. </summary>
+        void IncludeInPredictBatchInterface();
+
         /// <summary> Tags a profiling function to be included in the SWIG interface. </summary>
         void IncludeInSwigInterface();
 
@@ -42,6 +42,9 @@ namespace emitters
     /// <summary> Indicates the Predict function that should be wrapped by SWIG. </summary>
     static const std::string c_predictFunctionTagName = "ell.fn.predict";
 
+    /// <summary> Indicates the batched Predict function, which calls the Predict function on each input of a batch. </summary>
+    static const std::string c_predictBatchFunctionTagName = "ell.fn.predictBatch";
+
     /// <summary> Indicates a function that should be wrapped by SWIG. </summary>
     static const std::string c_swigFunctionTagName = "ell.fn.swig";
 
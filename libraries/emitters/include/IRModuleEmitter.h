@@ -179,6 +179,14 @@ namespace emitters
         /// <summary> Ends the current function. </summary>
         void EndFunction();
 
+        /// <summary> Indicates if a function starts tasks in the module's thread pool, either itself or through the
+        /// functions it calls or starts. Two such functions must not run concurrently. </summary>
+        ///
+        /// <param name="function"> The function to check. Its body must already be emitted. </param>
+        ///
+        /// <returns> True if the function uses the thread pool. </returns>
+        bool UsesThreadPool(LLVMFunction function) const { return _threadPool.IsUsedBy(function); }
+
         /// <summary> Ends the current function with a return value. </summary>
         ///
         /// <param name="return"> The value the function returns. </param>
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// llvm
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+// stl
+#include <memory>
+#include <string>
+
+namespace ell
+{
+namespace emitters
+{
+    /// <summary>
+    /// An on-disk cache for the object code generated by the JIT. The object code for a module is stored in
+    /// the file `<key>.o` in the cache directory, and reloaded from it (instead of being generated again) the
+    /// next time a module with the same key is jitted. The caller is responsible for choosing a key that
+    /// identifies everything the generated code depends on.
+    /// </summary>
+    class IRObjectCache : public llvm::ObjectCache
+    {
+    public:
+        /// <summary> Constructor </summary>
+        ///
+        /// <param name="directory"> The directory to store the cached object files in. It is created if it doesn't exist. </param>
+        /// <param name="key"> The key identifying the module's object code. </param>
+        IRObjectCache(const std::string& directory, const std::string& key);
+
+        /// <summary> Indicates if the cache already holds object code for the key. </summary>
+        ///
+        /// <returns> `true` if the object file for the key exists. </returns>
+        bool HasObject() const;
+
+        /// <summary> Gets the path of the object file for the key. </summary>
+        ///
+        /// <returns> The path of the object file. </returns>
+        std::string GetObjectPath() const { return _objectPath; }
+
+        /// <summary> Called by the JIT after compiling a module. Writes the object code to the cache. </summary>
+        ///
+        /// <param name="module"> The module that was compiled. </param>
+        /// <param name="object"> The module's object code. </param>
+        void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object) override;
+
+        /// <summary> Called by the JIT before compiling a module. Returns the cached object code, if there is any. </summary>
+        ///
+        /// <param name="module"> The module about to be compiled. </param>
+        /// <returns> The cached object code, or `nullptr` if the module must be compiled. </returns>
+        std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+    private:
+        std::string _directory;
+        std::string _objectPath;
+    };
+}
+}
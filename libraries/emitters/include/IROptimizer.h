@@ -12,12 +12,38 @@
 // llvm
 #include <llvm/IR/LegacyPassManager.h>
 
+// stl
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
 namespace ell
 {
 namespace emitters
 {
     class IRModuleEmitter;
 
+    /// <summary> The compile time and IR size cost of one optimization pass. </summary>
+    struct OptimizationPassStatistics
+    {
+        /// <summary> The name of the pass. </summary>
+        std::string passName;
+
+        /// <summary> `true` for a function pass (run on each function separately), `false` for a module pass. </summary>
+        bool isFunctionPass = false;
+
+        /// <summary> The total time spent in the pass, in milliseconds. </summary>
+        double time = 0;
+
+        /// <summary> The number of IR instructions in the code the pass ran on, before it ran. </summary>
+        size_t instructionsBefore = 0;
+
+        /// <summary> The number of IR instructions in the code the pass ran on, after it ran. </summary>
+        size_t instructionsAfter = 0;
+    };
+
     ///<summary> Class to manage LLVM optimizations </summary>
     class IROptimizer
     {
@@ -29,7 +55,11 @@ namespace emitters
 
         ~IROptimizer();
 
-        /// <summary> Add common optimizations to the optimizer pipeline. </summary>
+        /// <summary>
+        /// Add common optimizations to the optimizer pipeline. The passes are chosen by the module's
+        /// `CompilerOptions::optimizationProfile`. If `CompilerOptions::reportOptimizationPasses` is set,
+        /// the time spent in each pass is recorded, without changing the pipeline or the code it produces.
+        /// </summary>
         void AddStandardPasses();
 
         /// <summary> Optimize the given function. </summary>
@@ -40,10 +70,26 @@ namespace emitters
         /// <summary> Optimize the module. </summary>
         void OptimizeModule(llvm::Module* pModule);
 
+        /// <summary> Gets the cost of each pass run so far, in the order the passes were added (function passes first). Empty unless the passes are being reported. </summary>
+        ///
+        /// <returns> The statistics for each pass. </returns>
+        std::vector<OptimizationPassStatistics> GetPassStatistics() const;
+
     private:
+        struct PassTimer;
+
         IRModuleEmitter& _module;
-        llvm::legacy::PassManager _modulePasses;
-        llvm::legacy::FunctionPassManager _functionPasses;
+
+        // If the passes are being reported, there is a timer for each one. The timers must outlive the pass managers.
+        std::vector<std::unique_ptr<PassTimer>> _passTimers;
+        std::unique_ptr<llvm::legacy::PassManager> _modulePasses;
+        std::unique_ptr<llvm::legacy::FunctionPassManager> _functionPasses;
     };
+
+    /// <summary> Writes a table with the cost of each optimization pass. </summary>
+    ///
+    /// <param name="os"> The stream to write to. </param>
+    /// <param name="statistics"> The statistics for each pass, as returned by `IROptimizer::GetPassStatistics`. </param>
+    void WriteOptimizationPassReport(std::ostream& os, const std::vector<OptimizationPassStatistics>& statistics);
 }
 }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "CompilerOptions.h"
 #include "IREmitter.h"
 #include "LLVMUtilities.h"
 
@@ -16,6 +17,7 @@
 
 // stl
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace ell
@@ -29,7 +31,8 @@ namespace emitters
     class IRThreadPoolTaskArray;
 
     //
-    // IRThreadPool: Simple thread pool class that schedules tasks in blocks, and associated classes:
+    // IRThreadPool: Simple thread pool class that schedules tasks in blocks (or, optionally, with per-worker
+    // work-stealing deques), and associated classes:
     //
     // IRThreadPoolTask
     // IRThreadPoolTaskArray
@@ -149,6 +152,17 @@ namespace emitters
         /// <returns> The next task in the queue. </param>
         IRThreadPoolTask PopNextTask(IRFunctionEmitter& function);
 
+        /// <summary>
+        /// Pop a task off a worker's own deque, stealing one from another worker's deque if it is empty, and waiting
+        /// for new tasks to be started if all the deques are empty. Only valid with the work-stealing scheduling policy.
+        /// </summary>
+        ///
+        /// <param name="function"> The function currently being emitted into. </param>
+        /// <param name="workerIndex"> The index of the worker thread asking for a task. </param>
+        ///
+        /// <returns> The next task for the worker, or a null task if the thread pool is shutting down. </param>
+        IRThreadPoolTask PopNextTask(IRFunctionEmitter& function, LLVMValue workerIndex);
+
         /// <summary> Wait for all tasks to finish. </summary>
         ///
         /// <param name="function"> The function currently being emitted into. </param>
@@ -162,7 +176,9 @@ namespace emitters
     private:
         friend class IRThreadPool;
         IRThreadPoolTaskQueue(); // create an empty queue
+        void SetSchedulingPolicy(ThreadPoolSchedulingPolicy policy, int numWorkers); // must be called before Initialize
         void Initialize(IRFunctionEmitter& function); // initializes the task array
+        bool IsWorkStealing() const { return _policy == ThreadPoolSchedulingPolicy::workStealing; }
         LLVMValue GetDataStruct() { return _queueData; }
         LLVMValue DecrementCountField(IRFunctionEmitter& function, LLVMValue fieldPtr);
         llvm::StructType* GetTaskQueueDataType(IRModuleEmitter& module) const;
@@ -187,6 +203,14 @@ namespace emitters
         void UnlockQueueMutex(IRFunctionEmitter& function);
         void ShutDown(IRFunctionEmitter& function);
 
+        // Work-stealing support
+        llvm::StructType* GetWorkerDequeDataType(IRModuleEmitter& module) const;
+        LLVMValue GetWorkerIdPointer(IRFunctionEmitter& function, LLVMValue workerIndex);
+        LLVMValue GetWorkerDequePointer(IRFunctionEmitter& function, LLVMValue workerIndex);
+        void SetWorkerDequeRange(IRFunctionEmitter& function, int workerIndex, int begin, int end);
+        LLVMValue TryPopWorkerTask(IRFunctionEmitter& function, LLVMValue workerIndex, bool steal);
+        void WaitForNewTasks(IRFunctionEmitter& function, LLVMValue workerIndex);
+
         enum class Fields
         {
             queueMutex = 0,
@@ -194,10 +218,25 @@ namespace emitters
             workFinishedCondVar,
             unscheduledCount,
             unfinishedCount,
-            shutdownFlag
+            shutdownFlag,
+            taskGeneration // incremented each time a new set of tasks is started (used by the work-stealing policy)
         };
         LLVMValue _queueData = nullptr; // a struct with the above fields
         IRThreadPoolTaskArray _tasks;
+
+        // Each worker owns a deque holding a range [head, tail) of indices into the task array. The owner pops tasks from
+        // the tail, and other workers steal tasks from the head.
+        enum class WorkerDequeFields
+        {
+            dequeMutex = 0,
+            head,
+            tail,
+            lastSeenGeneration
+        };
+        ThreadPoolSchedulingPolicy _policy = ThreadPoolSchedulingPolicy::block;
+        int _numWorkers = 0;
+        llvm::GlobalVariable* _workerDeques = nullptr; // global array of structs with the above fields
+        llvm::GlobalVariable* _workerIds = nullptr; // global array of worker indices, passed to the worker threads
     };
 
     //
@@ -225,6 +264,14 @@ namespace emitters
         /// <summary> Tell the thread pool to finish and kill the treads. </summary>
         void ShutDown(IRFunctionEmitter& function);
 
+        /// <summary> Indicates if a function starts tasks in the thread pool, either itself or through the functions it
+        /// calls or starts. The pool has a single active task array, so two such functions must not run concurrently. </summary>
+        ///
+        /// <param name="function"> The function to check. Its body must already be emitted. </param>
+        ///
+        /// <returns> True if the function uses the thread pool. </returns>
+        bool IsUsedBy(LLVMFunction function) const;
+
     private:
         void Initialize(); // Allocates threads and adds global initializer and finalizer functions
         bool IsInitialized() const;
@@ -238,6 +285,9 @@ namespace emitters
 
         // task queue
         IRThreadPoolTaskQueue _taskQueue;
+
+        // functions that call AddTasks
+        std::unordered_set<const llvm::Function*> _users;
     };
 }
 }
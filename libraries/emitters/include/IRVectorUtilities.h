@@ -7,13 +7,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "CompilerOptions.h"
 #include "EmitterTypes.h"
 #include "IRFunctionEmitter.h"
+#include "IRLocalScalar.h"
 #include "LLVMUtilities.h"
 
 // utilities
 #include "TypeTraits.h"
 
+// stl
+#include <functional>
+#include <type_traits>
+
 namespace ell
 {
 namespace emitters
@@ -52,6 +58,87 @@ namespace emitters
     /// <returns> The sum of the elements in the given vector </returns>
     template <typename ValueType>
     LLVMValue HorizontalVectorSum(IRFunctionEmitter& function, LLVMValue vectorValue);
+
+    /// <summary> Gets the number of elements per vector to use when emitting explicit vector code </summary>
+    ///
+    /// If `options.vectorWidth` is nonzero, it is used as-is. Otherwise the width is the number of elements
+    /// that fit in one SIMD register of the target device (e.g., 16 floats or 8 doubles with AVX-512), or 1
+    /// for doubles on targets whose SIMD units have no double-precision instructions (e.g., 32-bit ARM NEON).
+    ///
+    /// <param name="options"> The compiler options </param>
+    /// <param name="elementSize"> The size of one vector element, in bytes </param>
+    /// <param name="isFloatingPoint"> Indicates if the vector elements are floating-point values </param>
+    ///
+    /// <returns> The number of elements per vector (at least 1) </returns>
+    int GetVectorWidth(const CompilerOptions& options, size_t elementSize, bool isFloatingPoint);
+
+    /// <summary> Gets the number of elements of type `ValueType` per vector to use when emitting explicit vector code </summary>
+    ///
+    /// <typeparam name="ValueType"> The vector element type </typeparam>
+    /// <param name="options"> The compiler options </param>
+    ///
+    /// <returns> The number of elements per vector (at least 1) </returns>
+    template <typename ValueType>
+    int GetVectorWidth(const CompilerOptions& options);
+
+    /// <summary> Create a vector filled with copies of a (runtime) value </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="value"> The scalar value to place in the vector elements </param>
+    /// <param name="vectorWidth"> The number of vector elements. If 1, `value` is returned unchanged. </param>
+    ///
+    /// <returns> An LLVM vector with repeated entries of the given value </returns>
+    LLVMValue BroadcastVector(IRFunctionEmitter& function, LLVMValue value, int vectorWidth);
+
+    /// <summary> Load consecutive elements of an array into a vector </summary>
+    ///
+    /// Doesn't assume the elements are aligned to the vector size.
+    ///
+    /// <typeparam name="ValueType"> The array element type </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pArray"> Pointer to the array </param>
+    /// <param name="offset"> The index of the first element to load </param>
+    /// <param name="vectorWidth"> The number of elements to load. If 1, a scalar value is returned. </param>
+    ///
+    /// <returns> The loaded vector (or scalar) </returns>
+    template <typename ValueType>
+    LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, int vectorWidth);
+
+    /// <summary> Store a vector into consecutive elements of an array </summary>
+    ///
+    /// Doesn't assume the elements are aligned to the vector size.
+    ///
+    /// <typeparam name="ValueType"> The array element type </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pArray"> Pointer to the array </param>
+    /// <param name="offset"> The index of the first element to store </param>
+    /// <param name="value"> The vector (or scalar) value to store </param>
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, LLVMValue value);
+
+    /// <summary> Type of the body of a vectorized loop. Gets the index of the first element to process and the number of elements to process (1 in the epilogue). </summary>
+    using VectorizedForLoopBodyFunction = std::function<void(IRFunctionEmitter& function, IRLocalScalar index, int vectorWidth)>;
+
+    /// <summary> Emits a loop over consecutive elements that processes `vectorWidth` elements per iteration, followed by an epilogue loop that processes the remaining elements one at a time </summary>
+    ///
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="size"> The number of elements to process </param>
+    /// <param name="vectorWidth"> The number of elements to process per iteration of the main loop </param>
+    /// <param name="body"> The loop body </param>
+    void VectorizedFor(IRFunctionEmitter& function, int size, int vectorWidth, VectorizedForLoopBodyFunction body);
+
+    /// <summary> Emits explicit vector code to compute the sum of the elements of an array </summary>
+    ///
+    /// The vector width is derived from the module's compiler options (see `GetVectorWidth`).
+    ///
+    /// <typeparam name="ValueType"> The array element type </typeparam>
+    /// <param name="function"> The function being emitted </param>
+    /// <param name="pArray"> Pointer to the array </param>
+    /// <param name="size"> The number of elements to sum </param>
+    ///
+    /// <returns> The sum of the elements of the array </returns>
+    template <typename ValueType>
+    LLVMValue VectorizedSum(IRFunctionEmitter& function, LLVMValue pArray, int size);
 }
 }
 
@@ -34,6 +34,25 @@ namespace emitters
         
         /// <summary> Indicates if the target device is a macOS system </summary>
         bool IsMacOS() const;
+
+        /// <summary> Gets the size of the widest SIMD registers on the target device, derived from its `features` string (e.g., "+avx2" or "+neon") </summary>
+        ///
+        /// <returns> The vector register size in bits, or 0 if it can't be determined </returns>
+        size_t GetVectorRegisterSize() const;
+
+        /// <summary> Indicates if the SIMD units of the target device have double-precision floating-point instructions
+        /// (e.g., SSE2 and AArch64 NEON do, 32-bit ARM NEON doesn't) </summary>
+        bool HasDoublePrecisionVectors() const;
     };
+
+    /// <summary> Gets the features of the host CPU, as a comma-separated LLVM feature string (e.g., "+avx2,+fma,-avx512f") </summary>
+    ///
+    /// <returns> The host CPU's feature string, or an empty string if the features can't be determined </returns>
+    std::string GetHostCPUFeatures();
+
+    /// <summary> Gets the name of the host CPU (e.g., "skylake" or "cortex-a53") </summary>
+    ///
+    /// <returns> The host CPU's name, or "generic" if it can't be determined </returns>
+    std::string GetHostCPUName();
 }
 }
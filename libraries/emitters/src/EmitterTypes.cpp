@@ -189,6 +189,12 @@ namespace emitters
         return VariableType::BytePointer;
     }
 
+    template <>
+    VariableType GetVariableType<int8_t>()
+    {
+        return VariableType::Char8;
+    }
+
     template <>
     VariableType GetVariableType<uint8_t>()
     {
@@ -86,6 +86,24 @@ namespace emitters
     //
     // Exported functions
     //
+    OptimizationLevel GetOptimizationLevel(const CompilerOptions& options)
+    {
+        if (!options.optimize)
+        {
+            return OptimizationLevel::Default;
+        }
+
+        switch (options.optimizationProfile)
+        {
+        case OptimizationProfile::size:
+            return OptimizationLevel::Default;
+        case OptimizationProfile::compileSpeed:
+            return OptimizationLevel::Less;
+        default:
+            return OptimizationLevel::Aggressive;
+        }
+    }
+
     bool IsMachineCodeFormat(ModuleOutputFormat format)
     {
         return (ModuleOutputFormat::assembly == format || ModuleOutputFormat::objectCode == format);
@@ -221,6 +221,11 @@ namespace emitters
         return llvm::ConstantDataArray::get(_llvmContext, value);
     }
 
+    llvm::Constant* IREmitter::Literal(const std::vector<int8_t>& value)
+    {
+        return llvm::ConstantDataArray::get(_llvmContext, llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+    }
+
     llvm::Constant* IREmitter::Literal(const std::vector<float>& value)
     {
         return llvm::ConstantDataArray::get(_llvmContext, value);
@@ -233,12 +238,12 @@ namespace emitters
 
     llvm::Constant* IREmitter::Literal(const std::vector<int>& value)
     {
-        return llvm::ConstantDataArray::get(_llvmContext, reinterpret_cast<const std::vector<uint32_t>&>(value));
+        return llvm::ConstantDataArray::get(_llvmContext, llvm::ArrayRef<uint32_t>(reinterpret_cast<const uint32_t*>(value.data()), value.size()));
     }
 
     llvm::Constant* IREmitter::Literal(const std::vector<int64_t>& value)
     {
-        return llvm::ConstantDataArray::get(_llvmContext, reinterpret_cast<const std::vector<uint64_t>&>(value));
+        return llvm::ConstantDataArray::get(_llvmContext, llvm::ArrayRef<uint64_t>(reinterpret_cast<const uint64_t*>(value.data()), value.size()));
     }
 
     LLVMValue IREmitter::Literal(const std::string& name, const std::string& value)
@@ -8,13 +8,17 @@
 
 #include "IRExecutionEngine.h"
 #include "IRModuleEmitter.h"
+#include "TargetDevice.h"
 
 // llvm
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 
 // stl
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace ell
 {
@@ -39,6 +43,16 @@ namespace emitters
         _pBuilder = std::make_unique<llvm::EngineBuilder>(std::move(pModule));
         _pBuilder->setEngineKind(llvm::EngineKind::JIT).setVerifyModules(verify).setUseOrcMCJITReplacement(false);
 
+        // Jitted code always runs on the host, so let the code generator use all of the host CPU's vector units
+        std::vector<std::string> hostFeatures;
+        std::stringstream features(GetHostCPUFeatures());
+        std::string feature;
+        while (std::getline(features, feature, ','))
+        {
+            hostFeatures.push_back(feature);
+        }
+        _pBuilder->setMCPU(llvm::sys::getHostCPUName()).setMAttrs(hostFeatures);
+
         static bool installed = false;
         if (!installed)
         {
@@ -95,6 +109,24 @@ namespace emitters
         return functionAddress;
     }
 
+    void IRExecutionEngine::SetObjectCache(std::unique_ptr<llvm::ObjectCache> objectCache)
+    {
+        if (_pEngine)
+        {
+            throw EmitterException(EmitterError::unexpected, "The object cache must be set before the execution engine is created");
+        }
+        _objectCache = std::move(objectCache);
+    }
+
+    void IRExecutionEngine::SetOptimizationLevel(llvm::CodeGenOpt::Level level)
+    {
+        if (_pEngine)
+        {
+            throw EmitterException(EmitterError::unexpected, "The optimization level must be set before the execution engine is created");
+        }
+        _pBuilder->setOptLevel(level);
+    }
+
     void IRExecutionEngine::DefineFunction(LLVMFunction func, uintptr_t address)
     {
         EnsureEngine();
@@ -129,6 +161,10 @@ namespace emitters
         {
             auto pEngine = _pBuilder->create();
             _pEngine.reset(pEngine);
+            if (_objectCache)
+            {
+                _pEngine->setObjectCache(_objectCache.get());
+            }
             PerformInitialization();
         }
     }
@@ -1680,6 +1680,12 @@ namespace emitters
         InsertMetadata(c_predictFunctionTagName);
     }
 
+    void IRFunctionEmitter::IncludeInPredictBatchInterface()
+    {
+        _pFunction->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
+        InsertMetadata(c_predictBatchFunctionTagName);
+    }
+
     void IRFunctionEmitter::IncludeInSwigInterface()
     {
         _pFunction->setLinkage(llvm::GlobalValue::LinkageTypes::ExternalLinkage);
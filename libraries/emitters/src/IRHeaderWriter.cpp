@@ -547,6 +547,67 @@ namespace emitters
 
     }
 
+    void WritePredictBatchMethod(LLVMFunction predictBatchFunction, CppWrapperInfo& info)
+    {
+        // The batch function takes (context, count, inputs..., outputs...), where each buffer holds `count` samples.
+        // The first output is returned by value, the other outputs are resized and passed as arguments.
+        std::string batchFunctionName = predictBatchFunction->getName();
+        std::string returnType = "void";
+        std::string returnVariable;
+        std::vector<std::string> methodArgs = { "int count" };
+        std::vector<std::string> callArgs;
+        std::stringstream body;
+        int outputCount = 0;
+        for (auto arg = predictBatchFunction->arg_begin(), end = predictBatchFunction->arg_end(); arg != end; ++arg)
+        {
+            std::string argName = arg->getName();
+            if (argName == "context")
+            {
+                callArgs.push_back("this");
+            }
+            else if (argName == "count")
+            {
+                callArgs.push_back("count");
+            }
+            else
+            {
+                std::stringstream ss;
+                WriteLLVMType(ss, arg->getType()->getPointerElementType());
+                std::string argType = SwiggifyType(ss.str());
+                if (argName.find("output") != std::string::npos)
+                {
+                    if (outputCount == 0)
+                    {
+                        returnType = "std::vector<" + argType + ">";
+                        returnVariable = argName;
+                        body << "        std::vector<" << argType << "> " << argName << "(count * GetOutputSize(" << outputCount << "));\n";
+                    }
+                    else
+                    {
+                        methodArgs.push_back("std::vector<" + argType + ">& " + argName);
+                        body << "        " << argName << ".resize(count * GetOutputSize(" << outputCount << "));\n";
+                    }
+                    ++outputCount;
+                }
+                else
+                {
+                    methodArgs.push_back("std::vector<" + argType + ">& " + argName);
+                }
+                callArgs.push_back(argName + ".data()");
+            }
+        }
+
+        info.helperMethods << "    " << returnType << " " << info.predictMethodName << "Batch(" << utilities::Join(methodArgs, ", ") << ")\n";
+        info.helperMethods << "    {\n";
+        info.helperMethods << body.str();
+        info.helperMethods << "        " << batchFunctionName << "(" << utilities::Join(callArgs, ", ") << ");\n";
+        if (!returnVariable.empty())
+        {
+            info.helperMethods << "        return " << returnVariable << ";\n";
+        }
+        info.helperMethods << "    }\n\n";
+    }
+
     void WriteModuleCppWrapper(std::ostream& os, IRModuleEmitter& moduleEmitter)
     {
         auto callbacks = GetFunctionsWithTag(moduleEmitter, c_callbackFunctionTagName);
@@ -594,6 +655,12 @@ namespace emitters
 
         WritePredictMethod(moduleCallbacks, info);
 
+        auto predictBatchFunctions = GetFunctionsWithTag(moduleEmitter, c_predictBatchFunctionTagName);
+        if (!hasSourceNodes && !predictBatchFunctions.empty())
+        {
+            WritePredictBatchMethod(predictBatchFunctions[0].function, info);
+        }
+
         // now write out the final completed code.
 
         // (Note: newlines are part of the syntax for #include)
@@ -125,6 +125,10 @@ namespace emitters
                 parameters.targetDevice.triple = hostTriple.normalize();
                 parameters.targetDevice.architecture = llvm::Triple::getArchTypeName(hostTriple.getArch());
                 parameters.targetDevice.cpu = llvm::sys::getHostCPUName();
+                if (parameters.targetDevice.features.empty())
+                {
+                    parameters.targetDevice.features = GetHostCPUFeatures();
+                }
 
                 std::string error;
                 const llvm::Target* target = llvm::TargetRegistry::lookupTarget(parameters.targetDevice.triple, error);
@@ -774,10 +778,7 @@ namespace emitters
         MachineCodeOutputOptions options;
         auto compilerOptions = GetCompilerOptions();
         options.targetDevice = compilerOptions.targetDevice;
-        if (compilerOptions.optimize)
-        {
-            options.optimizationLevel = OptimizationLevel::Aggressive;
-        }
+        options.optimizationLevel = GetOptimizationLevel(compilerOptions);
 
         options.verifyModule = true;
         options.floatFusionMode = compilerOptions.useFastMath ? FloatFusionMode::Fast : FloatFusionMode::Standard;
@@ -847,10 +848,7 @@ namespace emitters
         MachineCodeOutputOptions options;
         auto compilerOptions = GetCompilerOptions();
         options.targetDevice = compilerOptions.targetDevice;
-        if (compilerOptions.optimize)
-        {
-            options.optimizationLevel = OptimizationLevel::Aggressive;
-        }
+        options.optimizationLevel = GetOptimizationLevel(compilerOptions);
         // Other params to possibly set:
         //   bool verboseOutput = false;
         //   bool verifyModule = false;
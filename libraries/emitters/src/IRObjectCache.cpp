@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRObjectCache.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRObjectCache.h"
+
+// utilities
+#include "Logger.h"
+
+// llvm
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace ell
+{
+namespace emitters
+{
+    using namespace logging;
+
+    IRObjectCache::IRObjectCache(const std::string& directory, const std::string& key)
+        : _directory(directory)
+    {
+        llvm::SmallString<256> path(directory);
+        llvm::sys::path::append(path, key + ".o");
+        _objectPath = path.str().str();
+    }
+
+    bool IRObjectCache::HasObject() const
+    {
+        return llvm::sys::fs::exists(_objectPath);
+    }
+
+    void IRObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef object)
+    {
+        // A failure to write the cache only costs a recompile next time, so errors are logged and ignored
+        if (auto error = llvm::sys::fs::create_directories(_directory))
+        {
+            Log() << "Couldn't create JIT cache directory " << _directory << ": " << error.message() << EOL;
+            return;
+        }
+
+        // Write to a temporary file and rename it, so that other processes sharing the cache never see a partial file
+        int fd = -1;
+        llvm::SmallString<256> tempPath;
+        if (auto error = llvm::sys::fs::createUniqueFile(_objectPath + "-%%%%%%.tmp", fd, tempPath))
+        {
+            Log() << "Couldn't create JIT cache file for " << _objectPath << ": " << error.message() << EOL;
+            return;
+        }
+
+        {
+            llvm::raw_fd_ostream stream(fd, true);
+            stream.write(object.getBufferStart(), object.getBufferSize());
+        }
+
+        if (auto error = llvm::sys::fs::rename(tempPath, _objectPath))
+        {
+            Log() << "Couldn't write JIT cache file " << _objectPath << ": " << error.message() << EOL;
+            llvm::sys::fs::remove(tempPath);
+            return;
+        }
+        Log() << "Wrote JIT object code to " << _objectPath << EOL;
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> IRObjectCache::getObject(const llvm::Module* module)
+    {
+        auto buffer = llvm::MemoryBuffer::getFile(_objectPath);
+        if (!buffer)
+        {
+            return nullptr;
+        }
+
+        Log() << "Loaded JIT object code from " << _objectPath << EOL;
+        return std::move(*buffer);
+    }
+}
+}
@@ -11,6 +11,9 @@
 #include "LLVMInclude.h"
 
 // llvm
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/Analysis/CallGraphSCCPass.h>
+#include <llvm/Analysis/LoopPass.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
@@ -18,6 +21,8 @@
 #include <llvm/Transforms/Scalar/GVN.h>
 
 // stl
+#include <chrono>
+#include <iomanip>
 #include <memory>
 
 namespace ell
@@ -26,47 +31,310 @@ namespace emitters
 {
     using namespace llvm;
 
+    // The cost of one reported pass, recorded by the timer passes that run just before and just after it
+    struct IROptimizer::PassTimer
+    {
+        OptimizationPassStatistics statistics;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    namespace
+    {
+        size_t CountInstructions(const llvm::Function& function)
+        {
+            size_t count = 0;
+            for (const auto& block : function)
+            {
+                count += block.size();
+            }
+            return count;
+        }
+
+        size_t CountInstructions(const llvm::Module& module)
+        {
+            size_t count = 0;
+            for (const auto& function : module)
+            {
+                count += CountInstructions(function);
+            }
+            return count;
+        }
+
+        size_t CountInstructions(llvm::CallGraphSCC& scc)
+        {
+            size_t count = 0;
+            for (auto node : scc)
+            {
+                if (auto function = node->getFunction())
+                {
+                    count += CountInstructions(*function);
+                }
+            }
+            return count;
+        }
+
+        size_t CountInstructions(const llvm::Loop& loop)
+        {
+            size_t count = 0;
+            for (auto block : loop.blocks())
+            {
+                count += block->size();
+            }
+            return count;
+        }
+
+        template <typename TimerType>
+        void StartOrStopTimer(TimerType& timer, bool isStart, size_t instructionCount)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (isStart)
+            {
+                timer.statistics.instructionsBefore += instructionCount;
+                timer.start = now;
+            }
+            else
+            {
+                timer.statistics.time += std::chrono::duration<double, std::milli>(now - timer.start).count();
+                timer.statistics.instructionsAfter += instructionCount;
+            }
+        }
+
+        //
+        // Passes that start or stop the timer of the pass after or before them. Each is the same kind of pass as the pass it
+        // times, so the pass manager groups it with that pass and the real passes are nested and interleaved the same way as
+        // without the timers. They don't change the IR, and preserve all analyses.
+        //
+        template <typename TimerType>
+        class ModuleTimerPass : public llvm::ModulePass
+        {
+        public:
+            static char ID;
+            ModuleTimerPass(TimerType& timer, bool isStart)
+                : llvm::ModulePass(ID), _timer(timer), _isStart(isStart) {}
+            void getAnalysisUsage(llvm::AnalysisUsage& usage) const override { usage.setPreservesAll(); }
+            bool runOnModule(llvm::Module& module) override
+            {
+                StartOrStopTimer(_timer, _isStart, CountInstructions(module));
+                return false;
+            }
+
+        private:
+            TimerType& _timer;
+            bool _isStart;
+        };
+
+        template <typename TimerType>
+        class FunctionTimerPass : public llvm::FunctionPass
+        {
+        public:
+            static char ID;
+            FunctionTimerPass(TimerType& timer, bool isStart)
+                : llvm::FunctionPass(ID), _timer(timer), _isStart(isStart) {}
+            void getAnalysisUsage(llvm::AnalysisUsage& usage) const override { usage.setPreservesAll(); }
+            bool runOnFunction(llvm::Function& function) override
+            {
+                StartOrStopTimer(_timer, _isStart, CountInstructions(function));
+                return false;
+            }
+
+        private:
+            TimerType& _timer;
+            bool _isStart;
+        };
+
+        template <typename TimerType>
+        class CallGraphSCCTimerPass : public llvm::CallGraphSCCPass
+        {
+        public:
+            static char ID;
+            CallGraphSCCTimerPass(TimerType& timer, bool isStart)
+                : llvm::CallGraphSCCPass(ID), _timer(timer), _isStart(isStart) {}
+            void getAnalysisUsage(llvm::AnalysisUsage& usage) const override
+            {
+                llvm::CallGraphSCCPass::getAnalysisUsage(usage);
+                usage.setPreservesAll();
+            }
+            bool runOnSCC(llvm::CallGraphSCC& scc) override
+            {
+                StartOrStopTimer(_timer, _isStart, CountInstructions(scc));
+                return false;
+            }
+
+        private:
+            TimerType& _timer;
+            bool _isStart;
+        };
+
+        template <typename TimerType>
+        class LoopTimerPass : public llvm::LoopPass
+        {
+        public:
+            static char ID;
+            LoopTimerPass(TimerType& timer, bool isStart)
+                : llvm::LoopPass(ID), _timer(timer), _isStart(isStart) {}
+            void getAnalysisUsage(llvm::AnalysisUsage& usage) const override { usage.setPreservesAll(); }
+            bool runOnLoop(llvm::Loop* loop, llvm::LPPassManager&) override
+            {
+                StartOrStopTimer(_timer, _isStart, CountInstructions(*loop));
+                return false;
+            }
+
+        private:
+            TimerType& _timer;
+            bool _isStart;
+        };
+
+        template <typename TimerType>
+        char ModuleTimerPass<TimerType>::ID = 0;
+        template <typename TimerType>
+        char FunctionTimerPass<TimerType>::ID = 0;
+        template <typename TimerType>
+        char CallGraphSCCTimerPass<TimerType>::ID = 0;
+        template <typename TimerType>
+        char LoopTimerPass<TimerType>::ID = 0;
+
+        // A pass manager that adds each pass between a pair of timer passes
+        template <typename PassManagerType, typename TimerType>
+        class TimingPassManager : public PassManagerType
+        {
+        public:
+            template <typename... Args>
+            TimingPassManager(std::vector<std::unique_ptr<TimerType>>& timers, Args&&... args)
+                : PassManagerType(std::forward<Args>(args)...), _timers(timers) {}
+
+            void add(llvm::Pass* pass) override
+            {
+                auto kind = pass->getPassKind();
+                if (pass->getAsImmutablePass() != nullptr || (kind != llvm::PT_Module && kind != llvm::PT_Function && kind != llvm::PT_CallGraphSCC && kind != llvm::PT_Loop))
+                {
+                    // Immutable passes (such as the alias analyses) claim to be module passes, even in a function pass manager, but
+                    // never run. The standard pipelines have no other kinds of pass.
+                    PassManagerType::add(pass);
+                    return;
+                }
+
+                _timers.push_back(std::make_unique<TimerType>());
+                auto& timer = *_timers.back();
+                timer.statistics.passName = pass->getPassName().str();
+                timer.statistics.isFunctionPass = kind == llvm::PT_Function || kind == llvm::PT_Loop;
+                PassManagerType::add(CreateTimerPass(kind, timer, true));
+                PassManagerType::add(pass);
+                PassManagerType::add(CreateTimerPass(kind, timer, false));
+            }
+
+        private:
+            static llvm::Pass* CreateTimerPass(llvm::PassKind kind, TimerType& timer, bool isStart)
+            {
+                switch (kind)
+                {
+                case llvm::PT_Module:
+                    return new ModuleTimerPass<TimerType>(timer, isStart);
+                case llvm::PT_CallGraphSCC:
+                    return new CallGraphSCCTimerPass<TimerType>(timer, isStart);
+                case llvm::PT_Loop:
+                    return new LoopTimerPass<TimerType>(timer, isStart);
+                default:
+                    return new FunctionTimerPass<TimerType>(timer, isStart);
+                }
+            }
+
+            std::vector<std::unique_ptr<TimerType>>& _timers;
+        };
+    }
+
     IROptimizer::IROptimizer(IRModuleEmitter& module)
-        : _module(module), _functionPasses(module.GetLLVMModule())
+        : _module(module), _modulePasses(std::make_unique<llvm::legacy::PassManager>()), _functionPasses(std::make_unique<llvm::legacy::FunctionPassManager>(module.GetLLVMModule()))
     {
     }
 
     IROptimizer::~IROptimizer()
     {
-        (void)_functionPasses.doFinalization();
+        (void)_functionPasses->doFinalization();
     }
 
     void IROptimizer::AddStandardPasses()
     {
-        _functionPasses.add(llvm::createVerifierPass());
+        const auto& compilerOptions = _module.GetCompilerOptions();
 
-        auto targetMachine = _module.GetTargetMachine();
         llvm::PassManagerBuilder builder;
-        builder.OptLevel = 3;
-        builder.SizeLevel = 0;
+        switch (compilerOptions.optimizationProfile)
+        {
+        case OptimizationProfile::latency:
+            builder.OptLevel = 3;
+            builder.SizeLevel = 0;
+            builder.LoopVectorize = true;
+            builder.SLPVectorize = true;
+            break;
+        case OptimizationProfile::size:
+            builder.OptLevel = 2;
+            builder.SizeLevel = 1;
+            builder.LoopVectorize = false;
+            builder.SLPVectorize = false;
+            break;
+        case OptimizationProfile::compileSpeed:
+            builder.OptLevel = 1;
+            builder.SizeLevel = 0;
+            builder.LoopVectorize = false;
+            builder.SLPVectorize = false;
+            break;
+        default:
+            throw EmitterException(EmitterError::notSupported, "Unknown optimization profile");
+        }
         builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, builder.SizeLevel, false);
-        builder.LoopVectorize = true;
-        builder.SLPVectorize = true;
-        builder.populateFunctionPassManager(_functionPasses);
-        builder.populateModulePassManager(_modulePasses);
-
-        (void)_functionPasses.doInitialization();
 
+        auto targetMachine = _module.GetTargetMachine();
         if (targetMachine)
         {
             targetMachine->adjustPassManager(builder);
         }
+
+        if (compilerOptions.reportOptimizationPasses)
+        {
+            // The same pipeline, with each pass between a pair of timer passes
+            _modulePasses = std::make_unique<TimingPassManager<llvm::legacy::PassManager, PassTimer>>(_passTimers);
+            _functionPasses = std::make_unique<TimingPassManager<llvm::legacy::FunctionPassManager, PassTimer>>(_passTimers, _module.GetLLVMModule());
+        }
+
+        _functionPasses->add(llvm::createVerifierPass());
+        builder.populateFunctionPassManager(*_functionPasses);
+        builder.populateModulePassManager(*_modulePasses);
+        (void)_functionPasses->doInitialization();
     }
 
     void IROptimizer::OptimizeFunction(LLVMFunction pFunction)
     {
         assert(pFunction != nullptr);
-        _functionPasses.run(*pFunction);
+        _functionPasses->run(*pFunction);
     }
 
     void IROptimizer::OptimizeModule(llvm::Module* pModule)
     {
-        _modulePasses.run(*pModule);
+        _modulePasses->run(*pModule);
+    }
+
+    std::vector<OptimizationPassStatistics> IROptimizer::GetPassStatistics() const
+    {
+        std::vector<OptimizationPassStatistics> result;
+        for (const auto& timer : _passTimers)
+        {
+            result.push_back(timer->statistics);
+        }
+        return result;
+    }
+
+    void WriteOptimizationPassReport(std::ostream& os, const std::vector<OptimizationPassStatistics>& statistics)
+    {
+        double totalTime = 0;
+        os << std::left << std::setw(48) << "Pass" << std::setw(10) << "Kind" << std::right << std::setw(12) << "Time (ms)"
+           << std::setw(14) << "Instr before" << std::setw(14) << "Instr after" << "\n";
+        for (const auto& pass : statistics)
+        {
+            os << std::left << std::setw(48) << pass.passName << std::setw(10) << (pass.isFunctionPass ? "function" : "module")
+               << std::right << std::setw(12) << std::fixed << std::setprecision(3) << pass.time
+               << std::setw(14) << pass.instructionsBefore << std::setw(14) << pass.instructionsAfter << "\n";
+            totalTime += pass.time;
+        }
+        os << std::left << std::setw(58) << "Total" << std::right << std::setw(12) << std::fixed << std::setprecision(3) << totalTime << "\n";
     }
 }
 }
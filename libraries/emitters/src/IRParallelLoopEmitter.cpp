@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "IRParallelLoopEmitter.h"
+#include "CompilerOptions.h"
 #include "IRAsyncTask.h"
 #include "IRFunctionEmitter.h"
 #include "IRModuleEmitter.h"
@@ -18,6 +19,22 @@ namespace ell
 {
 namespace emitters
 {
+    namespace
+    {
+        // With the work-stealing thread pool, loops are split into more tasks than there are threads, so that
+        // workers that finish their share early have something left to steal.
+        const int c_tasksPerThreadForWorkStealing = 4;
+
+        int GetDefaultNumTasks(const CompilerOptions& compilerSettings)
+        {
+            if (compilerSettings.useThreadPool && compilerSettings.threadPoolPolicy == ThreadPoolSchedulingPolicy::workStealing)
+            {
+                return compilerSettings.maxThreads * c_tasksPerThreadForWorkStealing;
+            }
+            return compilerSettings.maxThreads;
+        }
+    }
+
     IRParallelForLoopEmitter::IRParallelForLoopEmitter(IRFunctionEmitter& functionEmitter)
         : _functionEmitter(functionEmitter) {}
 
@@ -31,7 +48,7 @@ namespace emitters
         ParallelLoopOptions newOptions = options;
         if (newOptions.numTasks == 0)
         {
-            newOptions.numTasks = std::min(numIterations, compilerSettings.maxThreads);
+            newOptions.numTasks = std::min(numIterations, GetDefaultNumTasks(compilerSettings));
         }
         EmitLoop(_functionEmitter.LocalScalar<int32_t>(begin), _functionEmitter.LocalScalar<int32_t>(end), _functionEmitter.LocalScalar<int32_t>(increment), newOptions, capturedValues, body);
     }
@@ -39,12 +56,13 @@ namespace emitters
     void IRParallelForLoopEmitter::EmitLoop(IRLocalScalar begin, IRLocalScalar end, IRLocalScalar increment, const ParallelLoopOptions& options, const std::vector<LLVMValue>& capturedValues, BodyFunction body)
     {
         auto& compilerSettings = _functionEmitter.GetModule().GetCompilerOptions();
-        const int numTasks = options.numTasks == 0 ? compilerSettings.maxThreads : options.numTasks;
+        const int numTasks = options.numTasks == 0 ? GetDefaultNumTasks(compilerSettings) : options.numTasks;
         auto span = end - begin;
         auto numIterations = (span - 1) / increment + 1;
         // TODO: explicitly check for empty loop?
 
-        auto taskSize = Max(1, numIterations / numTasks);
+        // Round the task size up, so the last task doesn't drop the leftover iterations
+        auto taskSize = Max(1, (numIterations + (numTasks - 1)) / numTasks);
         if (compilerSettings.parallelize && numTasks > 1)
         {
             auto taskFunction = GetTaskFunction(capturedValues, body);
@@ -10,10 +10,15 @@
 #include "IRFunctionEmitter.h"
 #include "IRMetadata.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
 
 // utilities
 #include "Unused.h"
 
+// stl
+#include <algorithm>
+#include <vector>
+
 namespace ell
 {
 namespace emitters
@@ -64,58 +69,303 @@ namespace emitters
             return function.GetFunction();
         }
 
+        //
+        // Blocked GEMM, after Goto and van de Geijn, "Anatomy of High-Performance Matrix Multiplication":
+        // for each NC-wide block of columns of C and each KC-deep slice of the inner dimension, a KC x NC block of B is
+        // packed into NR-wide panels, then for each MC-tall block of rows, an MC x KC block of A is packed into MR-tall
+        // panels. A microkernel multiplies one panel of each into an MR x NR tile of C that lives in vector registers.
+        // The packed panels are read with unit stride regardless of the layout and transposition of the inputs, and are
+        // sized to stay in the caches: an A panel and a B panel in L1, a block of A in L2, and a block of B in L3.
+        //
+        const int c_gemmL1CacheBytes = 32 * 1024;
+        const int c_gemmL2CacheBytes = 256 * 1024;
+        const int c_gemmL3CacheBytes = 2 * 1024 * 1024;
+        const int c_gemmMaxDepth = 512;
+
+        // CBLAS enum values
+        const int c_cblasColMajor = 102;
+        const int c_cblasTrans = 112;
+
+        struct GEMMBlocking
+        {
+            int vectorWidth; // number of elements per vector
+            int numTileVectors; // number of vectors in each row of the microkernel's tile of C
+            int tileRows; // MR
+            int tileColumns; // NR
+            int blockDepth; // KC
+            int blockRows; // MC
+            int blockColumns; // NC
+        };
+
+        template <typename ValueType>
+        GEMMBlocking GetGEMMBlocking(const CompilerOptions& options)
+        {
+            GEMMBlocking blocking;
+            blocking.vectorWidth = GetVectorWidth<ValueType>(options);
+
+            // The microkernel keeps tileRows * numTileVectors accumulators, plus numTileVectors values of B and a
+            // broadcast value of A, in registers: 15 of the 16 vector registers of SSE/AVX, or 16 scalar registers
+            // if there are no vectors.
+            blocking.numTileVectors = blocking.vectorWidth > 1 ? 2 : 4;
+            blocking.tileRows = blocking.vectorWidth > 1 ? 6 : 4;
+            blocking.tileColumns = blocking.numTileVectors * blocking.vectorWidth;
+
+            const int elementSize = static_cast<int>(sizeof(ValueType));
+            auto roundDown = [](int value, int multiple) { return std::max(multiple, (value / multiple) * multiple); };
+            blocking.blockDepth = roundDown(std::min(c_gemmMaxDepth, c_gemmL1CacheBytes / 2 / (blocking.tileColumns * elementSize)), 8);
+            blocking.blockRows = roundDown(c_gemmL2CacheBytes / 2 / (blocking.blockDepth * elementSize), blocking.tileRows);
+            blocking.blockColumns = roundDown(c_gemmL3CacheBytes / 2 / (blocking.blockDepth * elementSize), blocking.tileColumns);
+            return blocking;
+        }
+
+        // The values a row block of the GEMM needs, in the order they're passed to the parallel loop's task function
+        struct GEMMRowBlockArguments
+        {
+            LLVMValue m;
+            LLVMValue A;
+            LLVMValue aRowStride;
+            LLVMValue aColumnStride;
+            LLVMValue alpha;
+            LLVMValue packedB;
+            LLVMValue C;
+            LLVMValue ldc;
+            LLVMValue blockColumn; // jc
+            LLVMValue blockColumns; // nc
+            LLVMValue blockDepthStart; // pc
+            LLVMValue blockDepth; // kc
+
+            std::vector<LLVMValue> ToList() const
+            {
+                return { m, A, aRowStride, aColumnStride, alpha, packedB, C, ldc, blockColumn, blockColumns, blockDepthStart, blockDepth };
+            }
+
+            static GEMMRowBlockArguments FromList(const std::vector<LLVMValue>& values)
+            {
+                return { values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7], values[8], values[9], values[10], values[11] };
+            }
+        };
+
+        // Packs the kc x nc block of B starting at (pc, jc) into panels of NR columns. Entry (p, j) of the panel starting
+        // at column jr is at `packedB[jr * kc + p * NR + (j - jr)]`. Columns past the end of the block are zero.
+        template <typename ValueType>
+        void EmitPackB(IRFunctionEmitter& function, const GEMMBlocking& blocking, IRLocalArray B, IRLocalScalar bRowStride, IRLocalScalar bColumnStride, IRLocalArray packedB, IRLocalScalar blockDepthStart, IRLocalScalar blockColumn, IRLocalScalar blockDepth, IRLocalScalar blockColumns)
+        {
+            const int tileColumns = blocking.tileColumns;
+            function.For(function.LocalScalar(0), blockColumns, function.LocalScalar(tileColumns), [=](IRFunctionEmitter& function, IRLocalScalar jr) {
+                function.For(blockDepth, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    auto rowOffset = (blockDepthStart + p) * bRowStride;
+                    for (int jj = 0; jj < tileColumns; ++jj)
+                    {
+                        auto isInBlock = function.LocalScalar(jr + jj < blockColumns);
+                        auto offset = function.LocalScalar(function.Select(isInBlock, rowOffset + (blockColumn + jr + jj) * bColumnStride, function.Literal<int>(0)));
+                        packedB[(jr * blockDepth) + (p * tileColumns) + jj] = function.Select(isInBlock, function.ValueAt(B, offset), function.Literal<ValueType>(0));
+                    }
+                });
+            });
+        }
+
+        // Packs alpha times the mc x kc block of A starting at (ic, pc) into panels of MR rows. Entry (i, p) of the panel
+        // starting at row ir is at `packedA[ir * kc + p * MR + (i - ir)]`. Rows past the end of the block are zero.
+        template <typename ValueType>
+        void EmitPackA(IRFunctionEmitter& function, const GEMMBlocking& blocking, IRLocalArray A, IRLocalScalar aRowStride, IRLocalScalar aColumnStride, IRLocalScalar alpha, IRLocalArray packedA, IRLocalScalar blockRow, IRLocalScalar blockDepthStart, IRLocalScalar blockRows, IRLocalScalar blockDepth)
+        {
+            const int tileRows = blocking.tileRows;
+            function.For(function.LocalScalar(0), blockRows, function.LocalScalar(tileRows), [=](IRFunctionEmitter& function, IRLocalScalar ir) {
+                function.For(blockDepth, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                    auto columnOffset = (blockDepthStart + p) * aColumnStride;
+                    for (int ii = 0; ii < tileRows; ++ii)
+                    {
+                        auto isInBlock = function.LocalScalar(ir + ii < blockRows);
+                        auto offset = function.LocalScalar(function.Select(isInBlock, (blockRow + ir + ii) * aRowStride + columnOffset, function.Literal<int>(0)));
+                        packedA[(ir * blockDepth) + (p * tileRows) + ii] = function.Select(isInBlock, function.ValueAt(A, offset) * alpha, function.Literal<ValueType>(0));
+                    }
+                });
+            });
+        }
+
+        // Adds the product of an MR-row panel of packed A and an NR-column panel of packed B to the mr x nr tile of C at `pC`
+        template <typename ValueType>
+        void EmitGEMMMicrokernel(IRFunctionEmitter& function, const GEMMBlocking& blocking, LLVMValue pPackedA, LLVMValue pPackedB, IRLocalScalar blockDepth, LLVMValue pC, IRLocalScalar ldc, IRLocalScalar tileRows, IRLocalScalar tileColumns)
+        {
+            const int vectorWidth = blocking.vectorWidth;
+            const int numTileVectors = blocking.numTileVectors;
+            const int maxTileRows = blocking.tileRows;
+            const int maxTileColumns = blocking.tileColumns;
+            const auto add = GetAddForValueType<ValueType>();
+            const auto multiply = GetMultiplyForValueType<ValueType>();
+
+            auto& emitter = function.GetEmitter();
+            auto elementType = emitter.Type(GetVariableType<ValueType>());
+            auto vectorType = vectorWidth > 1 ? emitter.VectorType(GetVariableType<ValueType>(), vectorWidth) : elementType;
+            auto zero = vectorWidth > 1 ? FillVector<ValueType>(function, llvm::cast<llvm::VectorType>(vectorType), 0) : function.Literal<ValueType>(0);
+
+            // Separate scalar variables, so the optimizer can keep them in registers
+            std::vector<LLVMValue> accumulators;
+            for (int index = 0; index < maxTileRows * numTileVectors; ++index)
+            {
+                accumulators.push_back(function.Variable(vectorType, "accum"));
+                function.Store(accumulators.back(), zero);
+            }
+
+            function.For(blockDepth, [=](IRFunctionEmitter& function, IRLocalScalar p) {
+                std::vector<LLVMValue> bValues;
+                for (int v = 0; v < numTileVectors; ++v)
+                {
+                    bValues.push_back(LoadVector<ValueType>(function, pPackedB, p * maxTileColumns + v * vectorWidth, vectorWidth));
+                }
+
+                for (int ii = 0; ii < maxTileRows; ++ii)
+                {
+                    auto aValue = BroadcastVector(function, function.ValueAt(pPackedA, p * maxTileRows + ii), vectorWidth);
+                    for (int v = 0; v < numTileVectors; ++v)
+                    {
+                        function.OperationAndUpdate(accumulators[ii * numTileVectors + v], add, function.Operator(multiply, aValue, bValues[v]));
+                    }
+                }
+            });
+
+            // Add the tile into C, going through a temporary buffer at the edges of C
+            auto isFullTile = function.LocalScalar((tileRows == maxTileRows) && (tileColumns == maxTileColumns));
+            function.If(isFullTile, [=](IRFunctionEmitter& function) {
+                for (int ii = 0; ii < maxTileRows; ++ii)
+                {
+                    for (int v = 0; v < numTileVectors; ++v)
+                    {
+                        auto offset = ldc * ii + (v * vectorWidth);
+                        auto sum = function.Operator(add, LoadVector<ValueType>(function, pC, offset, vectorWidth), function.Load(accumulators[ii * numTileVectors + v]));
+                        StoreVector<ValueType>(function, pC, offset, sum);
+                    }
+                }
+            })
+                .Else([=](IRFunctionEmitter& function) {
+                    LLVMValue tile = function.Variable(elementType, maxTileRows * maxTileColumns);
+                    for (int ii = 0; ii < maxTileRows; ++ii)
+                    {
+                        for (int v = 0; v < numTileVectors; ++v)
+                        {
+                            StoreVector<ValueType>(function, tile, function.Literal<int>(ii * maxTileColumns + v * vectorWidth), function.Load(accumulators[ii * numTileVectors + v]));
+                        }
+                    }
+
+                    auto C = function.LocalArray(pC);
+                    auto tileValues = function.LocalArray(tile);
+                    function.For(tileRows, [=](IRFunctionEmitter& function, IRLocalScalar ii) {
+                        function.For(tileColumns, [=](IRFunctionEmitter& function, IRLocalScalar jj) {
+                            auto offset = ii * ldc + jj;
+                            C[offset] = C[offset] + tileValues[ii * maxTileColumns + jj];
+                        });
+                    });
+                });
+        }
+
+        // Multiplies the mc x kc block of A starting at row `rowBlock * MC` by the packed block of B, and adds the result to C
+        template <typename ValueType>
+        void EmitGEMMRowBlock(IRFunctionEmitter& function, const GEMMBlocking& blocking, IRLocalScalar rowBlock, const GEMMRowBlockArguments& arguments)
+        {
+            auto m = function.LocalScalar(arguments.m);
+            auto ldc = function.LocalScalar(arguments.ldc);
+            auto blockColumn = function.LocalScalar(arguments.blockColumn);
+            auto blockColumns = function.LocalScalar(arguments.blockColumns);
+            auto blockDepth = function.LocalScalar(arguments.blockDepth);
+            auto packedB = arguments.packedB;
+
+            auto blockRow = rowBlock * blocking.blockRows;
+            auto blockRows = Min(m - blockRow, blocking.blockRows);
+
+            auto packedA = function.Malloc(GetPointerType(GetVariableType<ValueType>()), static_cast<int64_t>(blocking.blockRows) * blocking.blockDepth * sizeof(ValueType));
+            EmitPackA<ValueType>(function, blocking, function.LocalArray(arguments.A), function.LocalScalar(arguments.aRowStride), function.LocalScalar(arguments.aColumnStride), function.LocalScalar(arguments.alpha), function.LocalArray(packedA), blockRow, function.LocalScalar(arguments.blockDepthStart), blockRows, blockDepth);
+
+            auto C = arguments.C;
+            function.For(function.LocalScalar(0), blockColumns, function.LocalScalar(blocking.tileColumns), [=](IRFunctionEmitter& function, IRLocalScalar jr) {
+                auto tileColumns = Min(blockColumns - jr, blocking.tileColumns);
+                function.For(function.LocalScalar(0), blockRows, function.LocalScalar(blocking.tileRows), [=](IRFunctionEmitter& function, IRLocalScalar ir) {
+                    auto tileRows = Min(blockRows - ir, blocking.tileRows);
+                    auto pC = function.PointerOffset(C, (blockRow + ir) * ldc + blockColumn + jr);
+                    EmitGEMMMicrokernel<ValueType>(function, blocking, function.PointerOffset(packedA, ir * blockDepth), function.PointerOffset(packedB, jr * blockDepth), blockDepth, pC, ldc, tileRows, tileColumns);
+                });
+            });
+
+            function.Free(packedA);
+        }
+
         template <typename ValueType>
         LLVMFunction EmitGEMMFunction(IRModuleEmitter& module, const std::string& functionName, const VariableTypeList& argTypes)
         {
-            const auto CblasNoTrans = 111;
-            const auto CblasTrans = 112;
+            const auto blocking = GetGEMMBlocking<ValueType>(module.GetCompilerOptions());
 
             auto function = module.BeginFunction(functionName, VariableType::Int32, argTypes);
             auto arguments = function.Arguments().begin();
-            auto order = &(*arguments++);
-            auto transposeA = function.LocalScalar(&(*arguments++)) == CblasTrans;
-            auto transposeB = function.LocalScalar(&(*arguments++)) == CblasTrans;
+            auto isColumnMajor = function.LocalScalar(&(*arguments++)) == c_cblasColMajor;
+            auto transposeA = function.LocalScalar(&(*arguments++)) == c_cblasTrans;
+            auto transposeB = function.LocalScalar(&(*arguments++)) == c_cblasTrans;
             auto m = function.LocalScalar(&(*arguments++));
             auto n = function.LocalScalar(&(*arguments++));
             auto k = function.LocalScalar(&(*arguments++));
             auto alpha = function.LocalScalar(&(*arguments++));
-            auto A = function.LocalArray(&(*arguments++));
+            auto A = function.LocalScalar(&(*arguments++));
             auto lda = function.LocalScalar(&(*arguments++));
-            auto B = function.LocalArray(&(*arguments++));
+            auto B = function.LocalScalar(&(*arguments++));
             auto ldb = function.LocalScalar(&(*arguments++));
             auto beta = function.LocalScalar(&(*arguments++));
             auto C = function.LocalArray(&(*arguments++));
             auto ldc = function.LocalScalar(&(*arguments++));
-            UNUSED(CblasNoTrans, order, alpha, beta);
-
-            // C = A x B, A: mxk, B: kxn, C: mxn
-            // A': kxm, B': nxk
-
-            // Loop orders:
-            // A*B:   i, k, j
-            // A'*B:  k, i, j
-            // A*B':  i, j, k
-            // A'*B': k, j, i (?)
-
-            // Clear output
-            auto count = ldc * m;
-            function.MemorySet<ValueType>(C, function.Literal<int>(0), function.Literal<uint8_t>(0), count);
-
-            // Accumulate partial values into output
-            function.For(m, [A, B, C, lda, ldb, ldc, transposeA, transposeB, n, k](IRFunctionEmitter& function, auto i) {
-                function.For(k, [i, A, B, C, lda, ldb, ldc, transposeA, transposeB, n](IRFunctionEmitter& function, auto k) {
-                    function.For(n, [i, k, A, B, C, lda, ldb, ldc, transposeA, transposeB](IRFunctionEmitter& function, auto j) {
-                        auto aOffset = function.LocalScalar(function.Select(transposeA, (k * lda) + i, (i * lda) + k));
-                        auto bOffset = function.LocalScalar(function.Select(transposeB, (j * ldb) + k, (k * ldb) + j));
-                        auto cOffset = (i * ldc) + j;
-
-                        // accumulate product in C[i, j]
-                        C[cOffset] = C[cOffset] + (A[aOffset] * B[bOffset]);
+
+            // In column-major order, compute the row-major product C' = B' * A'
+            auto select = [&function](IRLocalScalar condition, LLVMValue trueValue, LLVMValue falseValue) {
+                return function.LocalScalar(function.Select(condition, trueValue, falseValue));
+            };
+            auto rows = select(isColumnMajor, n, m);
+            auto columns = select(isColumnMajor, m, n);
+            auto left = select(isColumnMajor, B, A);
+            auto right = select(isColumnMajor, A, B);
+            auto leftStride = select(isColumnMajor, ldb, lda);
+            auto rightStride = select(isColumnMajor, lda, ldb);
+            auto transposeLeft = select(isColumnMajor, transposeB, transposeA);
+            auto transposeRight = select(isColumnMajor, transposeA, transposeB);
+
+            // Strides between consecutive rows and columns of the (possibly transposed) inputs
+            auto one = function.Literal<int>(1);
+            auto aRowStride = select(transposeLeft, one, leftStride);
+            auto aColumnStride = select(transposeLeft, leftStride, one);
+            auto bRowStride = select(transposeRight, one, rightStride);
+            auto bColumnStride = select(transposeRight, rightStride, one);
+
+            // C = beta * C (C isn't read if beta is zero)
+            function.If(beta != function.Literal<ValueType>(1), [=](IRFunctionEmitter& function) {
+                function.For(rows, [=](IRFunctionEmitter& function, IRLocalScalar i) {
+                    function.For(columns, [=](IRFunctionEmitter& function, IRLocalScalar j) {
+                        auto offset = i * ldc + j;
+                        C[offset] = function.Select(beta == function.Literal<ValueType>(0), function.Literal<ValueType>(0), beta * C[offset]);
                     });
                 });
             });
-            function.Return(function.Literal<int>(0));
 
+            // C += alpha * A * B
+            auto packedB = function.Malloc(GetPointerType(GetVariableType<ValueType>()), static_cast<int64_t>(blocking.blockDepth) * blocking.blockColumns * sizeof(ValueType));
+            function.For(function.LocalScalar(0), columns, function.LocalScalar(blocking.blockColumns), [=](IRFunctionEmitter& function, IRLocalScalar blockColumn) {
+                auto blockColumns = Min(columns - blockColumn, blocking.blockColumns);
+                function.For(function.LocalScalar(0), k, function.LocalScalar(blocking.blockDepth), [=](IRFunctionEmitter& function, IRLocalScalar blockDepthStart) {
+                    auto blockDepth = Min(k - blockDepthStart, blocking.blockDepth);
+                    EmitPackB<ValueType>(function, blocking, function.LocalArray(right), bRowStride, bColumnStride, function.LocalArray(packedB), blockDepthStart, blockColumn, blockDepth, blockColumns);
+
+                    // Row blocks are independent, so they can run in parallel. A single row block runs inline, without
+                    // the cost of starting a task.
+                    GEMMRowBlockArguments rowBlockArguments = { rows, left, aRowStride, aColumnStride, alpha, packedB, C, ldc, blockColumn, blockColumns, blockDepthStart, blockDepth };
+                    auto numRowBlocks = (rows + (blocking.blockRows - 1)) / blocking.blockRows;
+                    function.If(numRowBlocks > 1, [=](IRFunctionEmitter& function) {
+                        function.ParallelFor(numRowBlocks, rowBlockArguments.ToList(), [blocking](IRFunctionEmitter& function, IRLocalScalar rowBlock, std::vector<LLVMValue> capturedValues) {
+                            EmitGEMMRowBlock<ValueType>(function, blocking, rowBlock, GEMMRowBlockArguments::FromList(capturedValues));
+                        });
+                    }).Else([=](IRFunctionEmitter& function) {
+                        function.For(numRowBlocks, [=](IRFunctionEmitter& function, IRLocalScalar rowBlock) {
+                            EmitGEMMRowBlock<ValueType>(function, blocking, rowBlock, rowBlockArguments);
+                        });
+                    });
+                });
+            });
+            function.Free(packedB);
+
+            function.Return(function.Literal<int>(0));
             module.EndFunction();
             return function.GetFunction();
         }
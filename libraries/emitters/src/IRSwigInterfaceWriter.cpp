@@ -65,7 +65,20 @@ namespace emitters
                 ReplaceDelimiter(predictPythonCode, "PREDICT_METHOD", predictMethodName);
                 ReplaceDelimiter(predictPythonCode, "INPUT_VECTOR_TYPE", inputVectorType);
                 ReplaceDelimiter(predictPythonCode, "RESET_FUNCTION", resetFunctionName);
-                
+
+                if (_hasPredictBatchFunction)
+                {
+                    // clang-format off
+                    std::string predictBatchPythonCode(
+                        #include "SwigPredictBatchPython.in"
+                    );
+                    // clang-format on
+
+                    ReplaceDelimiter(predictBatchPythonCode, "WRAPPER_CLASS", className);
+                    ReplaceDelimiter(predictBatchPythonCode, "PREDICT_BATCH_METHOD", predictMethodName + "Batch");
+                    ReplaceDelimiter(predictBatchPythonCode, "INPUT_VECTOR_TYPE", inputVectorType);
+                    predictPythonCode += predictBatchPythonCode;
+                }
 
                 os << "%pythoncode %{\n"
                    << predictPythonCode
@@ -80,6 +93,7 @@ namespace emitters
                 ModuleCallbackDefinitions moduleCallbacks(callbacks);
 
                 _functionName = _function->getName();
+                _hasPredictBatchFunction = moduleCallbacks.sources.empty() && !GetFunctionsWithTag(moduleEmitter, c_predictBatchFunctionTagName).empty();
 
                 if (moduleCallbacks.sources.empty())
                 {
@@ -120,6 +134,7 @@ namespace emitters
             std::string _functionName;
             std::string _inputType;
             bool _inputIsScalar; 
+            bool _hasPredictBatchFunction = false;
             LLVMFunction _function;
         };
 
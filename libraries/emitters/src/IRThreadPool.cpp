@@ -19,6 +19,7 @@
 #include "Unused.h"
 
 // stl
+#include <unordered_set>
 #include <vector>
 
 namespace ell
@@ -37,6 +38,7 @@ namespace emitters
     void IRThreadPool::Initialize()
     {
         _maxThreads = _module.GetCompilerOptions().maxThreads;
+        _taskQueue.SetSchedulingPolicy(_module.GetCompilerOptions().threadPoolPolicy, static_cast<int>(_maxThreads));
         auto pthreadType = _module.GetRuntime().GetPosixEmitter().GetPthreadType();
 
         // Create global array to hold pthread objects
@@ -67,7 +69,10 @@ namespace emitters
                 llvm::ConstantPointerNull* nullAttr = initThreadPoolFunction.NullPointer(int8PtrType);
                 initThreadPoolFunction.For(_maxThreads, [this, int8PtrType, nullAttr, workerThreadFunction](auto& initThreadPoolFunction, LLVMValue index) {
                     auto threadPtr = initThreadPoolFunction.PointerOffset(_threads, index);
-                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(_taskQueue.GetDataStruct(), int8PtrType));
+
+                    // With the work-stealing policy, each worker thread is passed its index so it can find its own deque
+                    auto threadArg = _taskQueue.IsWorkStealing() ? _taskQueue.GetWorkerIdPointer(initThreadPoolFunction, index) : _taskQueue.GetDataStruct();
+                    initThreadPoolFunction.PthreadCreate(threadPtr, nullAttr, workerThreadFunction, initThreadPoolFunction.CastPointer(threadArg, int8PtrType));
                 });
             });
         }
@@ -97,9 +102,46 @@ namespace emitters
             Initialize();
         }
 
+        _users.insert(function.GetFunction());
         return _taskQueue.StartTasks(function, taskFunction, arguments);
     }
 
+    bool IRThreadPool::IsUsedBy(LLVMFunction function) const
+    {
+        // Follow every function the code refers to, which includes the task functions passed to pthread_create
+        std::unordered_set<const llvm::Function*> visited;
+        std::vector<const llvm::Function*> functionsToVisit = { function };
+        while (!functionsToVisit.empty())
+        {
+            auto current = functionsToVisit.back();
+            functionsToVisit.pop_back();
+            if (!visited.insert(current).second)
+            {
+                continue;
+            }
+
+            if (_users.count(current) != 0)
+            {
+                return true;
+            }
+
+            for (const auto& block : *current)
+            {
+                for (const auto& instruction : block)
+                {
+                    for (const auto& operand : instruction.operands())
+                    {
+                        if (auto referencedFunction = llvm::dyn_cast<llvm::Function>(operand->stripPointerCasts()))
+                        {
+                            functionsToVisit.push_back(referencedFunction);
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
     void IRThreadPool::ShutDown(IRFunctionEmitter& function)
     {
         auto& context = function.GetLLVMContext();
@@ -124,10 +166,18 @@ namespace emitters
 
         auto workerThreadFunction = _module.BeginFunction("WorkerThreadFunction", int8PtrType, { int8PtrType });
         {
+            LLVMValue workerIndex = nullptr;
+            if (_taskQueue.IsWorkStealing())
+            {
+                auto int32PtrType = llvm::Type::getInt32PtrTy(context);
+                auto workerIdPtr = &(*workerThreadFunction.Arguments().begin());
+                workerIndex = workerThreadFunction.Load(workerThreadFunction.CastPointer(workerIdPtr, int32PtrType));
+            }
+
             auto notDoneVar = workerThreadFunction.Variable(boolType, "notDone");
             workerThreadFunction.Store(notDoneVar, workerThreadFunction.TrueBit());
-            workerThreadFunction.While(notDoneVar, [this, notDoneVar](IRFunctionEmitter& workerThreadFunction) {
-                auto task = _taskQueue.PopNextTask(workerThreadFunction);
+            workerThreadFunction.While(notDoneVar, [this, notDoneVar, workerIndex](IRFunctionEmitter& workerThreadFunction) {
+                auto task = workerIndex == nullptr ? _taskQueue.PopNextTask(workerThreadFunction) : _taskQueue.PopNextTask(workerThreadFunction, workerIndex);
                 // check for a poison "null" task, indicating we should break out of the loop and terminate the thread
                 workerThreadFunction.If(
                         workerThreadFunction.Operator(TypedOperator::logicalOr, task.IsNull(workerThreadFunction), _taskQueue.GetShutdownFlag(workerThreadFunction)),
@@ -170,6 +220,16 @@ namespace emitters
         // Note: we can't initialize ourselves here, for ordering reasons.
     }
 
+    void IRThreadPoolTaskQueue::SetSchedulingPolicy(ThreadPoolSchedulingPolicy policy, int numWorkers)
+    {
+        if (IsInitialized())
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "Error: setting the scheduling policy of a thread pool task queue after it has been initialized");
+        }
+        _policy = policy;
+        _numWorkers = numWorkers;
+    }
+
     void IRThreadPoolTaskQueue::Initialize(IRFunctionEmitter& function)
     {
         if (_queueData != nullptr)
@@ -193,6 +253,7 @@ namespace emitters
         auto count = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unscheduledCount));
         auto unfinishedCount = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::unfinishedCount));
         auto shutdownFlag = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::shutdownFlag));
+        auto taskGeneration = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskGeneration));
 
         // Initialize the fields
         llvm::ConstantPointerNull* nullAttr = function.NullPointer(int8PtrType);
@@ -203,6 +264,25 @@ namespace emitters
         function.Store(count, function.Literal<int>(0));
         function.Store(unfinishedCount, function.Literal<int>(0));
         function.Store(shutdownFlag, function.FalseBit());
+        function.Store(taskGeneration, function.Literal<int>(0));
+
+        if (IsWorkStealing())
+        {
+            auto int32Type = llvm::Type::getInt32Ty(context);
+            _workerIds = module.GlobalArray("workerIds", int32Type, _numWorkers);
+            _workerDeques = module.GlobalArray("workerDeques", GetWorkerDequeDataType(module), _numWorkers);
+            for (int workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+            {
+                auto index = function.Literal<int>(workerIndex);
+                function.Store(GetWorkerIdPointer(function, index), index);
+
+                auto deque = GetWorkerDequePointer(function, index);
+                errCode = function.PthreadMutexInit(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::dequeMutex)), nullAttr);
+                function.Store(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::head)), function.Literal<int>(0));
+                function.Store(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::tail)), function.Literal<int>(0));
+                function.Store(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::lastSeenGeneration)), function.Literal<int>(0));
+            }
+        }
 
         _tasks.Initialize(function);
     }
@@ -218,6 +298,20 @@ namespace emitters
         LockQueueMutex(function);
         _tasks.SetTasks(function, taskFunction, arguments);
         SetInitialCount(function, function.Literal<int>(numTasks));
+        if (IsWorkStealing())
+        {
+            // Deal the tasks out to the workers in contiguous ranges, and bump the generation count so idle workers
+            // know there is new work to look for.
+            for (int workerIndex = 0; workerIndex < _numWorkers; ++workerIndex)
+            {
+                auto begin = static_cast<int>((workerIndex * numTasks) / _numWorkers);
+                auto end = static_cast<int>(((workerIndex + 1) * numTasks) / _numWorkers);
+                SetWorkerDequeRange(function, workerIndex, begin, end);
+            }
+
+            auto generationPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskGeneration));
+            function.Store(generationPtr, function.Operator(TypedOperator::add, function.Load(generationPtr), function.Literal<int>(1)));
+        }
         function.PthreadCondBroadcast(GetWorkAvailableConditionVariablePointer(function));
         UnlockQueueMutex(function);
         return GetTaskArray();
@@ -258,6 +352,121 @@ namespace emitters
         return _tasks.GetTask(function, newCount);
     }
 
+    IRThreadPoolTask IRThreadPoolTaskQueue::PopNextTask(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(IsInitialized());
+        assert(IsWorkStealing());
+
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        auto taskIndexVar = function.Variable(int32Type, "taskIndex");
+        auto searchingVar = function.Variable(boolType, "searching");
+        auto victimOffsetVar = function.Variable(int32Type, "victimOffset");
+        auto keepStealingVar = function.Variable(boolType, "keepStealing");
+        auto numWorkers = function.Literal<int>(_numWorkers);
+
+        function.Store(taskIndexVar, function.Literal<int>(-1));
+        function.Store(searchingVar, function.TrueBit());
+        function.While(searchingVar, [=](IRFunctionEmitter& function) {
+            // First look in our own deque
+            function.Store(taskIndexVar, this->TryPopWorkerTask(function, workerIndex, false));
+
+            // If it's empty, try to steal a task from the other workers, starting with our neighbor
+            function.Store(victimOffsetVar, function.Literal<int>(1));
+            function.Store(keepStealingVar, function.LogicalAnd(function.Comparison(TypedComparison::lessThan, function.Literal<int>(1), numWorkers), function.Comparison(TypedComparison::lessThan, function.Load(taskIndexVar), function.Literal<int>(0))));
+            function.While(keepStealingVar, [=](IRFunctionEmitter& function) {
+                auto victimOffset = function.Load(victimOffsetVar);
+                auto victimIndex = function.Operator(TypedOperator::moduloSigned, function.Operator(TypedOperator::add, workerIndex, victimOffset), numWorkers);
+                function.Store(taskIndexVar, this->TryPopWorkerTask(function, victimIndex, true));
+
+                auto nextVictimOffset = function.Operator(TypedOperator::add, victimOffset, function.Literal<int>(1));
+                function.Store(victimOffsetVar, nextVictimOffset);
+                function.Store(keepStealingVar, function.LogicalAnd(function.Comparison(TypedComparison::lessThan, nextVictimOffset, numWorkers), function.Comparison(TypedComparison::lessThan, function.Load(taskIndexVar), function.Literal<int>(0))));
+            });
+
+            auto foundTask = function.Comparison(TypedComparison::greaterThanOrEquals, function.Load(taskIndexVar), function.Literal<int>(0));
+            function.If(foundTask, [searchingVar](IRFunctionEmitter& function) {
+                function.Store(searchingVar, function.FalseBit());
+            }).Else([=](IRFunctionEmitter& function) {
+                // All the deques are empty: sleep until new tasks are started, or we're shut down
+                this->WaitForNewTasks(function, workerIndex);
+                function.If(this->GetShutdownFlag(function), [searchingVar](IRFunctionEmitter& function) {
+                    function.Store(searchingVar, function.FalseBit());
+                });
+            });
+        });
+
+        // Get task from task array --- a negative index (which is what we get when shutting down) returns a null task
+        return _tasks.GetTask(function, function.Load(taskIndexVar));
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::TryPopWorkerTask(IRFunctionEmitter& function, LLVMValue workerIndex, bool steal)
+    {
+        auto& context = function.GetLLVMContext();
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        auto deque = GetWorkerDequePointer(function, workerIndex);
+        auto mutex = function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::dequeMutex));
+        auto headPtr = function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::head));
+        auto tailPtr = function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::tail));
+
+        auto resultVar = function.Variable(int32Type, "poppedTaskIndex");
+        function.Store(resultVar, function.Literal<int>(-1));
+
+        auto errCode = function.PthreadMutexLock(mutex);
+        auto head = function.Load(headPtr);
+        auto tail = function.Load(tailPtr);
+        function.If(function.Comparison(TypedComparison::lessThan, head, tail), [=](IRFunctionEmitter& function) {
+            if (steal)
+            {
+                // Thieves take the oldest task, from the head of the deque
+                function.Store(resultVar, head);
+                function.Store(headPtr, function.Operator(TypedOperator::add, head, function.Literal<int>(1)));
+            }
+            else
+            {
+                // The owner takes the newest task, from the tail of the deque
+                auto newTail = function.Operator(TypedOperator::subtract, tail, function.Literal<int>(1));
+                function.Store(resultVar, newTail);
+                function.Store(tailPtr, newTail);
+            }
+        });
+        errCode = function.PthreadMutexUnlock(mutex);
+        UNUSED(errCode);
+
+        return function.Load(resultVar);
+    }
+
+    void IRThreadPoolTaskQueue::WaitForNewTasks(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        auto& context = function.GetLLVMContext();
+        auto boolType = llvm::Type::getInt1Ty(context);
+
+        auto deque = GetWorkerDequePointer(function, workerIndex);
+        auto lastSeenGenerationPtr = function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::lastSeenGeneration));
+        auto generationPtr = function.GetStructFieldPointer(_queueData, static_cast<int>(Fields::taskGeneration));
+        auto queueMutex = GetQueueMutexPointer(function);
+        auto workAvailableCondVar = GetWorkAvailableConditionVariablePointer(function);
+
+        // Tasks are dealt out to the deques before the generation count is incremented (with the queue mutex held),
+        // so if the generation hasn't changed since we last looked, there is no new work and we can safely sleep.
+        auto isIdleVar = function.Variable(boolType, "isIdle");
+        LockQueueMutex(function);
+        auto isIdle = [=](IRFunctionEmitter& function) {
+            auto noNewTasks = function.Comparison(TypedComparison::equals, function.Load(generationPtr), function.Load(lastSeenGenerationPtr));
+            return function.LogicalAnd(noNewTasks, function.LogicalNot(this->GetShutdownFlag(function)));
+        };
+        function.Store(isIdleVar, isIdle(function));
+        function.While(isIdleVar, [=](IRFunctionEmitter& function) {
+            function.PthreadCondWait(workAvailableCondVar, queueMutex);
+            function.Store(isIdleVar, isIdle(function));
+        });
+        function.Store(lastSeenGenerationPtr, function.Load(generationPtr));
+        UnlockQueueMutex(function);
+    }
+
     bool IRThreadPoolTaskQueue::IsInitialized() const
     {
         return _queueData != nullptr;
@@ -311,10 +520,43 @@ namespace emitters
         auto boolType = llvm::Type::getInt1Ty(context);
         auto int32Type = llvm::Type::getInt32Ty(context);
 
-        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, boolType };
+        std::vector<LLVMType> fieldTypes = { mutexType, conditionVarType, conditionVarType, int32Type, int32Type, boolType, int32Type };
         return module.GetAnonymousStructType(fieldTypes);
     }
 
+    llvm::StructType* IRThreadPoolTaskQueue::GetWorkerDequeDataType(IRModuleEmitter& module) const
+    {
+        auto& context = module.GetLLVMContext();
+        auto mutexType = module.GetRuntime().GetPosixEmitter().GetPthreadMutexType();
+        auto int32Type = llvm::Type::getInt32Ty(context);
+
+        std::vector<LLVMType> fieldTypes = { mutexType, int32Type, int32Type, int32Type };
+        return module.GetAnonymousStructType(fieldTypes);
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::GetWorkerIdPointer(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(_workerIds != nullptr);
+        return function.PointerOffset(_workerIds, workerIndex);
+    }
+
+    LLVMValue IRThreadPoolTaskQueue::GetWorkerDequePointer(IRFunctionEmitter& function, LLVMValue workerIndex)
+    {
+        assert(_workerDeques != nullptr);
+        return function.PointerOffset(_workerDeques, workerIndex);
+    }
+
+    void IRThreadPoolTaskQueue::SetWorkerDequeRange(IRFunctionEmitter& function, int workerIndex, int begin, int end)
+    {
+        auto deque = GetWorkerDequePointer(function, function.Literal<int>(workerIndex));
+        auto mutex = function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::dequeMutex));
+        auto errCode = function.PthreadMutexLock(mutex);
+        function.Store(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::head)), function.Literal<int>(begin));
+        function.Store(function.GetStructFieldPointer(deque, static_cast<int>(WorkerDequeFields::tail)), function.Literal<int>(end));
+        errCode = function.PthreadMutexUnlock(mutex);
+        UNUSED(errCode);
+    }
+
     LLVMValue IRThreadPoolTaskQueue::GetQueueMutexPointer(IRFunctionEmitter& function)
     {
         assert(IsInitialized());
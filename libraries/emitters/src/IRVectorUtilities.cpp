@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     IRVectorUtilities.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "IRVectorUtilities.h"
+
+// stl
+#include <algorithm>
+
+namespace ell
+{
+namespace emitters
+{
+    namespace
+    {
+        // Used when the target's vector register size is unknown
+        const int c_defaultVectorWidth = 4;
+    }
+
+    int GetVectorWidth(const CompilerOptions& options, size_t elementSize, bool isFloatingPoint)
+    {
+        if (options.vectorWidth > 0)
+        {
+            return options.vectorWidth;
+        }
+
+        // Vectors of doubles would just be split into scalar operations
+        if (isFloatingPoint && elementSize == sizeof(double) && !options.targetDevice.HasDoublePrecisionVectors())
+        {
+            return 1;
+        }
+
+        auto registerBytes = options.targetDevice.GetVectorRegisterSize() / 8;
+        if (registerBytes == 0)
+        {
+            return c_defaultVectorWidth;
+        }
+        return std::max(1, static_cast<int>(registerBytes / elementSize));
+    }
+
+    LLVMValue BroadcastVector(IRFunctionEmitter& function, LLVMValue value, int vectorWidth)
+    {
+        if (vectorWidth == 1)
+        {
+            return value;
+        }
+        return function.GetEmitter().GetIRBuilder().CreateVectorSplat(vectorWidth, value);
+    }
+
+    void VectorizedFor(IRFunctionEmitter& function, int size, int vectorWidth, VectorizedForLoopBodyFunction body)
+    {
+        const int numBlocks = vectorWidth > 1 ? size / vectorWidth : 0;
+        if (numBlocks > 0)
+        {
+            function.For(numBlocks, [vectorWidth, body](IRFunctionEmitter& function, IRLocalScalar blockIndex) {
+                body(function, blockIndex * vectorWidth, vectorWidth);
+            });
+        }
+
+        // epilogue
+        const int epilogueStart = numBlocks * vectorWidth;
+        if (epilogueStart < size)
+        {
+            function.For(epilogueStart, size, [body](IRFunctionEmitter& function, IRLocalScalar index) {
+                body(function, index, 1);
+            });
+        }
+    }
+}
+}
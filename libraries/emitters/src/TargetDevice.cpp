@@ -9,9 +9,16 @@
 #include "TargetDevice.h"
 
 // llvm
+#include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/Support/Host.h>
 
+// stl
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
 namespace ell
 {
 namespace emitters
@@ -23,6 +30,59 @@ namespace emitters
             auto normalizedTriple = llvm::Triple::normalize(tripleString.empty() ? llvm::sys::getDefaultTargetTriple() : tripleString);
             return llvm::Triple(normalizedTriple);
         }
+
+        // Parses a comma-separated LLVM feature string (e.g., "+avx2,+fma,-avx512f") into a map from feature name to enabled state
+        std::unordered_map<std::string, bool> ParseFeatures(const std::string& features)
+        {
+            std::unordered_map<std::string, bool> result;
+            std::stringstream stream(features);
+            std::string feature;
+            while (std::getline(stream, feature, ','))
+            {
+                if (feature.size() > 1 && (feature[0] == '+' || feature[0] == '-'))
+                {
+                    result[feature.substr(1)] = feature[0] == '+';
+                }
+            }
+            return result;
+        }
+
+        struct SIMDFeature
+        {
+            const char* name;
+            size_t registerSize; // in bits
+            bool hasDoublePrecision; // false if the unit has no double-precision floating-point vector instructions
+        };
+
+        // Returns the widest SIMD feature enabled in an LLVM feature string, or nullptr if none is
+        const SIMDFeature* GetWidestSIMDFeature(const std::string& features)
+        {
+            // Widest first
+            static const SIMDFeature simdFeatures[] = {
+                { "avx512f", 512, true },
+                { "avx2", 256, true },
+                { "avx", 256, true },
+                { "neon", 128, true },
+                { "sse4.2", 128, true },
+                { "sse4.1", 128, true },
+                { "ssse3", 128, true },
+                { "sse3", 128, true },
+                { "sse2", 128, true },
+                { "sse", 128, false },
+                { "altivec", 128, false },
+            };
+
+            auto enabledFeatures = ParseFeatures(features);
+            for (const auto& simdFeature : simdFeatures)
+            {
+                auto it = enabledFeatures.find(simdFeature.name);
+                if (it != enabledFeatures.end() && it->second)
+                {
+                    return &simdFeature;
+                }
+            }
+            return nullptr;
+        }
     }
 
     bool TargetDevice::IsWindows() const
@@ -42,5 +102,66 @@ namespace emitters
         auto tripleObj = GetNormalizedTriple(triple);
         return tripleObj.getOS() == llvm::Triple::MacOSX || tripleObj.getOS() == llvm::Triple::Darwin;
     }
+
+    size_t TargetDevice::GetVectorRegisterSize() const
+    {
+        auto simdFeature = GetWidestSIMDFeature(features);
+        if (simdFeature != nullptr)
+        {
+            return simdFeature->registerSize;
+        }
+
+        // No SIMD features listed: fall back on the vector units every CPU of the target architecture has
+        switch (GetNormalizedTriple(triple).getArch())
+        {
+        case llvm::Triple::x86_64:
+        case llvm::Triple::aarch64:
+            return 128;
+        default:
+            return 0;
+        }
+    }
+
+    bool TargetDevice::HasDoublePrecisionVectors() const
+    {
+        auto arch = GetNormalizedTriple(triple).getArch();
+        auto simdFeature = GetWidestSIMDFeature(features);
+        if (simdFeature != nullptr)
+        {
+            // 32-bit ARM NEON only has single-precision floating-point vector instructions
+            auto isNeon = std::string(simdFeature->name) == "neon";
+            return simdFeature->hasDoublePrecision && !(isNeon && arch != llvm::Triple::aarch64 && arch != llvm::Triple::aarch64_be);
+        }
+        return arch == llvm::Triple::x86_64 || arch == llvm::Triple::aarch64;
+    }
+
+    std::string GetHostCPUFeatures()
+    {
+        llvm::StringMap<bool> hostFeatures;
+        if (!llvm::sys::getHostCPUFeatures(hostFeatures))
+        {
+            return "";
+        }
+
+        // Sort the features so the string is stable (it ends up in cache keys and function attributes)
+        std::vector<std::string> features;
+        for (const auto& feature : hostFeatures)
+        {
+            features.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+        }
+        std::sort(features.begin(), features.end());
+
+        std::string result;
+        for (const auto& feature : features)
+        {
+            result += (result.empty() ? "" : ",") + feature;
+        }
+        return result;
+    }
+
+    std::string GetHostCPUName()
+    {
+        return llvm::sys::getHostCPUName().str();
+    }
 }
 }
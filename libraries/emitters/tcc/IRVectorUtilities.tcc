@@ -71,5 +71,68 @@ namespace emitters
         auto half2 = emitter.GetIRBuilder().CreateExtractElement(vectorValue, static_cast<uint64_t>(1));
         return function.Operator(emitters::GetAddForValueType<ValueType>(), half1, half2);
     }
+
+    template <typename ValueType>
+    int GetVectorWidth(const CompilerOptions& options)
+    {
+        return GetVectorWidth(options, sizeof(ValueType), std::is_floating_point<ValueType>::value);
+    }
+
+    template <typename ValueType>
+    LLVMValue LoadVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, int vectorWidth)
+    {
+        if (vectorWidth == 1)
+        {
+            return function.ValueAt(pArray, offset);
+        }
+
+        auto& emitter = function.GetEmitter();
+        auto vectorType = emitter.VectorType(GetVariableType<ValueType>(), vectorWidth);
+        auto pVector = function.CastPointer(function.PointerOffset(pArray, offset), vectorType->getPointerTo());
+        return emitter.GetIRBuilder().CreateAlignedLoad(pVector, alignof(ValueType));
+    }
+
+    template <typename ValueType>
+    void StoreVector(IRFunctionEmitter& function, LLVMValue pArray, LLVMValue offset, LLVMValue value)
+    {
+        if (!value->getType()->isVectorTy())
+        {
+            function.SetValueAt(pArray, offset, value);
+            return;
+        }
+
+        auto pVector = function.CastPointer(function.PointerOffset(pArray, offset), value->getType()->getPointerTo());
+        function.GetEmitter().GetIRBuilder().CreateAlignedStore(value, pVector, alignof(ValueType));
+    }
+
+    template <typename ValueType>
+    LLVMValue VectorizedSum(IRFunctionEmitter& function, LLVMValue pArray, int size)
+    {
+        const int vectorWidth = GetVectorWidth<ValueType>(function.GetModule().GetCompilerOptions());
+        const auto add = GetAddForValueType<ValueType>();
+
+        LLVMValue scalarAccum = function.Variable(GetVariableType<ValueType>(), "accum");
+        function.StoreZero(scalarAccum);
+
+        LLVMValue vectorAccum = nullptr;
+        if (vectorWidth > 1)
+        {
+            auto vectorType = function.GetEmitter().VectorType(GetVariableType<ValueType>(), vectorWidth);
+            vectorAccum = function.Variable(vectorType, "vecAccum");
+            function.Store(vectorAccum, FillVector<ValueType>(function, vectorType, 0));
+        }
+
+        VectorizedFor(function, size, vectorWidth, [pArray, scalarAccum, vectorAccum, add](IRFunctionEmitter& function, IRLocalScalar index, int width) {
+            auto value = LoadVector<ValueType>(function, pArray, index, width);
+            function.OperationAndUpdate(width == 1 ? scalarAccum : vectorAccum, add, value);
+        });
+
+        LLVMValue sum = function.Load(scalarAccum);
+        if (vectorAccum != nullptr)
+        {
+            sum = function.Operator(add, HorizontalVectorSum<ValueType>(function, function.Load(vectorAccum)), sum);
+        }
+        return sum;
+    }
 }
 }
@@ -7,8 +7,11 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+// emitters
+#include "CompilerOptions.h"
+
 void TestIRAsyncTask(bool parallel);
 
 void TestParallelTasks(bool parallel, bool useThreadPool);
 
-void TestParallelFor(int start, int end, int increment, bool parallel);
+void TestParallelFor(int start, int end, int increment, bool parallel, ell::emitters::ThreadPoolSchedulingPolicy policy = ell::emitters::ThreadPoolSchedulingPolicy::block);
@@ -0,0 +1,13 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GEMMTiming.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Compares the GEMM emitted when BLAS isn't used (on one thread and on `numThreads` threads) with the BLAS GEMM, if there is one
+template <typename ValueType>
+void TimeGEMM(int m, int n, int k, int numThreads, int numIterations);
@@ -27,6 +27,7 @@ void TestHeader();
 void TestTwoEmitsInOneSession();
 void TestStruct();
 void TestDuplicateStructs();
+void TestVectorWidth();
 
 void TestScopedIf();
 void TestScopedIfElse();
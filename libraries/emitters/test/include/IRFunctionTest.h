@@ -7,5 +7,14 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+// emitters
+#include "CompilerOptions.h"
+
 void TestIRAddFunction();
 void TestIRFunction();
+void TestOptimizationProfile(ell::emitters::OptimizationProfile profile, bool reportPasses);
+void TestOptimizationPassReportIR(ell::emitters::OptimizationProfile profile);
+
+// Checks the GEMM emitted when BLAS isn't used against a reference implementation
+template <typename ValueType>
+void TestNativeGEMM(int m, int n, int k, bool columnMajor, bool transposeA, bool transposeB, int vectorWidth, bool parallelize);
@@ -0,0 +1,18 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPoolTiming.h (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "CompilerOptions.h"
+
+// Parallel loop where the cost of each iteration grows linearly with its index
+void TimeImbalancedParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ell::emitters::ThreadPoolSchedulingPolicy policy);
+
+// Parallel loop where each iteration has the same cost
+void TimeBalancedParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ell::emitters::ThreadPoolSchedulingPolicy policy);
@@ -235,14 +235,15 @@ void TestParallelTasks(bool parallel, bool useThreadPool)
 //
 // TestParallelFor
 //
-void TestParallelFor(int begin, int end, int increment, bool parallel)
+void TestParallelFor(int begin, int end, int increment, bool parallel, ThreadPoolSchedulingPolicy policy)
 {
-    std::cout << "Testing parallel for loop" << std::endl;
+    std::cout << "Testing parallel for loop" << (policy == ThreadPoolSchedulingPolicy::workStealing ? " with work-stealing scheduler" : "") << std::endl;
     CompilerOptions options;
     options.optimize = false;
     options.targetDevice.deviceName = "host";
     options.parallelize = parallel;
     options.useThreadPool = true;
+    options.threadPoolPolicy = policy;
     IRModuleEmitter module("ParallelForTest", options);
 
     // Types
@@ -271,7 +272,7 @@ void TestParallelFor(int begin, int end, int increment, bool parallel)
         testParallelForFunction.For(arraySize, [begin, end, increment, data, result](IRFunctionEmitter& function, LLVMValue i) {
             auto index = function.LocalScalar(i);
             auto val = function.LocalScalar(function.ValueAt(data, index));
-            function.If((index >= begin) && (index < end) && (((val-begin) % increment) == 0) && (val != index), [result](IRFunctionEmitter& function) {
+            function.If((index >= begin) && (index < end) && (((index-begin) % increment) == 0) && (val != index), [result](IRFunctionEmitter& function) {
                 function.Store(result, function.Literal(1));
             });
         });
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     GEMMTiming.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GEMMTiming.h"
+
+// emitters
+#include "CompilerOptions.h"
+#include "IRExecutionEngine.h"
+#include "IRModuleEmitter.h"
+#include "IRRuntime.h"
+
+// math
+#include "BlasWrapper.h"
+
+// utilities
+#include "MillisecondTimer.h"
+#include "TypeName.h"
+
+// stl
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+
+namespace
+{
+template <typename ValueType>
+using GEMMFunction = int (*)(int, int, int, int, int, int, ValueType, const ValueType*, int, const ValueType*, int, ValueType, ValueType*, int);
+
+// CBLAS enum values
+const int cblasRowMajor = 101;
+const int cblasNoTrans = 111;
+
+void PrintTime(const std::string& name, int m, int n, int k, double duration)
+{
+    auto gflops = duration > 0 ? (2.0 * m * n * k) / (duration * 1.0e6) : 0.0;
+    std::cout << "Time to multiply " << m << "x" << k << " and " << k << "x" << n << " matrices with " << name << ": " << duration << " ms (" << gflops << " GFLOPS)" << std::endl;
+}
+
+double TimeFunction(std::function<void()> function, int numIterations)
+{
+    // Run once to page in the code and data (and start the thread pool, if there is one)
+    function();
+
+    utilities::MillisecondTimer timer;
+    for (int iter = 0; iter < numIterations; ++iter)
+    {
+        function();
+    }
+    return timer.Elapsed() / numIterations;
+}
+
+template <typename ValueType>
+double TimeNativeGEMM(int m, int n, int k, int numThreads, int numIterations, const std::vector<ValueType>& A, const std::vector<ValueType>& B, std::vector<ValueType>& C)
+{
+    CompilerOptions options;
+    options.optimize = true;
+    options.targetDevice.deviceName = "host";
+    options.useBlas = false;
+    options.parallelize = numThreads > 1;
+    options.maxThreads = numThreads;
+    IRModuleEmitter module("GEMMTiming", options);
+    auto functionName = module.GetRuntime().GetGEMMFunction<ValueType>(false)->getName().str();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (GEMMFunction<ValueType>)executionEngine.ResolveFunctionAddress(functionName);
+    return TimeFunction([&]() { compiledFunction(cblasRowMajor, cblasNoTrans, cblasNoTrans, m, n, k, 1, A.data(), k, B.data(), n, 0, C.data(), n); }, numIterations);
+}
+}
+
+template <typename ValueType>
+void TimeGEMM(int m, int n, int k, int numThreads, int numIterations)
+{
+    std::vector<ValueType> A(m * k);
+    std::vector<ValueType> B(k * n);
+    std::vector<ValueType> C(m * n);
+    for (int index = 0; index < m * k; ++index)
+    {
+        A[index] = static_cast<ValueType>(index % 7) / 7;
+    }
+    for (int index = 0; index < k * n; ++index)
+    {
+        B[index] = static_cast<ValueType>(index % 5) / 5;
+    }
+
+    const std::string typeName = utilities::GetTypeName<ValueType>();
+    PrintTime("emitted " + typeName + " GEMM", m, n, k, TimeNativeGEMM(m, n, k, 1, numIterations, A, B, C));
+    if (numThreads > 1)
+    {
+        PrintTime("emitted " + typeName + " GEMM on " + std::to_string(numThreads) + " threads", m, n, k, TimeNativeGEMM(m, n, k, numThreads, numIterations, A, B, C));
+    }
+
+#if USE_BLAS
+    auto blasTime = TimeFunction([&]() { math::Blas::Gemm(math::MatrixLayout::rowMajor, math::MatrixTranspose::noTranspose, math::MatrixTranspose::noTranspose, m, n, k, static_cast<ValueType>(1), A.data(), k, B.data(), n, static_cast<ValueType>(0), C.data(), n); }, numIterations);
+    PrintTime("BLAS " + typeName + " GEMM", m, n, k, blasTime);
+#endif
+}
+
+template void TimeGEMM<float>(int m, int n, int k, int numThreads, int numIterations);
+template void TimeGEMM<double>(int m, int n, int k, int numThreads, int numIterations);
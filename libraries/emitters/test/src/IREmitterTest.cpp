@@ -16,6 +16,8 @@
 #include "IRFunctionEmitter.h"
 #include "IRHeaderWriter.h"
 #include "IRModuleEmitter.h"
+#include "IRVectorUtilities.h"
+#include "TargetDevice.h"
 
 // testing
 #include "testing.h"
@@ -605,6 +607,40 @@ void TestDuplicateStructs()
     testing::ProcessTest("Testing double-declaration of non-equivalent structs", gotException);
 }
 
+void TestVectorWidth()
+{
+    CompilerOptions options;
+    options.targetDevice.triple = "x86_64-pc-linux-gnu";
+
+    options.targetDevice.features = "+avx512f,+avx2,+avx";
+    testing::ProcessTest("Testing AVX-512 vector width for float", GetVectorWidth<float>(options) == 16);
+    testing::ProcessTest("Testing AVX-512 vector width for double", GetVectorWidth<double>(options) == 8);
+
+    options.targetDevice.features = "+avx2,-avx512f,+fma";
+    testing::ProcessTest("Testing AVX2 vector width for float", GetVectorWidth<float>(options) == 8);
+    testing::ProcessTest("Testing AVX2 vector width for int64", GetVectorWidth<int64_t>(options) == 4);
+
+    options.targetDevice.features = "";
+    testing::ProcessTest("Testing baseline x86_64 vector width for float", GetVectorWidth<float>(options) == 4);
+
+    options.targetDevice.triple = "armv7-linux-gnueabihf";
+    options.targetDevice.features = "+neon,+vfp4";
+    testing::ProcessTest("Testing NEON vector width for float", GetVectorWidth<float>(options) == 4);
+    testing::ProcessTest("Testing 32-bit NEON vector width for double", GetVectorWidth<double>(options) == 1);
+    testing::ProcessTest("Testing 32-bit NEON vector width for int64", GetVectorWidth<int64_t>(options) == 2);
+
+    options.targetDevice.triple = "aarch64-linux-gnu";
+    options.targetDevice.features = "+neon";
+    testing::ProcessTest("Testing AArch64 NEON vector width for double", GetVectorWidth<double>(options) == 2);
+
+    options.targetDevice.triple = "thumbv6m-none-eabi";
+    options.targetDevice.features = "+armv6-m,+v6m";
+    testing::ProcessTest("Testing vector register size of target without SIMD units", options.targetDevice.GetVectorRegisterSize() == 0);
+
+    options.vectorWidth = 3;
+    testing::ProcessTest("Testing explicit vector width", GetVectorWidth<double>(options) == 3);
+}
+
 void TestScopedIf()
 {
     auto module = MakeHostModuleEmitter("If");
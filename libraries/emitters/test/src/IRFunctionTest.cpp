@@ -18,16 +18,22 @@
 #include "IRExecutionEngine.h"
 #include "IRFunctionEmitter.h"
 #include "IRModuleEmitter.h"
+#include "IROptimizer.h"
+#include "IRRuntime.h"
 #include "Variable.h"
 
 // testing
 #include "testing.h"
 
 // stl
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 using namespace ell;
 using namespace ell::emitters;
@@ -55,6 +61,37 @@ public:
 using UnaryScalarDoubleFunction = double (*)(double);
 using BinaryScalarDoubleFunction = double (*)(double, double);
 
+template <typename ValueType>
+using GEMMFunction = int (*)(int, int, int, int, int, int, ValueType, const ValueType*, int, const ValueType*, int, ValueType, ValueType*, int);
+
+// CBLAS enum values
+const int cblasRowMajor = 101;
+const int cblasColMajor = 102;
+const int cblasNoTrans = 111;
+const int cblasTrans = 112;
+
+// C = alpha * op(A) * op(B) + beta * C, computed the obvious way
+template <typename ValueType>
+void ReferenceGEMM(bool columnMajor, bool transposeA, bool transposeB, int m, int n, int k, ValueType alpha, const ValueType* A, int lda, const ValueType* B, int ldb, ValueType beta, ValueType* C, int ldc)
+{
+    auto at = [columnMajor](const ValueType* matrix, int ld, bool transpose, int row, int column) {
+        return (columnMajor != transpose) ? matrix[column * ld + row] : matrix[row * ld + column];
+    };
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            double sum = 0;
+            for (int p = 0; p < k; ++p)
+            {
+                sum += at(A, lda, transposeA, i, p) * at(B, ldb, transposeB, p, j);
+            }
+            auto& c = columnMajor ? C[j * ldc + i] : C[i * ldc + j];
+            c = static_cast<ValueType>(alpha * sum) + (beta == 0 ? 0 : beta * c);
+        }
+    }
+}
+
 //
 // Tests
 //
@@ -130,3 +167,144 @@ void TestIRFunction()
     }
     testing::ProcessTest("Testing compilable function", testing::IsEqual(computedResult, compiledResult));
 }
+
+namespace
+{
+// sum = x * (0 + 1 + ... + 99), with each term computed by a call to a helper function the optimizer can inline
+void EmitSumTimesFunction(IRModuleEmitter& module, const std::string& functionName)
+{
+    const std::string termName = functionName + "Term";
+    NamedVariableTypeList termArgs = { { "x", VariableType::Double }, { "i", VariableType::Int32 } };
+    auto term = module.BeginFunction(termName, VariableType::Double, termArgs);
+    {
+        LLVMValue x = term.GetFunctionArgument("x");
+        LLVMValue i = term.GetFunctionArgument("i");
+        term.Return(term.LocalScalar(x) * term.LocalScalar(term.CastValue<int, double>(i)));
+    }
+    module.EndFunction();
+
+    NamedVariableTypeList args = { { "x", VariableType::Double } };
+    auto function = module.BeginFunction(functionName, VariableType::Double, args);
+    {
+        LLVMValue x = function.GetFunctionArgument("x");
+        auto sum = function.Variable(VariableType::Double, "sum");
+        function.Store(sum, function.Literal<double>(0.0));
+        function.For(100, [x, sum, termName](IRFunctionEmitter& function, IRLocalScalar i) {
+            auto value = function.LocalScalar(function.Call(termName, { x, i }));
+            function.Store(sum, function.LocalScalar(function.Load(sum)) + value);
+        });
+        function.Return(function.Load(sum));
+    }
+    module.EndFunction();
+}
+
+std::string GetOptimizationProfileName(OptimizationProfile profile)
+{
+    return profile == OptimizationProfile::latency ? "latency" : (profile == OptimizationProfile::size ? "size" : "compileSpeed");
+}
+} // namespace
+
+void TestOptimizationProfile(OptimizationProfile profile, bool reportPasses)
+{
+    CompilerOptions options;
+    options.optimizationProfile = profile;
+    options.reportOptimizationPasses = reportPasses;
+    IRModuleEmitter module("OptimizationProfile", options);
+
+    const std::string functionName = "SumTimes";
+    EmitSumTimesFunction(module, functionName);
+
+    IROptimizer optimizer(module);
+    optimizer.AddStandardPasses();
+    module.Optimize(optimizer);
+    auto statistics = optimizer.GetPassStatistics();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (UnaryScalarDoubleFunction)executionEngine.ResolveFunctionAddress(functionName);
+
+    std::string profileName = GetOptimizationProfileName(profile);
+    testing::ProcessTest("Testing optimization profile " + profileName + (reportPasses ? " with pass report" : ""), testing::IsEqual(compiledFunction(2.0), 2.0 * 4950));
+
+    if (reportPasses)
+    {
+        bool hasNames = !statistics.empty();
+        for (const auto& pass : statistics)
+        {
+            hasNames = hasNames && !pass.passName.empty() && pass.time >= 0;
+        }
+        testing::ProcessTest("Testing optimization pass report for profile " + profileName, hasNames);
+        WriteOptimizationPassReport(std::cout, statistics);
+    }
+    else
+    {
+        testing::ProcessTest("Testing optimization passes aren't reported by default", statistics.empty());
+    }
+}
+
+void TestOptimizationPassReportIR(OptimizationProfile profile)
+{
+    // Timing the passes mustn't change the pipeline, so the optimized IR must be the same with and without the report
+    auto getOptimizedIR = [profile](bool reportPasses) {
+        CompilerOptions options;
+        options.optimizationProfile = profile;
+        options.reportOptimizationPasses = reportPasses;
+        IRModuleEmitter module("OptimizationPassReportIR", options);
+        EmitSumTimesFunction(module, "SumTimes");
+
+        IROptimizer optimizer(module);
+        optimizer.AddStandardPasses();
+        module.Optimize(optimizer);
+
+        std::stringstream stream;
+        module.WriteToStream(stream, ModuleOutputFormat::ir);
+        return stream.str();
+    };
+
+    auto unreportedIR = getOptimizedIR(false);
+    auto reportedIR = getOptimizedIR(true);
+    testing::ProcessTest("Testing optimization pass report doesn't change the IR for profile " + GetOptimizationProfileName(profile), !unreportedIR.empty() && unreportedIR == reportedIR);
+}
+
+template <typename ValueType>
+void TestNativeGEMM(int m, int n, int k, bool columnMajor, bool transposeA, bool transposeB, int vectorWidth, bool parallelize)
+{
+    CompilerOptions options;
+    options.useBlas = false;
+    options.vectorWidth = vectorWidth;
+    options.parallelize = parallelize;
+    IRModuleEmitter module("NativeGEMM", options);
+    auto functionName = module.GetRuntime().GetGEMMFunction<ValueType>(false)->getName().str();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (GEMMFunction<ValueType>)executionEngine.ResolveFunctionAddress(functionName);
+
+    // Leading dimensions larger than the matrices, to check that they're respected
+    const int ld = std::max({ m, n, k }) + 3;
+    std::vector<ValueType> A(ld * ld);
+    std::vector<ValueType> B(ld * ld);
+    std::vector<ValueType> C(ld * ld);
+    for (int index = 0; index < ld * ld; ++index)
+    {
+        A[index] = static_cast<ValueType>((index % 7) - 3) / 4;
+        B[index] = static_cast<ValueType>((index % 5) - 2) / 2;
+        C[index] = static_cast<ValueType>(index % 3);
+    }
+
+    const ValueType alpha = 1.5;
+    const ValueType beta = 0.5;
+    auto expected = C;
+    ReferenceGEMM(columnMajor, transposeA, transposeB, m, n, k, alpha, A.data(), ld, B.data(), ld, beta, expected.data(), ld);
+    compiledFunction(columnMajor ? cblasColMajor : cblasRowMajor, transposeA ? cblasTrans : cblasNoTrans, transposeB ? cblasTrans : cblasNoTrans, m, n, k, alpha, A.data(), ld, B.data(), ld, beta, C.data(), ld);
+
+    double maxError = 0;
+    for (int index = 0; index < ld * ld; ++index)
+    {
+        maxError = std::max(maxError, std::abs(static_cast<double>(C[index]) - static_cast<double>(expected[index])));
+    }
+
+    std::string name = std::to_string(m) + "x" + std::to_string(k) + " * " + std::to_string(k) + "x" + std::to_string(n) + (columnMajor ? ", column-major" : "") + (transposeA ? ", A transposed" : "") + (transposeB ? ", B transposed" : "") + ", vector width " + std::to_string(vectorWidth) + (parallelize ? ", parallel" : "");
+    testing::ProcessTest("Testing native GEMM (" + name + ")", maxError < 1e-4 * std::max(1, k));
+}
+
+template void TestNativeGEMM<float>(int m, int n, int k, bool columnMajor, bool transposeA, bool transposeB, int vectorWidth, bool parallelize);
+template void TestNativeGEMM<double>(int m, int n, int k, bool columnMajor, bool transposeA, bool transposeB, int vectorWidth, bool parallelize);
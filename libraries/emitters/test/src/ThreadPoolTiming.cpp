@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ThreadPoolTiming.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPoolTiming.h"
+
+// emitters
+#include "IRExecutionEngine.h"
+#include "IRFunctionEmitter.h"
+#include "IRModuleEmitter.h"
+
+// testing
+#include "testing.h"
+
+// utilities
+#include "MillisecondTimer.h"
+
+// stl
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+using namespace ell::emitters;
+
+namespace
+{
+using FloatFunction = float (*)();
+
+std::string GetPolicyName(ThreadPoolSchedulingPolicy policy)
+{
+    switch (policy)
+    {
+    case ThreadPoolSchedulingPolicy::block:
+        return "block";
+    case ThreadPoolSchedulingPolicy::workStealing:
+        return "work-stealing";
+    default:
+        return "unknown";
+    }
+}
+
+// Emits and runs a function with a parallel loop over `numLoopIterations` iterations. If `imbalanced` is true, iteration `i`
+// does `i * workPerIteration` units of work, otherwise each iteration does `numLoopIterations * workPerIteration / 2` units.
+void TimeParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ThreadPoolSchedulingPolicy policy, bool imbalanced)
+{
+    CompilerOptions options;
+    options.optimize = true;
+    options.targetDevice.deviceName = "host";
+    options.parallelize = true;
+    options.useThreadPool = true;
+    options.maxThreads = numThreads;
+    options.threadPoolPolicy = policy;
+    IRModuleEmitter module("ThreadPoolTiming", options);
+
+    auto& context = module.GetLLVMContext();
+    auto floatType = llvm::Type::getFloatTy(context);
+
+    const std::string functionName = "ParallelLoop";
+    auto function = module.BeginFunction(functionName, floatType);
+    {
+        auto data = module.GlobalArray("data", floatType, numLoopIterations);
+        auto dataPtr = function.PointerOffset(data, 0);
+        function.ParallelFor(numLoopIterations, { dataPtr }, [imbalanced, numLoopIterations, workPerIteration](IRFunctionEmitter& function, IRLocalScalar i, std::vector<LLVMValue> capturedValues) {
+            auto data = function.LocalArray(capturedValues[0]);
+            auto work = imbalanced ? i * workPerIteration : function.LocalScalar<int>(numLoopIterations * workPerIteration / 2);
+            auto sum = function.Variable(VariableType::Float, "sum");
+            function.Store(sum, function.Literal<float>(0));
+            function.For(work, [sum](IRFunctionEmitter& function, IRLocalScalar j) {
+                auto value = function.LocalScalar(function.Load(sum));
+                function.Store(sum, value * 0.5f + 1.0f);
+            });
+            data[i] = function.Load(sum);
+        });
+
+        function.Return(function.ValueAt(dataPtr, function.Literal<int>(0)));
+    }
+    module.EndFunction();
+
+    IRExecutionEngine executionEngine(std::move(module));
+    auto compiledFunction = (FloatFunction)executionEngine.ResolveFunctionAddress(functionName);
+
+    // Run once to start the thread pool and page in the code
+    volatile float result = compiledFunction();
+
+    utilities::MillisecondTimer timer;
+    for (int iter = 0; iter < numIterations; ++iter)
+    {
+        result = compiledFunction();
+    }
+    auto duration = timer.Elapsed();
+
+    std::cout << "Time to run " << (imbalanced ? "imbalanced" : "balanced") << " parallel loop of " << numLoopIterations << " iterations on " << numThreads
+              << " threads with " << GetPolicyName(policy) << " scheduler: " << (duration / numIterations) << " ms" << std::endl;
+}
+}
+
+void TimeImbalancedParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ThreadPoolSchedulingPolicy policy)
+{
+    TimeParallelFor(numLoopIterations, workPerIteration, numThreads, numIterations, policy, true);
+}
+
+void TimeBalancedParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ThreadPoolSchedulingPolicy policy)
+{
+    TimeParallelFor(numLoopIterations, workPerIteration, numThreads, numIterations, policy, false);
+}
@@ -37,6 +37,7 @@ void TestIR()
     TestTwoEmitsInOneSession();
     TestStruct();
     TestDuplicateStructs();
+    TestVectorWidth();
 
     // if/then constructs
     TestScopedIf();
@@ -46,6 +47,27 @@ void TestIR()
     // From IRFunctionTest.h
     TestIRAddFunction();
     TestIRFunction();
+    TestOptimizationProfile(emitters::OptimizationProfile::latency, false);
+    TestOptimizationProfile(emitters::OptimizationProfile::latency, true);
+    TestOptimizationProfile(emitters::OptimizationProfile::size, true);
+    TestOptimizationProfile(emitters::OptimizationProfile::compileSpeed, true);
+    TestOptimizationPassReportIR(emitters::OptimizationProfile::latency);
+    TestOptimizationPassReportIR(emitters::OptimizationProfile::size);
+
+    // TestNativeGEMM<ValueType>(m, n, k, columnMajor, transposeA, transposeB, vectorWidth, parallelize)
+    for (bool transposeA : { false, true })
+    {
+        for (bool transposeB : { false, true })
+        {
+            TestNativeGEMM<float>(37, 91, 300, false, transposeA, transposeB, 8, false);
+            TestNativeGEMM<double>(37, 91, 300, true, transposeA, transposeB, 4, false);
+        }
+    }
+    TestNativeGEMM<float>(1, 1, 1, false, false, false, 0, false);
+    TestNativeGEMM<float>(6, 16, 8, false, false, false, 8, false); // exactly one microkernel tile
+    TestNativeGEMM<float>(130, 70, 33, false, false, false, 1, false);
+    TestNativeGEMM<float>(200, 1100, 700, false, false, false, 0, false); // several blocks in every dimension
+    TestNativeGEMM<double>(200, 1100, 700, false, true, false, 0, true);
 }
 
 void TestAsyncEmitter()
@@ -70,6 +92,9 @@ void TestAsyncEmitter()
     TestParallelFor(10, 90, 2, true);
     TestParallelFor(10, 90, 3, true);
     TestParallelFor(30, 40, 11, true);
+    TestParallelFor(0, 100, 1, true, emitters::ThreadPoolSchedulingPolicy::workStealing);
+    TestParallelFor(10, 90, 3, true, emitters::ThreadPoolSchedulingPolicy::workStealing);
+    TestParallelFor(30, 40, 11, true, emitters::ThreadPoolSchedulingPolicy::workStealing);
 }
 
 void TestPosixEmitter()
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     timing_main.cpp (emitters)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GEMMTiming.h"
+#include "ThreadPoolTiming.h"
+
+// testing
+#include "testing.h"
+
+// stl
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+using namespace ell;
+
+int main()
+{
+    const int numThreads = std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+    const auto block = emitters::ThreadPoolSchedulingPolicy::block;
+    const auto workStealing = emitters::ThreadPoolSchedulingPolicy::workStealing;
+
+    // void TimeImbalancedParallelFor(int numLoopIterations, int workPerIteration, int numThreads, int numIterations, ThreadPoolSchedulingPolicy policy);
+    TimeImbalancedParallelFor(256, 100, numThreads, 20, block);
+    TimeImbalancedParallelFor(256, 100, numThreads, 20, workStealing);
+    std::cout << "\n";
+
+    TimeImbalancedParallelFor(37, 2000, numThreads, 20, block);
+    TimeImbalancedParallelFor(37, 2000, numThreads, 20, workStealing);
+    std::cout << "\n";
+
+    TimeBalancedParallelFor(256, 100, numThreads, 20, block);
+    TimeBalancedParallelFor(256, 100, numThreads, 20, workStealing);
+    std::cout << "\n";
+
+    // void TimeGEMM<ValueType>(int m, int n, int k, int numThreads, int numIterations);
+    TimeGEMM<float>(64, 64, 64, numThreads, 100);
+    TimeGEMM<float>(256, 256, 256, numThreads, 20);
+    TimeGEMM<float>(1024, 1024, 1024, numThreads, 5);
+    TimeGEMM<float>(64, 3136, 576, numThreads, 10); // an unrolled 3x3 convolution with 64 channels on a 56x56 image
+    TimeGEMM<double>(256, 256, 256, numThreads, 20);
+    std::cout << "\n";
+
+    return testing::DidTestFail() ? 1 : 0;
+}
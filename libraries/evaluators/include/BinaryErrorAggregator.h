@@ -32,6 +32,11 @@ namespace evaluators
         /// <returns> The current value. </returns>
         std::vector<double> GetResult() const;
 
+        /// <summary> Adds the state of another aggregator to this one, as if this aggregator had also been updated with its examples. </summary>
+        ///
+        /// <param name="other"> The other aggregator. </param>
+        void Merge(const BinaryErrorAggregator& other);
+
         /// <summary> Resets the aggregator to its initial state. </summary>
         void Reset();
 
@@ -52,6 +52,9 @@ namespace evaluators
     {
         size_t evaluationFrequency;
         bool addZeroEvaluation;
+
+        /// <summary> The number of threads that each evaluation splits the dataset between, or zero to use one per hardware thread. </summary>
+        size_t numThreads = 1;
     };
 
     /// <summary> Implements an evaluator that holds a data set and a set of evaluation aggregators. </summary>
@@ -98,10 +101,13 @@ namespace evaluators
         void Print(std::ostream& os) const override;
 
     protected:
+        using AggregatorTupleType = std::tuple<AggregatorTypes...>;
+
         void EvaluateZero();
+        void EvaluateRange(AggregatorTupleType& aggregators, const PredictorType& predictor, size_t fromIndex, size_t size) const;
 
         template <size_t Index>
-        using AggregatorType = typename std::tuple_element<Index, std::tuple<AggregatorTypes...>>::type;
+        using AggregatorType = typename std::tuple_element<Index, AggregatorTupleType>::type;
 
         struct ElementUpdaterParameters
         {
@@ -122,6 +128,18 @@ namespace evaluators
             AggregatorT& _aggregator;
         };
 
+        template <typename AggregatorT>
+        class ElementMerger
+        {
+        public:
+            ElementMerger(AggregatorT& aggregator, const AggregatorT& other);
+            void operator()();
+
+        private:
+            AggregatorT& _aggregator;
+            const AggregatorT& _other;
+        };
+
         template <typename AggregatorT>
         class ElementResetter
         {
@@ -135,13 +153,19 @@ namespace evaluators
         };
 
         template <std::size_t Index>
-        auto GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+        static auto GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>;
+
+        template <std::size_t Index>
+        auto GetElementMergeFunction(const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>;
 
         template <std::size_t Index>
         auto GetElementResetFunction() -> ElementResetter<AggregatorType<Index>>;
 
         template <std::size_t... Sequence>
-        void DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>);
+        static void DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>);
+
+        template <std::size_t... Sequence>
+        void DispatchMerge(const AggregatorTupleType& other, std::index_sequence<Sequence...>);
 
         template <std::size_t... Sequence>
         void Aggregate(std::index_sequence<Sequence...>);
@@ -156,7 +180,7 @@ namespace evaluators
         data::Dataset<ExampleType> _dataset;
         EvaluatorParameters _evaluatorParameters;
         size_t _evaluateCounter = 0;
-        typename std::tuple<AggregatorTypes...> _aggregatorTuple;
+        AggregatorTupleType _aggregatorTuple;
         std::vector<std::vector<std::vector<double>>> _values;
     };
 
@@ -55,6 +55,11 @@ namespace evaluators
         return { auc };
     }
 
+    void AUCAggregator::Merge(const AUCAggregator& other)
+    {
+        _aggregates.insert(_aggregates.end(), other._aggregates.begin(), other._aggregates.end());
+    }
+
     void AUCAggregator::Reset()
     {
         _aggregates.resize(0);
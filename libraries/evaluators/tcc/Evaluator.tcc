@@ -11,10 +11,22 @@
 // utilities
 #include "FunctionUtils.h"
 
+// stl
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace ell
 {
 namespace evaluators
 {
+    namespace detail
+    {
+        // ranges smaller than this aren't worth a thread of their own
+        constexpr size_t minParallelEvaluationRangeSize = 1024;
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     Evaluator<PredictorType, AggregatorTypes...>::Evaluator(const data::AnyDataset& anyDataset, const EvaluatorParameters& evaluatorParameters, AggregatorTypes... aggregators)
         : _dataset(anyDataset), _evaluatorParameters(evaluatorParameters), _aggregatorTuple(std::make_tuple(aggregators...))
@@ -36,7 +48,40 @@ namespace evaluators
             return;
         }
 
-        auto iterator = _dataset.GetExampleReferenceIterator();
+        auto numThreads = _evaluatorParameters.numThreads;
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        auto numExamples = _dataset.NumExamples();
+        auto numRanges = std::min(numThreads, std::max(numExamples / detail::minParallelEvaluationRangeSize, size_t{ 1 }));
+
+        // each range after the first is evaluated on another thread, by its own copy of the (reset) aggregators
+        std::vector<AggregatorTupleType> rangeAggregators(numRanges - 1, _aggregatorTuple);
+        std::vector<std::future<void>> tasks;
+        for (size_t rangeIndex = 1; rangeIndex < numRanges; ++rangeIndex)
+        {
+            auto fromIndex = rangeIndex * numExamples / numRanges;
+            auto size = (rangeIndex + 1) * numExamples / numRanges - fromIndex;
+            tasks.emplace_back(std::async(std::launch::async, [this, &predictor, &rangeAggregators, rangeIndex, fromIndex, size]() { EvaluateRange(rangeAggregators[rangeIndex - 1], predictor, fromIndex, size); }));
+        }
+
+        // the first range is evaluated on this thread, directly into the evaluator's aggregators
+        EvaluateRange(_aggregatorTuple, predictor, 0, numExamples / numRanges);
+
+        // merge the other ranges in order, rethrowing any exception that was thrown while evaluating them
+        for (size_t taskIndex = 0; taskIndex < tasks.size(); ++taskIndex)
+        {
+            tasks[taskIndex].get();
+            DispatchMerge(rangeAggregators[taskIndex], std::make_index_sequence<sizeof...(AggregatorTypes)>());
+        }
+        Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    void Evaluator<PredictorType, AggregatorTypes...>::EvaluateRange(AggregatorTupleType& aggregators, const PredictorType& predictor, size_t fromIndex, size_t size) const
+    {
+        auto iterator = _dataset.GetExampleReferenceIterator(fromIndex, size);
 
         while (iterator.IsValid())
         {
@@ -46,10 +91,9 @@ namespace evaluators
             double label = example.GetMetadata().label;
             double prediction = predictor.Predict(example.GetDataVector());
 
-            DispatchUpdate(prediction, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+            DispatchUpdate(aggregators, prediction, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
             iterator.Next();
         }
-        Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -118,7 +162,7 @@ namespace evaluators
             double weight = example.GetMetadata().weight;
             double label = example.GetMetadata().label;
 
-            DispatchUpdate(0.0, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
+            DispatchUpdate(_aggregatorTuple, 0.0, label, weight, std::make_index_sequence<sizeof...(AggregatorTypes)>());
             iterator.Next();
         }
         Aggregate(std::make_index_sequence<sizeof...(AggregatorTypes)>());
@@ -139,6 +183,20 @@ namespace evaluators
         _aggregator.Update(_params.prediction, _params.label, _params.weight);
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::ElementMerger(AggregatorT& aggregator, const AggregatorT& other)
+        : _aggregator(aggregator), _other(other)
+    {
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <typename AggregatorT>
+    void Evaluator<PredictorType, AggregatorTypes...>::ElementMerger<AggregatorT>::operator()()
+    {
+        _aggregator.Merge(_other);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <typename AggregatorT>
     Evaluator<PredictorType, AggregatorTypes...>::ElementResetter<AggregatorT>::ElementResetter(AggregatorT& aggregator)
@@ -156,9 +214,16 @@ namespace evaluators
 
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t Index>
-    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementUpdateFunction(AggregatorTupleType& aggregators, const ElementUpdaterParameters& params) -> ElementUpdater<AggregatorType<Index>>
     {
-        return {std::get<Index>(_aggregatorTuple), params};
+        return {std::get<Index>(aggregators), params};
+    }
+
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t Index>
+    auto Evaluator<PredictorType, AggregatorTypes...>::GetElementMergeFunction(const AggregatorTupleType& other) -> ElementMerger<AggregatorType<Index>>
+    {
+        return {std::get<Index>(_aggregatorTuple), std::get<Index>(other)};
     }
 
     template <typename PredictorType, typename... AggregatorTypes>
@@ -170,14 +235,22 @@ namespace evaluators
 
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
-    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(double prediction, double label, double weight, std::index_sequence<Sequence...>)
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchUpdate(AggregatorTupleType& aggregators, double prediction, double label, double weight, std::index_sequence<Sequence...>)
     {
-        // Call (X.Update(), 0) for each X in _aggregatorTuple
+        // Call (X.Update(), 0) for each X in aggregators
         ElementUpdaterParameters params{ prediction, label, weight };
-        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(params)...);
+        utilities::InOrderFunctionEvaluator(GetElementUpdateFunction<Sequence>(aggregators, params)...);
         // [this, prediction, label, weight]() { std::get<Sequence>(_aggregatorTuple).Update(prediction, label, weight); }...); // GCC bug prevents compilation
     }
 
+    template <typename PredictorType, typename... AggregatorTypes>
+    template <std::size_t... Sequence>
+    void Evaluator<PredictorType, AggregatorTypes...>::DispatchMerge(const AggregatorTupleType& other, std::index_sequence<Sequence...>)
+    {
+        // Call X.Merge(Y) for each X in _aggregatorTuple and its counterpart Y in other
+        utilities::InOrderFunctionEvaluator(GetElementMergeFunction<Sequence>(other)...);
+    }
+
     template <typename PredictorType, typename... AggregatorTypes>
     template <std::size_t... Sequence>
     void Evaluator<PredictorType, AggregatorTypes...>::Aggregate(std::index_sequence<Sequence...>)
@@ -31,6 +31,13 @@ namespace evaluators
         return { meanLoss };
     }
 
+    template <typename LossFunctionType>
+    void LossAggregator<LossFunctionType>::Merge(const LossAggregator<LossFunctionType>& other)
+    {
+        _sumWeights += other._sumWeights;
+        _sumWeightedLosses += other._sumWeightedLosses;
+    }
+
     template <typename LossFunctionType>
     void LossAggregator<LossFunctionType>::Reset()
     {
@@ -10,4 +10,5 @@
 namespace ell
 {
 void TestEvaluators();
+void TestParallelEvaluator();
 }
\ No newline at end of file
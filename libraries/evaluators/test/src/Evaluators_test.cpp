@@ -27,6 +27,7 @@
 
 // stl
 #include <iostream>
+#include <random>
 
 namespace ell
 {
@@ -51,4 +52,48 @@ void TestEvaluators()
     std::cout << "Goodness: " << evaluator->GetGoodness() << std::endl;
     testing::ProcessTest("Evaluator sanity check", !testing::IsEqual(evaluator->GetGoodness(), 0.0, 1e-8));
 }
+
+void TestParallelEvaluator()
+{
+    // create a dataset large enough to be split between several threads
+    using ExampleType = data::DenseSupervisedDataset::DatasetExampleType;
+    data::DenseSupervisedDataset dataset;
+    std::default_random_engine engine(123);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        double x = normal(engine);
+        double y = normal(engine);
+        double label = x + 0.5 * y + normal(engine) > 0 ? 1.0 : -1.0;
+        dataset.AddExample(ExampleType{ { x, y }, data::WeightLabel{ 1.0 + (i % 3), label } });
+    }
+
+    using PredictorType = predictors::LinearPredictor<double>;
+    using EvaluatorType = evaluators::Evaluator<PredictorType, evaluators::BinaryErrorAggregator, evaluators::AUCAggregator, evaluators::LossAggregator<functions::SquaredLoss>>;
+    PredictorType predictor({ 1.0, 0.25 }, 0.1);
+
+    EvaluatorType serialEvaluator(dataset.GetAnyDataset(), { 1, true }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+    serialEvaluator.Evaluate(predictor);
+    serialEvaluator.Evaluate(predictor);
+
+    bool ok = true;
+    for (size_t numThreads : { 2, 3, 4 })
+    {
+        EvaluatorType parallelEvaluator(dataset.GetAnyDataset(), { 1, true, numThreads }, evaluators::BinaryErrorAggregator(), evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::SquaredLoss()));
+        parallelEvaluator.Evaluate(predictor);
+        parallelEvaluator.Evaluate(predictor);
+
+        const auto& serialValues = serialEvaluator.GetValues();
+        const auto& parallelValues = parallelEvaluator.GetValues();
+        ok = ok && serialValues.size() == parallelValues.size();
+        for (size_t i = 0; ok && i < serialValues.size(); ++i)
+        {
+            for (size_t j = 0; j < serialValues[i].size(); ++j)
+            {
+                ok = ok && testing::IsEqual(serialValues[i][j], parallelValues[i][j], 1e-9);
+            }
+        }
+    }
+    testing::ProcessTest("Evaluator on several threads matches the serial evaluator", ok);
+}
 }
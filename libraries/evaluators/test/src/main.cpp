@@ -27,6 +27,7 @@ int main()
     try
     {
         TestEvaluators();
+        TestParallelEvaluator();
     }
     catch (const utilities::Exception& exception)
     {
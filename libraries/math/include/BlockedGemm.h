@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BlockedGemm.h (math)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Matrix.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Native implementations of the BLAS GEMV and GEMM functions, with the same arguments as the BLAS wrappers,
+    /// for use when BLAS isn't available. GEMM is cache-blocked: blocks of the inputs are packed into contiguous
+    /// panels, which a register-tiled kernel multiplies with vectorizable loops. Large products are split across
+    /// several threads.
+    /// </summary>
+    namespace Blocked
+    {
+        /// <summary> Sets the number of threads used by large matrix products. </summary>
+        ///
+        /// <param name="numThreads"> The number of threads (0 means the number of hardware threads). The default is 1. </param>
+        void SetNumThreads(int numThreads);
+
+        /// <summary> Gets the number of threads used by large matrix products. </summary>
+        ///
+        /// <returns> The number of threads. </returns>
+        int GetNumThreads();
+
+        /// @{
+        /// <summary> Generalized matrix vector multiplication, y = alpha*M*x + beta*y. </summary>
+        ///
+        /// <param name="order"> Row major or column major. </param>
+        /// <param name="transpose"> Whether or not to transpose the matrix M. </param>
+        /// <param name="m"> Number of matrix rows. </param>
+        /// <param name="n"> Number of matrix columns. </param>
+        /// <param name="alpha"> The scalar alpha, which multiplies M * x. </param>
+        /// <param name="M"> The matrix M. </param>
+        /// <param name="lda"> The matrix increment. </param>
+        /// <param name="x"> The vector x. </param>
+        /// <param name="incx"> The vector x increment. </param>
+        /// <param name="beta"> The scalar beta, which multiplies the left-hand side vector y. </param>
+        /// <param name="y"> The vector y, multiplied by beta and used to store the result. </param>
+        /// <param name="incy"> The vector y increment. </param>
+        void Gemv(MatrixLayout order, MatrixTranspose transpose, int m, int n, float alpha, const float* M, int lda, const float* x, int incx, float beta, float* y, int incy);
+        void Gemv(MatrixLayout order, MatrixTranspose transpose, int m, int n, double alpha, const double* M, int lda, const double* x, int incx, double beta, double* y, int incy);
+        /// @}
+
+        /// @{
+        /// <summary> Generalized matrix matrix multiplication, C = alpha*A*B + beta*C. </summary>
+        ///
+        /// <param name="order"> Row major or column major. </param>
+        /// <param name="transposeA"> Whether or not to transpose the matrix A. </param>
+        /// <param name="transposeB"> Whether or not to transpose the matrix B. </param>
+        /// <param name="m"> Number of matrix rows in A and C. </param>
+        /// <param name="n"> Number of matrix columns in B and C. </param>
+        /// <param name="k"> Number of matrix columns in A and matrix rows in B. </param>
+        /// <param name="alpha"> The scalar alpha, which multiplies A * B. </param>
+        /// <param name="A"> The matrix A. </param>
+        /// <param name="lda"> The matrix increment for A. </param>
+        /// <param name="B"> The matrix B. </param>
+        /// <param name="ldb"> The matrix increment for B. </param>
+        /// <param name="beta"> The scalar beta, which multiplies the matrix C. If zero, C isn't read. </param>
+        /// <param name="C"> The matrix C. </param>
+        /// <param name="ldc"> The matrix increment for C. </param>
+        void Gemm(MatrixLayout order, MatrixTranspose transposeA, MatrixTranspose transposeB, int m, int n, int k, float alpha, const float* A, int lda, const float* B, int ldb, float beta, float* C, int ldc);
+        void Gemm(MatrixLayout order, MatrixTranspose transposeA, MatrixTranspose transposeB, int m, int n, int k, double alpha, const double* A, int lda, const double* B, int ldb, double beta, double* C, int ldc);
+        /// @}
+    }
+}
+}
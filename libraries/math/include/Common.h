@@ -16,7 +16,8 @@ namespace math
     enum class ImplementationType
     {
         native,
-        openBlas
+        openBlas,
+        blocked // a cache-blocked native implementation of the matrix products, for when BLAS isn't available
     };
 
     /// <summary> A stub class that represents the scalar one. </summary>
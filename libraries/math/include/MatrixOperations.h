@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "BlockedGemm.h"
 #include "Common.h"
 #include "Matrix.h"
 #include "Vector.h"
@@ -406,9 +407,27 @@ namespace math
             static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
         };
 
-#else
+#endif // USE_BLAS
+
+        template <>
+        struct MatrixOperations<ImplementationType::blocked> : public MatrixOperations<ImplementationType::native>
+        {
+            static std::string GetImplementationName() { return "Blocked"; }
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+        };
+
+#ifndef USE_BLAS
+        // Without BLAS, the default implementation is the fastest one there is
         template <>
-        struct MatrixOperations<ImplementationType::openBlas> : public MatrixOperations<ImplementationType::native>
+        struct MatrixOperations<ImplementationType::openBlas> : public MatrixOperations<ImplementationType::blocked>
         {
         };
 
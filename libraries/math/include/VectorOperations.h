@@ -579,9 +579,16 @@ namespace math
             static void ScaleAddSet(ElementType scalarA, ConstVectorReference<ElementType, orientation> vectorA, ElementType scalarB, ConstVectorReference<ElementType, orientation> vectorB, VectorReference<ElementType, orientation> output);
         };
 
-#else
+#endif // USE_BLAS
+
+        template<>
+        struct VectorOperations<ImplementationType::blocked> : public VectorOperations<ImplementationType::native>
+        {};
+
+#ifndef USE_BLAS
+        // Without BLAS, the default implementation is the fastest one there is
         template<>
-        struct VectorOperations<ImplementationType::openBlas> : public VectorOperations<ImplementationType::native>
+        struct VectorOperations<ImplementationType::openBlas> : public VectorOperations<ImplementationType::blocked>
         {};
 
 #endif // USE_BLAS
@@ -0,0 +1,464 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BlockedGemm.cpp (math)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BlockedGemm.h"
+
+// stl
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Blocked
+    {
+        namespace
+        {
+            // The width of the widest vector registers the compiler may use, in bytes
+#if defined(__AVX512F__)
+            constexpr int vectorBytes = 64;
+#elif defined(__AVX__)
+            constexpr int vectorBytes = 32;
+#else
+            constexpr int vectorBytes = 16;
+#endif
+
+            // Cache sizes the block sizes are chosen for (typical of desktop and embedded CPUs alike)
+            constexpr int l1CacheBytes = 32 * 1024;
+            constexpr int l2CacheBytes = 256 * 1024;
+            constexpr int l3CacheBytes = 2 * 1024 * 1024;
+
+            // Products with fewer multiply-adds than this per thread aren't worth splitting
+            constexpr double minMultiplyAddsPerThread = 1 << 20;
+
+            int numThreads = 1;
+
+            // Register tile and cache block sizes:
+            //  - the kernel keeps a TileRows x TileColumns block of C in registers, as two vectors per tile row
+            //  - a blockDepth x blockColumns panel of B stays in the L3 cache, a blockRows x blockDepth panel of A in the L2 cache,
+            //    and a blockDepth x TileColumns sliver of B in the L1 cache
+            template <typename ElementType>
+            struct Blocking
+            {
+                static constexpr int TileRows = 6;
+                static constexpr int TileColumns = 2 * vectorBytes / static_cast<int>(sizeof(ElementType));
+
+                Blocking()
+                {
+                    const int elementSize = static_cast<int>(sizeof(ElementType));
+                    blockDepth = std::max(32, std::min(512, (l1CacheBytes / 2) / (TileColumns * elementSize)));
+                    blockDepth -= blockDepth % 8;
+                    blockRows = std::max(TileRows, ((l2CacheBytes / 2) / (blockDepth * elementSize)) / TileRows * TileRows);
+                    blockColumns = std::max(TileColumns, ((l3CacheBytes / 2) / (blockDepth * elementSize)) / TileColumns * TileColumns);
+                }
+
+                int blockDepth;
+                int blockRows;
+                int blockColumns;
+            };
+
+            int RoundUp(int value, int multiple)
+            {
+                return ((value + multiple - 1) / multiple) * multiple;
+            }
+
+            int GetEffectiveNumThreads()
+            {
+                return numThreads == 0 ? static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)) : numThreads;
+            }
+
+            // The layout of a row-major product: element (i, j) of a matrix is at i * rowStride + j * columnStride
+            template <typename ElementType>
+            struct MatrixView
+            {
+                const ElementType* data;
+                int rowStride;
+                int columnStride;
+
+                const ElementType& operator()(int row, int column) const { return data[row * rowStride + column * columnStride]; }
+            };
+
+            // Copies a depth x columns block of B into panels of TileColumns columns, each stored row by row and padded with zeros
+            template <typename ElementType>
+            void PackB(MatrixView<ElementType> B, int firstRow, int firstColumn, int depth, int columns, ElementType* packed)
+            {
+                constexpr int tileColumns = Blocking<ElementType>::TileColumns;
+                for (int j = 0; j < columns; j += tileColumns)
+                {
+                    const int panelColumns = std::min(columns - j, tileColumns);
+                    for (int p = 0; p < depth; ++p)
+                    {
+                        for (int jj = 0; jj < panelColumns; ++jj)
+                        {
+                            packed[jj] = B(firstRow + p, firstColumn + j + jj);
+                        }
+                        std::fill(packed + panelColumns, packed + tileColumns, ElementType{});
+                        packed += tileColumns;
+                    }
+                }
+            }
+
+            // Copies a rows x depth block of A, scaled by alpha, into panels of TileRows rows, each stored column by column and padded with zeros
+            template <typename ElementType>
+            void PackA(MatrixView<ElementType> A, int firstRow, int firstColumn, int rows, int depth, ElementType alpha, ElementType* packed)
+            {
+                constexpr int tileRows = Blocking<ElementType>::TileRows;
+                for (int i = 0; i < rows; i += tileRows)
+                {
+                    const int panelRows = std::min(rows - i, tileRows);
+                    for (int p = 0; p < depth; ++p)
+                    {
+                        for (int ii = 0; ii < panelRows; ++ii)
+                        {
+                            packed[ii] = alpha * A(firstRow + i + ii, firstColumn + p);
+                        }
+                        std::fill(packed + panelRows, packed + tileRows, ElementType{});
+                        packed += tileRows;
+                    }
+                }
+            }
+
+#if defined(__GNUC__)
+            // Vector types for the kernel's accumulators, for compilers with vector extensions
+            template <typename ElementType>
+            struct VectorTypes;
+
+            template <>
+            struct VectorTypes<float>
+            {
+                typedef float VectorType __attribute__((vector_size(vectorBytes)));
+            };
+
+            template <>
+            struct VectorTypes<double>
+            {
+                typedef double VectorType __attribute__((vector_size(vectorBytes)));
+            };
+#endif
+
+            // Adds the product of a packed A panel and a packed B panel to a rows x columns tile of C
+            template <typename ElementType>
+            void MultiplyTile(const ElementType* packedA, const ElementType* packedB, int depth, ElementType* C, int ldc, int rows, int columns)
+            {
+                constexpr int tileRows = Blocking<ElementType>::TileRows;
+                constexpr int tileColumns = Blocking<ElementType>::TileColumns;
+
+                ElementType accumulators[tileRows][tileColumns];
+#if defined(__GNUC__)
+                // Each row of the tile is two vectors, all of which stay in registers
+                using VectorType = typename VectorTypes<ElementType>::VectorType;
+                constexpr int vectorSize = vectorBytes / static_cast<int>(sizeof(ElementType));
+                VectorType vectorAccumulators[tileRows][2] = {};
+                for (int p = 0; p < depth; ++p)
+                {
+                    VectorType b0, b1;
+                    std::memcpy(&b0, packedB + p * tileColumns, sizeof(VectorType));
+                    std::memcpy(&b1, packedB + p * tileColumns + vectorSize, sizeof(VectorType));
+                    const ElementType* a = packedA + p * tileRows;
+                    for (int ii = 0; ii < tileRows; ++ii)
+                    {
+                        vectorAccumulators[ii][0] += a[ii] * b0;
+                        vectorAccumulators[ii][1] += a[ii] * b1;
+                    }
+                }
+                std::memcpy(accumulators, vectorAccumulators, sizeof(accumulators));
+#else
+                // Fixed-size loops over the tile, which the compiler can vectorize
+                std::fill(&accumulators[0][0], &accumulators[0][0] + tileRows * tileColumns, ElementType{});
+                for (int p = 0; p < depth; ++p)
+                {
+                    const ElementType* b = packedB + p * tileColumns;
+                    const ElementType* a = packedA + p * tileRows;
+                    for (int ii = 0; ii < tileRows; ++ii)
+                    {
+                        const ElementType aValue = a[ii];
+                        for (int jj = 0; jj < tileColumns; ++jj)
+                        {
+                            accumulators[ii][jj] += aValue * b[jj];
+                        }
+                    }
+                }
+#endif
+
+                if (rows == tileRows && columns == tileColumns)
+                {
+                    for (int ii = 0; ii < tileRows; ++ii)
+                    {
+                        for (int jj = 0; jj < tileColumns; ++jj)
+                        {
+                            C[ii * ldc + jj] += accumulators[ii][jj];
+                        }
+                    }
+                }
+                else
+                {
+                    for (int ii = 0; ii < rows; ++ii)
+                    {
+                        for (int jj = 0; jj < columns; ++jj)
+                        {
+                            C[ii * ldc + jj] += accumulators[ii][jj];
+                        }
+                    }
+                }
+            }
+
+            // The dot product of two contiguous arrays, accumulated in several independent partial sums so that it vectorizes
+            template <typename ElementType>
+            ElementType Dot(const ElementType* a, const ElementType* b, int size)
+            {
+                int i = 0;
+                ElementType sum = 0;
+#if defined(__GNUC__)
+                using VectorType = typename VectorTypes<ElementType>::VectorType;
+                constexpr int vectorSize = vectorBytes / static_cast<int>(sizeof(ElementType));
+                VectorType sums[2] = {};
+                for (; i + 2 * vectorSize <= size; i += 2 * vectorSize)
+                {
+                    VectorType a0, a1, b0, b1;
+                    std::memcpy(&a0, a + i, sizeof(VectorType));
+                    std::memcpy(&a1, a + i + vectorSize, sizeof(VectorType));
+                    std::memcpy(&b0, b + i, sizeof(VectorType));
+                    std::memcpy(&b1, b + i + vectorSize, sizeof(VectorType));
+                    sums[0] += a0 * b0;
+                    sums[1] += a1 * b1;
+                }
+                for (int j = 0; j < vectorSize; ++j)
+                {
+                    sum += sums[0][j] + sums[1][j];
+                }
+#else
+                ElementType sums[4] = {};
+                for (; i + 4 <= size; i += 4)
+                {
+                    sums[0] += a[i] * b[i];
+                    sums[1] += a[i + 1] * b[i + 1];
+                    sums[2] += a[i + 2] * b[i + 2];
+                    sums[3] += a[i + 3] * b[i + 3];
+                }
+                sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+                for (; i < size; ++i)
+                {
+                    sum += a[i] * b[i];
+                }
+                return sum;
+            }
+
+            // Adds alpha * A * packed B to the rows [firstRow, firstRow + rows) of a column block of C, one L2-sized block of rows at a time
+            template <typename ElementType>
+            void MultiplyRows(const Blocking<ElementType>& blocking, MatrixView<ElementType> A, int firstRow, int rows, int firstDepth, int depth, ElementType alpha, const ElementType* packedB, int columns, ElementType* C, int ldc)
+            {
+                constexpr int tileRows = Blocking<ElementType>::TileRows;
+                constexpr int tileColumns = Blocking<ElementType>::TileColumns;
+
+                std::vector<ElementType> packedA(static_cast<size_t>(RoundUp(std::min(rows, blocking.blockRows), tileRows)) * depth);
+                for (int i = firstRow; i < firstRow + rows; i += blocking.blockRows)
+                {
+                    const int blockRows = std::min(firstRow + rows - i, blocking.blockRows);
+                    PackA(A, i, firstDepth, blockRows, depth, alpha, packedA.data());
+                    for (int j = 0; j < columns; j += tileColumns)
+                    {
+                        const int tileWidth = std::min(columns - j, tileColumns);
+                        for (int ii = 0; ii < blockRows; ii += tileRows)
+                        {
+                            const int tileHeight = std::min(blockRows - ii, tileRows);
+                            MultiplyTile(packedA.data() + ii * depth, packedB + j * depth, depth, C + (i + ii) * ldc + j, ldc, tileHeight, tileWidth);
+                        }
+                    }
+                }
+            }
+
+            // C = alpha * A * B + beta * C, for row-major C
+            template <typename ElementType>
+            void RowMajorGemm(MatrixView<ElementType> A, MatrixView<ElementType> B, int m, int n, int k, ElementType alpha, ElementType beta, ElementType* C, int ldc)
+            {
+                if (beta != 1)
+                {
+                    for (int i = 0; i < m; ++i)
+                    {
+                        ElementType* row = C + i * ldc;
+                        if (beta == 0)
+                        {
+                            std::fill(row, row + n, ElementType{});
+                        }
+                        else
+                        {
+                            std::transform(row, row + n, row, [beta](ElementType value) { return beta * value; });
+                        }
+                    }
+                }
+
+                if (m == 0 || n == 0 || k == 0 || alpha == 0)
+                {
+                    return;
+                }
+
+                const Blocking<ElementType> blocking;
+                constexpr int tileRows = Blocking<ElementType>::TileRows;
+                constexpr int tileColumns = Blocking<ElementType>::TileColumns;
+
+                // Split the rows of C into one range of whole tiles per thread
+                const double numMultiplyAdds = static_cast<double>(m) * n * k;
+                const int maxThreads = std::max(1, static_cast<int>(numMultiplyAdds / minMultiplyAddsPerThread));
+                const int numRowTiles = (m + tileRows - 1) / tileRows;
+                const int numTasks = maxThreads == 1 ? 1 : std::min({ GetEffectiveNumThreads(), maxThreads, numRowTiles });
+                const int rowsPerTask = ((numRowTiles + numTasks - 1) / numTasks) * tileRows;
+
+                std::vector<ElementType> packedB(static_cast<size_t>(RoundUp(std::min(n, blocking.blockColumns), tileColumns)) * std::min(k, blocking.blockDepth));
+                for (int j = 0; j < n; j += blocking.blockColumns)
+                {
+                    const int blockColumns = std::min(n - j, blocking.blockColumns);
+                    for (int p = 0; p < k; p += blocking.blockDepth)
+                    {
+                        const int blockDepth = std::min(k - p, blocking.blockDepth);
+                        PackB(B, p, j, blockDepth, blockColumns, packedB.data());
+
+                        if (numTasks == 1)
+                        {
+                            MultiplyRows(blocking, A, 0, m, p, blockDepth, alpha, packedB.data(), blockColumns, C + j, ldc);
+                        }
+                        else
+                        {
+                            std::vector<std::future<void>> tasks;
+                            for (int i = 0; i < m; i += rowsPerTask)
+                            {
+                                const int rows = std::min(m - i, rowsPerTask);
+                                tasks.push_back(std::async(std::launch::async, [&, i, rows]() {
+                                    MultiplyRows(blocking, A, i, rows, p, blockDepth, alpha, packedB.data(), blockColumns, C + j, ldc);
+                                }));
+                            }
+                            for (auto& task : tasks)
+                            {
+                                task.get();
+                            }
+                        }
+                    }
+                }
+            }
+
+            template <typename ElementType>
+            void GemmImpl(MatrixLayout order, MatrixTranspose transposeA, MatrixTranspose transposeB, int m, int n, int k, ElementType alpha, const ElementType* A, int lda, const ElementType* B, int ldb, ElementType beta, ElementType* C, int ldc)
+            {
+                // A column-major product is the row-major product of the transposed matrices, in reverse order: C' = B' * A'
+                if (order == MatrixLayout::columnMajor)
+                {
+                    std::swap(m, n);
+                    std::swap(A, B);
+                    std::swap(lda, ldb);
+                    std::swap(transposeA, transposeB);
+                }
+
+                MatrixView<ElementType> viewA = transposeA == MatrixTranspose::transpose ? MatrixView<ElementType>{ A, 1, lda } : MatrixView<ElementType>{ A, lda, 1 };
+                MatrixView<ElementType> viewB = transposeB == MatrixTranspose::transpose ? MatrixView<ElementType>{ B, 1, ldb } : MatrixView<ElementType>{ B, ldb, 1 };
+                RowMajorGemm(viewA, viewB, m, n, k, alpha, beta, C, ldc);
+            }
+
+            template <typename ElementType>
+            void GemvImpl(MatrixLayout order, MatrixTranspose transpose, int m, int n, ElementType alpha, const ElementType* M, int lda, const ElementType* x, int incx, ElementType beta, ElementType* y, int incy)
+            {
+                // the sizes of x and y
+                const bool transposed = transpose == MatrixTranspose::transpose;
+                const int xSize = transposed ? m : n;
+                const int ySize = transposed ? n : m;
+
+                // copy strided vectors into contiguous buffers, so the inner loops are unit-stride
+                std::vector<ElementType> xBuffer;
+                if (incx != 1)
+                {
+                    xBuffer.resize(xSize);
+                    for (int i = 0; i < xSize; ++i)
+                    {
+                        xBuffer[i] = x[i * incx];
+                    }
+                    x = xBuffer.data();
+                }
+
+                // in row-major terms, either each entry of y is a dot product with a row of M, or y is a sum of scaled rows of M
+                const bool rowsDotX = (order == MatrixLayout::rowMajor) != transposed;
+                const int numRows = order == MatrixLayout::rowMajor ? m : n;
+                const int numColumns = order == MatrixLayout::rowMajor ? n : m;
+                if (rowsDotX)
+                {
+                    for (int i = 0; i < numRows; ++i)
+                    {
+                        ElementType& target = y[i * incy];
+                        target = alpha * Dot(M + i * lda, x, numColumns) + (beta == 0 ? ElementType{} : beta * target);
+                    }
+                    return;
+                }
+
+                // four rows at a time, so each load and store of the result is reused four times
+                std::vector<ElementType> result(ySize, ElementType{});
+                ElementType* r = result.data();
+                int i = 0;
+                for (; i + 4 <= numRows; i += 4)
+                {
+                    const ElementType* row0 = M + i * lda;
+                    const ElementType* row1 = row0 + lda;
+                    const ElementType* row2 = row1 + lda;
+                    const ElementType* row3 = row2 + lda;
+                    const ElementType x0 = x[i], x1 = x[i + 1], x2 = x[i + 2], x3 = x[i + 3];
+                    for (int j = 0; j < numColumns; ++j)
+                    {
+                        r[j] += row0[j] * x0 + row1[j] * x1 + row2[j] * x2 + row3[j] * x3;
+                    }
+                }
+                for (; i < numRows; ++i)
+                {
+                    const ElementType* row = M + i * lda;
+                    const ElementType xi = x[i];
+                    for (int j = 0; j < numColumns; ++j)
+                    {
+                        r[j] += row[j] * xi;
+                    }
+                }
+
+                for (int j = 0; j < ySize; ++j)
+                {
+                    ElementType& target = y[j * incy];
+                    target = alpha * result[j] + (beta == 0 ? ElementType{} : beta * target);
+                }
+            }
+        }
+
+        void SetNumThreads(int threads)
+        {
+            numThreads = std::max(threads, 0);
+        }
+
+        int GetNumThreads()
+        {
+            return numThreads;
+        }
+
+        void Gemv(MatrixLayout order, MatrixTranspose transpose, int m, int n, float alpha, const float* M, int lda, const float* x, int incx, float beta, float* y, int incy)
+        {
+            GemvImpl(order, transpose, m, n, alpha, M, lda, x, incx, beta, y, incy);
+        }
+
+        void Gemv(MatrixLayout order, MatrixTranspose transpose, int m, int n, double alpha, const double* M, int lda, const double* x, int incx, double beta, double* y, int incy)
+        {
+            GemvImpl(order, transpose, m, n, alpha, M, lda, x, incx, beta, y, incy);
+        }
+
+        void Gemm(MatrixLayout order, MatrixTranspose transposeA, MatrixTranspose transposeB, int m, int n, int k, float alpha, const float* A, int lda, const float* B, int ldb, float beta, float* C, int ldc)
+        {
+            GemmImpl(order, transposeA, transposeB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        }
+
+        void Gemm(MatrixLayout order, MatrixTranspose transposeA, MatrixTranspose transposeB, int m, int n, int k, double alpha, const double* A, int lda, const double* B, int ldb, double beta, double* C, int ldc)
+        {
+            GemmImpl(order, transposeA, transposeB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        }
+    }
+}
+}
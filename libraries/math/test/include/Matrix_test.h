@@ -182,6 +182,9 @@ void TestVectorMatrixMultiplyScaleAddUpdate();
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
 void TestMatrixMatrixMultiplyScaleAddUpdate();
 
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
+void TestLargeMatrixMatrixMultiplyScaleAddUpdate();
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixElementwiseMultiplySet();
 
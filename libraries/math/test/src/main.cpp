@@ -89,6 +89,7 @@ void RunOrientedVectorTests()
 
     RunOrientedVectorImplementationTests<ElementType, orientation, math::ImplementationType::native>();
     RunOrientedVectorImplementationTests<ElementType, orientation, math::ImplementationType::openBlas>();
+    RunOrientedVectorImplementationTests<ElementType, orientation, math::ImplementationType::blocked>();
 }
 
 template<typename ElementType>
@@ -110,6 +111,7 @@ void RunVectorTests()
 
     RunVectorImplementationTests<ElementType, math::ImplementationType::native>();
     RunVectorImplementationTests<ElementType, math::ImplementationType::openBlas>();
+    RunVectorImplementationTests<ElementType, math::ImplementationType::blocked>();
 }
 
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
@@ -119,6 +121,7 @@ void RunTripleLayoutMatrixImplementationTests()
     TestMatrixScaleAddSetOneMatrixScalar<ElementType, layout1, layout2, layout3, implementation>();
     TestMatrixScaleAddSetScalarMatrixScalar<ElementType, layout1, layout2, layout3,  implementation>();
     TestMatrixMatrixMultiplyScaleAddUpdate<ElementType, layout1, layout2, layout3, implementation>();
+    TestLargeMatrixMatrixMultiplyScaleAddUpdate<ElementType, layout1, layout2, layout3, implementation>();
 }
 
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::ImplementationType implementation>
@@ -204,6 +207,7 @@ void RunLayoutMatrixTests()
 
     RunLayoutMatrixImplementationTests<ElementType, layout, math::ImplementationType::native>();
     RunLayoutMatrixImplementationTests<ElementType, layout, math::ImplementationType::openBlas>();
+    RunLayoutMatrixImplementationTests<ElementType, layout, math::ImplementationType::blocked>();
 }
 
 template<typename ElementType>
@@ -258,6 +262,7 @@ void RunLayoutTensorTests()
 
     RunLayoutTensorImplementationTests<ElementType, dimension0, dimension1, dimension2, math::ImplementationType::native>();
     RunLayoutTensorImplementationTests<ElementType, dimension0, dimension1, dimension2, math::ImplementationType::openBlas>();
+    RunLayoutTensorImplementationTests<ElementType, dimension0, dimension1, dimension2, math::ImplementationType::blocked>();
 }
 
 template <typename ElementType>
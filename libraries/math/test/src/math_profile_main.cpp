@@ -48,6 +48,9 @@ void RunProfile()
     ProfileMatrixMatrixMultiplyScaleAddUpdate<ElementType, row, column>(10, 10, 10, 100 * repetitions);
     ProfileMatrixMatrixMultiplyScaleAddUpdate<ElementType, row, column>(100, 100, 100, 10 * repetitions);
     ProfileMatrixMatrixMultiplyScaleAddUpdate<ElementType, row, column>(1000, 1000, 1000, repetitions);
+
+    ProfileMatrixMatrixMultiplyScaleAddUpdate<ElementType, column, row>(1000, 1000, 1000, repetitions);
+    ProfileMatrixMatrixMultiplyScaleAddUpdate<ElementType, row, row>(256, 2000, 500, repetitions);
 }
 
 int main()
@@ -1319,6 +1319,32 @@ void TestMatrixMatrixMultiplyScaleAddUpdate()
     testing::ProcessTest(implementationName + "::MultiplyScaleAddUpdate(scalar, Matrix, Matrix, scalar, Matrix)", C == R && CCC == R);
 }
 
+// Large enough to span several register tiles and cache blocks, and to be split across threads
+template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2, math::MatrixLayout layout3, math::ImplementationType implementation>
+void TestLargeMatrixMatrixMultiplyScaleAddUpdate()
+{
+    auto implementationName = math::Internal::MatrixOperations<implementation>::GetImplementationName();
+
+    // small integer entries, so that the products are exact
+    const size_t m = 131, n = 67, k = 541;
+    size_t count = 0;
+    math::Matrix<ElementType, layout1> A(m, k);
+    A.Generate([&count]() { return static_cast<ElementType>(static_cast<int>(count++ % 5) - 2); });
+    math::Matrix<ElementType, layout2> B(k, n);
+    B.Generate([&count]() { return static_cast<ElementType>(static_cast<int>(count++ % 7) - 3); });
+    math::Matrix<ElementType, layout3> C(m, n);
+    C.Generate([&count]() { return static_cast<ElementType>(static_cast<int>(count++ % 3)); });
+
+    math::Matrix<ElementType, layout3> R(C);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(static_cast<ElementType>(2), A, B, static_cast<ElementType>(-1), R);
+
+    math::Blocked::SetNumThreads(3);
+    math::MultiplyScaleAddUpdate<implementation>(static_cast<ElementType>(2), A, B, static_cast<ElementType>(-1), C);
+    math::Blocked::SetNumThreads(1);
+
+    testing::ProcessTest(implementationName + "::MultiplyScaleAddUpdate(scalar, Matrix, Matrix, scalar, Matrix) with large matrices", C == R);
+}
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixElementwiseMultiplySet()
 {
@@ -48,6 +48,16 @@ void PrintLine(std::string functionName, double native, double singleBlas, doubl
         << std::endl;
 }
 
+void PrintLine(std::string functionName, double native, double singleBlas, double multiBlas, double singleBlocked, double multiBlocked)
+{
+    std::cout << functionName
+        << "\tnative:1.0\tsingleBlas:" << singleBlas / native
+        << "\tmultiBlas:" << multiBlas / native
+        << "\tsingleBlocked:" << singleBlocked / native
+        << "\tmultiBlocked:" << multiBlocked / native
+        << std::endl;
+}
+
 template <typename ElementType, typename VectorAType, math::VectorOrientation orientation>
 void ProfileVectorScaleAddWorker(ElementType scalarA, VectorAType vectorA, ElementType scalarB, math::VectorReference<ElementType, orientation> vectorB, std::string description, size_t repetitions)
 {
@@ -161,13 +171,18 @@ void ProfileMatrixVectorMultiplyScaleAddUpdate(size_t numRows, size_t numColumns
     double singleBlas = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::openBlas>::MultiplyScaleAddUpdate(s, M, v, t, u); }, repetitions);
     math::Blas::SetNumThreads(0);
     double multiBlas = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::openBlas>::MultiplyScaleAddUpdate(s, M, v, t, u); }, repetitions);
+    math::Blocked::SetNumThreads(1);
+    double singleBlocked = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::blocked>::MultiplyScaleAddUpdate(s, M, v, t, u); }, repetitions);
+    math::Blocked::SetNumThreads(0);
+    double multiBlocked = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::blocked>::MultiplyScaleAddUpdate(s, M, v, t, u); }, repetitions);
+    math::Blocked::SetNumThreads(1);
 
     std::string type = std::string("<") + typeid(ElementType).name() + ">";
     std::string vector1 = "Vector" + type + "[" + std::to_string(numColumns) + "]";
     std::string vector2 = "Vector" + type + "[" + std::to_string(numRows) + "]";
     std::string matrix = "Matrix" + type + "[" + std::to_string(numRows) + ", " + std::to_string(numColumns) + "]";
     std::string functionName = "MultiplyScaleAddUpdate(scalar, " + matrix + ", " + vector1 + ", scalar, " +vector2 + ")";
-    PrintLine(functionName, native, singleBlas, multiBlas);
+    PrintLine(functionName, native, singleBlas, multiBlas, singleBlocked, multiBlocked);
 }
 
 template <typename ElementType, math::MatrixLayout layout1, math::MatrixLayout layout2>
@@ -194,11 +209,16 @@ void ProfileMatrixMatrixMultiplyScaleAddUpdate(size_t numRows, size_t numColumns
     double singleBlas = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::openBlas>::MultiplyScaleAddUpdate(a, M, N, b, T); }, repetitions);
     math::Blas::SetNumThreads(0);
     double multiBlas = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::openBlas>::MultiplyScaleAddUpdate(a, M, N, b, T); }, repetitions);
+    math::Blocked::SetNumThreads(1);
+    double singleBlocked = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::blocked>::MultiplyScaleAddUpdate(a, M, N, b, T); }, repetitions);
+    math::Blocked::SetNumThreads(0);
+    double multiBlocked = GetTime([&]() { math::Internal::MatrixOperations<math::ImplementationType::blocked>::MultiplyScaleAddUpdate(a, M, N, b, T); }, repetitions);
+    math::Blocked::SetNumThreads(1);
 
     std::string type = std::string("<") + typeid(ElementType).name() + ">";
     std::string matrix1 = "Matrix" + type + "[" + std::to_string(numRows) + ", " + std::to_string(numColumns) + "]";
     std::string matrix2 = "Matrix" + type + "[" + std::to_string(numColumns) + ", " + std::to_string(numColumns2) + "]";
     std::string matrix3 = "Matrix" + type + "[" + std::to_string(numRows) + ", " + std::to_string(numColumns2) + "]";
     std::string functionName = "MultiplyScaleAddUpdate(scalar, " + matrix1 + ", " + matrix2 + ", scalar, " + matrix3 + ")";
-    PrintLine(functionName, native, singleBlas, multiBlas);
+    PrintLine(functionName, native, singleBlas, multiBlas, singleBlocked, multiBlocked);
 }
@@ -186,6 +186,20 @@ namespace model
         /// <summary> Force jitting to finish so you can time execution without jit cost. </summary>
         void FinishJitting() const;
 
+        /// <summary>
+        /// Computes the map's output for a batch of inputs with a single call to the batch predict function, which calls the
+        /// predict function on each input in turn. The map must have a single input and output, and must have been compiled
+        /// with `emitPredictBatchFunction` set.
+        /// </summary>
+        ///
+        /// <typeparam name="InputType"> The map's input element type. </typeparam>
+        /// <typeparam name="OutputType"> The map's output element type. </typeparam>
+        /// <param name="inputs"> The inputs, stored as `count` consecutive input vectors. </param>
+        /// <param name="count"> The number of inputs in the batch. </param>
+        /// <returns> The outputs, stored as `count` consecutive output vectors. </returns>
+        template <typename InputType, typename OutputType>
+        std::vector<OutputType> ComputeBatch(const std::vector<InputType>& inputs, size_t count) const;
+
         /// <summary> Set a context object to use in the predict call </summary>
         void SetContext(void* context) { _context = context; }
 
@@ -211,7 +225,7 @@ namespace model
     private:
         friend class IRMapCompiler;
 
-        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule);
+        IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule, const std::string& jitCacheKey);
 
         void EnsureExecutionEngine() const;
         void SetComputeFunction() const;
@@ -226,6 +240,7 @@ namespace model
 
         mutable std::unique_ptr<emitters::IRExecutionEngine> _executionEngine;
         bool _verifyJittedModule = false;
+        std::string _jitCacheKey;
         void* _context = nullptr;
 
         // Only one of the entries in each of these tuples is active, depending on the input and output types of the map
@@ -17,6 +17,7 @@
 #include "OutputPort.h"
 
 // emitters
+#include "IROptimizer.h"
 #include "LLVMUtilities.h"
 
 // stl
@@ -58,6 +59,24 @@ namespace model
         /// <returns> The CompilerOptions struct used by the IR emitter to control code generation. </returns>
         const emitters::CompilerOptions& GetCompilerOptions() const { return GetModule().GetCompilerOptions(); }
 
+        /// <summary>
+        /// Gets the key that identifies the code generated for a map in the JIT cache. The key is a hash of the map's
+        /// archive, the version of ELL's code generation, the LLVM version, the compiler options and the target device
+        /// (including the host CPU, when jitting for the host).
+        /// </summary>
+        ///
+        /// <param name="map"> The map to be compiled. </param>
+        /// <returns> The key, as a string of hex digits. </returns>
+        std::string GetJitCacheKey(const Map& map) const;
+
+        /// <summary>
+        /// Gets the cost of each IR optimization pass run by the most recent call to `Compile`. Empty unless
+        /// `CompilerOptions::reportOptimizationPasses` is set.
+        /// </summary>
+        ///
+        /// <returns> The statistics for each optimization pass. </returns>
+        const std::vector<emitters::OptimizationPassStatistics>& GetOptimizationPassStatistics() const { return _optimizationPassStatistics; }
+
         /// <summary> Get the optimizer used by this compiler. </summary>
         ModelOptimizer& GetOptimizer() { return _optimizer; }
 
@@ -157,6 +176,7 @@ namespace model
         void OnEndCompileNode(const Node& node) override;
         void PushScope() override;
         void PopScope() override;
+        void CompileNodes(Model& model) override;
         emitters::ModuleEmitter* GetModuleEmitter() override { return &_moduleEmitter; }
         void EnsureValidMap(Map& map);
         virtual std::string GetPredictFunctionName() const;
@@ -171,10 +191,14 @@ namespace model
         const Node* GetUniqueParent(const Node& node);
         bool TryMergeNodeIntoRegion(emitters::IRBlockRegion* pDestination, const Node& src);
 
+        bool ShouldCompileNodesConcurrently() const;
+        void CompileNodeBranches(const std::vector<std::vector<const Node*>>& branches);
+
         void EmitGetInputSizeFunction(const Map& map);
         void EmitGetOutputSizeFunction(const Map& map);
         void EmitGetSinkOutputSizeFunction(const Map& map);
         void EmitGetNumNodesFunction(const Map& map);
+        void EmitPredictBatchWrapperFunction(const Map& map);
         void EmitSizeConditionals(emitters::IRFunctionEmitter& fn, std::vector<int> sizes);
 
         void EmitShapeEnum();
@@ -185,6 +209,11 @@ namespace model
 
         // stack of node regions
         std::vector<NodeMap<emitters::IRBlockRegion*>> _nodeRegions;
+
+        // number of task functions emitted for independent branches of the model
+        int _numBranchFunctions = 0;
+
+        std::vector<emitters::OptimizationPassStatistics> _optimizationPassStatistics;
     };
 }
 }
@@ -439,6 +439,23 @@ namespace model
         std::unordered_map<std::string, PortElementsBase> _outputElementsMap;
         utilities::PropertyBag _metadata;
 
+        // The interpreter's execution plan for a set of outputs: the nodes the outputs depend on, in the order they must be
+        // computed. Plans are built on first use and discarded when the model changes. At most a few are kept, and the
+        // oldest is discarded first.
+        struct ComputePlan
+        {
+            PortElementsBase outputs;
+            std::vector<const Node*> nodes;
+        };
+        mutable std::vector<ComputePlan> _computePlans;
+        mutable size_t _computePlansModelRevision = 0;
+
+        const ComputePlan& GetComputePlan(const PortElementsBase& outputs) const;
+        void InvalidateComputePlans();
+
+        template <typename ValueType>
+        std::vector<ValueType> ComputeOutputWithPlan(const PortElementsBase& outputs) const;
+
         std::vector<const Node*> GetAllOutputNodes() const;
         std::vector<const Node*> GetDebugSinkNodes() const;
         std::vector<const Node*> GetMatchingNodesByType(const std::string name) const;
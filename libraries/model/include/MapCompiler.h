@@ -11,6 +11,7 @@
 #include "CompilableNodeUtilities.h"
 #include "MapCompilerOptions.h"
 #include "OutputPort.h"
+#include "PortBufferAllocator.h"
 
 // emitters
 #include "CompilerOptions.h"
@@ -50,6 +51,11 @@ namespace model
         /// <returns> The MapCompilerOptions struct used by the map compiler to control code generation. </returns>
         const MapCompilerOptions& GetMapCompilerOptions() const { return _parameters; }
 
+        /// <summary> Gets statistics about the memory used by the port variables of the compiled map. </summary>
+        ///
+        /// <returns> The PortBufferStatistics for the most recently compiled map. </returns>
+        const PortBufferStatistics& GetPortBufferStatistics() const { return _portBufferStatistics; }
+
         //
         // Routines for Node implementers
         //
@@ -112,6 +118,12 @@ namespace model
         virtual void PopScope();
         virtual emitters::ModuleEmitter* GetModuleEmitter() = 0;
 
+        /// <summary> Compiles the nodes of the model into the current function, in dependency order. </summary>
+        virtual void CompileNodes(Model& model);
+
+        /// <summary> Compiles a single node into the current function. </summary>
+        void CompileNode(const Node& node);
+
     private:
         enum class ArgType
         {
@@ -121,7 +133,10 @@ namespace model
 
         friend class CompilableNode;
 
-        void CompileNodes(Model& model);
+        void PlanPortBuffers(Model& model);
+        emitters::Variable* GetPortBufferSlotVariable(size_t slotIndex);
+        void VerifyPortBufferAlias(const Port& port, emitters::Variable* pVar);
+        void RecordPortVariable(const OutputPortBase& port, bool isShared);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const OutputPortBase& port, ArgType argType);
         emitters::Variable* AllocatePortFunctionArgument(emitters::ModuleEmitter& emitter, const PortElementBase& element, ArgType argType);
 
@@ -129,6 +144,12 @@ namespace model
         // map from ports to runtime variables, for all ports in the model
         // stored as a stack, with the top of the stack being the innermost scope
         std::vector<std::unordered_map<const Port*, emitters::Variable*>> _portToVarMaps; // Do we need separate elementToVarMaps?
+
+        // shared buffers for the port variables of the top-level map function (if `reusePortBuffers` is set)
+        PortBufferAllocator _portBufferAllocator;
+        std::vector<emitters::Variable*> _portBufferSlotVariables;
+        std::unordered_map<const emitters::Variable*, const OutputPortBase*> _portBufferSlotOwners;
+        PortBufferStatistics _portBufferStatistics;
     };
 }
 }
@@ -23,7 +23,16 @@ namespace model
     class Map;
     class Model;
     class Node;
-    
+
+    /// <summary> How decision forests (ForestPredictorNode) are compiled. </summary>
+    enum class ForestLoweringStrategy
+    {
+        dataflow = 0, // refine the forest into threshold, multiplexer, and sum nodes, which evaluate every split
+        branching, // emit nested if/else statements for each tree, so only the splits on the path to the leaf are evaluated
+        flattened, // store the trees in flat arrays and walk each tree from its root with a loop
+        quickScorer // visit each feature's splits in threshold order and find each tree's exit leaf with bitvectors of its leaves
+    };
+
     struct MapCompilerOptions
     {
         // map-specific compiler settings
@@ -34,6 +43,11 @@ namespace model
         std::string sourceFunctionName;
         std::string sinkFunctionName;
         bool verifyJittedModule = false;
+        bool reusePortBuffers = false; // share buffers between port variables whose lifetimes don't overlap
+        bool emitPredictBatchFunction = false; // also emit "<mapFunctionName>Batch", a convenience wrapper that calls the predict function on each input of a batch
+        bool parallelizeNodes = false; // run independent branches of the model concurrently (requires compilerSettings.parallelize)
+        std::string jitCacheDirectory; // if set, jitted object code is stored in (and reloaded from) this directory
+        ForestLoweringStrategy forestLowering = ForestLoweringStrategy::dataflow;
         
         // optimizations
         ModelOptimizerOptions optimizerSettings;
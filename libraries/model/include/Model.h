@@ -149,6 +149,14 @@ namespace model
         /// <returns> The number of nodes in the model </summary>
         size_t Size() const { return _data->idToNodeMap.size(); }
 
+        /// <summary>
+        /// Returns a number that changes whenever the graph of the model may have changed: when a node is added to the model,
+        /// or when an input port is reset with `ModelEditor::ResetInputPort`.
+        /// </summary>
+        ///
+        /// <returns> The revision of the model </returns>
+        size_t GetRevision() const;
+
         /// <summary> Retrieves a set of nodes by type </summary>
         ///
         /// <typeparam name="NodeType"> The type of the node </typeparam>
@@ -339,6 +347,7 @@ namespace model
             // We keep it sorted by id to make visiting all nodes deterministically ordered
             IDToNodeMap idToNodeMap;
             utilities::PropertyBag metadata;
+            size_t numNodesAdded = 0;
         };
 
         Model(const std::shared_ptr<Model::ModelData>& data);
@@ -24,6 +24,9 @@ public:
     /// <param name="newInput"> The new input for the input port </param>
     /// <remarks> This should ideally only be used sparingly, such as during the optimization process </remarks>
     static void ResetInputPort(const InputPortBase* port, const OutputPortBase& newInput);
+
+    /// <summary> Returns the number of times `ResetInputPort` has been called, on any model </summary>
+    static size_t GetInputPortResetCount();
 };
 }
 }
\ No newline at end of file
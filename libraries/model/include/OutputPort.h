@@ -97,6 +97,9 @@ namespace model
         /// <returns> The output element, converted to a `double`. </returns>
         virtual double GetDoubleOutput(size_t index) const { return 0.0; };
 
+        /// <summary> Allocates storage for the port's output, so that computing it doesn't allocate. </summary>
+        virtual void ReserveOutput() const {}
+
         /// <summary> Gets the name of this type (for serialization). </summary>
         ///
         /// <returns> The name of this type. </returns>
@@ -157,6 +160,9 @@ namespace model
         /// <returns> The output element, converted to a `double`. </returns>
         double GetDoubleOutput(size_t index) const override;
 
+        /// <summary> Allocates storage for the port's output, so that computing it doesn't allocate. </summary>
+        void ReserveOutput() const override { _cachedOutput.reserve(Size()); }
+
         /// <summary> Sets the cached output from this port </summary>
         ///
         /// <param name=values> The values this port should output </param>
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortBufferAllocator.h (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "OutputPort.h"
+#include "Port.h"
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ell
+{
+namespace model
+{
+    class Model;
+
+    /// <summary> Statistics about the memory used for compiled port buffers, in bytes. </summary>
+    struct PortBufferStatistics
+    {
+        /// <summary> The memory needed if every output port had its own buffer. </summary>
+        size_t naiveSize = 0;
+
+        /// <summary> The memory used by the shared arena slots (the peak arena size). </summary>
+        size_t arenaSize = 0;
+
+        /// <summary> The total memory actually allocated for port buffers, shared and private. </summary>
+        size_t allocatedSize = 0;
+
+        /// <summary> The number of ports placed in shared arena slots. </summary>
+        size_t numSharedPorts = 0;
+
+        /// <summary> The number of shared arena slots. </summary>
+        size_t numSlots = 0;
+    };
+
+    /// <summary>
+    /// Performs a liveness analysis over the nodes of a model (in the order they are visited by
+    /// `Model::Visit`) and assigns output ports with non-overlapping lifetimes to shared buffer slots.
+    /// </summary>
+    class PortBufferAllocator
+    {
+    public:
+        /// <summary> A shared buffer slot. Every port assigned to the slot has the slot's type and fits in its size. </summary>
+        struct Slot
+        {
+            Port::PortType type;
+            size_t size;
+        };
+
+        PortBufferAllocator() = default;
+
+        /// <summary> Constructor. Analyzes the model and assigns the candidate ports to slots. </summary>
+        ///
+        /// <param name="model"> The model to analyze. </param>
+        /// <param name="isCandidate"> A predicate returning `true` for output ports that may be placed in a shared slot. </param>
+        PortBufferAllocator(const Model& model, std::function<bool(const OutputPortBase&)> isCandidate);
+
+        /// <summary> Indicates if the given port has been assigned to a shared slot. </summary>
+        ///
+        /// <param name="port"> The port to look up. </param>
+        /// <returns> `true` if the port has been assigned to a slot. </returns>
+        bool HasSlot(const OutputPortBase& port) const;
+
+        /// <summary> Gets the index of the slot the given port has been assigned to. </summary>
+        ///
+        /// <param name="port"> The port to look up. Must have been assigned to a slot. </param>
+        /// <returns> The index of the port's slot. </returns>
+        size_t GetSlotIndex(const OutputPortBase& port) const;
+
+        /// <summary> Gets a slot by index. </summary>
+        ///
+        /// <param name="index"> The index of the slot. </param>
+        /// <returns> The slot. </returns>
+        const Slot& GetSlot(size_t index) const { return _slots[index]; }
+
+        /// <summary> Returns the number of shared slots. </summary>
+        size_t NumSlots() const { return _slots.size(); }
+
+        /// <summary> Gets the position (in visit order) of the last node that may read the given port. </summary>
+        ///
+        /// <param name="port"> The port to look up. </param>
+        /// <returns> The position of the last reader of the port, or -1 if the port wasn't seen by the analysis. </returns>
+        int GetLastUse(const OutputPortBase& port) const;
+
+    private:
+        struct PortLifetime
+        {
+            int definition = 0;
+            int lastUse = 0;
+        };
+
+        std::vector<Slot> _slots;
+        std::unordered_map<const OutputPortBase*, size_t> _portSlots;
+        std::unordered_map<const OutputPortBase*, PortLifetime> _lifetimes;
+    };
+
+    /// <summary> Gets the size in bytes of a single element of a compiled port of the given type. </summary>
+    ///
+    /// <param name="type"> The port type. </param>
+    /// <returns> The size of one element, in bytes. </returns>
+    size_t GetPortElementSize(Port::PortType type);
+}
+}
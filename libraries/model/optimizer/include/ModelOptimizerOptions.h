@@ -8,6 +8,8 @@
 
 #pragma once
 
+// stl
+#include <string>
 
 namespace ell
 {
@@ -26,7 +28,8 @@ namespace model
         diagonal,
         simple,
         winograd,
-        unrolled
+        unrolled,
+        autotune // time each compatible method on the host and use the fastest
     };
 
     struct ModelOptimizerOptions
@@ -34,8 +37,15 @@ namespace model
         // individual optimization settings
         bool fuseLinearFunctionNodes = true;
 
+        // Fusing convolutions with their bias, batch normalization, and activation nodes replaces the
+        // preferred convolution method with a direct loop nest, so it's off by default
+        bool fuseConvolutionNodes = false;
+
         PreferredConvolutionMethod preferredConvolutionMethod = PreferredConvolutionMethod::automatic;
 
+        // file where autotuned convolution methods are cached across compiles (if empty, results aren't saved)
+        std::string convolutionTuningDatabase;
+
         // phase
         OptimizerPhase phase = OptimizerPhase::optimize;
     };
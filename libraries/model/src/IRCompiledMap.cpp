@@ -16,6 +16,7 @@
 #include "Port.h"
 
 // emitters
+#include "IRObjectCache.h"
 #include "IROptimizer.h"
 
 // utilities
@@ -33,13 +34,13 @@ namespace ell
 namespace model
 {
     IRCompiledMap::IRCompiledMap(IRCompiledMap&& other)
-        : CompiledMap(std::move(other), other._functionName, other._compilerOptions), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _verifyJittedModule(other._verifyJittedModule), _computeFunctionDefined(false)
+        : CompiledMap(std::move(other), other._functionName, other._compilerOptions), _moduleName(std::move(other._moduleName)), _module(std::move(other._module)), _executionEngine(std::move(other._executionEngine)), _verifyJittedModule(other._verifyJittedModule), _jitCacheKey(std::move(other._jitCacheKey)), _computeFunctionDefined(false)
     {
     }
 
     // private constructor:
-    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule)
-        : CompiledMap(std::move(map), functionName, options), _module(std::move(module)), _verifyJittedModule(verifyJittedModule), _computeFunctionDefined(false)
+    IRCompiledMap::IRCompiledMap(Map map, const std::string& functionName, const MapCompilerOptions& options, std::unique_ptr<emitters::IRModuleEmitter> module, bool verifyJittedModule, const std::string& jitCacheKey)
+        : CompiledMap(std::move(map), functionName, options), _module(std::move(module)), _verifyJittedModule(verifyJittedModule), _jitCacheKey(jitCacheKey), _computeFunctionDefined(false)
     {
         _moduleName = _module->GetModuleName();
     }
@@ -61,6 +62,14 @@ namespace model
         {
             auto moduleClone = std::unique_ptr<llvm::Module>(llvm::CloneModule(_module->GetLLVMModule()));
             _executionEngine = std::make_unique<emitters::IRExecutionEngine>(std::move(moduleClone), _verifyJittedModule);
+            if (_compilerOptions.compilerSettings.optimizationProfile == emitters::OptimizationProfile::compileSpeed)
+            {
+                _executionEngine->SetOptimizationLevel(emitters::GetOptimizationLevel(_compilerOptions.compilerSettings));
+            }
+            if (!_compilerOptions.jitCacheDirectory.empty())
+            {
+                _executionEngine->SetObjectCache(std::make_unique<emitters::IRObjectCache>(_compilerOptions.jitCacheDirectory, _jitCacheKey));
+            }
         }
     }
 
@@ -11,10 +11,12 @@
 #include "CompilableNodeUtilities.h"
 #include "IRMetadata.h"
 #include "IRModelProfiler.h"
+#include "InputNodeBase.h"
 #include "Model.h"
 #include "ModelOptimizer.h"
 #include "OptimizationPassRegistry.h"
 #include "OutputNode.h"
+#include "OutputNodeBase.h"
 
 // emitters
 #include "EmitterException.h"
@@ -22,11 +24,23 @@
 #include "Variable.h"
 
 // utils
+#include "Files.h"
+#include "JsonArchiver.h"
 #include "Logger.h"
 #include "StringUtil.h"
 
+// llvm
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Host.h>
+
 // stl
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <set>
+#include <sstream>
 #include <tuple>
+#include <unordered_map>
 
 namespace ell
 {
@@ -38,6 +52,64 @@ namespace model
         {
             return (node.GetRuntimeTypeName().find("ConvolutionalLayerNode") == 0);
         }
+
+        // Version of the code the compiler generates. Bump it whenever a change to the compiler or to a node's emitter changes
+        // the generated code, so that objects cached by earlier builds of ELL are no longer found.
+        const int c_jitCacheCodeVersion = 1;
+
+        // 64-bit FNV-1a hash, which (unlike std::hash) is stable across processes and platforms
+        uint64_t HashString(const std::string& str)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (auto ch : str)
+            {
+                hash ^= static_cast<unsigned char>(ch);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        // Autotuning takes the convolution methods it has already measured from the tuning database, so the database's
+        // contents determine the generated code
+        uint64_t HashConvolutionTuningDatabase(const MapCompilerOptions& options)
+        {
+            const auto& filename = options.optimizerSettings.convolutionTuningDatabase;
+            if (options.optimizerSettings.preferredConvolutionMethod != PreferredConvolutionMethod::autotune || filename.empty() || !utilities::FileExists(filename))
+            {
+                return 0;
+            }
+
+            auto stream = utilities::OpenIfstream(filename);
+            std::stringstream contents;
+            contents << stream.rdbuf();
+            return HashString(contents.str());
+        }
+
+        void WriteCacheKeyOptions(std::ostream& stream, const MapCompilerOptions& options)
+        {
+            const auto& compilerSettings = options.compilerSettings;
+            const auto& targetDevice = compilerSettings.targetDevice;
+            stream << options.moduleName << ';' << options.mapFunctionName << ';' << options.inlineNodes << ';' << options.profile << ';'
+                   << options.sourceFunctionName << ';' << options.sinkFunctionName << ';' << options.reusePortBuffers << ';'
+                   << options.emitPredictBatchFunction << ';' << options.parallelizeNodes << ';' << static_cast<int>(options.forestLowering) << ';'
+                   << options.optimizerSettings.fuseLinearFunctionNodes << ';' << options.optimizerSettings.fuseConvolutionNodes << ';' << static_cast<int>(options.optimizerSettings.preferredConvolutionMethod) << ';' << options.optimizerSettings.convolutionTuningDatabase << ';' << HashConvolutionTuningDatabase(options) << ';'
+                   << compilerSettings.unrollLoops << ';' << compilerSettings.inlineOperators << ';' << compilerSettings.allowVectorInstructions << ';'
+                   << compilerSettings.vectorWidth << ';' << compilerSettings.useBlas << ';' << static_cast<int>(compilerSettings.blasType) << ';'
+                   << compilerSettings.profile << ';' << compilerSettings.optimize << ';' << static_cast<int>(compilerSettings.optimizationProfile) << ';'
+                   << compilerSettings.reportOptimizationPasses << ';'
+                   << compilerSettings.includeDiagnosticInfo << ';'
+                   << compilerSettings.parallelize << ';' << compilerSettings.useThreadPool << ';' << compilerSettings.maxThreads << ';'
+                   << static_cast<int>(compilerSettings.threadPoolPolicy) << ';' << compilerSettings.useFastMath << ';' << compilerSettings.debug << ';'
+                   << compilerSettings.positionIndependentCode.GetValue(false) << ';'
+                   << targetDevice.deviceName << ';' << targetDevice.triple << ';' << targetDevice.architecture << ';' << targetDevice.dataLayout << ';'
+                   << targetDevice.cpu << ';' << targetDevice.features << ';' << targetDevice.numBits << ';';
+        }
+
+        // Source and sink nodes invoke user callbacks, so they always run on the thread that called the map function
+        bool MustRunOnCallingThread(const Node& node)
+        {
+            return dynamic_cast<const SourceNodeBase*>(&node) != nullptr || dynamic_cast<const SinkNodeBase*>(&node) != nullptr;
+        }
     }
 
     using namespace logging;
@@ -100,6 +172,21 @@ namespace model
         return GetMapCompilerOptions().mapFunctionName;
     }
 
+    std::string IRMapCompiler::GetJitCacheKey(const Map& map) const
+    {
+        std::stringstream keyStream;
+        utilities::JsonArchiver archiver(keyStream);
+        archiver.Archive(map);
+
+        // The jitted code is generated for the machine it runs on
+        keyStream << c_jitCacheCodeVersion << ';' << LLVM_VERSION_STRING << ';' << llvm::sys::getHostCPUName().str() << ';';
+        WriteCacheKeyOptions(keyStream, GetMapCompilerOptions());
+
+        std::stringstream key;
+        key << std::hex << std::setfill('0') << std::setw(16) << HashString(keyStream.str());
+        return key.str();
+    }
+
     IRCompiledMap IRMapCompiler::Compile(Map map)
     {
         // phases of compilation / refinement / optimization
@@ -121,6 +208,15 @@ namespace model
 
         Log() << "Compile called for map" << EOL;
 
+        // The IR is optimized even if the JIT cache holds this map's object code: if the cached object can't be loaded
+        // when the map is jitted, the module is compiled and stored under the same key, so it must be the optimized one
+        std::string jitCacheKey;
+        if (!GetMapCompilerOptions().jitCacheDirectory.empty())
+        {
+            jitCacheKey = GetJitCacheKey(map);
+            Log() << "JIT cache key: " << jitCacheKey << EOL;
+        }
+
         EnsureValidMap(map);
 
         //
@@ -159,6 +255,13 @@ namespace model
         // Now we have the refined map, compile it
         Log() << "Compiling map..." << EOL;
         CompileMap(map, GetPredictFunctionName());
+        if (GetMapCompilerOptions().reusePortBuffers)
+        {
+            const auto& statistics = GetPortBufferStatistics();
+            Log() << "Port buffers: " << statistics.numSharedPorts << " ports share " << statistics.numSlots << " slots. "
+                  << "Arena size: " << statistics.arenaSize << " bytes, total allocated: " << statistics.allocatedSize
+                  << " bytes, naive size: " << statistics.naiveSize << " bytes" << EOL;
+        }
 
         // Emit runtime model APIs
         EmitModelAPIFunctions(map);
@@ -181,6 +284,7 @@ namespace model
             emitters::IROptimizer optimizer(*module);
             optimizer.AddStandardPasses();
             module->Optimize(optimizer);
+            _optimizationPassStatistics = optimizer.GetPassStatistics();
 
             // Reinsert callback declarations after optimization
             for (const auto& savedCallback : savedCallbacks)
@@ -191,7 +295,7 @@ namespace model
             }
         }
 
-        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), std::move(module), GetMapCompilerOptions().verifyJittedModule);
+        return IRCompiledMap(std::move(map), GetMapCompilerOptions().mapFunctionName, GetMapCompilerOptions(), std::move(module), GetMapCompilerOptions().verifyJittedModule, jitCacheKey);
     }
 
     void IRMapCompiler::EmitModelAPIFunctions(const Map& map)
@@ -204,6 +308,10 @@ namespace model
         EmitGetInputShapeFunction(map);
         EmitGetOutputShapeFunction(map);
         EmitGetSinkOutputShapeFunction(map);
+        if (GetMapCompilerOptions().emitPredictBatchFunction)
+        {
+            EmitPredictBatchWrapperFunction(map);
+        }
     }
 
     void IRMapCompiler::EmitGetInputSizeFunction(const Map& map)
@@ -531,6 +639,71 @@ namespace model
         _moduleEmitter.EndFunction();
     }
 
+    void IRMapCompiler::EmitPredictBatchWrapperFunction(const Map& map)
+    {
+        // This is only a convenience for callers with many inputs: it calls the predict function once per sample, so each
+        // sample still streams the model's weights, and nodes aren't lowered to batched kernels (e.g., GEMM instead of GEMV).
+        // The only saving is the per-call overhead of the host language or wrapper.
+        if (!map.GetSourceNodes().empty())
+        {
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, "Batch predict function not supported for maps with source nodes");
+        }
+
+        auto predictFunctionName = GetPredictFunctionName();
+        auto predictFunction = _moduleEmitter.GetFunction(predictFunctionName);
+        if (predictFunction == nullptr)
+        {
+            throw emitters::EmitterException(emitters::EmitterError::functionNotFound, "Couldn't find predict function " + predictFunctionName);
+        }
+
+        // The batch function takes the predict function's arguments, with the number of samples inserted after the context.
+        // Each input and output argument points to `count` consecutive samples.
+        auto& context = _moduleEmitter.GetLLVMContext();
+        emitters::NamedLLVMTypeList parameters;
+        for (auto& argument : predictFunction->args())
+        {
+            parameters.push_back({ argument.getName().str(), argument.getType() });
+            if (parameters.size() == 1)
+            {
+                parameters.push_back({ "count", llvm::Type::getInt32Ty(context) });
+            }
+        }
+
+        std::vector<int> sampleSizes;
+        for (size_t i = 0, n = map.GetNumInputs(); i < n; ++i)
+        {
+            sampleSizes.push_back(static_cast<int>(map.GetInputSize(i)));
+        }
+        for (size_t i = 0, n = map.GetNumOutputs(); i < n; ++i)
+        {
+            sampleSizes.push_back(static_cast<int>(map.GetOutputSize(i)));
+        }
+
+        auto function = _moduleEmitter.BeginFunction(predictFunctionName + "Batch", llvm::Type::getVoidTy(context), parameters);
+        function.IncludeInHeader();
+        function.IncludeInPredictBatchInterface();
+
+        auto arguments = function.Arguments().begin();
+        emitters::LLVMValue contextArgument = &(*arguments++);
+        emitters::LLVMValue countArgument = &(*arguments++);
+        std::vector<emitters::LLVMValue> dataArguments;
+        for (auto end = function.Arguments().end(); arguments != end; ++arguments)
+        {
+            dataArguments.push_back(&(*arguments));
+        }
+        assert(dataArguments.size() == sampleSizes.size());
+
+        function.For(countArgument, [predictFunction, contextArgument, dataArguments, sampleSizes](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar sample) {
+            emitters::IRValueList callArguments = { contextArgument };
+            for (size_t i = 0; i < dataArguments.size(); ++i)
+            {
+                callArguments.push_back(function.PointerOffset(dataArguments[i], sample * sampleSizes[i]));
+            }
+            function.Call(predictFunction, callArguments);
+        });
+        _moduleEmitter.EndFunction();
+    }
+
     //
     // Node implementor methods:
     //
@@ -621,6 +794,192 @@ namespace model
         _nodeRegions.pop_back();
     }
 
+    bool IRMapCompiler::ShouldCompileNodesConcurrently() const
+    {
+        const auto& options = GetMapCompilerOptions();
+        if (!options.parallelizeNodes || !options.compilerSettings.parallelize)
+        {
+            return false;
+        }
+
+        // The shared port buffers' lifetimes and the profiler's counters both assume the nodes run one after another
+        if (options.reusePortBuffers || options.profile)
+        {
+            Log() << "Not running independent nodes concurrently, because port buffers are shared or the model is being profiled" << EOL;
+            return false;
+        }
+        return true;
+    }
+
+    void IRMapCompiler::CompileNodes(Model& model)
+    {
+        if (!ShouldCompileNodesConcurrently())
+        {
+            MapCompiler::CompileNodes(model);
+            return;
+        }
+
+        // Partition the nodes (in visit order) into sections of independent branches. A node whose parents are
+        // all in one branch of the current section is appended to that branch, and a node with no parents in the
+        // current section starts a new one. A node that depends on more than one branch joins them: the
+        // section is emitted, with each branch running as a concurrent task, and the node starts the next section.
+        const auto maxBranches = static_cast<size_t>(std::max(1, GetCompilerOptions().maxThreads));
+        std::vector<std::vector<const Node*>> branches;
+        std::unordered_map<const Node*, size_t> nodeBranches;
+        auto endSection = [this, &branches, &nodeBranches]() {
+            CompileNodeBranches(branches);
+            branches.clear();
+            nodeBranches.clear();
+        };
+
+        model.Visit([this, maxBranches, &branches, &nodeBranches, &endSection](const Node& node) {
+            // Nodes without inputs (e.g., inputs and constants) can run before anything else in the section
+            if (node.GetInputPorts().empty())
+            {
+                CompileNode(node);
+                return;
+            }
+
+            if (MustRunOnCallingThread(node))
+            {
+                endSection();
+                CompileNode(node);
+                return;
+            }
+
+            std::set<size_t> parentBranches;
+            for (auto input : node.GetInputPorts())
+            {
+                for (auto parentNode : input->GetParentNodes())
+                {
+                    auto it = nodeBranches.find(parentNode);
+                    if (it != nodeBranches.end())
+                    {
+                        parentBranches.insert(it->second);
+                    }
+                }
+            }
+
+            if (parentBranches.size() > 1)
+            {
+                endSection();
+                parentBranches.clear();
+            }
+
+            size_t branchIndex = 0;
+            if (!parentBranches.empty())
+            {
+                branchIndex = *parentBranches.begin();
+            }
+            else if (branches.size() < maxBranches)
+            {
+                branchIndex = branches.size();
+                branches.emplace_back();
+            }
+            else
+            {
+                // Too many branches for the available threads: run this one after the shortest existing branch
+                auto shortest = std::min_element(branches.begin(), branches.end(), [](const std::vector<const Node*>& a, const std::vector<const Node*>& b) { return a.size() < b.size(); });
+                branchIndex = static_cast<size_t>(shortest - branches.begin());
+            }
+
+            branches[branchIndex].push_back(&node);
+            nodeBranches[&node] = branchIndex;
+        });
+        endSection();
+    }
+
+    void IRMapCompiler::CompileNodeBranches(const std::vector<std::vector<const Node*>>& branches)
+    {
+        if (branches.size() < 2)
+        {
+            for (const auto& branch : branches)
+            {
+                for (auto node : branch)
+                {
+                    CompileNode(*node);
+                }
+            }
+            return;
+        }
+
+        // Each branch is compiled into its own task function. The task functions take the same arguments
+        // as the map function, so the nodes can find the map's input and output variables by name.
+        auto& module = GetModule();
+        auto& mapFunction = module.GetCurrentFunction();
+        auto mapFunctionName = mapFunction.GetFunctionName();
+        emitters::NamedLLVMTypeList parameters;
+        std::vector<emitters::LLVMValue> arguments;
+        for (auto& argument : mapFunction.GetFunction()->args())
+        {
+            parameters.push_back({ argument.getName().str(), argument.getType() });
+            arguments.push_back(&argument);
+        }
+
+        std::vector<emitters::LLVMFunction> taskFunctions;
+        for (const auto& branch : branches)
+        {
+            auto taskFunctionName = mapFunctionName + "_branch" + std::to_string(_numBranchFunctions++);
+            Log() << "Creating task function " << taskFunctionName << " for " << branch.size() << " nodes" << EOL;
+
+            auto& taskFunction = module.BeginFunction(taskFunctionName, llvm::Type::getVoidTy(GetLLVMContext()), parameters);
+            taskFunctions.push_back(taskFunction.GetFunction());
+
+            // Code regions can't be merged across functions
+            _nodeRegions.emplace_back();
+            for (auto node : branch)
+            {
+                CompileNode(*node);
+            }
+            _nodeRegions.pop_back();
+            module.EndFunction();
+        }
+
+        // The thread pool has a single active task array, so branches that start tasks in it (e.g., with ParallelFor or
+        // the emitted GEMM) run one after another on this thread. The other branches run as concurrent tasks, except
+        // that one of them runs on this thread if no branch uses the pool.
+        std::vector<emitters::LLVMFunction> asyncTaskFunctions;
+        std::vector<emitters::LLVMFunction> callingThreadTaskFunctions;
+        for (auto taskFunction : taskFunctions)
+        {
+            if (module.UsesThreadPool(taskFunction))
+            {
+                Log() << "Task function " << taskFunction->getName().str() << " uses the thread pool, running it on the calling thread" << EOL;
+                callingThreadTaskFunctions.push_back(taskFunction);
+            }
+            else
+            {
+                asyncTaskFunctions.push_back(taskFunction);
+            }
+        }
+        if (callingThreadTaskFunctions.empty())
+        {
+            callingThreadTaskFunctions.push_back(asyncTaskFunctions.back());
+            asyncTaskFunctions.pop_back();
+        }
+
+        auto& function = module.GetCurrentFunction();
+        auto pBlock = function.Block("branches");
+        function.SetCurrentBlock(pBlock);
+        function.AddRegion(pBlock);
+
+        std::vector<emitters::IRTask> tasks;
+        for (auto taskFunction : asyncTaskFunctions)
+        {
+            tasks.push_back(function.StartAsyncTask(taskFunction, arguments));
+        }
+        for (auto taskFunction : callingThreadTaskFunctions)
+        {
+            function.Call(taskFunction, arguments);
+        }
+        for (auto& task : tasks)
+        {
+            task.Wait(function);
+        }
+
+        function.GetCurrentRegion()->SetEnd(function.GetCurrentBlock());
+    }
+
     NodeMap<emitters::IRBlockRegion*>& IRMapCompiler::GetCurrentNodeBlocks()
     {
         assert(_nodeRegions.size() > 0);
@@ -707,6 +1066,12 @@ namespace model
     {
         Log() << "Trying to merge parent node " << DiagnosticString(dest) << " with child node " << DiagnosticString(src) << EOL;
 
+        if (GetMapCompilerOptions().reusePortBuffers)
+        {
+            Log() << "Not merging code regions, because port buffers are shared" << EOL;
+            return false;
+        }
+
         emitters::IRBlockRegion* pDestRegion = GetCurrentNodeBlocks().Get(dest);
         if (pDestRegion == nullptr)
         {
@@ -738,6 +1103,13 @@ namespace model
 
     emitters::IRBlockRegion* IRMapCompiler::GetMergeableNodeRegion(const PortElementBase& element)
     {
+        // Moving a node's code into another region changes when it executes, which would break
+        // the port lifetimes the shared port buffers were assigned with
+        if (GetMapCompilerOptions().reusePortBuffers)
+        {
+            return nullptr;
+        }
+
         const Node* pNode = nullptr;
         if (HasSingleDescendant(element))
         {
@@ -28,6 +28,9 @@ namespace model
         //
         constexpr utilities::ArchiveVersion noMetadataArchiveVersion = { utilities::ArchiveVersionNumbers::v2 };
         constexpr utilities::ArchiveVersion metadataArchiveVersion = { utilities::ArchiveVersionNumbers::v3_model_metadata };
+
+        // The number of interpreter execution plans a map keeps
+        constexpr size_t maxComputePlans = 8;
     }
 
     Map::Map(const Model& model, const std::vector<std::pair<std::string, InputNodeBase*>>& inputs, const std::vector<std::pair<std::string, PortElementsBase>>& outputs)
@@ -124,29 +127,104 @@ namespace model
         node->SetInput(inputValues);
     }
 
+    const Map::ComputePlan& Map::GetComputePlan(const PortElementsBase& outputs) const
+    {
+        // Nodes added to the model through GetModel(), or inputs reset with ModelEditor, may change the dependencies of an output
+        if (_model.GetRevision() != _computePlansModelRevision)
+        {
+            _computePlans.clear();
+            _computePlansModelRevision = _model.GetRevision();
+        }
+
+        for (const auto& plan : _computePlans)
+        {
+            if (plan.outputs == outputs)
+            {
+                return plan;
+            }
+        }
+
+        ComputePlan plan;
+        plan.outputs = outputs;
+        std::unordered_set<const OutputPortBase*> usedPorts;
+        for (const auto& range : outputs.GetRanges())
+        {
+            usedPorts.insert(range.ReferencedPort());
+        }
+        auto ports = std::vector<const OutputPortBase*>(usedPorts.begin(), usedPorts.end());
+        _model.VisitSubmodel(ports, [&plan](const Node& node) {
+            for (auto port : node.GetOutputPorts())
+            {
+                port->ReserveOutput();
+            }
+            plan.nodes.push_back(&node);
+        });
+
+        if (_computePlans.size() >= maxComputePlans)
+        {
+            _computePlans.erase(_computePlans.begin());
+        }
+        _computePlans.push_back(std::move(plan));
+        return _computePlans.back();
+    }
+
+    void Map::InvalidateComputePlans()
+    {
+        _computePlans.clear();
+        _computePlansModelRevision = 0;
+    }
+
+    template <typename ValueType>
+    std::vector<ValueType> Map::ComputeOutputWithPlan(const PortElementsBase& outputs) const
+    {
+        for (const auto& range : outputs.GetRanges())
+        {
+            if (range.GetPortType() != Port::GetPortType<ValueType>())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+            }
+        }
+
+        const auto& plan = GetComputePlan(outputs);
+        for (auto node : plan.nodes)
+        {
+            node->Compute();
+        }
+
+        std::vector<ValueType> result;
+        result.reserve(outputs.Size());
+        for (const auto& range : outputs.GetRanges())
+        {
+            const auto& portOutput = static_cast<const OutputPort<ValueType>*>(range.ReferencedPort())->GetOutput();
+            auto begin = portOutput.begin() + range.GetStartIndex();
+            result.insert(result.end(), begin, begin + range.Size());
+        }
+        return result;
+    }
+
     std::vector<bool> Map::ComputeBoolOutput(const PortElementsBase& outputs) const
     {
-        return _model.ComputeOutput<bool>(outputs);
+        return ComputeOutputWithPlan<bool>(outputs);
     }
 
     std::vector<int> Map::ComputeIntOutput(const PortElementsBase& outputs) const
     {
-        return _model.ComputeOutput<int>(outputs);
+        return ComputeOutputWithPlan<int>(outputs);
     }
 
     std::vector<int64_t> Map::ComputeInt64Output(const PortElementsBase& outputs) const
     {
-        return _model.ComputeOutput<int64_t>(outputs);
+        return ComputeOutputWithPlan<int64_t>(outputs);
     }
 
     std::vector<float> Map::ComputeFloatOutput(const PortElementsBase& outputs) const
     {
-        return _model.ComputeOutput<float>(outputs);
+        return ComputeOutputWithPlan<float>(outputs);
     }
 
     std::vector<double> Map::ComputeDoubleOutput(const PortElementsBase& outputs) const
     {
-        return _model.ComputeOutput<double>(outputs);
+        return ComputeOutputWithPlan<double>(outputs);
     }
 
     template <>
@@ -218,6 +296,8 @@ namespace model
         swap(a._outputElements, b._outputElements);
         swap(a._outputNames, b._outputNames);
         swap(a._outputElementsMap, b._outputElementsMap);
+        swap(a._computePlans, b._computePlans);
+        swap(a._computePlansModelRevision, b._computePlansModelRevision);
     }
 
     std::vector<const Node*> Map::GetAllOutputNodes() const
@@ -362,7 +442,8 @@ namespace model
         }
         auto minimalModel = transformer.CopySubmodel(_model, outputPorts, context);
         FixTransformedIO(transformer);
-        _model = std::move(minimalModel);        
+        _model = std::move(minimalModel);
+        InvalidateComputePlans();
     }
 
     size_t Map::GetNumInputs() const
@@ -508,6 +589,7 @@ namespace model
         auto refinedModel = transformer.RefineModel(_model, context, maxIterations);
         FixTransformedIO(transformer);
         _model = std::move(refinedModel);
+        InvalidateComputePlans();
         Prune();
     }
 
@@ -518,6 +600,7 @@ namespace model
 
         FixTransformedIO(context);
         _model = std::move(optimizedModel);
+        InvalidateComputePlans();
         Prune();
     }
 
@@ -527,6 +610,7 @@ namespace model
         auto refinedModel = transformer.TransformModel(_model, context, transformFunction);
         FixTransformedIO(transformer);
         _model = std::move(refinedModel);
+        InvalidateComputePlans();
     }
 
     void Map::RenameCallbacks(const std::string& sourceCallbackName, const std::string& sinkCallbackName)
@@ -594,6 +678,7 @@ namespace model
 
         // Unarchive the model
         archiver["model"] >> _model;
+        InvalidateComputePlans();
 
         // Unarchive the inputs
         std::vector<utilities::UniqueId> inputIds;
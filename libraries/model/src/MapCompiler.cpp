@@ -42,6 +42,8 @@ namespace model
         std::vector<std::string> comments = { std::string("Input size: ") + std::to_string(inputSize), std::string("Output size: ") + std::to_string(outputSize) };
         pModuleEmitter->SetFunctionComments(functionName, comments);
 
+        PlanPortBuffers(map.GetModel());
+
         OnBeginCompileModel(map.GetModel());
         CompileNodes(map.GetModel());
         OnEndCompileModel(map.GetModel());
@@ -52,21 +54,87 @@ namespace model
 
     void MapCompiler::CompileNodes(Model& model)
     {
-        model.Visit([this](const Node& node) {
-            if (!node.IsCompilable(this))
-            {
-                std::string typeName = node.GetRuntimeTypeName();
-                throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
-            }
+        model.Visit([this](const Node& node) { CompileNode(node); });
+    }
+
+    void MapCompiler::CompileNode(const Node& node)
+    {
+        if (!node.IsCompilable(this))
+        {
+            std::string typeName = node.GetRuntimeTypeName();
+            throw emitters::EmitterException(emitters::EmitterError::notSupported, std::string("Uncompilable node type: " + typeName));
+        }
 
-            auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
-            assert(compilableNode != nullptr && "Got null compilable node");
+        auto compilableNode = const_cast<CompilableNode*>(dynamic_cast<const CompilableNode*>(&node));
+        assert(compilableNode != nullptr && "Got null compilable node");
+
+        Log() << "Now compiling node " << DiagnosticString(node) << EOL;
+        OnBeginCompileNode(node);
+        compilableNode->CompileNode(*this);
+        OnEndCompileNode(node);
+    }
+
+    void MapCompiler::PlanPortBuffers(Model& model)
+    {
+        _portBufferStatistics = {};
+        _portBufferSlotVariables.clear();
+        _portBufferSlotOwners.clear();
+        if (!_parameters.reusePortBuffers)
+        {
+            _portBufferAllocator = {};
+            return;
+        }
 
-            Log() << "Now compiling node " << DiagnosticString(node) << EOL;
-            OnBeginCompileNode(node);
-            compilableNode->CompileNode(*this);
-            OnEndCompileNode(node);
+        // Ports already bound to a variable (e.g., the map's inputs and outputs) and ports whose padding
+        // must keep its initial value can't share storage. Nodes without inputs (e.g., constants) bind their
+        // outputs to their own global variables.
+        _portBufferAllocator = PortBufferAllocator(model, [this](const OutputPortBase& port) {
+            return port.Size() != 0 &&
+                   !port.GetNode()->GetInputPorts().empty() &&
+                   !port.GetMemoryLayout().HasPadding() &&
+                   GetVariableForPort(port) == nullptr;
         });
+
+        _portBufferSlotVariables.resize(_portBufferAllocator.NumSlots(), nullptr);
+        Log() << "Planned " << _portBufferAllocator.NumSlots() << " shared port buffer slots" << EOL;
+    }
+
+    emitters::Variable* MapCompiler::GetPortBufferSlotVariable(size_t slotIndex)
+    {
+        auto& pVar = _portBufferSlotVariables[slotIndex];
+        if (pVar == nullptr)
+        {
+            auto pModuleEmitter = GetModuleEmitter();
+            const auto& slot = _portBufferAllocator.GetSlot(slotIndex);
+            pVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, PortTypeToVariableType(slot.type), slot.size);
+            pModuleEmitter->AllocateVariable(*pVar);
+
+            auto slotSize = slot.size * GetPortElementSize(slot.type);
+            _portBufferStatistics.arenaSize += slotSize;
+            _portBufferStatistics.allocatedSize += slotSize;
+            ++_portBufferStatistics.numSlots;
+        }
+        return pVar;
+    }
+
+    void MapCompiler::RecordPortVariable(const OutputPortBase& port, bool isShared)
+    {
+        // Only the top-level map function's port variables are tracked
+        if (_portToVarMaps.size() != 1)
+        {
+            return;
+        }
+
+        auto portSize = port.Size() * GetPortElementSize(port.GetType());
+        _portBufferStatistics.naiveSize += portSize;
+        if (isShared)
+        {
+            ++_portBufferStatistics.numSharedPorts;
+        }
+        else
+        {
+            _portBufferStatistics.allocatedSize += portSize;
+        }
     }
 
     emitters::Variable* MapCompiler::AllocatePortVariable(const OutputPortBase& port)
@@ -74,10 +142,21 @@ namespace model
         auto pModuleEmitter = GetModuleEmitter();
         assert(port.Size() != 0);
 
+        if (_portToVarMaps.size() == 1 && _portBufferAllocator.HasSlot(port))
+        {
+            auto slotIndex = _portBufferAllocator.GetSlotIndex(port);
+            auto pVar = GetPortBufferSlotVariable(slotIndex);
+            _portBufferSlotOwners[pVar] = &port;
+            SetVariableForPort(port, pVar);
+            RecordPortVariable(port, true);
+            return pVar;
+        }
+
         emitters::VariableType varType = PortTypeToVariableType(port.GetType());
         auto pVar = pModuleEmitter->Variables().AddVectorVariable(emitters::VariableScope::global, varType, port.Size());
         pModuleEmitter->AllocateVariable(*pVar);
         SetVariableForPort(port, pVar);
+        RecordPortVariable(port, false);
         return pVar;
     }
 
@@ -164,9 +243,34 @@ namespace model
 
     void MapCompiler::SetVariableForPort(const Port& port, emitters::Variable* pVar)
     {
+        VerifyPortBufferAlias(port, pVar);
         _portToVarMaps.back()[&port] = pVar;
     }
 
+    void MapCompiler::VerifyPortBufferAlias(const Port& port, emitters::Variable* pVar)
+    {
+        if (_portToVarMaps.size() != 1 || _portBufferSlotOwners.empty())
+        {
+            return;
+        }
+
+        auto owner = _portBufferSlotOwners.find(pVar);
+        if (owner == _portBufferSlotOwners.end() || owner->second == &port)
+        {
+            return;
+        }
+
+        // A node is binding its output to a shared buffer owned by another port. This is only safe if
+        // the owner's buffer stays reserved for as long as the new port is read.
+        auto outputPort = dynamic_cast<const OutputPortBase*>(&port);
+        if (outputPort != nullptr && _portBufferAllocator.GetLastUse(*outputPort) > _portBufferAllocator.GetLastUse(*owner->second))
+        {
+            const Node* node = port.GetNode();
+            throw emitters::EmitterException(emitters::EmitterError::unexpected,
+                                             std::string("Port buffer reuse: output of node ") + node->GetRuntimeTypeName() + "(" + node->GetId().ToString() + ") aliases a shared buffer past its lifetime");
+        }
+    }
+
     void MapCompiler::SetVariableForElement(const PortElementBase& element, emitters::Variable* pVar)
     {
         SetVariableForPort(*element.ReferencedPort(), pVar);
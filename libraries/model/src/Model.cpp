@@ -8,6 +8,7 @@
 
 #include "Model.h"
 #include "InputPort.h"
+#include "ModelEditor.h"
 #include "Node.h"
 #include "Port.h"
 #include "SliceNode.h"
@@ -133,6 +134,12 @@ namespace model
         }
     }
 
+    size_t Model::GetRevision() const
+    {
+        // Both counts only increase, so the sum changes whenever either of them does
+        return _data->numNodesAdded + ModelEditor::GetInputPortResetCount();
+    }
+
     ForwardNodeIterator Model::GetNodeIterator() const
     {
         return GetNodeIterator(std::vector<const OutputPortBase*>{});
@@ -245,6 +252,7 @@ namespace model
         EnsureNodeHasUniqueId(*sharedNode);
         sharedNode->RegisterDependencies();
         _data->idToNodeMap[sharedNode->GetId()] = sharedNode;
+        ++_data->numNodesAdded;
         return sharedNode.get();
     }
 
@@ -8,16 +8,31 @@
 
 #include "ModelEditor.h"
 
+// stl
+#include <atomic>
+
 namespace ell
 {
 namespace model
 {
+namespace
+{
+    // Nodes don't know which model they belong to, so resets are counted for all models
+    std::atomic<size_t> inputPortResetCount{ 0 };
+}
+
 
 void ModelEditor::ResetInputPort(const InputPortBase* port, const OutputPortBase& newInput)
 {
     // Luckily nothing is ever really const in the codebase. If that changes, this is UB
     const_cast<InputPortBase*>(port)->SetInput(&newInput);
     port->GetNode()->RegisterDependencies();
+    ++inputPortResetCount;
+}
+
+size_t ModelEditor::GetInputPortResetCount()
+{
+    return inputPortResetCount;
 }
 
 }
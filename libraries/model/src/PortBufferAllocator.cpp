@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     PortBufferAllocator.cpp (model)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PortBufferAllocator.h"
+#include "InputPort.h"
+#include "Model.h"
+#include "Node.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cstdint>
+
+namespace ell
+{
+namespace model
+{
+    namespace
+    {
+        // A node with a single input and a single output of the same type and size may simply
+        // bind its output to its input's variable instead of emitting a copy (e.g., a same-type
+        // TypeCastNode). We treat such outputs as possible aliases of their inputs.
+        bool MayAliasInput(const Node& node)
+        {
+            const auto& inputs = node.GetInputPorts();
+            const auto& outputs = node.GetOutputPorts();
+            if (inputs.size() != 1 || outputs.size() != 1)
+            {
+                return false;
+            }
+
+            const auto& inputPort = inputs[0]->GetReferencedPort();
+            return inputPort.GetType() == outputs[0]->GetType() && inputPort.Size() == outputs[0]->Size();
+        }
+    }
+
+    PortBufferAllocator::PortBufferAllocator(const Model& model, std::function<bool(const OutputPortBase&)> isCandidate)
+    {
+        std::vector<const Node*> nodes;
+        model.Visit([&nodes](const Node& node) { nodes.push_back(&node); });
+
+        // Compute the lifetime of each output port: from the node that writes it to the last node that reads it
+        std::vector<const OutputPortBase*> candidates;
+        for (int nodeIndex = 0; nodeIndex < static_cast<int>(nodes.size()); ++nodeIndex)
+        {
+            const auto& node = *nodes[nodeIndex];
+            for (auto input : node.GetInputPorts())
+            {
+                auto& lifetime = _lifetimes[&input->GetReferencedPort()];
+                lifetime.lastUse = std::max(lifetime.lastUse, nodeIndex);
+            }
+
+            for (auto output : node.GetOutputPorts())
+            {
+                _lifetimes[output] = { nodeIndex, nodeIndex };
+                if (isCandidate(*output))
+                {
+                    candidates.push_back(output);
+                }
+            }
+        }
+
+        // Extend the lifetime of a port to cover the lifetime of any output that may alias it. Walking the
+        // nodes in reverse order makes this transitive over chains of aliasing nodes.
+        for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        {
+            const auto& node = **it;
+            if (MayAliasInput(node))
+            {
+                auto& inputLifetime = _lifetimes[&node.GetInputPorts()[0]->GetReferencedPort()];
+                inputLifetime.lastUse = std::max(inputLifetime.lastUse, _lifetimes[node.GetOutputPorts()[0]].lastUse);
+            }
+        }
+
+        // Greedily assign the candidate ports, in order of definition, to the best-fitting free slot
+        std::vector<int> slotBusyUntil;
+        for (auto port : candidates)
+        {
+            const auto& lifetime = _lifetimes[port];
+            const auto size = port->Size();
+
+            int bestFit = -1;
+            int largest = -1;
+            for (int slotIndex = 0; slotIndex < static_cast<int>(_slots.size()); ++slotIndex)
+            {
+                const auto& slot = _slots[slotIndex];
+                if (slot.type != port->GetType() || slotBusyUntil[slotIndex] >= lifetime.definition)
+                {
+                    continue;
+                }
+
+                if (slot.size >= size && (bestFit < 0 || slot.size < _slots[bestFit].size))
+                {
+                    bestFit = slotIndex;
+                }
+                if (largest < 0 || slot.size > _slots[largest].size)
+                {
+                    largest = slotIndex;
+                }
+            }
+
+            auto slotIndex = bestFit >= 0 ? bestFit : largest;
+            if (slotIndex < 0)
+            {
+                slotIndex = static_cast<int>(_slots.size());
+                _slots.push_back({ port->GetType(), 0 });
+                slotBusyUntil.push_back(0);
+            }
+
+            _slots[slotIndex].size = std::max(_slots[slotIndex].size, size);
+            slotBusyUntil[slotIndex] = lifetime.lastUse;
+            _portSlots[port] = static_cast<size_t>(slotIndex);
+        }
+    }
+
+    bool PortBufferAllocator::HasSlot(const OutputPortBase& port) const
+    {
+        return _portSlots.find(&port) != _portSlots.end();
+    }
+
+    size_t PortBufferAllocator::GetSlotIndex(const OutputPortBase& port) const
+    {
+        auto it = _portSlots.find(&port);
+        if (it == _portSlots.end())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port has not been assigned to a buffer slot");
+        }
+        return it->second;
+    }
+
+    int PortBufferAllocator::GetLastUse(const OutputPortBase& port) const
+    {
+        auto it = _lifetimes.find(&port);
+        return it == _lifetimes.end() ? -1 : it->second.lastUse;
+    }
+
+    size_t GetPortElementSize(Port::PortType type)
+    {
+        switch (type)
+        {
+            case Port::PortType::boolean:
+                return sizeof(uint8_t); // booleans are emitted as bytes
+            case Port::PortType::integer:
+                return sizeof(int32_t);
+            case Port::PortType::bigInt:
+                return sizeof(int64_t);
+            case Port::PortType::smallReal:
+                return sizeof(float);
+            case Port::PortType::real:
+                return sizeof(double);
+            default:
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Port type not supported");
+        }
+    }
+}
+}
@@ -79,6 +79,38 @@ namespace model
         }
     }
 
+    template <typename InputType, typename OutputType>
+    std::vector<OutputType> IRCompiledMap::ComputeBatch(const std::vector<InputType>& inputs, size_t count) const
+    {
+        if (!_compilerOptions.emitPredictBatchFunction)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Map wasn't compiled with a batch predict function");
+        }
+
+        if (GetNumInputs() != 1 || GetNumOutputs() != 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "ComputeBatch requires a map with a single input and output");
+        }
+
+        if (GetInput(0)->GetOutputPort().GetType() != Port::GetPortType<InputType>() || GetOutput(0).GetPortType() != Port::GetPortType<OutputType>())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch);
+        }
+
+        if (inputs.size() != count * GetInputSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "Batch input size must be count times the map's input size");
+        }
+
+        EnsureExecutionEngine();
+        auto functionPointer = _executionEngine->ResolveFunctionAddress(_functionName + "Batch");
+        auto fn = reinterpret_cast<void (*)(void*, int, const InputType*, OutputType*)>(functionPointer);
+
+        std::vector<OutputType> outputs(count * GetOutputSize());
+        fn(GetContext(), static_cast<int>(count), inputs.data(), outputs.data());
+        return outputs;
+    }
+
     template<typename ElementType>
     ElementType* IRCompiledMap::GetGlobalValuePointer(const std::string& name)
     {
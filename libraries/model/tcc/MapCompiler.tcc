@@ -29,6 +29,7 @@ namespace model
 
         pModuleEmitter->AllocateVariable(*pVar);
         SetVariableForPort(port, pVar);
+        RecordPortVariable(port, false);
         return pVar;
     }
 
@@ -38,7 +39,7 @@ namespace model
         emitters::Variable* pVar = GetVariableForPort(port);
         if (pVar == nullptr)
         {
-            pVar = AllocatePortVariable(port);
+            pVar = AllocatePortVariable(port, initialValue);
         }
         assert(pVar != nullptr);
         return pVar;
@@ -32,6 +32,7 @@ void TestL2NormSquaredNodeCompiled();
 void TestMatrixVectorProductNodeCompile();
 void TestCompilableBinaryOperationNode();
 void TestCompilableBinaryOperationNode2();
+void TestCompilableVectorizedElementwiseNodes(int vectorWidth);
 void TestCompilableScalarBinaryPredicateNode();
 void TestCompilableBinaryPredicateNode();
 void TestCompilableMultiplexerNode();
@@ -50,6 +51,7 @@ void TestMultipleOutputNodes();
 void TestShapeFunctionGeneration();
 void TestCompilableClockNode();
 void TestCompilableFFTNode();
+void TestCompilableDCTNode(size_t numFilters, size_t windowSize);
 
 //
 // mathy nodes
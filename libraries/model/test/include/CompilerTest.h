@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Map.h"
+#include "MapCompilerOptions.h"
 
 // stl
 #include <string>
@@ -43,5 +44,11 @@ void TestCombineOutputMap();
 void TestMultiOutputMap();
 void TestMultiSourceSinkMap();
 void TestCompiledMapMove();
+void TestReusePortBuffers();
+void TestPredictBatchFunction();
+void TestParallelizeNodes();
+void TestParallelizeConvolutionNodes();
+void TestForestLowering(ell::model::ForestLoweringStrategy strategy);
+void TestJitCache();
 
 #include "../tcc/CompilerTest.tcc"
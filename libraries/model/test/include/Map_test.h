@@ -10,6 +10,8 @@
 void TestMapCreate();
 void TestMapCompute();
 void TestMapComputeDataVector();
+void TestMapComputePlan();
+void TestMapComputePlanAfterResetInputPort();
 void TestMapRefine();
 void TestMapSerialization();
 void TestMapClockNode();
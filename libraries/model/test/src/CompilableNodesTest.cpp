@@ -38,9 +38,11 @@
 #include "BiasLayerNode.h"
 #include "BinaryOperationNode.h"
 #include "BinaryPredicateNode.h"
+#include "BroadcastFunctionNode.h"
 #include "ClockNode.h"
 #include "ConcatenationNode.h"
 #include "ConstantNode.h"
+#include "DCTNode.h"
 #include "DTWDistanceNode.h"
 #include "DelayNode.h"
 #include "DotProductNode.h"
@@ -101,6 +103,7 @@
 // stl
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -461,6 +464,48 @@ void TestCompilableBinaryOperationNode2()
     VerifyCompiledOutput(map, compiledMap, signal, "BinaryOperationNode");
 }
 
+void TestCompilableVectorizedElementwiseNodes(int vectorWidth)
+{
+    using ElementType = float;
+    const int numRows = 3;
+    const int numColumns = 3;
+    const int numChannels = 7; // not a multiple of any vector width, to exercise the epilogue loops
+    model::PortMemoryLayout layout(model::MemoryShape{ numRows, numColumns, numChannels });
+    const int size = layout.GetMemorySize();
+
+    std::vector<ElementType> weights(size);
+    std::iota(weights.begin(), weights.end(), 1.0f);
+    std::vector<ElementType> scale = { 1, 2, 3, 4, 5, 6, 7 };
+    std::vector<ElementType> bias = { 7, 6, 5, 4, 3, 2, 1 };
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(size);
+    auto weightsNode = model.AddNode<nodes::ConstantNode<ElementType>>(weights);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<ElementType>>(inputNode->output, weightsNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto squareNode = model.AddNode<nodes::UnaryOperationNode<ElementType>>(multiplyNode->output, emitters::UnaryOperationType::square);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<ElementType>>(squareNode->output, emitters::UnaryOperationType::sqrt);
+    auto scaleNode = model.AddNode<nodes::ConstantNode<ElementType>>(scale);
+    auto biasNode = model.AddNode<nodes::ConstantNode<ElementType>>(bias);
+    auto linearNode = model.AddNode<nodes::BroadcastLinearFunctionNode<ElementType>>(sqrtNode->output, layout, scaleNode->output, biasNode->output, 2, layout);
+    auto sumNode = model.AddNode<nodes::SumNode<ElementType>>(linearNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", sumNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.allowVectorInstructions = true;
+    settings.compilerSettings.vectorWidth = vectorWidth;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    std::vector<std::vector<ElementType>> signal;
+    for (int index = 0; index < 4; ++index)
+    {
+        std::vector<ElementType> input(size);
+        std::iota(input.begin(), input.end(), static_cast<ElementType>(index - 2));
+        signal.push_back(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, "Vectorized elementwise nodes (vectorWidth = " + std::to_string(vectorWidth) + ")");
+}
+
 // Problem: memory corruption for BinaryPredicateNode (probably because of bool foolishness)
 void TestCompilableScalarBinaryPredicateNode()
 {
@@ -1184,6 +1229,34 @@ void TestCompilableFFTNode()
     VerifyCompiledOutput(map, compiledMap, signal, "FFTNode");
 }
 
+void TestCompilableDCTNode(size_t numFilters, size_t windowSize)
+{
+    using ValueType = float;
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(windowSize);
+    auto dctNode = model.AddNode<nodes::DCTNode<ValueType>>(inputNode->output, numFilters);
+
+    std::vector<std::vector<ValueType>> signal;
+    for (int iter = 0; iter < 3; ++iter)
+    {
+        std::vector<ValueType> input(windowSize);
+        for (size_t index = 0; index < windowSize; ++index)
+        {
+            input[index] = std::sin(static_cast<ValueType>((iter + 1) * index) / 3) + static_cast<ValueType>(index % 5) / 5;
+        }
+        signal.push_back(input);
+    }
+
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", dctNode->output } });
+    model::MapCompilerOptions settings;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // compare output
+    auto method = dsp::ShouldUseFastDCT(numFilters, windowSize) ? "FFT" : "matrix";
+    VerifyCompiledOutput(map, compiledMap, signal, std::string("DCTNode (") + method + ", " + std::to_string(numFilters) + " x " + std::to_string(windowSize) + ")");
+}
+
 class BinaryFunctionIRNode : public nodes::IRNode
 {
 public:
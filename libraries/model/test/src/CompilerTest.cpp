@@ -18,8 +18,10 @@
 
 // nodes
 #include "AccumulatorNode.h"
+#include "BinaryOperationNode.h"
 #include "ClockNode.h"
 #include "ConstantNode.h"
+#include "ConvolutionalLayerNode.h"
 #include "DelayNode.h"
 #include "DotProductNode.h"
 #include "ForestPredictorNode.h"
@@ -31,6 +33,7 @@
 #include "SourceNode.h"
 #include "SquaredEuclideanDistanceNode.h"
 #include "SumNode.h"
+#include "UnaryOperationNode.h"
 
 // emitters
 #include "EmitterException.h"
@@ -46,13 +49,20 @@
 #include "LinearPredictor.h"
 #include "ProtoNNPredictor.h"
 
+// predictors/neural
+#include "ConvolutionalLayer.h"
+
 // utilities
+#include "Files.h"
 #include "Logger.h"
 
 // testing
 #include "testing.h"
 
 // stl
+#include <array>
+#include <cstdio>
+#include <functional>
 #include <iostream>
 #include <ostream>
 #include <string>
@@ -114,6 +124,44 @@ model::Map MakeForestMap()
     return { model, { { "input", inputNode } }, { { "output", forestNode->output } } };
 }
 
+// A forest with one complete tree of the given depth. Each level splits one of the 3 features at the middle of the range of values
+// that reach the node, so every leaf is reachable. Trees deeper than 6 have more leaves than QuickScorer handles.
+model::Map MakeDeepForestMap(int depth)
+{
+    // define some abbreviations
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+    using SplittableNodeId = predictors::SimpleForestPredictor::SplittableNodeId;
+    using Range = std::array<double, 3>;
+
+    // build a forest
+    predictors::SimpleForestPredictor forest;
+    std::function<void(SplittableNodeId, int, Range, Range)> splitNode;
+    splitNode = [&](SplittableNodeId nodeId, int level, Range low, Range high) {
+        const size_t feature = level % 3;
+        const double threshold = (low[feature] + high[feature]) / 2;
+        auto nodeIndex = forest.Split(SplitAction{ nodeId, SplitRule{ feature, threshold }, EdgePredictorVector{ -threshold - level, threshold + level } });
+        if (level + 1 < depth)
+        {
+            auto leftHigh = high;
+            leftHigh[feature] = threshold;
+            auto rightLow = low;
+            rightLow[feature] = threshold;
+            splitNode(forest.GetChildId(nodeIndex, 0), level + 1, low, leftHigh);
+            splitNode(forest.GetChildId(nodeIndex, 1), level + 1, rightLow, high);
+        }
+    };
+    splitNode(forest.GetNewRootId(), 0, { 0.0, 0.0, 0.0 }, { 1.0, 1.0, 1.0 });
+
+    // build the model
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto forestNode = model.AddNode<nodes::SimpleForestPredictorNode>(inputNode->output, forest);
+
+    return { model, { { "input", inputNode } }, { { "output", forestNode->output } } };
+}
+
 //
 // Tests
 //
@@ -314,6 +362,252 @@ void TestCompiledMapMove()
     VerifyCompiledOutput(map, compiledMap2, signal, " moved compiled map");
 }
 
+void TestReusePortBuffers()
+{
+    // A chain of nodes where each intermediate result is dead once the next one has been computed
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(8);
+    auto squareNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::square);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(squareNode->output, emitters::UnaryOperationType::sqrt);
+    auto squareNode2 = model.AddNode<nodes::UnaryOperationNode<double>>(sqrtNode->output, emitters::UnaryOperationType::square);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(squareNode2->output, inputNode->output, emitters::BinaryOperationType::add);
+    auto sqrtNode2 = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::sqrt);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<double>>(sqrtNode2->output, sqrtNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.reusePortBuffers = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of map with shared port buffers", testing::IsEqual(compiledMap.IsValid(), true));
+
+    const auto& statistics = compiler.GetPortBufferStatistics();
+    testing::ProcessTest("Testing port buffers are shared", statistics.numSharedPorts > 0 && statistics.numSlots < statistics.numSharedPorts);
+    testing::ProcessTest("Testing shared port buffers use less memory", statistics.allocatedSize < statistics.naiveSize);
+
+    // compare output
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4, 5, 6, 7, 8 }, { 4, 5, 6, 7, 8, 9, 1, 2 }, { 7, 8, 9, 3, 4, 5, 2, 3 } };
+    VerifyCompiledOutput(map, compiledMap, signal, " map with shared port buffers");
+}
+
+void TestPredictBatchFunction()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    auto squareNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::square);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(squareNode->output, inputNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.emitPredictBatchFunction = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing batch predict function is emitted", compiledMap.GetModule().GetFunction(settings.mapFunctionName + "Batch") != nullptr);
+
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 5, 6, 7 }, { 7, 8, 9, 3 } };
+    std::vector<double> batchInput;
+    std::vector<double> expectedOutput;
+    for (const auto& input : signal)
+    {
+        batchInput.insert(batchInput.end(), input.begin(), input.end());
+        auto output = map.Compute<double>(input);
+        expectedOutput.insert(expectedOutput.end(), output.begin(), output.end());
+    }
+
+    auto batchOutput = compiledMap.ComputeBatch<double, double>(batchInput, signal.size());
+    testing::ProcessTest("Testing batch predict function output", testing::IsEqual(batchOutput, expectedOutput));
+}
+
+void TestParallelizeNodes()
+{
+    // Two independent branches, joined by an add node, followed by another pair of branches
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(16);
+    auto squareNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::square);
+    auto sqrtNode = model.AddNode<nodes::UnaryOperationNode<double>>(squareNode->output, emitters::UnaryOperationType::sqrt);
+    auto sinNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::sin);
+    auto cosNode = model.AddNode<nodes::UnaryOperationNode<double>>(sinNode->output, emitters::UnaryOperationType::cos);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(sqrtNode->output, cosNode->output, emitters::BinaryOperationType::add);
+    auto squareNode2 = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::square);
+    auto tanhNode = model.AddNode<nodes::UnaryOperationNode<double>>(addNode->output, emitters::UnaryOperationType::tanh);
+    auto multiplyNode = model.AddNode<nodes::BinaryOperationNode<double>>(squareNode2->output, tanhNode->output, emitters::BinaryOperationType::coordinatewiseMultiply);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", multiplyNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.parallelizeNodes = true;
+    settings.compilerSettings.parallelize = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of map with concurrent branches", testing::IsEqual(compiledMap.IsValid(), true));
+    testing::ProcessTest("Testing branch task functions are emitted", compiledMap.GetModule().GetFunction(settings.mapFunctionName + "_branch0") != nullptr);
+
+    std::vector<std::vector<double>> signal;
+    for (int sample = 0; sample < 3; ++sample)
+    {
+        std::vector<double> input;
+        for (int index = 0; index < 16; ++index)
+        {
+            input.push_back((sample + 1) * (index - 8) / 4.0);
+        }
+        signal.push_back(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, " map with concurrent branches");
+}
+
+void TestParallelizeConvolutionNodes()
+{
+    // Two convolution branches, whose compiled code runs ParallelFor loops on the thread pool, joined by an add node
+    using ElementType = double;
+    using LayerParameters = typename predictors::neural::Layer<ElementType>::LayerParameters;
+    using TensorType = typename predictors::neural::Layer<ElementType>::TensorType;
+    using Shape = typename predictors::neural::Layer<ElementType>::Shape;
+
+    const size_t numRows = 6;
+    const size_t numColumns = 6;
+    const size_t numChannels = 2;
+    const size_t numFilters = 4;
+    const size_t filterSize = 3;
+    TensorType inputWithPadding(numRows + 2, numColumns + 2, numChannels);
+    Shape outputShape = { numRows, numColumns, numFilters };
+    LayerParameters parameters{ inputWithPadding, predictors::neural::ZeroPadding(1), outputShape, predictors::neural::NoPadding() };
+    predictors::neural::ConvolutionalParameters convolutionalParams{ filterSize, 1, predictors::neural::ConvolutionMethod::simple, 1 };
+
+    TensorType weights1(filterSize * numFilters, filterSize, numChannels);
+    TensorType weights2(filterSize * numFilters, filterSize, numChannels);
+    for (size_t i = 0; i < filterSize * numFilters; ++i)
+    {
+        for (size_t j = 0; j < filterSize; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                weights1(i, j, k) = static_cast<ElementType>((i + 2 * j + 3 * k) % 5) - 2;
+                weights2(i, j, k) = static_cast<ElementType>((3 * i + j + k) % 7) / 4;
+            }
+        }
+    }
+    predictors::neural::ConvolutionalLayer<ElementType> layer1(parameters, convolutionalParams, weights1);
+    predictors::neural::ConvolutionalLayer<ElementType> layer2(parameters, convolutionalParams, weights2);
+
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<ElementType>>(inputWithPadding.Size());
+    auto convNode1 = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer1);
+    auto convNode2 = model.AddNode<nodes::ConvolutionalLayerNode<ElementType>>(inputNode->output, layer2);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<ElementType>>(convNode1->output, convNode2->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+
+    model::MapCompilerOptions settings;
+    settings.parallelizeNodes = true;
+    settings.compilerSettings.parallelize = true;
+    settings.compilerSettings.useThreadPool = true;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    testing::ProcessTest("Testing IsValid of map with concurrent convolution branches", testing::IsEqual(compiledMap.IsValid(), true));
+
+    std::vector<std::vector<ElementType>> signal;
+    for (int sample = 0; sample < 3; ++sample)
+    {
+        std::vector<ElementType> input(inputWithPadding.Size());
+        for (size_t index = 0; index < input.size(); ++index)
+        {
+            input[index] = static_cast<ElementType>((sample + 1) * (static_cast<int>(index % 11) - 5)) / 4;
+        }
+        signal.push_back(input);
+    }
+    VerifyCompiledOutput(map, compiledMap, signal, " map with concurrent convolution branches");
+}
+
+void VerifyForestLowering(const model::Map& map, const std::vector<std::vector<double>>& signal, model::ForestLoweringStrategy strategy, const std::string& name)
+{
+    auto forestNode = map.GetModel().GetNodesByType<nodes::SimpleForestPredictorNode>()[0];
+    auto treeOutputsMap = model::Map(map.GetModel(), { { "input", map.GetInput(0) } }, { { "treeOutputs", forestNode->treeOutputs } });
+    auto edgeIndicatorMap = model::Map(map.GetModel(), { { "input", map.GetInput(0) } }, { { "edgeIndicator", forestNode->edgeIndicatorVector } });
+
+    model::MapCompilerOptions settings;
+    settings.forestLowering = strategy;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    model::IRMapCompiler treeOutputsCompiler(settings);
+    auto compiledTreeOutputsMap = treeOutputsCompiler.Compile(treeOutputsMap);
+    model::IRMapCompiler edgeIndicatorCompiler(settings);
+    auto compiledEdgeIndicatorMap = edgeIndicatorCompiler.Compile(edgeIndicatorMap);
+
+    std::string strategyName = " " + name + " (lowering strategy " + std::to_string(static_cast<int>(strategy)) + ")";
+    testing::ProcessTest("Testing IsValid of" + strategyName, testing::IsEqual(compiledMap.IsValid(), true));
+    VerifyCompiledOutput(map, compiledMap, signal, strategyName);
+    VerifyCompiledOutput(treeOutputsMap, compiledTreeOutputsMap, signal, " tree outputs of" + strategyName);
+    VerifyCompiledOutput(edgeIndicatorMap, compiledEdgeIndicatorMap, signal, " edge indicator vector of" + strategyName);
+}
+
+void TestForestLowering(model::ForestLoweringStrategy strategy)
+{
+    // inputs that reach every leaf of both trees, including values equal to the thresholds
+    std::vector<std::vector<double>> signal = { { 0.1, 0.1, 0.1 }, { 0.1, 0.5, 0.1 }, { 0.25, 0.65, 0.1 }, { 0.3, 0.8, 0.1 }, { 0.5, 0.2, 0.5 }, { 0.5, 0.21, 0.95 }, { 0.2, 0.4, 0.9 }, { 0.9, 0.9, 0.9 } };
+    VerifyForestLowering(MakeForestMap(), signal, strategy, "forest map");
+
+    // A tree with 128 leaves, which QuickScorer compiles with the flattened walk instead
+    std::vector<std::vector<double>> deepSignal;
+    for (int index = 0; index < 64; ++index)
+    {
+        deepSignal.push_back({ ((index * 37) % 64 + 0.5) / 64, ((index * 11) % 64 + 0.5) / 64, ((index * 23) % 64 + 0.5) / 64 });
+    }
+    deepSignal.push_back({ 0.5, 0.5, 0.5 });
+    VerifyForestLowering(MakeDeepForestMap(7), deepSignal, strategy, "deep forest map");
+}
+
+void TestJitCache()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(4);
+    auto squareNode = model.AddNode<nodes::UnaryOperationNode<double>>(inputNode->output, emitters::UnaryOperationType::square);
+    auto addNode = model.AddNode<nodes::BinaryOperationNode<double>>(squareNode->output, inputNode->output, emitters::BinaryOperationType::add);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", addNode->output } });
+    std::vector<std::vector<double>> signal = { { 1, 2, 3, 4 }, { 4, 5, 6, 7 }, { 7, 8, 9, 3 } };
+
+    model::MapCompilerOptions settings;
+    settings.jitCacheDirectory = utilities::JoinPaths(utilities::GetWorkingDirectory(), "jit_cache_test");
+    model::IRMapCompiler compiler(settings);
+    auto key = compiler.GetJitCacheKey(map);
+    auto objectPath = utilities::JoinPaths(settings.jitCacheDirectory, key + ".o");
+    std::remove(objectPath.c_str());
+
+    // The first compile generates the object code and stores it in the cache
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.FinishJitting();
+    testing::ProcessTest("Testing jitted code is stored in the JIT cache", utilities::FileExists(objectPath));
+    VerifyCompiledOutput(map, compiledMap, signal, " map stored in the JIT cache");
+
+    // The second compile loads it from the cache
+    model::IRMapCompiler cachedCompiler(settings);
+    testing::ProcessTest("Testing JIT cache key is stable", testing::IsEqual(cachedCompiler.GetJitCacheKey(map), key));
+    auto cachedMap = cachedCompiler.Compile(map);
+    VerifyCompiledOutput(map, cachedMap, signal, " map loaded from the JIT cache");
+
+    // Different compiler options must use a different key
+    auto otherSettings = settings;
+    otherSettings.compilerSettings.optimize = false;
+    model::IRMapCompiler otherCompiler(otherSettings);
+    testing::ProcessTest("Testing JIT cache key depends on the compiler options", otherCompiler.GetJitCacheKey(map) != key);
+    auto reportSettings = settings;
+    reportSettings.compilerSettings.reportOptimizationPasses = true;
+    testing::ProcessTest("Testing JIT cache key depends on optimization pass reporting", model::IRMapCompiler(reportSettings).GetJitCacheKey(map) != key);
+
+    // Autotuned compiles depend on the contents of the tuning database, not just its name
+    auto tuningSettings = settings;
+    tuningSettings.optimizerSettings.preferredConvolutionMethod = model::PreferredConvolutionMethod::autotune;
+    tuningSettings.optimizerSettings.convolutionTuningDatabase = utilities::JoinPaths(settings.jitCacheDirectory, "tuning_database_test.json");
+    utilities::OpenOfstream(tuningSettings.optimizerSettings.convolutionTuningDatabase) << "1";
+    auto tuningKey = model::IRMapCompiler(tuningSettings).GetJitCacheKey(map);
+    utilities::OpenOfstream(tuningSettings.optimizerSettings.convolutionTuningDatabase) << "2";
+    testing::ProcessTest("Testing JIT cache key depends on the tuning database contents", model::IRMapCompiler(tuningSettings).GetJitCacheKey(map) != tuningKey);
+
+    std::remove(tuningSettings.optimizerSettings.convolutionTuningDatabase.c_str());
+    std::remove(objectPath.c_str());
+}
+
 typedef void (*MapPredictFunction)(void* context, double*, double*);
 
 void TestBinaryVector(bool expanded, bool runJit)
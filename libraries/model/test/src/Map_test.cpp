@@ -16,11 +16,13 @@
 #include "Map.h"
 #include "InputNode.h"
 #include "Model.h"
+#include "ModelEditor.h"
 #include "OutputNode.h"
 #include "PortElements.h"
 
 // nodes
 #include "ClockNode.h"
+#include "ConstantNode.h"
 #include "ExtremalValueNode.h"
 #include "MovingAverageNode.h"
 #include "SinkNode.h"
@@ -108,6 +110,64 @@ void TestMapComputeDataVector()
     testing::ProcessTest("Testing map compute 2", testing::IsEqual(resultValues[0], 8.5) && testing::IsEqual(resultValues[1], 10.5));
 }
 
+void TestMapComputePlan()
+{
+    auto model = GetSimpleModel();
+    auto inputNodes = model.GetNodesByType<model::InputNode<double>>();
+    auto outputNodes = model.GetNodesByType<model::OutputNode<double>>();
+    assert(outputNodes.size() == 1);
+    auto map = model::Map(model, { { "doubleInput", inputNodes[0] } }, { { "doubleOutput", outputNodes[0]->output } });
+
+    auto input = std::vector<std::vector<double>>{ { 1.0, 2.0, 3.0 },
+                                                   { 4.0, 5.0, 6.0 },
+                                                   { 7.0, 8.0, 9.0 },
+                                                   { 10.0, 11.0, 12.0 } };
+
+    // Compare each step of the map, which reuses its execution plan, with computing the original model directly
+    bool ok = true;
+    for (const auto& inVec : input)
+    {
+        inputNodes[0]->SetInput(inVec);
+        map.SetInputValue("doubleInput", inVec);
+        ok = ok && testing::IsEqual(map.ComputeOutput<double>("doubleOutput"), model.ComputeOutput(outputNodes[0]->output));
+    }
+    testing::ProcessTest("Testing map compute with execution plan", ok);
+
+    // Refining the map replaces its model, so the plan must be rebuilt. The refined nodes start with no state, so compare
+    // with a new copy of the original model.
+    map.Refine();
+    map.Reset();
+    auto referenceModel = GetSimpleModel();
+    auto referenceInputNode = referenceModel.GetNodesByType<model::InputNode<double>>()[0];
+    auto referenceOutputNode = referenceModel.GetNodesByType<model::OutputNode<double>>()[0];
+    ok = true;
+    for (const auto& inVec : input)
+    {
+        referenceInputNode->SetInput(inVec);
+        map.SetInputValue("doubleInput", inVec);
+        ok = ok && testing::IsEqual(map.ComputeOutput<double>("doubleOutput"), referenceModel.ComputeOutput(referenceOutputNode->output));
+    }
+    testing::ProcessTest("Testing map compute with execution plan after refine", ok);
+}
+
+void TestMapComputePlanAfterResetInputPort()
+{
+    model::Model model;
+    auto inputNode = model.AddNode<model::InputNode<double>>(3);
+    auto outputNode = model.AddNode<model::OutputNode<double>>(inputNode->output);
+    auto map = model::Map(model, { { "input", inputNode } }, { { "output", outputNode->output } });
+
+    // Add the new input before computing, so that resetting the port doesn't change the number of nodes
+    auto constantNode = map.GetModel().AddNode<nodes::ConstantNode<double>>(std::vector<double>{ 10.0, 20.0, 30.0 });
+    map.SetInputValue("input", std::vector<double>{ 1.0, 2.0, 3.0 });
+    bool ok = testing::IsEqual(map.ComputeOutput<double>("output"), std::vector<double>{ 1.0, 2.0, 3.0 });
+
+    auto mapOutputNode = map.GetModel().GetNodesByType<model::OutputNode<double>>()[0];
+    model::ModelEditor::ResetInputPort(&mapOutputNode->input, constantNode->output);
+    ok = ok && testing::IsEqual(map.ComputeOutput<double>("output"), std::vector<double>{ 10.0, 20.0, 30.0 });
+    testing::ProcessTest("Testing map compute with execution plan after ResetInputPort", ok);
+}
+
 void TestMapRefine()
 {
     auto model = GetSimpleModel();
@@ -55,6 +55,8 @@ int main()
         TestMapCreate();
         TestMapCompute();
         TestMapComputeDataVector();
+        TestMapComputePlan();
+        TestMapComputePlanAfterResetInputPort();
         TestMapRefine();
         TestMapSerialization();
         TestMapClockNode();
@@ -42,6 +42,14 @@ void TestIRCompiler()
     TestSimpleMap(false);
     TestSimpleMap(true);
     TestCompiledMapMove();
+    TestReusePortBuffers();
+    TestPredictBatchFunction();
+    TestParallelizeNodes();
+    TestParallelizeConvolutionNodes();
+    TestForestLowering(model::ForestLoweringStrategy::branching);
+    TestForestLowering(model::ForestLoweringStrategy::flattened);
+    TestForestLowering(model::ForestLoweringStrategy::quickScorer);
+    TestJitCache();
     TestBinaryScalar();
     TestBinaryVector(true);
     TestBinaryVector(false);
@@ -100,6 +108,8 @@ void TestIRCompiler()
     TestCompilableUnaryOperationNode();
     TestCompilableBinaryOperationNode();
     TestCompilableBinaryOperationNode2();
+    TestCompilableVectorizedElementwiseNodes(0); // derived from the target device
+    TestCompilableVectorizedElementwiseNodes(16);
     TestCompilableScalarBinaryPredicateNode();
     TestCompilableBinaryPredicateNode();
     TestCompilableMultiplexerNode();
@@ -118,6 +128,10 @@ void TestIRCompiler()
     TestCompilableSinkNode();
     TestCompilableClockNode();
     TestCompilableFFTNode();
+    TestCompilableDCTNode(13, 64); // FFT
+    TestCompilableDCTNode(64, 64); // FFT, with coefficients past N/2
+    TestCompilableDCTNode(4, 64); // matrix
+    TestCompilableDCTNode(13, 40); // matrix
 
     TestPerformanceCounters();
     TestCompilableDotProductNode2<float>(3); // uses IR
@@ -19,6 +19,7 @@
 
 // emitters
 #include "EmitterTypes.h"
+#include "IRVectorUtilities.h"
 #include "LLVMUtilities.h"
 
 // utilities
@@ -29,6 +30,7 @@
 
 // stl
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -343,9 +343,10 @@ namespace nodes
         using BroadcastFunctionNode<ValueType, FunctionType>::GetBroadcastDimension;
         using BroadcastFunctionNode<ValueType, FunctionType>::NumPrimaryInputDimensions;
 
-    protected:
+        /// <summary> Gets the function applied to each element. </summary>
         using BroadcastFunctionNode<ValueType, FunctionType>::GetFunction;
 
+    protected:
         utilities::ArchiveVersion GetArchiveVersion() const override;
         bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
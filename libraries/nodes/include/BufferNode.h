@@ -79,8 +79,9 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
 
-        // Buffer
+        // Buffer, used as a ring whose oldest sample is at _position
         mutable std::vector<ValueType> _samples;
+        mutable size_t _position = 0;
         size_t _windowSize;
     };
 }
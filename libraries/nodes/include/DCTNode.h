@@ -8,6 +8,9 @@
 
 #pragma once
 
+// dsp
+#include "DCT.h"
+
 // model
 #include "CompilableNode.h"
 #include "IRMapCompiler.h"
@@ -27,6 +30,7 @@
 
 // stl
 #include <cmath>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,12 +38,16 @@ namespace ell
 {
 namespace nodes
 {
-    /// <summary> A node that performs a real-valued discrete cosine transform (DCT) on its input </summary>
+    /// <summary>
+    /// A node that performs a real-valued discrete cosine transform (DCT) on its input. When `dsp::ShouldUseFastDCT`
+    /// says so, the node computes the DCT with an FFT and compiles itself to code that does the same; otherwise it
+    /// multiplies by the DCT matrix, and refines itself into a matrix-vector product.
+    /// </summary>
     ///
     /// <typeparam name="ValueType"> The element type. </typeparam>
     ///
     template <typename ValueType>
-    class DCTNode : public model::Node
+    class DCTNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -67,15 +75,20 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Indicates if this node is able to compile itself to code. </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override { return _dctPlan != nullptr; }
+
     protected:
         void Compute() const override;
         bool Refine(model::ModelTransformer& transformer) const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
         bool HasState() const override { return true; } // Stored state: size
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
+        void SetDCTSize(size_t numFilters);
 
         // Inputs
         model::InputPort<ValueType> _input;
@@ -83,8 +96,11 @@ namespace nodes
         // Output
         model::OutputPort<ValueType> _output;
 
-        // DCT Matrix
+        // DCT Matrix, if the DCT is computed with it
         math::RowMatrix<ValueType> _dctCoeffs;
+
+        // DCT plan, if the DCT is computed with an FFT
+        std::unique_ptr<dsp::DCTPlan<ValueType>> _dctPlan;
     };
 }
 }
@@ -8,6 +8,9 @@
 
 #pragma once
 
+// dsp
+#include "FFT.h"
+
 // emitters
 #include "LLVMUtilities.h"
 
@@ -63,6 +66,22 @@ namespace nodes
         /// <returns> The name of this type. </returns>
         std::string GetRuntimeTypeName() const override { return GetTypeName(); }
 
+        /// <summary> Gets the function, emitting it if necessary, that computes the complex FFT of a plan in place. </summary>
+        ///
+        /// <param name="moduleEmitter"> The module to emit the function in. </param>
+        /// <param name="plan"> The plan of the FFT. </param>
+        ///
+        /// <returns> A function taking a pointer to the interleaved real and imaginary parts of the `plan.Size()` complex values. </returns>
+        static emitters::LLVMFunction GetFFTFunction(emitters::IRModuleEmitter& moduleEmitter, const dsp::FFTPlan<ValueType>& plan);
+
+        /// <summary> Emits code that computes the first N/2 + 1 entries of the spectrum of a real-valued signal of length N. </summary>
+        ///
+        /// <param name="function"> The function to emit the code in. </param>
+        /// <param name="plan"> The plan of the real-valued FFT. </param>
+        /// <param name="signal"> Pointer to the N values of the signal, which are left unchanged. </param>
+        /// <param name="spectrum"> Pointer to the N + 2 interleaved real and imaginary parts of the result. </param>
+        static void EmitRealFFT(emitters::IRFunctionEmitter& function, const dsp::RealFFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum);
+
     protected:
         void Compute() const override;
         void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
@@ -73,23 +92,8 @@ namespace nodes
     private:
         void Copy(model::ModelTransformer& transformer) const override;
 
-        // Emitting IR for FFT implemenations
-        void EmitFFT_2(emitters::IRFunctionEmitter& function, emitters::LLVMValue input);
-        void EmitFFT_4(emitters::IRFunctionEmitter& function, emitters::LLVMValue input);
-        void EmitFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch);
-        void EmitRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput);
-
-        // Getting FFT functions
-        emitters::LLVMFunction GetRealFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
-        emitters::LLVMFunction GetFFTFunction(emitters::IRModuleEmitter& moduleEmitter, size_t length);
-
-        // Hand-unrolled fixed-size versions
-        emitters::LLVMFunction GetFFTFunction_2(emitters::IRModuleEmitter& moduleEmitter);
-        emitters::LLVMFunction GetFFTFunction_4(emitters::IRModuleEmitter& moduleEmitter);
-
-        // Performing FFT (either by calling a function or emitting inline code)
-        void DoFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch);
-        void DoRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput);
+        // Emitting IR for the FFT plan
+        static void EmitFFT(emitters::IRFunctionEmitter& function, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal);
 
         // Inputs
         model::InputPort<ValueType> _input;
@@ -9,6 +9,9 @@
 #pragma once
 
 // model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "MapCompilerOptions.h"
 #include "Model.h"
 #include "ModelTransformer.h"
 #include "Node.h"
@@ -18,19 +21,28 @@
 #include "ForestPredictor.h"
 #include "SingleElementThresholdPredictor.h"
 
+// emitters
+#include "IRFunctionEmitter.h"
+
 // stl
 #include <string>
+#include <vector>
 
 namespace ell
 {
 namespace nodes
 {
-    /// <summary> Implements a forest node, which wraps the forest predictor. </summary>
+    /// <summary>
+    /// Implements a forest node, which wraps the forest predictor. By default, the node is refined into a dataflow
+    /// model that evaluates every split of every tree. When the map compiler's `forestLowering` option selects another
+    /// strategy, forests with single-element threshold splits and constant edge predictors compile directly to code
+    /// that only visits the splits each input reaches.
+    /// </summary>
     ///
     /// <typeparam name="SplitRuleType"> The split rule type. </typeparam>
     /// <typeparam name="EdgePredictorType"> The edge predictor type. </typeparam>
     template <typename SplitRuleType, typename EdgePredictorType>
-    class ForestPredictorNode : public model::Node
+    class ForestPredictorNode : public model::CompilableNode
     {
     public:
         /// @name Input and Output Ports
@@ -67,14 +79,22 @@ namespace nodes
         /// <summary> Refines this node in the model being constructed by the transformer </summary>
         bool Refine(model::ModelTransformer& transformer) const override;
 
+        /// <summary> Indicates if this node is able to compile itself to code. </summary>
+        bool IsCompilable(const model::MapCompiler* compiler) const override;
+
     protected:
         void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
         void WriteToArchive(utilities::Archiver& archiver) const override;
         void ReadFromArchive(utilities::Unarchiver& archiver) override;
 
     private:
         void Copy(model::ModelTransformer& transformer) const override;
 
+        void CompileBranching(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator);
+        void CompileFlattened(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator);
+        void CompileQuickScorer(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator);
+
         // Input
         model::InputPort<double> _input;
 
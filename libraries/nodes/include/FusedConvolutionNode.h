@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedConvolutionNode.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// math
+#include "Tensor.h"
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "ModelTransformer.h"
+#include "OutputPort.h"
+#include "PortMemoryLayout.h"
+
+// predictors
+#include "Activation.h"
+
+// utilities
+#include "ArchiveVersion.h"
+#include "TypeName.h"
+
+// stl
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A convolution with a per-channel bias and an activation function applied in its output loop, so the
+    /// whole computation makes a single pass over the output memory. Created by `FuseConvolutionOperationsPass`
+    /// from a chain of convolution, bias, batch normalization, and activation nodes.
+    /// </summary>
+    template <typename ValueType>
+    class FusedConvolutionNode : public model::CompilableNode
+    {
+    public:
+        using TensorType = math::ChannelColumnRowTensor<ValueType>;
+        using ConstTensorReferenceType = math::ConstChannelColumnRowTensorReference<ValueType>;
+
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default constructor. </summary>
+        FusedConvolutionNode();
+
+        /// <summary> Constructor for a fused convolution without an activation function. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="filterWeights"> The weights for the convolutional filters. Stored
+        ///  as a 3D tensor of dimensions (nf*fw) x fw x d, where nf == # filters, fw == filter width, and d == input depth. </param>
+        /// <param name="stride"> The output stride. </param>
+        /// <param name="bias"> The bias to add to each output channel, or an empty vector for no bias. </param>
+        FusedConvolutionNode(const model::OutputPort<ValueType>& input,
+                             const model::PortMemoryLayout& inputMemoryLayout,
+                             const model::PortMemoryLayout& outputMemoryLayout,
+                             const ConstTensorReferenceType& filterWeights,
+                             int stride,
+                             const std::vector<ValueType>& bias);
+
+        /// <summary> Constructor for a fused convolution with an activation function. </summary>
+        ///
+        /// <param name="input"> The ports to get input data from. </param>
+        /// <param name="inputMemoryLayout"> The layout of the input data. </param>
+        /// <param name="outputMemoryLayout"> The layout of the output data. </param>
+        /// <param name="filterWeights"> The weights for the convolutional filters. Stored
+        ///  as a 3D tensor of dimensions (nf*fw) x fw x d, where nf == # filters, fw == filter width, and d == input depth. </param>
+        /// <param name="stride"> The output stride. </param>
+        /// <param name="bias"> The bias to add to each output channel, or an empty vector for no bias. </param>
+        /// <param name="activation"> The activation function to apply to the biased result. </param>
+        FusedConvolutionNode(const model::OutputPort<ValueType>& input,
+                             const model::PortMemoryLayout& inputMemoryLayout,
+                             const model::PortMemoryLayout& outputMemoryLayout,
+                             const ConstTensorReferenceType& filterWeights,
+                             int stride,
+                             const std::vector<ValueType>& bias,
+                             const predictors::neural::Activation<ValueType>& activation);
+
+        /// <summary> Gets information about the input memory layout </summary>
+        const model::PortMemoryLayout& GetInputMemoryLayout() const { return _inputMemoryLayout; }
+
+        /// <summary> Gets information about the output memory layout </summary>
+        model::PortMemoryLayout GetOutputMemoryLayout() const { return _output.GetMemoryLayout(); }
+
+        /// <summary> Gets the weights for the convolutional filters </summary>
+        const TensorType& GetFilterWeights() const { return _filterWeights; }
+
+        /// <summary> Gets the output stride </summary>
+        int GetStride() const { return _stride; }
+
+        /// <summary> Gets the per-channel bias (empty if the convolution has no bias) </summary>
+        const std::vector<ValueType>& GetBias() const { return _bias; }
+
+        /// <summary> Indicates if an activation function is applied to the output </summary>
+        bool HasActivation() const { return _activation.GetImpl() != nullptr; }
+
+        /// <summary> Gets the activation function (only valid if `HasActivation()` is true) </summary>
+        const predictors::neural::Activation<ValueType>& GetActivation() const { return _activation; }
+
+        /// <summary> Returns true if the node can accept input with this memory layout order, else false </summary>
+        ///
+        /// <param name="order"> The memory layout order for all the input ports </summary>
+        /// <returns> If the node can accept the input memory layout order, true, else false </returns>
+        bool CanAcceptInputLayout(const utilities::DimensionOrder& order) const override
+        {
+            return GetInputMemoryLayout().GetLogicalDimensionOrder() == order;
+        }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("FusedConvolutionNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        utilities::ArchiveVersion GetArchiveVersion() const override;
+        bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: inputMemoryLayout, filterWeights, stride, bias, activation
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        model::PortMemoryLayout _inputMemoryLayout;
+        TensorType _filterWeights;
+        int _stride = 1;
+        std::vector<ValueType> _bias;
+        predictors::neural::Activation<ValueType> _activation; // no implementation means no activation
+    };
+}
+}
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.h (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// emitters
+#include "IRFunctionEmitter.h"
+
+// model
+#include "CompilableNode.h"
+#include "IRMapCompiler.h"
+#include "InputPort.h"
+#include "MapCompiler.h"
+#include "ModelTransformer.h"
+#include "Node.h"
+#include "OutputPort.h"
+
+// utilities
+#include "ArchiveVersion.h"
+#include "Exception.h"
+#include "IArchivable.h"
+#include "TypeName.h"
+
+// stl
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    /// <summary>
+    /// A node that multiplies a constant matrix of int8 weights by an input matrix. The input is quantized to int8
+    /// with a single (per-tensor) scale, the products are accumulated in int32, and the result is converted back
+    /// to floating point using the per-row weight scales: `output(i, j) = inputScale * weightScales[i] * sum_l(W(i, l) * q(l, j))`.
+    /// </summary>
+    template <typename ValueType>
+    class QuantizedMatrixMultiplyNode : public model::CompilableNode
+    {
+    public:
+        /// @name Input and Output Ports
+        /// @{
+        const model::InputPort<ValueType>& input = _input;
+        const model::OutputPort<ValueType>& output = _output;
+        /// @}
+
+        /// <summary> Default Constructor </summary>
+        QuantizedMatrixMultiplyNode();
+
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="input"> The right-hand input of the matrix multiplication, a row-major matrix of size k x n. </param>
+        /// <param name="m"> The number of rows of the weights matrix. </param>
+        /// <param name="n"> The number of columns of the input matrix. </param>
+        /// <param name="k"> The number of columns of the weights matrix (and rows of the input matrix). </param>
+        /// <param name="weights"> The quantized weights, a row-major matrix of size m x k. </param>
+        /// <param name="weightScales"> The scale of each row of the weights matrix. </param>
+        /// <param name="inputScale"> The scale used to quantize the input. </param>
+        /// <param name="transposeOutput"> If true, the output is stored as an n x m matrix. </param>
+        QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, int m, int n, int k, const std::vector<int8_t>& weights, const std::vector<ValueType>& weightScales, ValueType inputScale, bool transposeOutput);
+
+        /// <summary> Gets the quantized weights. </summary>
+        ///
+        /// <returns> The quantized weights, a row-major matrix of size m x k. </returns>
+        const std::vector<int8_t>& GetWeights() const { return _weights; }
+
+        /// <summary> Gets the scale of each row of the weights matrix. </summary>
+        ///
+        /// <returns> The per-row weight scales. </returns>
+        const std::vector<ValueType>& GetWeightScales() const { return _weightScales; }
+
+        /// <summary> Gets the scale used to quantize the input. </summary>
+        ///
+        /// <returns> The input scale. </returns>
+        ValueType GetInputScale() const { return _inputScale; }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        static std::string GetTypeName() { return utilities::GetCompositeTypeName<ValueType>("QuantizedMatrixMultiplyNode"); }
+
+        /// <summary> Gets the name of this type (for serialization). </summary>
+        ///
+        /// <returns> The name of this type. </returns>
+        std::string GetRuntimeTypeName() const override { return GetTypeName(); }
+
+    protected:
+        void Compute() const override;
+        void Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function) override;
+        utilities::ArchiveVersion GetArchiveVersion() const override;
+        bool CanReadArchiveVersion(const utilities::ArchiveVersion& version) const override;
+        void WriteToArchive(utilities::Archiver& archiver) const override;
+        void ReadFromArchive(utilities::Unarchiver& archiver) override;
+        bool HasState() const override { return true; } // stored state: m, n, k, weights, weightScales, inputScale, transposeOutput
+
+    private:
+        void Copy(model::ModelTransformer& transformer) const override;
+
+        // Input
+        model::InputPort<ValueType> _input;
+
+        // Output
+        model::OutputPort<ValueType> _output;
+
+        // Weights are MxK, input is KxN, output is MxN (or NxM if transposed)
+        int _m = 0, _n = 0, _k = 0;
+        std::vector<int8_t> _weights;
+        std::vector<ValueType> _weightScales;
+        ValueType _inputScale = 1;
+        bool _transposeOutput = false;
+    };
+
+    /// <summary> Gets the int8 quantization scale for values in the range [-range, range]. </summary>
+    ///
+    /// <param name="range"> The largest absolute value to be quantized. </param>
+    ///
+    /// <returns> The quantization scale, such that `range` maps to the largest quantized value. </returns>
+    template <typename ValueType>
+    ValueType GetInt8QuantizationScale(ValueType range);
+
+    /// <summary> Quantizes a value to int8 with the given scale, rounding to the nearest integer and saturating to [-127, 127]. </summary>
+    ///
+    /// <param name="value"> The value to quantize. </param>
+    /// <param name="scale"> The quantization scale. </param>
+    ///
+    /// <returns> The quantized value. </returns>
+    template <typename ValueType>
+    int8_t QuantizeToInt8(ValueType value, ValueType scale);
+}
+}
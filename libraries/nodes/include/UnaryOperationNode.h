@@ -20,6 +20,7 @@
 
 // emitters
 #include "EmitterTypes.h"
+#include "IRVectorUtilities.h"
 
 // utilities
 #include "TypeName.h"
@@ -27,6 +28,7 @@
 // stl
 #include <cmath>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace ell
@@ -79,7 +81,9 @@ namespace nodes
         void Copy(model::ModelTransformer& transformer) const override;
 
         emitters::LLVMFunction GetOperator(emitters::IRFunctionEmitter& function) const;
+        bool CanCompileVectorized() const;
         void CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
+        void CompileVectorizedLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
         void CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function);
 
         template <typename Operation>
@@ -538,7 +538,7 @@ namespace nodes
     {
         // Get compiler settings
         const auto& compilerSettings = compiler.GetCompilerOptions();
-        const int vectorSize = compilerSettings.vectorWidth;
+        const int vectorSize = emitters::GetVectorWidth<PackedBitsType>(compilerSettings);
 
         // Get port variables
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
@@ -682,7 +682,7 @@ namespace nodes
         const bool hasZeroPadding = predictors::neural::HasPadding(_inputPaddingParameters, predictors::neural::PaddingScheme::zeros);
 
         bool useVectorInstructions = compilerSettings.allowVectorInstructions;
-        const int vectorSize = compilerSettings.vectorWidth;
+        const int vectorSize = emitters::GetVectorWidth<PackedBitsType>(compilerSettings);
         const int numVectorBlocks = useVectorInstructions ? packedRowSize / vectorSize : 0;
         if (numVectorBlocks == 0)
         {
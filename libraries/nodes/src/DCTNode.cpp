@@ -9,10 +9,16 @@
 #include "DCTNode.h"
 
 // nodes
+#include "FFTNode.h"
 #include "MatrixVectorProductNode.h"
 
-// dsp
-#include "DCT.h"
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalScalar.h"
+
+// stl
+#include <algorithm>
+#include <string>
 
 namespace ell
 {
@@ -20,48 +26,144 @@ namespace nodes
 {
     template <typename ValueType>
     DCTNode<ValueType>::DCTNode()
-        : Node({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0), _dctCoeffs(0, 0)
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0), _dctCoeffs(0, 0)
     {
     }
 
     template <typename ValueType>
     DCTNode<ValueType>::DCTNode(const model::OutputPort<ValueType>& input, size_t numFilters)
-        : Node({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, numFilters), _dctCoeffs(0, 0)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, numFilters), _dctCoeffs(0, 0)
+    {
+        SetDCTSize(numFilters);
+    }
+
+    template <typename ValueType>
+    void DCTNode<ValueType>::SetDCTSize(size_t numFilters)
     {
-        _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _input.Size());
+        // Only keep the DCT matrix if the DCT isn't computed with an FFT
+        if (dsp::ShouldUseFastDCT(numFilters, _input.Size()))
+        {
+            _dctPlan = std::make_unique<dsp::DCTPlan<ValueType>>(numFilters, _input.Size());
+            _dctCoeffs = math::RowMatrix<ValueType>(0, 0);
+        }
+        else
+        {
+            _dctPlan = nullptr;
+            _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _input.Size());
+        }
     }
 
     template <typename ValueType>
     void DCTNode<ValueType>::Compute() const
     {
-        math::ColumnVector<ValueType> x(_input.GetValue());
-        auto result = dsp::DCT(_dctCoeffs, x);
-        _output.SetOutput(result.ToArray());
+        if (_dctPlan)
+        {
+            auto x = _input.GetValue();
+            std::vector<ValueType> result(_output.Size());
+            _dctPlan->Transform(x.data(), result.data());
+            _output.SetOutput(result);
+        }
+        else
+        {
+            math::ColumnVector<ValueType> x(_input.GetValue());
+            auto result = dsp::DCT(_dctCoeffs, x);
+            _output.SetOutput(result.ToArray());
+        }
     };
 
     template <typename ValueType>
     void DCTNode<ValueType>::Copy(model::ModelTransformer& transformer) const
     {
         const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
-        auto newNode = transformer.AddNode<DCTNode<ValueType>>(newPortElements, _dctCoeffs.NumRows());
+        auto newNode = transformer.AddNode<DCTNode<ValueType>>(newPortElements, _output.Size());
         transformer.MapNodeOutput(output, newNode->output);
     }
 
     template <typename ValueType>
     bool DCTNode<ValueType>::Refine(model::ModelTransformer& transformer) const
     {
+        if (_dctPlan)
+        {
+            Copy(transformer);
+            return false;
+        }
+
         const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
         auto newNode = transformer.AddNode<MatrixVectorProductNode<ValueType, math::MatrixLayout::rowMajor>>(newPortElements, _dctCoeffs);
         transformer.MapNodeOutput(output, newNode->output);
         return true;
     }
 
+    // Emits the same computation as dsp::DCTPlan::Transform
+    template <typename ValueType>
+    void DCTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        if (!_dctPlan)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "DCTNode only compiles itself when the DCT is computed with an FFT");
+        }
+
+        auto& module = function.GetModule();
+        auto& emitter = module.GetIREmitter();
+        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
+
+        const int windowSize = static_cast<int>(_dctPlan->WindowSize());
+        const int halfWindowSize = windowSize / 2;
+        const int numFilters = static_cast<int>(_dctPlan->NumFilters());
+
+        // Get port variables
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        // v[n] = x[2n], v[N-1-n] = x[2n+1]
+        emitters::LLVMValue reordered = function.Variable(valueType, windowSize);
+        function.For(halfWindowSize, [pInput, reordered, windowSize](emitters::IRFunctionEmitter& function, auto n) {
+            function.SetValueAt(reordered, n, function.ValueAt(pInput, n * 2));
+            function.SetValueAt(reordered, function.LocalScalar(windowSize - 1) - n, function.ValueAt(pInput, n * 2 + 1));
+        });
+
+        // Interleaved real and imaginary parts of the first N/2 + 1 entries of the spectrum of v
+        emitters::LLVMValue spectrum = function.Variable(valueType, windowSize + 2);
+        FFTNode<ValueType>::EmitRealFFT(function, _dctPlan->GetRealFFTPlan(), reordered, spectrum);
+
+        std::vector<ValueType> rotationFactors;
+        for (const auto& factor : _dctPlan->GetRotationFactors())
+        {
+            rotationFactors.push_back(factor.real());
+            rotationFactors.push_back(factor.imag());
+        }
+        auto rotationFactorsName = std::string("DCT_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(numFilters) + "_" + std::to_string(windowSize) + "_rotation";
+        auto rotationFactorsVar = module.ConstantArray(rotationFactorsName, rotationFactors);
+
+        // X[k] = Re(r[k] V[k])
+        function.For(std::min(numFilters, halfWindowSize + 1), [pOutput, spectrum, rotationFactorsVar](emitters::IRFunctionEmitter& function, auto k) {
+            auto rRe = function.LocalScalar(function.ValueAt(rotationFactorsVar, k * 2));
+            auto rIm = function.LocalScalar(function.ValueAt(rotationFactorsVar, k * 2 + 1));
+            auto vRe = function.LocalScalar(function.ValueAt(spectrum, k * 2));
+            auto vIm = function.LocalScalar(function.ValueAt(spectrum, k * 2 + 1));
+            function.SetValueAt(pOutput, k, (rRe * vRe) - (rIm * vIm));
+        });
+
+        // Past N/2, V[k] = conj(V[N-k])
+        if (numFilters > halfWindowSize + 1)
+        {
+            function.For(halfWindowSize + 1, numFilters, [pOutput, spectrum, rotationFactorsVar, windowSize](emitters::IRFunctionEmitter& function, auto k) {
+                auto rRe = function.LocalScalar(function.ValueAt(rotationFactorsVar, k * 2));
+                auto rIm = function.LocalScalar(function.ValueAt(rotationFactorsVar, k * 2 + 1));
+                auto mirrorIndex = (function.LocalScalar(windowSize) - k) * 2;
+                auto vRe = function.LocalScalar(function.ValueAt(spectrum, mirrorIndex));
+                auto vIm = function.LocalScalar(function.ValueAt(spectrum, mirrorIndex + 1));
+                function.SetValueAt(pOutput, k, (rRe * vRe) + (rIm * vIm));
+            });
+        }
+    }
+
     template <typename ValueType>
     void DCTNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
     {
         Node::WriteToArchive(archiver);
         archiver[defaultInputPortName] << _input;
-        archiver["numFilters"] << _dctCoeffs.NumRows();
+        archiver["numFilters"] << _output.Size();
     }
 
     template <typename ValueType>
@@ -71,7 +173,7 @@ namespace nodes
         Node::ReadFromArchive(archiver);
         archiver[defaultInputPortName] >> _input;
         archiver["numFilters"] >> numFilters;
-        _dctCoeffs = dsp::GetDCTMatrix<ValueType>(numFilters, _input.Size());
+        SetDCTSize(numFilters);
         _output.SetSize(numFilters);
     }
 
@@ -9,27 +9,17 @@
 #include "FFTNode.h"
 
 // emitters
-#include "EmitterException.h"
 #include "EmitterTypes.h"
-#include "IRLocalValue.h"
+#include "IRLocalScalar.h"
 #include "LLVMUtilities.h"
 
-// math
-#include "MathConstants.h"
-
-// dsp
-#include "FFT.h"
-
 // llvm
 #include <llvm/IR/Type.h>
 
 // stl
-#include <cmath>
-
-#define USE_STORED_TWIDDLE_FACTORS 1
-#define USE_FIXED_SMALL_FFT 1
-#define MAX_INLINE_FFT_SIZE 0 // 0 to disable inlining FFT code
-#define USE_REAL_FFT 0 // The real-valued FFT is slower than the complex one. Disable it for now.
+#include <complex>
+#include <string>
+#include <vector>
 
 namespace ell
 {
@@ -37,250 +27,39 @@ namespace nodes
 {
     namespace detail
     {
-        //
-        // Complex functions for emitters
-        //
-        template <typename ValueType>
-        llvm::StructType* GetComplexType(emitters::IRModuleEmitter& module)
-        {
-            auto& emitter = module.GetIREmitter();
-            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-            return module.GetAnonymousStructType({ valueType, valueType }, true);
-        }
-
-        inline llvm::StructType* GetComplexType(emitters::IRModuleEmitter& module, emitters::LLVMType valueType)
-        {
-            return module.GetAnonymousStructType({ valueType, valueType }, true);
-        }
-
-        inline emitters::IRLocalValue ComplexAdd(emitters::IRLocalValue a, emitters::IRLocalValue b)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re + b.re
-            // c.im = a.im + b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_add");
-            function.FillStruct(result, { a_re + b_re, a_im + b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue RealComplexAdd(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
-        {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re + b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_add");
-            function.FillStruct(result, { a_re + b_re, b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexSubtract(emitters::IRLocalValue a, emitters::IRLocalValue b)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re - b.re
-            // c.im = a.im - b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_sub");
-            function.FillStruct(result, { a_re - b_re, a_im - b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue RealComplexSubtract(emitters::IRLocalScalar a_re, emitters::IRLocalValue b)
-        {
-            if (!(b.value->getType()->isStructTy() && b.value->getType()->getNumContainedTypes() == 2 && a_re.value->getType() == b.value->getType()->getContainedType(0)))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re - b.re
-            // c.im = b.im
-            auto& function = a_re.function;
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(b.value->getType(), "rc_sub");
-            function.FillStruct(result, { a_re - b_re, b_im });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexMultiply(emitters::IRLocalValue a, emitters::IRLocalValue b)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType() == b.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re * b.re - a.im * b.im
-            // c.im = a.im * b.re + a.re * b.im
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto b_re = function.LocalScalar(function.ExtractStructField(b, 0));
-            auto b_im = function.LocalScalar(function.ExtractStructField(b, 1));
-            auto result = function.Variable(a.value->getType(), "c_mul");
-            function.FillStruct(result, { (a_re * b_re) - (a_im * b_im), (a_im * b_re) + (a_re * b_im) });
-            return { function, function.Load(result) };
-        }
-
-        template <typename ValueType>
-        inline emitters::IRLocalValue TimesI(emitters::IRLocalValue a)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = -a.im
-            // c.im = i*a.re
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto result = function.Variable(a.value->getType(), "c_times_i");
-            function.FillStruct(result, { -a_im, a_re });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexRealMultiply(emitters::IRLocalValue a, emitters::IRLocalScalar b_re)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2 && a.value->getType()->getContainedType(0) == b_re.value->getType()))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-
-            // c.re = a.re * b
-            // c.im = a.im * b
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            auto result = function.Variable(a.value->getType(), "rc_mul");
-            function.FillStruct(result, { (a_re * b_re), (a_im * b_re) });
-            return { function, function.Load(result) };
-        }
-
-        inline emitters::IRLocalValue ComplexAbs(emitters::IRLocalValue a)
-        {
-            if (!(a.value->getType()->isStructTy() && a.value->getType()->getNumContainedTypes() == 2))
-            {
-                throw emitters::EmitterException(emitters::EmitterError::valueTypeNotSupported);
-            }
-            auto& function = a.function;
-            auto a_re = function.LocalScalar(function.ExtractStructField(a, 0));
-            auto a_im = function.LocalScalar(function.ExtractStructField(a, 1));
-            // result = sqrt(real^2 + imag^2)
-            // Note, this is more accurately computed as std::hypot(std::real(z), std::imag(z))
-            auto magSquared = (a_re * a_re) + (a_im * a_im);
-            return { function, Sqrt(magSquared) };
-        }
-
-        inline emitters::IRLocalValue ImaginaryExp(emitters::IRLocalScalar x)
-        {
-            auto& function = x.function;
-            auto& module = function.GetModule();
-            auto type = x.value->getType();
-            auto complexType = GetComplexType(module, type);
-            // returns e ^ ix == cos(x) + isin(x)
-            auto result = function.Variable(complexType, "i_exp");
-            function.FillStruct(result, { Cos(x), Sin(x) });
-            return { function, function.Load(result) };
-        }
-
-        //
-        // FFT-specific functions
-        //
-        template <typename ValueType>
-        std::vector<std::complex<ValueType>> GetTwiddleFactors(size_t size)
-        {
-            // size == FFT length / 2
-            const auto pi = math::Constants<ValueType>::pi;
-            std::vector<std::complex<ValueType>> result(size);
-            for (size_t k = 0; k < size; ++k)
-            {
-                result[k] = std::exp(std::complex<ValueType>(0, pi * k / size));
-            }
-            return result;
-        }
-
         template <typename ValueType>
         std::string GetFFTFunctionName(size_t length)
         {
-            // function name: FFTC_<T>_<N>  (e.g., FFTC_float_2)
-            // function signature: void FFTC(complex<T>*, complex<T>*)
+            // function name: FFTC_<T>_<N>  (e.g., FFTC_float_256)
+            // function signature: void FFTC(T*), where the argument holds N interleaved complex values
             return std::string("FFTC_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
         }
 
-        template <typename ValueType>
-        std::string GetRealFFTFunctionName(size_t length)
-        {
-            // function name: FFTR_<T>_<N>  (e.g., FFT_float_32)
-            // function signature: void FFTR(T*, T*, complex<T>*)
-            return std::string("FFTR_") + utilities::GetTypeName<ValueType>() + "_" + std::to_string(length);
-        }
-
-        template <typename ValueType>
-        std::vector<emitters::LLVMType> GetFFTFunctionArguments(emitters::IRModuleEmitter& module)
-        {
-            auto complexType = detail::GetComplexType<ValueType>(module);
-            auto complexPtrType = complexType->getPointerTo();
-            return { complexPtrType, complexPtrType };
-        }
-
-        template <typename ValueType>
-        std::vector<emitters::LLVMType> GetRealFFTFunctionArguments(emitters::IRModuleEmitter& module)
-        {
-            auto& emitter = module.GetIREmitter();
-            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-            auto valuePtrType = valueType->getPointerTo();
-            auto complexType = detail::GetComplexType(module, valueType);
-            auto complexPtrType = complexType->getPointerTo();
-            return { valuePtrType, valuePtrType, complexPtrType };
-        }
-
         template <typename ValueType>
         emitters::IRFunctionEmitter GetFFTFunctionEmitter(emitters::IRModuleEmitter& module, size_t length)
         {
             auto& context = module.GetLLVMContext();
+            auto& emitter = module.GetIREmitter();
             auto voidType = llvm::Type::getVoidTy(context);
+            auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
 
             std::string functionName = GetFFTFunctionName<ValueType>(length);
-            auto argumentTypes = detail::GetFFTFunctionArguments<ValueType>(module);
-            emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
+            emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, { valueType->getPointerTo() });
             return function;
         }
 
         template <typename ValueType>
-        emitters::IRFunctionEmitter GetRealFFTFunctionEmitter(emitters::IRModuleEmitter& module, size_t length)
+        std::vector<ValueType> UnwrapComplexValues(const std::vector<std::complex<ValueType>>& values)
         {
-            auto& context = module.GetLLVMContext();
-            auto voidType = llvm::Type::getVoidTy(context);
-
-            std::string functionName = GetRealFFTFunctionName<ValueType>(length);
-            auto argumentTypes = detail::GetRealFFTFunctionArguments<ValueType>(module);
-            emitters::IRFunctionEmitter function = module.BeginFunction(functionName, voidType, argumentTypes);
-            return function;
+            std::vector<ValueType> result;
+            result.reserve(2 * values.size());
+            for (const auto& value : values)
+            {
+                result.push_back(value.real());
+                result.push_back(value.imag());
+            }
+            return result;
         }
-
     }
 
     template <typename ValueType>
@@ -295,329 +74,143 @@ namespace nodes
     {
     }
 
-    inline void Deinterleave(emitters::IRFunctionEmitter& function, emitters::LLVMValue array, emitters::LLVMValue halfLength, emitters::LLVMValue scratch)
-    {
-        auto halfN = function.LocalScalar(halfLength);
-        function.For(halfN, [&scratch, &array](emitters::IRFunctionEmitter& function, auto index)
-        {
-            auto evenIndex = index * 2;
-            auto oddIndex = evenIndex + 1;
-            function.SetValueAt(scratch, index, function.ValueAt(array, oddIndex));
-            function.SetValueAt(array, index, function.ValueAt(array, evenIndex));
-        });
-
-        function.For(halfN, [&scratch, &array, halfN](emitters::IRFunctionEmitter& function, auto index) {
-            function.SetValueAt(array, index + halfN, function.ValueAt(scratch, index));
-        });
-    }
-
-    inline void Deinterleave(emitters::IRFunctionEmitter& function, emitters::LLVMValue array, int halfN, emitters::LLVMValue scratch)
-    {
-        Deinterleave(function, array, function.Literal(halfN), scratch);
-    }
-
-    // FFT1 twiddle factors: [1]
-    // FFT2 twiddle factors: [1, -1]
-    // FFT4 twiddle factors: [1, i, -1, -i]
-    // FFT8 twiddle factors: [1, sqrt2/2+i*sqrt2/2, i, -sqrt2/2+i*sqrt2/2, -1, -sqrt2/2-i*sqrt2/2, -i, sqrt2/2-i*sqrt2/2]
-
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT_2(emitters::IRFunctionEmitter& function, emitters::LLVMValue input)
-    {
-        // FFT of length 2: x' = [x0+x1, x0-x1]
-        auto x0 = function.LocalScalar(function.ValueAt(input, 0));
-        auto x1 = function.LocalScalar(function.ValueAt(input, 1));
-        function.SetValueAt(input, 0, detail::ComplexAdd(x0, x1));
-        function.SetValueAt(input, 1, detail::ComplexSubtract(x0, x1));
-    }
-
+    // Emits the same passes as dsp::FFTPlan::Forward, reading the bit-reversal swaps and the twiddle factors
+    // from constant tables. The signal is an array of interleaved real and imaginary parts.
     template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction_2(emitters::IRModuleEmitter& module)
+    void FFTNode<ValueType>::EmitFFT(emitters::IRFunctionEmitter& function, const dsp::FFTPlan<ValueType>& plan, emitters::LLVMValue signal)
     {
-        const auto length = 2;
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            EmitFFT_2(function, input);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT_4(emitters::IRFunctionEmitter& function, emitters::LLVMValue input)
-    {
-        // FFT of length 4: X = [x0+x1+x2+x3, x0+ix1-x2-ix3, x0-x1+x2-x3, x0-ix1-x2+ix3]
-        // Input x = {x0, x1, x2, x3}
-        auto x0 = function.LocalScalar(function.ValueAt(input, 0));
-        auto x1 = function.LocalScalar(function.ValueAt(input, 1));
-        auto x2 = function.LocalScalar(function.ValueAt(input, 2));
-        auto x3 = function.LocalScalar(function.ValueAt(input, 3));
-
-        // deinterleave -> {x0, x2, x1, x3}
-        // call fft2 on each half:
-        //   -> {x0+x2, x0-x2, x1+x3, x1-x3}
-        // apply twiddle factor w_0 = 1:
-        //  -> { (x0+x2) + (x1+x3), ..., (x0+x2) - (x1+x3), ...}
-        // apply twiddle factor w_1 = i:
-        //  -> { (x0+x2) + (x1+x3), (x0-x2) + i(x1-x3), (x0+x2) - (x1+x3), (x0-x2) - i(x1-x3)}
-
-        auto x0px2 = detail::ComplexAdd(x0, x2);
-        auto x0mx2 = detail::ComplexSubtract(x0, x2);
-        auto x1px3 = detail::ComplexAdd(x1, x3);
-        auto x1mx3 = detail::ComplexSubtract(x1, x3);
-        function.SetValueAt(input, 0, detail::ComplexAdd(x0px2, x1px3));
-        function.SetValueAt(input, 1, detail::ComplexAdd(x0mx2, detail::TimesI<ValueType>(x1mx3)));
-        function.SetValueAt(input, 2, detail::ComplexSubtract(x0px2, x1px3));
-        function.SetValueAt(input, 3, detail::ComplexSubtract(x0mx2, detail::TimesI<ValueType>(x1mx3)));
-    }
-
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction_4(emitters::IRModuleEmitter& module)
-    {
-        const auto length = 4;
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-
-            EmitFFT_4(function, input);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    // Fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch)
-    {
-#if (USE_FIXED_SMALL_FFT)
-        if (length == 2)
-        {
-            EmitFFT_2(function, input);
-        }
-        if (length == 4)
-        {
-            EmitFFT_4(function, input);
-        }
-#endif // USE_FIXED_SMALL_FFT
-
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
         auto& module = function.GetModule();
-        auto& emitter = module.GetIREmitter();
-        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-        auto complexType = detail::GetComplexType(module, valueType);
-        auto complexPtrType = complexType->getPointerTo();
-
-        auto halfN = length / 2;
-        assert(halfN >= 1);
+        auto functionName = detail::GetFFTFunctionName<ValueType>(plan.Size());
+        const int length = static_cast<int>(plan.Size());
 
-        Deinterleave(function, input, halfN, scratch);
-        auto evens = input;
-        auto odds = function.PointerOffset(evens, halfN);
-
-        if (halfN > 1) // call recursive case if necessary
+        const auto& swaps = plan.GetBitReversalSwaps();
+        if (!swaps.empty())
         {
-            DoFFT(function, halfN, evens, scratch);
-            DoFFT(function, halfN, odds, scratch);
+            std::vector<int> swapIndices;
+            swapIndices.reserve(2 * swaps.size());
+            for (const auto& swap : swaps)
+            {
+                swapIndices.push_back(2 * swap.first);
+                swapIndices.push_back(2 * swap.second);
+            }
+            auto swapIndicesVar = module.ConstantArray(functionName + "_swaps", swapIndices);
+
+            function.For(static_cast<int>(swaps.size()), [swapIndicesVar, signal](emitters::IRFunctionEmitter& function, auto index) {
+                auto first = function.LocalScalar(function.ValueAt(swapIndicesVar, index * 2));
+                auto second = function.LocalScalar(function.ValueAt(swapIndicesVar, index * 2 + 1));
+                auto firstRe = function.LocalScalar(function.ValueAt(signal, first));
+                auto firstIm = function.LocalScalar(function.ValueAt(signal, first + 1));
+                auto secondRe = function.LocalScalar(function.ValueAt(signal, second));
+                auto secondIm = function.LocalScalar(function.ValueAt(signal, second + 1));
+                function.SetValueAt(signal, first, secondRe);
+                function.SetValueAt(signal, first + 1, secondIm);
+                function.SetValueAt(signal, second, firstRe);
+                function.SetValueAt(signal, second + 1, firstIm);
+            });
+        }
+
+        if (plan.HasRadix2Pass())
+        {
+            function.For(0, 2 * length, 4, [signal](emitters::IRFunctionEmitter& function, auto index) {
+                auto aRe = function.LocalScalar(function.ValueAt(signal, index));
+                auto aIm = function.LocalScalar(function.ValueAt(signal, index + 1));
+                auto bRe = function.LocalScalar(function.ValueAt(signal, index + 2));
+                auto bIm = function.LocalScalar(function.ValueAt(signal, index + 3));
+                function.SetValueAt(signal, index, aRe + bRe);
+                function.SetValueAt(signal, index + 1, aIm + bIm);
+                function.SetValueAt(signal, index + 2, aRe - bRe);
+                function.SetValueAt(signal, index + 3, aIm - bIm);
+            });
+        }
+
+        const auto& passes = plan.GetRadix4Passes();
+        if (passes.empty())
+        {
+            return;
+        }
+
+        auto twiddleFactorsVar = module.ConstantArray(functionName + "_twiddles", detail::UnwrapComplexValues(plan.GetTwiddleFactors()));
+        for (const auto& pass : passes)
+        {
+            // see dsp::detail::Radix4Pass for the butterfly
+            const int q = static_cast<int>(pass.quarterBlockSize);
+            const int twiddleOffset = 2 * static_cast<int>(pass.twiddleOffset);
+            function.For(0, length, 4 * q, [signal, twiddleFactorsVar, q, twiddleOffset](emitters::IRFunctionEmitter& function, auto blockStart) {
+                function.For(q, [signal, twiddleFactorsVar, q, twiddleOffset, blockStart](emitters::IRFunctionEmitter& function, auto j) {
+                    auto twiddleIndex = j * 4 + twiddleOffset;
+                    auto w1Re = function.LocalScalar(function.ValueAt(twiddleFactorsVar, twiddleIndex));
+                    auto w1Im = function.LocalScalar(function.ValueAt(twiddleFactorsVar, twiddleIndex + 1));
+                    auto w2Re = function.LocalScalar(function.ValueAt(twiddleFactorsVar, twiddleIndex + 2));
+                    auto w2Im = function.LocalScalar(function.ValueAt(twiddleFactorsVar, twiddleIndex + 3));
+
+                    auto aIndex = (blockStart + j) * 2;
+                    auto bIndex = aIndex + 2 * q;
+                    auto cIndex = bIndex + 2 * q;
+                    auto dIndex = cIndex + 2 * q;
+
+                    auto aRe = function.LocalScalar(function.ValueAt(signal, aIndex));
+                    auto aIm = function.LocalScalar(function.ValueAt(signal, aIndex + 1));
+                    auto bInRe = function.LocalScalar(function.ValueAt(signal, bIndex));
+                    auto bInIm = function.LocalScalar(function.ValueAt(signal, bIndex + 1));
+                    auto cRe = function.LocalScalar(function.ValueAt(signal, cIndex));
+                    auto cIm = function.LocalScalar(function.ValueAt(signal, cIndex + 1));
+                    auto dInRe = function.LocalScalar(function.ValueAt(signal, dIndex));
+                    auto dInIm = function.LocalScalar(function.ValueAt(signal, dIndex + 1));
+
+                    auto bRe = (w2Re * bInRe) - (w2Im * bInIm);
+                    auto bIm = (w2Re * bInIm) + (w2Im * bInRe);
+                    auto dRe = (w2Re * dInRe) - (w2Im * dInIm);
+                    auto dIm = (w2Re * dInIm) + (w2Im * dInRe);
+
+                    auto t0Re = aRe + bRe;
+                    auto t0Im = aIm + bIm;
+                    auto t1Re = aRe - bRe;
+                    auto t1Im = aIm - bIm;
+                    auto t2Re = cRe + dRe;
+                    auto t2Im = cIm + dIm;
+                    auto t3Re = cRe - dRe;
+                    auto t3Im = cIm - dIm;
+
+                    // u2 = w1 t2, u3 = -i w1 t3
+                    auto u2Re = (w1Re * t2Re) - (w1Im * t2Im);
+                    auto u2Im = (w1Re * t2Im) + (w1Im * t2Re);
+                    auto u3Re = (w1Re * t3Im) + (w1Im * t3Re);
+                    auto u3Im = (w1Im * t3Im) - (w1Re * t3Re);
+
+                    function.SetValueAt(signal, aIndex, t0Re + u2Re);
+                    function.SetValueAt(signal, aIndex + 1, t0Im + u2Im);
+                    function.SetValueAt(signal, cIndex, t0Re - u2Re);
+                    function.SetValueAt(signal, cIndex + 1, t0Im - u2Im);
+                    function.SetValueAt(signal, bIndex, t1Re + u3Re);
+                    function.SetValueAt(signal, bIndex + 1, t1Im + u3Im);
+                    function.SetValueAt(signal, dIndex, t1Re - u3Re);
+                    function.SetValueAt(signal, dIndex + 1, t1Im - u3Im);
+                });
+            });
         }
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-        auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-        std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-        ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-        std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-        auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped); // TODO: encode type name in variable name
-        auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-        bool twiddleFactorsVar = false;
-#endif
-
-        function.For(halfN, [&evens, &odds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, auto k) {
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-            // w = e^i(2*pi*k/N)
-            auto kValue = function.LocalScalar(function.CastValue<int, ValueType>(k));
-            auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-            auto e = function.LocalScalar(function.ValueAt(evens, k));
-            auto o = function.LocalScalar(function.ValueAt(odds, k));
-            auto wo = detail::ComplexMultiply(w, o); // wo = w*o
-            function.SetValueAt(evens, k, detail::ComplexAdd(e, wo)); // even
-            function.SetValueAt(odds, k, detail::ComplexSubtract(e, wo)); // odd
-        });
     }
 
     // Fixed-size FFT function implementation: size is known at compile time
     template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction(emitters::IRModuleEmitter& module, size_t length)
-    {
-#if (USE_FIXED_SMALL_FFT)
-        if (length == 2)
-        {
-            return GetFFTFunction_2(module);
-        }
-        if (length == 4)
-        {
-            return GetFFTFunction_4(module);
-        }
-#endif // USE_FIXED_SMALL_FFT
-
-        auto functionName = detail::GetFFTFunctionName<ValueType>(length);
-        auto existingFunction = module.GetFunction(functionName);
-        if (existingFunction != nullptr)
-        {
-            return existingFunction;
-        }
-
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
-        {
-            auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            auto scratch = function.LocalScalar(&(*arguments++));
-
-            EmitFFT(function, length, input, scratch);
-        }
-        module.EndFunction();
-        return function.GetFunction();
-    }
-
-    // Real-valued fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::EmitRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput)
+    emitters::LLVMFunction FFTNode<ValueType>::GetFFTFunction(emitters::IRModuleEmitter& module, const dsp::FFTPlan<ValueType>& plan)
     {
-        // TODO: assert(bitcount(length) == 1)  (i.e., length is a power of 2)
-        auto& module = function.GetModule();
-        auto complexType = detail::GetComplexType<ValueType>(module);
-        auto complexPtrType = complexType->getPointerTo();
-
-        auto halfN = length / 2;
-        assert(halfN >= 1);
-
-        Deinterleave(function, input, halfN, scratch);
-        auto evens = input;
-        auto odds = function.PointerOffset(evens, halfN);
-        auto complexEvens = complexInput;
-        auto complexOdds = function.PointerOffset(complexEvens, halfN);
-
-        if (halfN > 1) // call recursive case if necessary
-        {
-            DoRealFFT(function, halfN, evens, scratch, complexEvens);
-            DoRealFFT(function, halfN, odds, scratch, complexOdds);
-        }
-        else // here halfN == 1
-        {
-            // Base case: copy from real to complex
-            function.FillStruct(complexEvens, { function.Load(evens), function.Literal<ValueType>(0) });
-            function.FillStruct(complexOdds, { function.Load(odds), function.Literal<ValueType>(0) });
-        }
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-        auto twiddleFactors = detail::GetTwiddleFactors<ValueType>(halfN);
-        std::vector<ValueType> twiddleFactorsUnwrapped(twiddleFactors.size() * 2);
-        ValueType* dataPtr = reinterpret_cast<ValueType*>(twiddleFactors.data());
-        std::copy(dataPtr, dataPtr + twiddleFactorsUnwrapped.size(), twiddleFactorsUnwrapped.begin());
-        auto twiddleFactorsUnwrappedVar = module.ConstantArray(std::string("twiddles_") + std::to_string(halfN), twiddleFactorsUnwrapped);
-        auto twiddleFactorsVar = function.CastPointer(twiddleFactorsUnwrappedVar, complexPtrType);
-#else
-        bool twiddleFactorsVar = false; // Just here to appease the compiler
-#endif
-
-        function.For(halfN, [&evens, &odds, &complexEvens, complexOdds, &twiddleFactorsVar](emitters::IRFunctionEmitter& function, auto k) {
-
-#if (USE_STORED_TWIDDLE_FACTORS)
-            auto w = function.LocalScalar(function.ValueAt(twiddleFactorsVar, k));
-#else
-            // w = e^i(2*pi*k/N)
-            auto kValue = function.LocalScalar(function.CastValue<int, ValueType>(k));
-            auto w = detail::ImaginaryExp(function.LocalScalar(pi / halfN) * kValue);
-#endif
-
-            auto e = function.LocalScalar(function.ValueAt(evens, k));
-            auto o = function.LocalScalar(function.ValueAt(odds, k));
-            auto wo = detail::ComplexRealMultiply(w, o); // wo = w*o
-            function.SetValueAt(complexEvens, k, detail::RealComplexAdd(e, wo)); // even
-            function.SetValueAt(complexOdds, k, detail::RealComplexSubtract(e, wo)); // odd
-        });
-    }
-
-    // Real-valued fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    emitters::LLVMFunction FFTNode<ValueType>::GetRealFFTFunction(emitters::IRModuleEmitter& module, size_t length)
-    {
-        auto functionName = detail::GetRealFFTFunctionName<ValueType>(length);
+        auto functionName = detail::GetFFTFunctionName<ValueType>(plan.Size());
         auto existingFunction = module.GetFunction(functionName);
         if (existingFunction != nullptr)
         {
             return existingFunction;
         }
 
-        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, length);
+        emitters::IRFunctionEmitter function = detail::GetFFTFunctionEmitter<ValueType>(module, plan.Size());
         {
             auto arguments = function.Arguments().begin();
-            auto input = function.LocalScalar(&(*arguments++));
-            auto scratch = function.LocalScalar(&(*arguments++));
-            auto complexInput = function.LocalScalar(&(*arguments++));
-
-            EmitRealFFT(function, length, input, scratch, complexInput);
+            auto signal = function.LocalScalar(&(*arguments++));
+            EmitFFT(function, plan, signal);
         }
         module.EndFunction();
         return function.GetFunction();
     }
 
-    // Perform fixed-size FFT: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::DoFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch)
-    {
-        const bool inlineFFT = length <= MAX_INLINE_FFT_SIZE;
-        if (inlineFFT)
-        {
-            EmitFFT(function, length, input, scratch);
-        }
-        else
-        {
-            auto& module = function.GetModule();
-            auto fftFunction = GetFFTFunction(module, length);
-            function.Call(fftFunction, { input, scratch });
-        }
-    }
-
-    // Fixed-size FFT function implementation: size is known at compile time
-    template <typename ValueType>
-    void FFTNode<ValueType>::DoRealFFT(emitters::IRFunctionEmitter& function, size_t length, emitters::LLVMValue input, emitters::LLVMValue scratch, emitters::LLVMValue complexInput)
-    {
-        const bool inlineFFT = length <= MAX_INLINE_FFT_SIZE;
-        if (inlineFFT)
-        {
-            EmitRealFFT(function, length, input, scratch, complexInput);
-        }
-        else
-        {
-            auto& module = function.GetModule();
-            auto fftFunction = GetRealFFTFunction(module, length);
-            function.Call(fftFunction, { input, scratch, complexInput });
-        }
-    }
-
     template <typename ValueType>
     void FFTNode<ValueType>::Compute() const
     {
@@ -635,48 +228,80 @@ namespace nodes
         transformer.MapNodeOutput(output, newNode->output);
     }
 
+    // Emits the same computation as dsp::RealFFTPlan::Forward
+    template <typename ValueType>
+    void FFTNode<ValueType>::EmitRealFFT(emitters::IRFunctionEmitter& function, const dsp::RealFFTPlan<ValueType>& plan, emitters::LLVMValue signal, emitters::LLVMValue spectrum)
+    {
+        auto& module = function.GetModule();
+        auto& emitter = module.GetIREmitter();
+        auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
+        const int length = static_cast<int>(plan.Size());
+        const int halfLength = length / 2;
+
+        // The N real values, read as N/2 interleaved complex values z[m] = x[2m] + i x[2m+1], are transformed
+        // with a half-length complex FFT
+        emitters::LLVMValue buffer = function.Variable(valueType, length);
+        function.MemoryCopy<ValueType>(signal, buffer, length);
+        function.Call(GetFFTFunction(module, plan.GetComplexPlan()), { buffer });
+
+        // X[0] = Re(Z[0]) + Im(Z[0]), X[N/2] = Re(Z[0]) - Im(Z[0])
+        auto zero = function.LocalScalar<ValueType>(0);
+        auto z0Re = function.LocalScalar(function.ValueAt(buffer, 0));
+        auto z0Im = function.LocalScalar(function.ValueAt(buffer, 1));
+        function.SetValueAt(spectrum, 0, z0Re + z0Im);
+        function.SetValueAt(spectrum, 1, zero);
+        function.SetValueAt(spectrum, length, z0Re - z0Im);
+        function.SetValueAt(spectrum, length + 1, zero);
+
+        // X[k] = E[k] + w^k O[k], with E[k] = (Z[k] + conj(Z[M-k])) / 2 and O[k] = -i (Z[k] - conj(Z[M-k])) / 2
+        auto splitFactorsVar = module.ConstantArray(detail::GetFFTFunctionName<ValueType>(length) + "_split", detail::UnwrapComplexValues(plan.GetSplitFactors()));
+        function.For(1, halfLength, [buffer, spectrum, splitFactorsVar, halfLength](emitters::IRFunctionEmitter& function, auto k) {
+            auto half = function.LocalScalar<ValueType>(0.5);
+            auto zRe = function.LocalScalar(function.ValueAt(buffer, k * 2));
+            auto zIm = function.LocalScalar(function.ValueAt(buffer, k * 2 + 1));
+            auto mirrorIndex = (function.LocalScalar(halfLength) - k) * 2;
+            auto zMirrorRe = function.LocalScalar(function.ValueAt(buffer, mirrorIndex));
+            auto zMirrorIm = function.LocalScalar(function.ValueAt(buffer, mirrorIndex + 1));
+            auto wRe = function.LocalScalar(function.ValueAt(splitFactorsVar, k * 2));
+            auto wIm = function.LocalScalar(function.ValueAt(splitFactorsVar, k * 2 + 1));
+
+            auto evenRe = half * (zRe + zMirrorRe);
+            auto evenIm = half * (zIm - zMirrorIm);
+            auto oddRe = half * (zIm + zMirrorIm);
+            auto oddIm = half * (zMirrorRe - zRe);
+
+            function.SetValueAt(spectrum, k * 2, evenRe + (wRe * oddRe) - (wIm * oddIm));
+            function.SetValueAt(spectrum, k * 2 + 1, evenIm + (wRe * oddIm) + (wIm * oddRe));
+        });
+    }
+
     template <typename ValueType>
     void FFTNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
         auto& module = function.GetModule();
         auto& emitter = module.GetIREmitter();
         auto valueType = emitter.Type(emitters::GetVariableType<ValueType>());
-        auto complexType = detail::GetComplexType(module, valueType);
 
-        auto inputSize = input.Size();
-        auto outputSize = output.Size();
+        const int inputSize = static_cast<int>(input.Size());
+        const int outputSize = static_cast<int>(output.Size());
+        if (outputSize == 0)
+        {
+            return;
+        }
 
         // Get port variables
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
         emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
 
-        // Buffer for complex data
-        emitters::LLVMValue complexBuffer = function.Variable(complexType, inputSize);
-
-#if (USE_REAL_FFT)
-
-        emitters::LLVMValue scratch = function.Variable(valueType, inputSize / 2);
-        DoRealFFT(function, inputSize, pInput, scratch, complexBuffer);
-
-#else // Complex-input FFT
-
-        emitters::LLVMValue scratch = function.Variable(complexType, inputSize / 2);
-        emitters::LLVMValue temp = function.Variable(complexType, "temp");
-
-        // Convert real-valued data to complex
-        function.For(inputSize, [pInput, complexBuffer, temp](emitters::IRFunctionEmitter& function, auto index) {
-            function.FillStruct(temp, { function.ValueAt(pInput, index), function.Literal<ValueType>(0) });
-            function.SetValueAt(complexBuffer, index, function.Load(temp));
-        });
-
-        DoFFT(function, inputSize, complexBuffer, scratch);
-
-#endif // USE_REAL_FFT
+        // Interleaved real and imaginary parts of the first N/2 + 1 entries of the spectrum
+        dsp::RealFFTPlan<ValueType> plan(inputSize);
+        emitters::LLVMValue spectrum = function.Variable(valueType, inputSize + 2);
+        EmitRealFFT(function, plan, pInput, spectrum);
 
-        function.For(outputSize, [pOutput, complexBuffer](emitters::IRFunctionEmitter& function, auto index) {
-            auto complexValue = function.LocalScalar(function.ValueAt(complexBuffer, index));
-            auto absValue = detail::ComplexAbs(complexValue);
-            function.SetValueAt(pOutput, index, absValue);
+        function.For(outputSize, [pOutput, spectrum](emitters::IRFunctionEmitter& function, auto index) {
+            auto re = function.LocalScalar(function.ValueAt(spectrum, index * 2));
+            auto im = function.LocalScalar(function.ValueAt(spectrum, index * 2 + 1));
+            function.SetValueAt(pOutput, index, Sqrt((re * re) + (im * im)));
         });
     }
 
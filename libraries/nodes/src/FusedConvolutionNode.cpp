@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FusedConvolutionNode.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FusedConvolutionNode.h"
+#include "CompiledActivationFunctions.h"
+
+// emitters
+#include "IRLocalScalar.h"
+
+// predictors
+#include "HardSigmoidActivation.h"
+#include "LeakyReLUActivation.h"
+#include "ReLUActivation.h"
+#include "SigmoidActivation.h"
+#include "TanhActivation.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        //
+        // Relevant archive format versions
+        //
+        constexpr utilities::ArchiveVersion currentArchiveVersion = { utilities::ArchiveVersionNumbers::v2 };
+
+        // Emits the compiled equivalent of an activation function, using the same functions ActivationLayerNode refines into
+        template <typename ValueType>
+        emitters::LLVMValue EmitActivation(emitters::IRFunctionEmitter& function, const predictors::neural::ActivationImpl<ValueType>* activation, emitters::LLVMValue x)
+        {
+            if (dynamic_cast<const predictors::neural::ReLUActivation<ValueType>*>(activation))
+            {
+                return ReLUActivationFunction<ValueType>{}.Compile(function, x);
+            }
+            if (auto leakyReLU = dynamic_cast<const predictors::neural::LeakyReLUActivation<ValueType>*>(activation))
+            {
+                return LeakyReLUActivationFunction<ValueType>(leakyReLU->GetLeakyFactor()).Compile(function, x);
+            }
+            if (dynamic_cast<const predictors::neural::SigmoidActivation<ValueType>*>(activation))
+            {
+                return SigmoidActivationFunction<ValueType>{}.Compile(function, x);
+            }
+            if (dynamic_cast<const predictors::neural::HardSigmoidActivation<ValueType>*>(activation))
+            {
+                return HardSigmoidActivationFunction<ValueType>{}.Compile(function, x);
+            }
+            if (dynamic_cast<const predictors::neural::TanhActivation<ValueType>*>(activation))
+            {
+                return TanhActivationFunction<ValueType>{}.Compile(function, x);
+            }
+
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FusedConvolutionNode given an activation type it can't compile");
+        }
+    }
+
+    template <typename ValueType>
+    FusedConvolutionNode<ValueType>::FusedConvolutionNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    FusedConvolutionNode<ValueType>::FusedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                          const model::PortMemoryLayout& inputMemoryLayout,
+                                                          const model::PortMemoryLayout& outputMemoryLayout,
+                                                          const ConstTensorReferenceType& filterWeights,
+                                                          int stride,
+                                                          const std::vector<ValueType>& bias)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, outputMemoryLayout), _inputMemoryLayout(inputMemoryLayout), _filterWeights(filterWeights), _stride(stride), _bias(bias)
+    {
+        const int filterSize = static_cast<int>(filterWeights.NumColumns());
+        const int numFilters = outputMemoryLayout.GetActiveSize(2);
+        if (static_cast<int>(filterWeights.NumRows()) != numFilters * filterSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FusedConvolutionNode: filter weights don't match the number of output channels");
+        }
+
+        if (static_cast<int>(filterWeights.NumChannels()) != inputMemoryLayout.GetActiveSize(2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FusedConvolutionNode: filter weights don't match the number of input channels (depthwise-separable convolutions aren't supported)");
+        }
+
+        if (!bias.empty() && static_cast<int>(bias.size()) != numFilters)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "FusedConvolutionNode: must have one bias value per output channel");
+        }
+    }
+
+    template <typename ValueType>
+    FusedConvolutionNode<ValueType>::FusedConvolutionNode(const model::OutputPort<ValueType>& input,
+                                                          const model::PortMemoryLayout& inputMemoryLayout,
+                                                          const model::PortMemoryLayout& outputMemoryLayout,
+                                                          const ConstTensorReferenceType& filterWeights,
+                                                          int stride,
+                                                          const std::vector<ValueType>& bias,
+                                                          const predictors::neural::Activation<ValueType>& activation)
+        : FusedConvolutionNode(input, inputMemoryLayout, outputMemoryLayout, filterWeights, stride, bias)
+    {
+        _activation = activation;
+    }
+
+    template <typename ValueType>
+    void FusedConvolutionNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newInput = transformer.GetCorrespondingInputs(_input);
+        FusedConvolutionNode<ValueType>* newNode = nullptr;
+        if (HasActivation())
+        {
+            newNode = transformer.AddNode<FusedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _stride, _bias, _activation);
+        }
+        else
+        {
+            newNode = transformer.AddNode<FusedConvolutionNode<ValueType>>(newInput, _inputMemoryLayout, GetOutputMemoryLayout(), _filterWeights, _stride, _bias);
+        }
+        transformer.MapNodeOutput(this->output, newNode->output);
+    }
+
+    template <typename ValueType>
+    void FusedConvolutionNode<ValueType>::Compute() const
+    {
+        auto inputValues = _input.GetValue();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const auto& inputIncrement = _inputMemoryLayout.GetCumulativeIncrement();
+
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int inputDepth = _inputMemoryLayout.GetActiveSize(2);
+        const int outputRows = outputLayout.GetActiveSize(0);
+        const int outputColumns = outputLayout.GetActiveSize(1);
+        const int numFilters = outputLayout.GetActiveSize(2);
+
+        std::vector<ValueType> outputValues(outputLayout.GetMemorySize());
+        for (int filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+        {
+            for (int outputRow = 0; outputRow < outputRows; ++outputRow)
+            {
+                for (int outputColumn = 0; outputColumn < outputColumns; ++outputColumn)
+                {
+                    // The input window is relative to the start of the (padded) input memory
+                    ValueType value = 0;
+                    for (int windowRow = 0; windowRow < filterSize; ++windowRow)
+                    {
+                        for (int windowColumn = 0; windowColumn < filterSize; ++windowColumn)
+                        {
+                            auto inputOffset = (outputRow * _stride + windowRow) * inputIncrement[0] + (outputColumn * _stride + windowColumn) * inputIncrement[1];
+                            for (int channel = 0; channel < inputDepth; ++channel)
+                            {
+                                value += _filterWeights(filterIndex * filterSize + windowRow, windowColumn, channel) * inputValues[inputOffset + channel * inputIncrement[2]];
+                            }
+                        }
+                    }
+
+                    if (!_bias.empty())
+                    {
+                        value += _bias[filterIndex];
+                    }
+
+                    if (HasActivation())
+                    {
+                        value = _activation.Apply(value);
+                    }
+
+                    outputValues[outputLayout.GetEntryOffset({ outputRow, outputColumn, filterIndex })] = value;
+                }
+            }
+        }
+
+        _output.SetOutput(outputValues);
+    }
+
+    // Terminology:
+    // fw: filter width
+    // d: # input channels
+    // f: # filters (== output channels)
+
+    template <typename ValueType>
+    void FusedConvolutionNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        // input is a (h+2p) x (w+2p) x d array
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(this->input);
+
+        // output is a h x w x f array (plus any padding in the output layout)
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(this->output);
+
+        // weights are a f x fw x fw x d array
+        auto& module = function.GetModule();
+        auto pWeights = module.ConstantArray("fusedConvWeights_"s + GetInternalStateIdentifier(), _filterWeights.ReferenceAsMatrix().ToArray());
+        auto pBias = _bias.empty() ? nullptr : module.ConstantArray("fusedConvBias_"s + GetInternalStateIdentifier(), _bias);
+        auto activation = _activation.GetImpl();
+
+        const auto inputLayout = GetInputMemoryLayout();
+        const auto outputLayout = GetOutputMemoryLayout();
+        const auto inputIncrement = inputLayout.GetCumulativeIncrement();
+        const int filterSize = static_cast<int>(_filterWeights.NumColumns());
+        const int inputDepth = inputLayout.GetActiveSize(2);
+        const int stride = _stride;
+
+        // If the channels of consecutive columns are contiguous, a whole window row is a single dot product
+        const bool canCombineColumns = (inputLayout.GetStride(2) == inputDepth) && (stride == 1);
+
+        // For each filter
+        const auto numFilters = outputLayout.GetActiveSize(2);
+        function.ParallelFor(numFilters, { pInput, pOutput }, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar filterIndex, const std::vector<emitters::LLVMValue>& capturedValues) {
+            auto input = capturedValues[0];
+            auto result = capturedValues[1];
+
+            // For each output row
+            function.For(outputLayout.GetActiveSize(0), [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar outputRow) {
+                // For each output column
+                function.For(outputLayout.GetActiveSize(1), [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar outputColumn) {
+                    // The filters are typically small, so we unroll the loops here
+                    auto value = function.LocalScalar(ValueType{ 0 });
+                    for (int windowRow = 0; windowRow < filterSize; ++windowRow)
+                    {
+                        auto inputRowOffset = (outputRow * stride + windowRow) * static_cast<int>(inputIncrement[0]);
+                        if (canCombineColumns)
+                        {
+                            auto imageRow = function.PointerOffset(input, inputRowOffset + outputColumn * static_cast<int>(inputIncrement[1]));
+                            auto filterRow = function.PointerOffset(pWeights, filterIndex * (filterSize * filterSize * inputDepth) + inputDepth * filterSize * windowRow);
+                            value = value + function.DotProduct(filterSize * inputDepth, imageRow, filterRow);
+                        }
+                        else
+                        {
+                            for (int windowColumn = 0; windowColumn < filterSize; ++windowColumn)
+                            {
+                                auto imageRow = function.PointerOffset(input, inputRowOffset + (outputColumn * stride + windowColumn) * static_cast<int>(inputIncrement[1]));
+                                auto filterRow = function.PointerOffset(pWeights, filterIndex * (filterSize * filterSize * inputDepth) + inputDepth * (filterSize * windowRow + windowColumn));
+                                value = value + function.DotProduct(inputDepth, imageRow, filterRow);
+                            }
+                        }
+                    }
+
+                    // Apply the bias and activation before the single store to the output
+                    if (pBias != nullptr)
+                    {
+                        value = value + function.ValueAt(pBias, filterIndex);
+                    }
+
+                    if (activation != nullptr)
+                    {
+                        value = function.LocalScalar(EmitActivation<ValueType>(function, activation, value));
+                    }
+
+                    auto outputOffset = model::EmitGetEntryOffset(function, { outputRow, outputColumn, filterIndex }, outputLayout);
+                    function.SetValueAt(result, outputOffset, value);
+                });
+            });
+        });
+    }
+
+    template <typename ValueType>
+    utilities::ArchiveVersion FusedConvolutionNode<ValueType>::GetArchiveVersion() const
+    {
+        return std::max(currentArchiveVersion, CompilableNode::GetArchiveVersion());
+    }
+
+    template <typename ValueType>
+    bool FusedConvolutionNode<ValueType>::CanReadArchiveVersion(const utilities::ArchiveVersion& version) const
+    {
+        return CompilableNode::CanReadArchiveVersion(version);
+    }
+
+    template <typename ValueType>
+    void FusedConvolutionNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        model::CompilableNode::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver["inputLayout"] << _inputMemoryLayout;
+        archiver["outputLayout"] << GetOutputMemoryLayout();
+        archiver["stride"] << _stride;
+        math::TensorArchiver::Write(_filterWeights, "weights", archiver);
+        archiver["bias"] << _bias;
+        archiver["hasActivation"] << HasActivation();
+        if (HasActivation())
+        {
+            archiver["activation"] << _activation;
+        }
+    }
+
+    template <typename ValueType>
+    void FusedConvolutionNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        model::CompilableNode::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver["inputLayout"] >> _inputMemoryLayout;
+        model::PortMemoryLayout outputMemoryLayout;
+        archiver["outputLayout"] >> outputMemoryLayout;
+        _output.SetMemoryLayout(outputMemoryLayout);
+        archiver["stride"] >> _stride;
+        math::TensorArchiver::Read(_filterWeights, "weights", archiver);
+        archiver["bias"] >> _bias;
+        bool hasActivation = false;
+        archiver["hasActivation"] >> hasActivation;
+        if (hasActivation)
+        {
+            archiver["activation"] >> _activation;
+        }
+    }
+
+    // Explicit specializations
+    template class FusedConvolutionNode<float>;
+    template class FusedConvolutionNode<double>;
+}
+}
@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedMatrixMultiplyNode.cpp (nodes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedMatrixMultiplyNode.h"
+
+// emitters
+#include "EmitterTypes.h"
+#include "IRLocalScalar.h"
+#include "IRVectorUtilities.h"
+
+// stl
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace nodes
+{
+    namespace
+    {
+        //
+        // Relevant archive format versions
+        //
+        constexpr utilities::ArchiveVersion currentArchiveVersion = { utilities::ArchiveVersionNumbers::v2 };
+
+        constexpr int maxQuantizedValue = 127;
+
+        template <typename ValueType>
+        int8_t QuantizeScaledValue(ValueType scaledValue)
+        {
+            // Saturate, then round half away from zero (the compiled code uses the same sequence of operations)
+            scaledValue = std::min(std::max(scaledValue, static_cast<ValueType>(-maxQuantizedValue)), static_cast<ValueType>(maxQuantizedValue));
+            return static_cast<int8_t>(scaledValue + (scaledValue < 0 ? static_cast<ValueType>(-0.5) : static_cast<ValueType>(0.5)));
+        }
+    }
+
+    template <typename ValueType>
+    ValueType GetInt8QuantizationScale(ValueType range)
+    {
+        return range > 0 ? range / maxQuantizedValue : static_cast<ValueType>(1);
+    }
+
+    template <typename ValueType>
+    int8_t QuantizeToInt8(ValueType value, ValueType scale)
+    {
+        return QuantizeScaledValue(value * (1 / scale));
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode()
+        : CompilableNode({ &_input }, { &_output }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 0)
+    {
+    }
+
+    template <typename ValueType>
+    QuantizedMatrixMultiplyNode<ValueType>::QuantizedMatrixMultiplyNode(const model::OutputPort<ValueType>& input, int m, int n, int k, const std::vector<int8_t>& weights, const std::vector<ValueType>& weightScales, ValueType inputScale, bool transposeOutput)
+        : CompilableNode({ &_input }, { &_output }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, m * n), _m(m), _n(n), _k(k), _weights(weights), _weightScales(weightScales), _inputScale(inputScale), _transposeOutput(transposeOutput)
+    {
+        if (static_cast<int>(input.Size()) != k * n)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input matrix size incorrect");
+        }
+
+        if (static_cast<int>(weights.size()) != m * k)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Weights matrix size incorrect");
+        }
+
+        if (static_cast<int>(weightScales.size()) != m)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Must have one weight scale per row of the weights matrix");
+        }
+
+        if (inputScale <= 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Input scale must be positive");
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Compute() const
+    {
+        auto inputValues = _input.GetValue();
+
+        // Quantize the input, storing it transposed so the inner products run over contiguous memory
+        const ValueType inputScaleInverse = 1 / _inputScale;
+        std::vector<int8_t> quantizedInput(_k * _n);
+        for (int j = 0; j < _n; ++j)
+        {
+            for (int l = 0; l < _k; ++l)
+            {
+                quantizedInput[j * _k + l] = QuantizeScaledValue(inputValues[l * _n + j] * inputScaleInverse);
+            }
+        }
+
+        std::vector<ValueType> outputValues(_m * _n);
+        for (int j = 0; j < _n; ++j)
+        {
+            for (int i = 0; i < _m; ++i)
+            {
+                int32_t accum = 0;
+                for (int l = 0; l < _k; ++l)
+                {
+                    accum += static_cast<int32_t>(_weights[i * _k + l]) * static_cast<int32_t>(quantizedInput[j * _k + l]);
+                }
+
+                auto outputIndex = _transposeOutput ? (j * _m + i) : (i * _n + j);
+                outputValues[outputIndex] = static_cast<ValueType>(accum) * _weightScales[i] * _inputScale;
+            }
+        }
+
+        _output.SetOutput(outputValues);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        using namespace std::string_literals;
+
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+
+        auto& module = function.GetModule();
+        auto weights = module.ConstantArray("quantizedWeights_"s + GetInternalStateIdentifier(), _weights);
+        auto weightScales = module.ConstantArray("weightScales_"s + GetInternalStateIdentifier(), _weightScales);
+        auto quantizedInput = module.GlobalArray(emitters::VariableType::Char8, "quantizedInput_"s + GetInternalStateIdentifier(), _k * _n);
+
+        const int m = _m;
+        const int n = _n;
+        const int k = _k;
+        const bool transposeOutput = _transposeOutput;
+        const ValueType inputScale = _inputScale;
+        const ValueType inputScaleInverse = 1 / _inputScale;
+
+        // Quantize the input, storing it transposed so the inner products run over contiguous memory
+        function.For(n, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar j) {
+            function.For(k, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar l) {
+                auto value = function.LocalScalar(function.ValueAt(pInput, l * n + j)) * inputScaleInverse;
+                value = emitters::Min(emitters::Max(value, static_cast<ValueType>(-maxQuantizedValue)), static_cast<ValueType>(maxQuantizedValue));
+                auto rounding = function.Select(value < static_cast<ValueType>(0), function.Literal(static_cast<ValueType>(-0.5)), function.Literal(static_cast<ValueType>(0.5)));
+                auto quantized = function.CastFloatToInt(value + rounding, emitters::VariableType::Char8);
+                function.SetValueAt(quantizedInput, j * k + l, quantized);
+            });
+        });
+
+        // Multiply with int32 accumulation, then rescale the result. The output is computed in blocks of `blockRows` x
+        // `blockColumns` entries, so each vector of weights and of inputs loaded from memory is used by several dot products.
+        // The dot products over k are vectorized: each step loads `vectorWidth` int8 values from every row of weights and
+        // column of input in the block, and accumulates their sign-extended products in int32 vectors. The vector width
+        // is that of the int32 accumulators, so each accumulator fits in one register.
+        const int vectorWidth = emitters::GetVectorWidth<int32_t>(module.GetCompilerOptions());
+        auto emitBlock = [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iStart, emitters::IRLocalScalar jStart, int numRows, int numColumns) {
+            auto& emitter = function.GetEmitter();
+            const int numAccumulators = numRows * numColumns;
+            std::vector<emitters::LLVMValue> scalarAccumulators;
+            std::vector<emitters::LLVMValue> vectorAccumulators;
+            for (int index = 0; index < numAccumulators; ++index)
+            {
+                scalarAccumulators.push_back(function.Variable(emitters::VariableType::Int32, "accum"));
+                function.StoreZero(scalarAccumulators.back());
+                if (vectorWidth > 1)
+                {
+                    auto vectorType = emitter.VectorType(emitters::VariableType::Int32, vectorWidth);
+                    vectorAccumulators.push_back(function.Variable(vectorType, "vecAccum"));
+                    function.Store(vectorAccumulators.back(), emitters::FillVector<int32_t>(function, vectorType, 0));
+                }
+            }
+
+            emitters::VectorizedFor(function, k, vectorWidth, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar l, int width) {
+                auto& emitter = function.GetEmitter();
+                auto widen = [&emitter, &function, width](emitters::LLVMValue value) {
+                    return width == 1 ? emitter.CastInt(value, emitters::VariableType::Int32, true) : emitter.GetIRBuilder().CreateSExt(value, emitter.VectorType(emitters::VariableType::Int32, width));
+                };
+
+                std::vector<emitters::LLVMValue> weightValues;
+                for (int row = 0; row < numRows; ++row)
+                {
+                    weightValues.push_back(widen(emitters::LoadVector<int8_t>(function, weights, (iStart + row) * k + l, width)));
+                }
+                for (int column = 0; column < numColumns; ++column)
+                {
+                    auto inputValue = widen(emitters::LoadVector<int8_t>(function, quantizedInput, (jStart + column) * k + l, width));
+                    for (int row = 0; row < numRows; ++row)
+                    {
+                        const auto& accumulators = width == 1 ? scalarAccumulators : vectorAccumulators;
+                        auto product = function.Operator(emitters::TypedOperator::multiply, weightValues[row], inputValue);
+                        function.OperationAndUpdate(accumulators[row * numColumns + column], emitters::TypedOperator::add, product);
+                    }
+                }
+            });
+
+            for (int row = 0; row < numRows; ++row)
+            {
+                for (int column = 0; column < numColumns; ++column)
+                {
+                    auto index = row * numColumns + column;
+                    emitters::LLVMValue accum = function.Load(scalarAccumulators[index]);
+                    if (vectorWidth > 1)
+                    {
+                        accum = function.Operator(emitters::TypedOperator::add, emitters::HorizontalVectorSum<int32_t>(function, function.Load(vectorAccumulators[index])), accum);
+                    }
+
+                    auto i = iStart + row;
+                    auto j = jStart + column;
+                    auto result = function.LocalScalar(function.CastIntToFloat(accum, emitters::GetVariableType<ValueType>(), true)) * function.ValueAt(weightScales, i) * inputScale;
+                    auto outputIndex = transposeOutput ? (j * m + i) : (i * n + j);
+                    function.SetValueAt(pOutput, outputIndex, result);
+                }
+            }
+        };
+
+        // Loop over the blocks, and then over the rows and columns left over at the edges in smaller blocks
+        const int blockRows = 4;
+        const int blockColumns = 2;
+        auto emitBlockRow = [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar jStart, int numColumns) {
+            if (m / blockRows > 0)
+            {
+                function.For(m / blockRows, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar iBlock) {
+                    emitBlock(function, iBlock * blockRows, jStart, blockRows, numColumns);
+                });
+            }
+            if (m % blockRows != 0)
+            {
+                emitBlock(function, function.LocalScalar(m - m % blockRows), jStart, m % blockRows, numColumns);
+            }
+        };
+
+        if (n / blockColumns > 0)
+        {
+            function.For(n / blockColumns, [=](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar jBlock) {
+                emitBlockRow(function, jBlock * blockColumns, blockColumns);
+            });
+        }
+        if (n % blockColumns != 0)
+        {
+            emitBlockRow(function, function.LocalScalar(n - n % blockColumns), n % blockColumns);
+        }
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::Copy(model::ModelTransformer& transformer) const
+    {
+        const auto& newPortElements = transformer.GetCorrespondingInputs(_input);
+        auto newNode = transformer.AddNode<QuantizedMatrixMultiplyNode<ValueType>>(newPortElements, _m, _n, _k, _weights, _weightScales, _inputScale, _transposeOutput);
+        transformer.MapNodeOutput(output, newNode->output);
+    }
+
+    template <typename ValueType>
+    utilities::ArchiveVersion QuantizedMatrixMultiplyNode<ValueType>::GetArchiveVersion() const
+    {
+        return std::max(currentArchiveVersion, CompilableNode::GetArchiveVersion());
+    }
+
+    template <typename ValueType>
+    bool QuantizedMatrixMultiplyNode<ValueType>::CanReadArchiveVersion(const utilities::ArchiveVersion& version) const
+    {
+        return CompilableNode::CanReadArchiveVersion(version);
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::WriteToArchive(utilities::Archiver& archiver) const
+    {
+        Node::WriteToArchive(archiver);
+        archiver[defaultInputPortName] << _input;
+        archiver[defaultOutputPortName] << _output;
+        archiver["m"] << _m;
+        archiver["n"] << _n;
+        archiver["k"] << _k;
+        archiver["weights"] << std::vector<int>(_weights.begin(), _weights.end()); // int8 isn't an archivable type
+        archiver["weightScales"] << _weightScales;
+        archiver["inputScale"] << _inputScale;
+        archiver["transposeOutput"] << _transposeOutput;
+    }
+
+    template <typename ValueType>
+    void QuantizedMatrixMultiplyNode<ValueType>::ReadFromArchive(utilities::Unarchiver& archiver)
+    {
+        Node::ReadFromArchive(archiver);
+        archiver[defaultInputPortName] >> _input;
+        archiver[defaultOutputPortName] >> _output;
+        archiver["m"] >> _m;
+        archiver["n"] >> _n;
+        archiver["k"] >> _k;
+        std::vector<int> weights;
+        archiver["weights"] >> weights;
+        _weights.assign(weights.begin(), weights.end());
+        archiver["weightScales"] >> _weightScales;
+        archiver["inputScale"] >> _inputScale;
+        archiver["transposeOutput"] >> _transposeOutput;
+    }
+
+    // Explicitly instantiate versions
+    template float GetInt8QuantizationScale<float>(float range);
+    template double GetInt8QuantizationScale<double>(double range);
+    template int8_t QuantizeToInt8<float>(float value, float scale);
+    template int8_t QuantizeToInt8<double>(double value, double scale);
+    template class QuantizedMatrixMultiplyNode<float>;
+    template class QuantizedMatrixMultiplyNode<double>;
+}
+}
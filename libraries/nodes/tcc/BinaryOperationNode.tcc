@@ -294,9 +294,23 @@ namespace nodes
         emitters::LLVMValue pResult = compiler.EnsurePortEmitted(output);
 
         auto count = input1.Size();
-        function.VectorOperator(emitters::GetOperator<ValueType>(GetOperation()), count, pInput1, pInput2, [&pResult, &function](emitters::LLVMValue i, emitters::LLVMValue pValue) {
-            function.SetValueAt(pResult, i, pValue);
-        });
+        const auto& compilerSettings = compiler.GetCompilerOptions();
+        if (compilerSettings.allowVectorInstructions && !std::is_same<ValueType, bool>::value)
+        {
+            const auto op = emitters::GetOperator<ValueType>(GetOperation());
+            const int vectorSize = emitters::GetVectorWidth<ValueType>(compilerSettings);
+            emitters::VectorizedFor(function, count, vectorSize, [pInput1, pInput2, pResult, op](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i, int width) {
+                auto value1 = emitters::LoadVector<ValueType>(function, pInput1, i, width);
+                auto value2 = emitters::LoadVector<ValueType>(function, pInput2, i, width);
+                emitters::StoreVector<ValueType>(function, pResult, i, function.Operator(op, value1, value2));
+            });
+        }
+        else
+        {
+            function.VectorOperator(emitters::GetOperator<ValueType>(GetOperation()), count, pInput1, pInput2, [&pResult, &function](emitters::LLVMValue i, emitters::LLVMValue pValue) {
+                function.SetValueAt(pResult, i, pValue);
+            });
+        }
     }
 
     template <typename ValueType>
@@ -287,6 +287,41 @@ namespace nodes
         const auto broadcastDimension = GetBroadcastDimension();
         const auto numSecondaryInputs = NumSecondaryInputs();
 
+        // The innermost dimension is contiguous in memory, so (if the function allows it) we can process it a vector at a time
+        const auto& compilerSettings = compiler.GetCompilerOptions();
+        auto constantBegin = llvm::dyn_cast<llvm::ConstantInt>(begin.value);
+        auto constantEnd = llvm::dyn_cast<llvm::ConstantInt>(end.value);
+        if (dimension == numDimensions - 1 && compilerSettings.allowVectorInstructions && GetFunction().CanUseVectorTypes() && constantBegin != nullptr && constantEnd != nullptr)
+        {
+            const int loopBegin = static_cast<int>(constantBegin->getSExtValue());
+            const int count = static_cast<int>(constantEnd->getSExtValue()) - loopBegin;
+            const int vectorSize = emitters::GetVectorWidth<ValueType>(compilerSettings);
+            emitters::VectorizedFor(function, count, vectorSize, [dimension, loopBegin, inputOffset, inputStride, outputOffset, outputStride, broadcastDimension, numSecondaryInputs, prevInputDimensionOffset, prevOutputDimensionOffset, primaryInput, secondaryInputs, output, &secondaryValues, this](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar index, int width) {
+                auto loopIndex = index + loopBegin;
+                auto thisInputDimensionOffset = dimension == 0 ? loopIndex + inputOffset[dimension] : loopIndex + inputOffset[dimension] + (prevInputDimensionOffset * inputStride[dimension]);
+                auto thisOutputDimensionOffset = dimension == 0 ? loopIndex + outputOffset[dimension] : loopIndex + outputOffset[dimension] + (prevOutputDimensionOffset * outputStride[dimension]);
+
+                // Secondary values along the innermost dimension are loaded a vector at a time, the others are replicated across the vector
+                std::vector<emitters::LLVMValue> vectorSecondaryValues(numSecondaryInputs, nullptr);
+                for (int secondaryIndex = 0; secondaryIndex < numSecondaryInputs; ++secondaryIndex)
+                {
+                    if (dimension == broadcastDimension)
+                    {
+                        vectorSecondaryValues[secondaryIndex] = this->IsSecondaryInputPresent(secondaryIndex) ? emitters::LoadVector<ValueType>(function, secondaryInputs[secondaryIndex], loopIndex, width) : nullptr;
+                    }
+                    else if (secondaryValues[secondaryIndex] != nullptr)
+                    {
+                        vectorSecondaryValues[secondaryIndex] = emitters::BroadcastVector(function, secondaryValues[secondaryIndex], width);
+                    }
+                }
+
+                auto primaryValue = emitters::LoadVector<ValueType>(function, primaryInput, thisInputDimensionOffset, width);
+                auto outputValue = this->GetFunction().Compile(function, primaryValue, vectorSecondaryValues);
+                emitters::StoreVector<ValueType>(function, output, thisOutputDimensionOffset, outputValue);
+            });
+            return;
+        }
+
         function.For(begin, end, [dimension, numDimensions, inputSize, inputOffset, inputStride, outputOffset, outputStride, broadcastDimension, numSecondaryInputs, prevInputDimensionOffset, prevOutputDimensionOffset, primaryInput, secondaryInputs, output, &secondaryValues, &compiler, this](emitters::IRFunctionEmitter& function, auto loopIndex) {
             // Calculate the offset within this dimension = (loopIndex + offset[dimension])
             auto thisInputDimensionInternalOffset = loopIndex + inputOffset[dimension];
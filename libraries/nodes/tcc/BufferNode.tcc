@@ -6,6 +6,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// emitters
+#include "IRLocalScalar.h"
+
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace nodes
@@ -27,22 +33,29 @@ namespace nodes
     void BufferNode<ValueType>::Compute() const
     {
         auto inputSize = input.Size();
-        if (inputSize > _samples.size())
-        {
-            inputSize = _samples.size();
-        }
-        auto offset = _samples.size() - inputSize;
-        if (offset > 0)
+        if (inputSize >= _windowSize)
         {
-            // Copy samples forward to make room for new samples
-            std::copy_n(_samples.begin() + offset, inputSize, _samples.begin());
+            // The input fills the whole window
+            for (size_t index = 0; index < _windowSize; ++index)
+            {
+                _samples[index] = _input[index];
+            }
+            _position = 0;
+            _output.SetOutput(_samples);
+            return;
         }
-        // Copy input samples to tail
+
+        // Overwrite the oldest samples with the input samples, wrapping around the end of the buffer
         for (size_t index = 0; index < inputSize; ++index)
         {
-            _samples[index + offset] = _input[index];
+            _samples[(_position + index) % _windowSize] = _input[index];
         }
-        _output.SetOutput(_samples);
+        _position = (_position + inputSize) % _windowSize;
+
+        // The window starts with the oldest sample
+        std::vector<ValueType> window(_windowSize);
+        std::rotate_copy(_samples.begin(), _samples.begin() + _position, _samples.end(), window.begin());
+        _output.SetOutput(window);
     };
 
     template <typename ValueType>
@@ -56,24 +69,41 @@ namespace nodes
     template <typename ValueType>
     void BufferNode<ValueType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        int inputSize = input.Size();
-        size_t windowSize = this->GetWindowSize();
-        auto offset = windowSize - inputSize;
+        const int inputSize = static_cast<int>(input.Size());
+        const int windowSize = static_cast<int>(GetWindowSize());
 
         emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
-        auto bufferVar = function.GetModule().Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
-        function.GetModule().AllocateVariable(*bufferVar);
-        emitters::LLVMValue buffer = function.GetModule().EnsureEmitted(*bufferVar);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        if (inputSize >= windowSize)
+        {
+            // The input fills the whole window
+            function.MemoryCopy<ValueType>(pInput, pOutput, windowSize);
+            return;
+        }
 
-        // Copy samples forward to make room for new samples
-        function.MemoryMove<ValueType>(buffer, offset, 0, inputSize);
+        auto& module = function.GetModule();
+        auto bufferVar = module.Variables().AddVectorVariable<ValueType>(emitters::VariableScope::global, windowSize);
+        module.AllocateVariable(*bufferVar);
+        emitters::LLVMValue buffer = module.EnsureEmitted(*bufferVar);
+        llvm::GlobalVariable* positionVar = module.Global<int>(compiler.GetGlobalName(*this, "bufferPosition"), 0);
 
-        // Copy input samples to tail
-        function.MemoryCopy<ValueType>(pInput, 0, buffer, offset, inputSize);
+        // The buffer is a ring, and the oldest sample is at `position`. Instead of moving the buffer's contents to make
+        // room for the input samples, overwrite the oldest samples with them, wrapping around the end of the buffer.
+        auto zero = function.LocalScalar(0);
+        auto window = function.LocalScalar(windowSize);
+        auto position = function.LocalScalar(function.Load(positionVar));
+        auto firstCount = Min(function.LocalScalar(inputSize), window - position);
+        auto secondCount = function.LocalScalar(inputSize) - firstCount;
+        function.MemoryCopy<ValueType>(pInput, zero, buffer, position, firstCount);
+        function.MemoryCopy<ValueType>(pInput, firstCount, buffer, zero, secondCount);
 
-        // Copy to output
-        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
-        function.MemoryCopy<ValueType>(buffer, 0, pOutput, 0, windowSize);
+        auto newPosition = (position + inputSize) % windowSize;
+        function.Store(positionVar, newPosition);
+
+        // Copy to output, starting with the oldest sample
+        auto tailCount = window - newPosition;
+        function.MemoryCopy<ValueType>(buffer, newPosition, pOutput, zero, tailCount);
+        function.MemoryCopy<ValueType>(buffer, zero, pOutput, tailCount, newPosition);
     }
 
     template <typename ValueType>
@@ -91,7 +121,8 @@ namespace nodes
         archiver[defaultInputPortName] >> _input;
         archiver["windowSize"] >> _windowSize;
 
-        _samples.resize(_windowSize);
+        _samples.assign(_windowSize, 0);
+        _position = 0;
         _output.SetSize(_windowSize);
     }
 }
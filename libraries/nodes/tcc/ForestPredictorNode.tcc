@@ -14,23 +14,211 @@
 #include "SingleElementThresholdNode.h"
 #include "SumNode.h"
 
+// utilities
+#include "Exception.h"
+
 // stl
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ell
 {
 namespace nodes
 {
+    namespace ForestPredictorNodeImpl
+    {
+        // A forest of binary trees, stored in flat arrays indexed by interior node or by edge. Edge `firstEdgeIndices[node]`
+        // is taken when input[splitFeatures[node]] <= splitThresholds[node], and the edge after it otherwise.
+        struct FlatForest
+        {
+            std::vector<int> rootIndices;
+            std::vector<int> splitFeatures;
+            std::vector<double> splitThresholds;
+            std::vector<int> firstEdgeIndices;
+            std::vector<double> edgeValues;
+            std::vector<int> edgeTargets; // the interior node the edge leads to, or -1 if it leads to a leaf
+        };
+
+        // The splits of a forest in the order QuickScorer visits them: grouped by feature, and by increasing threshold within each
+        // feature. The leaves of each tree are numbered from left to right, and each split's mask clears the leaves that can't be
+        // reached when the split's test is true. The exit leaf of a tree is the lowest bit that survives all the true splits.
+        struct QuickScorerForest
+        {
+            std::vector<int> features;
+            std::vector<int> featureSplitsBegin; // the splits of features[i] are [featureSplitsBegin[i], featureSplitsBegin[i+1])
+            std::vector<double> splitThresholds; // followed by an unused sentinel, so the loop condition can always read one past the end
+            std::vector<int> splitTrees;
+            std::vector<int64_t> splitMasks;
+            std::vector<int> treeLeafOffsets;
+            std::vector<double> leafValues; // the output of the tree when this leaf is the exit leaf
+            std::vector<int> leafPathsBegin; // the path to leaf i is [leafPathsBegin[i], leafPathsBegin[i+1])
+            std::vector<int> leafPathEdges;
+        };
+
+        // QuickScorer represents the leaves of a tree with a 64-bit vector
+        constexpr int maxQuickScorerLeaves = 64;
+
+        inline void GetSplit(const predictors::SingleElementThresholdPredictor& splitRule, int& feature, double& threshold)
+        {
+            feature = static_cast<int>(splitRule.GetElementIndex());
+            threshold = splitRule.GetThreshold();
+        }
+
+        template <typename SplitRuleType>
+        void GetSplit(const SplitRuleType& splitRule, int& feature, double& threshold)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Only forests with single element threshold split rules can be compiled");
+        }
+
+        inline double GetEdgeValue(const predictors::ConstantPredictor& edgePredictor)
+        {
+            return edgePredictor.GetValue();
+        }
+
+        template <typename EdgePredictorType>
+        double GetEdgeValue(const EdgePredictorType& edgePredictor)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Only forests with constant edge predictors can be compiled");
+        }
+
+        // Returns true if every interior node of the forest has exactly two outgoing edges
+        template <typename ForestType>
+        bool IsBinaryForest(const ForestType& forest)
+        {
+            const auto& interiorNodes = forest.GetInteriorNodes();
+            return std::all_of(interiorNodes.begin(), interiorNodes.end(), [](const auto& interiorNode) { return interiorNode.GetOutgoingEdges().size() == 2; });
+        }
+
+        template <typename ForestType>
+        FlatForest FlattenForest(const ForestType& forest)
+        {
+            FlatForest result;
+            for (auto rootIndex : forest.GetRootIndices())
+            {
+                result.rootIndices.push_back(static_cast<int>(rootIndex));
+            }
+
+            result.edgeValues.resize(forest.NumEdges());
+            result.edgeTargets.resize(forest.NumEdges());
+            for (const auto& interiorNode : forest.GetInteriorNodes())
+            {
+                const auto& edges = interiorNode.GetOutgoingEdges();
+                if (edges.size() != 2)
+                {
+                    throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "Only forests of binary trees can be compiled");
+                }
+
+                int feature = 0;
+                double threshold = 0;
+                GetSplit(interiorNode.GetSplitRule(), feature, threshold);
+                result.splitFeatures.push_back(feature);
+                result.splitThresholds.push_back(threshold);
+
+                auto firstEdgeIndex = interiorNode.GetFirstEdgeIndex();
+                result.firstEdgeIndices.push_back(static_cast<int>(firstEdgeIndex));
+                for (size_t edgePosition = 0; edgePosition < edges.size(); ++edgePosition)
+                {
+                    const auto& edge = edges[edgePosition];
+                    result.edgeValues[firstEdgeIndex + edgePosition] = GetEdgeValue(edge.GetPredictor());
+                    result.edgeTargets[firstEdgeIndex + edgePosition] = edge.IsTargetInterior() ? static_cast<int>(edge.GetTargetNodeIndex()) : -1;
+                }
+            }
+            return result;
+        }
+
+        // Numbers the leaves below `nodeIndex` from left to right, and adds the splits of the subtree to `splits`
+        inline void AddQuickScorerSubtree(const FlatForest& forest, int treeIndex, int treeLeafOffset, int nodeIndex, std::vector<int>& path, double pathValue, std::vector<std::tuple<int, double, int, int64_t>>& splits, QuickScorerForest& result)
+        {
+            int leftLeavesBegin = 0;
+            int leftLeavesEnd = 0;
+            for (int edgePosition = 0; edgePosition < 2; ++edgePosition)
+            {
+                auto edgeIndex = forest.firstEdgeIndices[nodeIndex] + edgePosition;
+                auto edgePathValue = pathValue + forest.edgeValues[edgeIndex];
+                path.push_back(edgeIndex);
+                if (edgePosition == 0)
+                {
+                    leftLeavesBegin = static_cast<int>(result.leafValues.size()) - treeLeafOffset;
+                }
+
+                if (forest.edgeTargets[edgeIndex] >= 0)
+                {
+                    AddQuickScorerSubtree(forest, treeIndex, treeLeafOffset, forest.edgeTargets[edgeIndex], path, edgePathValue, splits, result);
+                }
+                else
+                {
+                    result.leafValues.push_back(edgePathValue);
+                    result.leafPathEdges.insert(result.leafPathEdges.end(), path.begin(), path.end());
+                    result.leafPathsBegin.push_back(static_cast<int>(result.leafPathEdges.size()));
+                }
+
+                if (edgePosition == 0)
+                {
+                    leftLeavesEnd = static_cast<int>(result.leafValues.size()) - treeLeafOffset;
+                }
+                path.pop_back();
+            }
+
+            // Trees with too many leaves are rejected by the caller, so their masks are skipped rather than shifted out of range
+            auto numLeftLeaves = leftLeavesEnd - leftLeavesBegin;
+            if (leftLeavesEnd < maxQuickScorerLeaves)
+            {
+                auto leftLeaves = ((uint64_t{ 1 } << numLeftLeaves) - 1) << leftLeavesBegin;
+                splits.emplace_back(forest.splitFeatures[nodeIndex], forest.splitThresholds[nodeIndex], treeIndex, static_cast<int64_t>(~leftLeaves));
+            }
+        }
+
+        // Returns false if a tree has too many leaves for QuickScorer
+        inline bool GetQuickScorerForest(const FlatForest& forest, QuickScorerForest& result)
+        {
+            std::vector<std::tuple<int, double, int, int64_t>> splits; // (feature, threshold, tree, mask)
+            std::vector<int> path;
+            result.leafPathsBegin.push_back(0);
+            for (size_t treeIndex = 0; treeIndex < forest.rootIndices.size(); ++treeIndex)
+            {
+                auto treeLeafOffset = static_cast<int>(result.leafValues.size());
+                result.treeLeafOffsets.push_back(treeLeafOffset);
+                AddQuickScorerSubtree(forest, static_cast<int>(treeIndex), treeLeafOffset, forest.rootIndices[treeIndex], path, 0.0, splits, result);
+                if (static_cast<int>(result.leafValues.size()) - treeLeafOffset > maxQuickScorerLeaves)
+                {
+                    return false;
+                }
+            }
+
+            std::stable_sort(splits.begin(), splits.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b) || (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) < std::get<1>(b)); });
+            for (size_t splitIndex = 0; splitIndex < splits.size(); ++splitIndex)
+            {
+                auto feature = std::get<0>(splits[splitIndex]);
+                if (result.features.empty() || result.features.back() != feature)
+                {
+                    result.features.push_back(feature);
+                    result.featureSplitsBegin.push_back(static_cast<int>(splitIndex));
+                }
+                result.splitThresholds.push_back(std::get<1>(splits[splitIndex]));
+                result.splitTrees.push_back(std::get<2>(splits[splitIndex]));
+                result.splitMasks.push_back(std::get<3>(splits[splitIndex]));
+            }
+            result.featureSplitsBegin.push_back(static_cast<int>(splits.size()));
+            result.splitThresholds.push_back(0.0);
+            return true;
+        }
+    }
+
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode(const model::OutputPort<double>& input, const predictors::ForestPredictor<SplitRuleType, EdgePredictorType>& forest)
-        : Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, forest.NumTrees()), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.NumEdges()), _forest(forest)
+        : CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, input, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, forest.NumTrees()), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, forest.NumEdges()), _forest(forest)
     {
     }
 
     template <typename SplitRuleType, typename EdgePredictorType>
     ForestPredictorNode<SplitRuleType, EdgePredictorType>::ForestPredictorNode()
-        : Node({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, 0), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
+        : CompilableNode({ &_input }, { &_output, &_treeOutputs, &_edgeIndicatorVector }), _input(this, {}, defaultInputPortName), _output(this, defaultOutputPortName, 1), _treeOutputs(this, treeOutputsPortName, 0), _edgeIndicatorVector(this, edgeIndicatorVectorPortName, 0)
     {
     }
 
@@ -184,5 +372,192 @@ namespace nodes
         auto edgeIndicator = _forest.GetEdgeIndicatorVector(inputDataVector);
         _edgeIndicatorVector.SetOutput(std::move(edgeIndicator));
     }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    bool ForestPredictorNode<SplitRuleType, EdgePredictorType>::IsCompilable(const model::MapCompiler* compiler) const
+    {
+        const bool isSimpleForest = std::is_same<SplitRuleType, predictors::SingleElementThresholdPredictor>::value && std::is_same<EdgePredictorType, predictors::ConstantPredictor>::value;
+        // Other forests are refined into dataflow nodes instead
+        return isSimpleForest && compiler != nullptr && compiler->GetMapCompilerOptions().forestLowering != model::ForestLoweringStrategy::dataflow && ForestPredictorNodeImpl::IsBinaryForest(_forest);
+    }
+
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::Compile(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pOutput = compiler.EnsurePortEmitted(output);
+        emitters::LLVMValue pTreeOutputs = compiler.EnsurePortEmitted(treeOutputs);
+        emitters::LLVMValue pEdgeIndicator = compiler.EnsurePortEmitted(edgeIndicatorVector);
+
+        const int numTrees = static_cast<int>(_forest.NumTrees());
+        const int numEdges = static_cast<int>(_forest.NumEdges());
+
+        // Only the edges on the paths to the exit leaves are set below
+        function.For(numEdges, [pEdgeIndicator](emitters::IRFunctionEmitter& function, auto i) {
+            function.SetValueAt(pEdgeIndicator, i, function.Literal<uint8_t>(0));
+        });
+
+        if (numTrees > 0)
+        {
+            switch (compiler.GetMapCompilerOptions().forestLowering)
+            {
+            case model::ForestLoweringStrategy::branching:
+                CompileBranching(function, pInput, pTreeOutputs, pEdgeIndicator);
+                break;
+            case model::ForestLoweringStrategy::quickScorer:
+                CompileQuickScorer(function, pInput, pTreeOutputs, pEdgeIndicator);
+                break;
+            default:
+                CompileFlattened(function, pInput, pTreeOutputs, pEdgeIndicator);
+                break;
+            }
+        }
+
+        // output = bias + sum of the tree outputs
+        auto sumVar = function.Variable(emitters::VariableType::Double, "forestSum");
+        function.Store(sumVar, function.Literal(_forest.GetBias()));
+        function.For(numTrees, [sumVar, pTreeOutputs](emitters::IRFunctionEmitter& function, auto treeIndex) {
+            function.Store(sumVar, function.LocalScalar(function.Load(sumVar)) + function.ValueAt(pTreeOutputs, treeIndex));
+        });
+        function.SetValueAt(pOutput, function.Literal(0), function.Load(sumVar));
+    }
+
+    // Emits nested if/else statements that follow the tree down from `nodeIndex`. The path values and edge indices are known
+    // when the code is emitted, so each leaf stores a constant.
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::CompileBranching(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator)
+    {
+        auto flatForest = ForestPredictorNodeImpl::FlattenForest(_forest);
+
+        std::function<void(emitters::IRFunctionEmitter&, int, int, double)> emitSubtree;
+        emitSubtree = [&](emitters::IRFunctionEmitter& function, int treeIndex, int nodeIndex, double pathValue) {
+            auto emitEdge = [&](emitters::IRFunctionEmitter& function, int edgeIndex) {
+                function.SetValueAt(pEdgeIndicator, function.Literal(edgeIndex), function.Literal<uint8_t>(1));
+                auto edgePathValue = pathValue + flatForest.edgeValues[edgeIndex];
+                auto target = flatForest.edgeTargets[edgeIndex];
+                if (target >= 0)
+                {
+                    emitSubtree(function, treeIndex, target, edgePathValue);
+                }
+                else
+                {
+                    function.SetValueAt(pTreeOutputs, function.Literal(treeIndex), function.Literal(edgePathValue));
+                }
+            };
+
+            auto firstEdgeIndex = flatForest.firstEdgeIndices[nodeIndex];
+            auto x = function.LocalScalar(function.ValueAt(pInput, function.Literal(flatForest.splitFeatures[nodeIndex])));
+            function.If(x > flatForest.splitThresholds[nodeIndex], [&](emitters::IRFunctionEmitter& function) {
+                emitEdge(function, firstEdgeIndex + 1);
+            })
+            .Else([&](emitters::IRFunctionEmitter& function) {
+                emitEdge(function, firstEdgeIndex);
+            });
+        };
+
+        for (size_t treeIndex = 0; treeIndex < flatForest.rootIndices.size(); ++treeIndex)
+        {
+            emitSubtree(function, static_cast<int>(treeIndex), flatForest.rootIndices[treeIndex], 0.0);
+        }
+    }
+
+    // Emits a loop that walks each tree from its root, reading the splits and edges from constant arrays
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::CompileFlattened(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator)
+    {
+        using namespace std::string_literals;
+        auto flatForest = ForestPredictorNodeImpl::FlattenForest(_forest);
+
+        auto& module = function.GetModule();
+        auto rootsVar = module.ConstantArray("forestRoots_"s + GetInternalStateIdentifier(), flatForest.rootIndices);
+        auto featuresVar = module.ConstantArray("forestSplitFeatures_"s + GetInternalStateIdentifier(), flatForest.splitFeatures);
+        auto thresholdsVar = module.ConstantArray("forestSplitThresholds_"s + GetInternalStateIdentifier(), flatForest.splitThresholds);
+        auto firstEdgesVar = module.ConstantArray("forestFirstEdges_"s + GetInternalStateIdentifier(), flatForest.firstEdgeIndices);
+        auto edgeValuesVar = module.ConstantArray("forestEdgeValues_"s + GetInternalStateIdentifier(), flatForest.edgeValues);
+        auto edgeTargetsVar = module.ConstantArray("forestEdgeTargets_"s + GetInternalStateIdentifier(), flatForest.edgeTargets);
+
+        auto nodeVar = function.Variable(emitters::VariableType::Int32, "forestNode");
+        auto pathValueVar = function.Variable(emitters::VariableType::Double, "forestPathValue");
+        auto notDoneVar = function.Variable(function.TrueBit()->getType(), "forestNotDone");
+        function.For(static_cast<int>(flatForest.rootIndices.size()), [=](emitters::IRFunctionEmitter& function, auto treeIndex) {
+            function.Store(nodeVar, function.ValueAt(rootsVar, treeIndex));
+            function.Store(pathValueVar, function.Literal(0.0));
+            function.Store(notDoneVar, function.TrueBit());
+            function.While(notDoneVar, [=](emitters::IRFunctionEmitter& function) {
+                auto node = function.LocalScalar(function.Load(nodeVar));
+                auto x = function.LocalScalar(function.ValueAt(pInput, function.ValueAt(featuresVar, node)));
+                auto threshold = function.LocalScalar(function.ValueAt(thresholdsVar, node));
+                auto edge = function.LocalScalar(function.ValueAt(firstEdgesVar, node)) + function.CastValue<bool, int>(x > threshold);
+                function.SetValueAt(pEdgeIndicator, edge, function.Literal<uint8_t>(1));
+                function.Store(pathValueVar, function.LocalScalar(function.Load(pathValueVar)) + function.ValueAt(edgeValuesVar, edge));
+
+                auto target = function.LocalScalar(function.ValueAt(edgeTargetsVar, edge));
+                function.Store(nodeVar, target);
+                function.Store(notDoneVar, target >= 0);
+            });
+            function.SetValueAt(pTreeOutputs, treeIndex, function.Load(pathValueVar));
+        });
+    }
+
+    // Emits QuickScorer: for each feature, a loop applies the masks of the splits whose thresholds the feature value exceeds,
+    // in increasing threshold order, and stops at the first split that is false. Then each tree's exit leaf is the lowest
+    // set bit of its leaf vector. Falls back to the flattened walk if a tree has too many leaves for one bit vector.
+    template <typename SplitRuleType, typename EdgePredictorType>
+    void ForestPredictorNode<SplitRuleType, EdgePredictorType>::CompileQuickScorer(emitters::IRFunctionEmitter& function, emitters::LLVMValue pInput, emitters::LLVMValue pTreeOutputs, emitters::LLVMValue pEdgeIndicator)
+    {
+        using namespace std::string_literals;
+        auto flatForest = ForestPredictorNodeImpl::FlattenForest(_forest);
+        ForestPredictorNodeImpl::QuickScorerForest quickScorerForest;
+        if (!ForestPredictorNodeImpl::GetQuickScorerForest(flatForest, quickScorerForest))
+        {
+            CompileFlattened(function, pInput, pTreeOutputs, pEdgeIndicator);
+            return;
+        }
+
+        auto& module = function.GetModule();
+        auto thresholdsVar = module.ConstantArray("forestQSThresholds_"s + GetInternalStateIdentifier(), quickScorerForest.splitThresholds);
+        auto treesVar = module.ConstantArray("forestQSTrees_"s + GetInternalStateIdentifier(), quickScorerForest.splitTrees);
+        auto masksVar = module.ConstantArray("forestQSMasks_"s + GetInternalStateIdentifier(), quickScorerForest.splitMasks);
+        auto leafOffsetsVar = module.ConstantArray("forestQSLeafOffsets_"s + GetInternalStateIdentifier(), quickScorerForest.treeLeafOffsets);
+        auto leafValuesVar = module.ConstantArray("forestQSLeafValues_"s + GetInternalStateIdentifier(), quickScorerForest.leafValues);
+        auto leafPathsBeginVar = module.ConstantArray("forestQSLeafPathsBegin_"s + GetInternalStateIdentifier(), quickScorerForest.leafPathsBegin);
+        auto leafPathEdgesVar = module.ConstantArray("forestQSLeafPathEdges_"s + GetInternalStateIdentifier(), quickScorerForest.leafPathEdges);
+
+        const int numTrees = static_cast<int>(flatForest.rootIndices.size());
+        auto leafVectors = function.Variable(emitters::VariableType::Int64, numTrees);
+        function.For(numTrees, [leafVectors](emitters::IRFunctionEmitter& function, auto treeIndex) {
+            function.SetValueAt(leafVectors, treeIndex, function.Literal<int64_t>(-1));
+        });
+
+        auto splitIndexVar = function.Variable(emitters::VariableType::Int32, "forestSplitIndex");
+        auto continueVar = function.Variable(function.TrueBit()->getType(), "forestContinue");
+        for (size_t featureIndex = 0; featureIndex < quickScorerForest.features.size(); ++featureIndex)
+        {
+            const int splitsBegin = quickScorerForest.featureSplitsBegin[featureIndex];
+            const int splitsEnd = quickScorerForest.featureSplitsBegin[featureIndex + 1];
+            auto x = function.LocalScalar(function.ValueAt(pInput, function.Literal(quickScorerForest.features[featureIndex])));
+            function.Store(splitIndexVar, function.Literal(splitsBegin));
+            function.Store(continueVar, x > function.LocalScalar(function.ValueAt(thresholdsVar, function.Literal(splitsBegin))));
+            function.While(continueVar, [=](emitters::IRFunctionEmitter& function) {
+                auto splitIndex = function.LocalScalar(function.Load(splitIndexVar));
+                auto treeIndex = function.ValueAt(treesVar, splitIndex);
+                function.SetValueAt(leafVectors, treeIndex, function.LocalScalar(function.ValueAt(leafVectors, treeIndex)) & function.LocalScalar(function.ValueAt(masksVar, splitIndex)));
+
+                auto nextSplitIndex = splitIndex + 1;
+                function.Store(splitIndexVar, nextSplitIndex);
+                function.Store(continueVar, (nextSplitIndex < splitsEnd) && (x > function.LocalScalar(function.ValueAt(thresholdsVar, nextSplitIndex))));
+            });
+        }
+
+        auto cttzFunction = module.GetIntrinsic(llvm::Intrinsic::cttz, { emitters::VariableType::Int64 });
+        function.For(numTrees, [=](emitters::IRFunctionEmitter& function, auto treeIndex) {
+            auto exitLeaf = function.CastValue<int64_t, int>(function.Call(cttzFunction, { function.ValueAt(leafVectors, treeIndex), function.FalseBit() }));
+            auto leafIndex = function.LocalScalar(function.ValueAt(leafOffsetsVar, treeIndex)) + exitLeaf;
+            function.SetValueAt(pTreeOutputs, treeIndex, function.ValueAt(leafValuesVar, leafIndex));
+            function.For(function.ValueAt(leafPathsBeginVar, leafIndex), function.ValueAt(leafPathsBeginVar, leafIndex + 1), [=](emitters::IRFunctionEmitter& function, auto pathIndex) {
+                function.SetValueAt(pEdgeIndicator, function.ValueAt(leafPathEdgesVar, pathIndex), function.Literal<uint8_t>(1));
+            });
+        });
+    }
 }
 }
@@ -49,7 +49,7 @@ namespace nodes
     {
         if (!compiler.GetCompilerOptions().unrollLoops)
         {
-            size_t vectorSize = compiler.GetCompilerOptions().vectorWidth;
+            size_t vectorSize = emitters::GetVectorWidth<ValueType>(compiler.GetCompilerOptions());
             bool vectorize = compiler.GetCompilerOptions().allowVectorInstructions && (input.Size() > vectorSize);
             if (vectorize)
             {
@@ -112,46 +112,10 @@ namespace nodes
     template <typename ValueType>
     void SumNode<ValueType>::CompileVectorizedLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
-        const int size = _input.Size();
-        const int vectorSize = compiler.GetCompilerOptions().vectorWidth;
-        assert(size >= vectorSize);
-
         emitters::LLVMValue input = compiler.EnsurePortEmitted(_input);
         emitters::LLVMValue output = compiler.EnsurePortEmitted(_output);
 
-        // Get LLVM types
-        auto& emitter = function.GetEmitter();
-        auto elementType = emitter.Type(emitters::GetVariableType<ValueType>());
-        DEBUG_USED(elementType);
-        assert(llvm::VectorType::isValidElementType(elementType) && "Invalid element type for LLVM vector");
-        auto vectorType = emitter.VectorType(emitters::GetVariableType<ValueType>(), vectorSize);
-        auto vectorPointerType = vectorType->getPointerTo();
-
-        // cast input to pointer-to-vector
-        auto inputVector = function.CastPointer(input, vectorPointerType);
-
-        emitters::LLVMValue vectorAccumVar = function.Variable(vectorType, "vecAccum");
-        function.Store(vectorAccumVar, emitters::FillVector<ValueType>(function, vectorType, 0));
-
-        const int numBlocks = size / vectorSize;
-        function.For(numBlocks, [inputVector, vectorAccumVar](emitters::IRFunctionEmitter& function, auto blockIndex) {
-            auto value = function.ValueAt(inputVector, blockIndex);
-            function.OperationAndUpdate(vectorAccumVar, emitters::GetAddForValueType<ValueType>(), value);
-        });
-
-        // Accumulate horizontal sum into output
-        auto sum = emitters::HorizontalVectorSum<ValueType>(function, function.Load(vectorAccumVar));
-
-        // epilogue
-        const int epilogueSize = size - (vectorSize * numBlocks);
-        if (epilogueSize > 0)
-        {
-            for(int epilogueIndex = vectorSize * numBlocks; epilogueIndex < size; ++epilogueIndex)
-            {
-                emitters::LLVMValue pValue = function.ValueAt(input, function.Literal<int>(epilogueIndex));
-                sum = function.Operator(emitters::GetAddForValueType<ValueType>(), sum, pValue);
-            }
-        }
+        auto sum = emitters::VectorizedSum<ValueType>(function, input, _input.Size());
         function.Store(output, sum);
     }
 
@@ -228,7 +228,14 @@ namespace nodes
     {
         if (!compiler.GetCompilerOptions().unrollLoops)
         {
-            CompileLoop(compiler, function);
+            if (compiler.GetCompilerOptions().allowVectorInstructions && CanCompileVectorized())
+            {
+                CompileVectorizedLoop(compiler, function);
+            }
+            else
+            {
+                CompileLoop(compiler, function);
+            }
         }
         else
         {
@@ -236,6 +243,21 @@ namespace nodes
         }
     }
 
+    // Only the operations that map to vector instructions are worth vectorizing: the others are calls into the runtime library
+    template <typename ValueType>
+    bool UnaryOperationNode<ValueType>::CanCompileVectorized() const
+    {
+        switch (this->GetOperation())
+        {
+            case emitters::UnaryOperationType::square:
+                return !std::is_same<ValueType, bool>::value;
+            case emitters::UnaryOperationType::sqrt:
+                return std::is_floating_point<ValueType>::value;
+            default:
+                return false;
+        }
+    }
+
     template <typename ValueType>
     void UnaryOperationNode<ValueType>::CompileLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -251,6 +273,30 @@ namespace nodes
         });
     }
 
+    template <typename ValueType>
+    void UnaryOperationNode<ValueType>::CompileVectorizedLoop(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
+    {
+        auto count = input.Size();
+        emitters::LLVMValue pInput = compiler.EnsurePortEmitted(input);
+        emitters::LLVMValue pResult = compiler.EnsurePortEmitted(output);
+
+        const int vectorSize = emitters::GetVectorWidth<ValueType>(compiler.GetCompilerOptions());
+        emitters::VectorizedFor(function, count, vectorSize, [pInput, pResult, this](emitters::IRFunctionEmitter& function, emitters::IRLocalScalar i, int width) {
+            emitters::LLVMValue inputValue = emitters::LoadVector<ValueType>(function, pInput, i, width);
+            emitters::LLVMValue pOpResult = nullptr;
+            if (GetOperation() == emitters::UnaryOperationType::square)
+            {
+                pOpResult = function.Operator(emitters::GetMultiplyForValueType<ValueType>(), inputValue, inputValue);
+            }
+            else
+            {
+                auto sqrtFunction = function.GetModule().GetRuntime().GetSqrtFunction(inputValue->getType());
+                pOpResult = function.Call(sqrtFunction, { inputValue });
+            }
+            emitters::StoreVector<ValueType>(function, pResult, i, pOpResult);
+        });
+    }
+
     template <typename ValueType>
     void UnaryOperationNode<ValueType>::CompileExpanded(model::IRMapCompiler& compiler, emitters::IRFunctionEmitter& function)
     {
@@ -387,11 +387,9 @@ static void TestMelFilterBankNode()
 }
 
 template <typename ValueType>
-static void TestBufferNode()
+static void TestBufferNode(size_t inputSize, size_t windowSize)
 {
     const ValueType epsilon = static_cast<ValueType>(1e-7);
-    const size_t inputSize = 16;
-    const size_t windowSize = 32;
 
     std::vector<std::vector<ValueType>> data;
     const int numEntries = 8;
@@ -412,12 +410,25 @@ static void TestBufferNode()
     model::IRMapCompiler compiler(settings);
     auto compiledMap = compiler.Compile(map);
 
+    // the window holds the last windowSize samples seen, preceded by zeros
+    std::vector<ValueType> history(windowSize, 0);
     for (size_t index = 0; index < data.size(); ++index)
     {
         auto input = data[index];
+        history.insert(history.end(), input.begin(), input.end());
+        std::vector<ValueType> expectedResult;
+        if (inputSize >= windowSize)
+        {
+            expectedResult.assign(input.begin(), input.begin() + windowSize);
+        }
+        else
+        {
+            expectedResult.assign(history.end() - windowSize, history.end());
+        }
 
         map.SetInputValue(0, input);
         auto computedResult = map.ComputeOutput<ValueType>(0);
+        testing::ProcessTest("Testing BufferNode compute", testing::IsEqual(computedResult, expectedResult, epsilon));
 
         compiledMap.SetInputValue(0, input);
         auto compiledResult = compiledMap.ComputeOutput<ValueType>(0);
@@ -1103,7 +1114,10 @@ void TestDSPNodes(const std::string& path)
     TestMelFilterBankNode<float>();
     TestMelFilterBankNode<double>();
 
-    TestBufferNode<float>();
+    TestBufferNode<float>(16, 32);
+    TestBufferNode<float>(10, 32); // window isn't a multiple of the input size
+    TestBufferNode<float>(16, 16);
+    TestBufferNode<float>(16, 8); // input larger than the window
 
     TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::simple);
     // TestConvolutionNodeCompile<float>(dsp::ConvolutionMethodOption::diagonal); // ERROR: diagonal test currently broken
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizedNodesTiming.cpp (nodes_test)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizedNodesTiming.h"
+
+// model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Map.h"
+#include "MapCompilerOptions.h"
+#include "Model.h"
+
+// nodes
+#include "ConstantNode.h"
+#include "MatrixMatrixMultiplyNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
+
+// utilities
+#include "MillisecondTimer.h"
+#include "RandomEngines.h"
+
+// stl
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+template <typename ValueType>
+std::vector<ValueType> GetRandomVector(size_t size, const std::string& seed)
+{
+    auto randomEngine = utilities::GetRandomEngine(seed);
+    std::uniform_real_distribution<ValueType> uniform(-1, 1);
+    std::vector<ValueType> result(size);
+    for (auto& value : result)
+    {
+        value = uniform(randomEngine);
+    }
+    return result;
+}
+
+template <typename ValueType>
+double TimeCompiledMap(model::Map& map, bool useBlas, const std::vector<ValueType>& input, int numIterations)
+{
+    model::MapCompilerOptions settings;
+    settings.compilerSettings.optimize = true;
+    settings.compilerSettings.useBlas = useBlas;
+    settings.compilerSettings.parallelize = false;
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    // Run once to page in the code and data
+    compiledMap.SetInputValue(0, input);
+    compiledMap.ComputeOutput<ValueType>(0);
+
+    utilities::MillisecondTimer timer;
+    for (int iter = 0; iter < numIterations; ++iter)
+    {
+        compiledMap.SetInputValue(0, input);
+        volatile auto result = compiledMap.ComputeOutput<ValueType>(0);
+    }
+    return timer.Elapsed() / numIterations;
+}
+
+// Times the int8 quantized multiply of an m x k weights matrix and a k x n input against the floating-point multiply
+template <typename ValueType>
+void TimeQuantizedMatrixMultiply(int m, int n, int k, int numIterations)
+{
+    auto weights = GetRandomVector<ValueType>(m * k, "weights");
+    auto input = GetRandomVector<ValueType>(k * n, "input");
+
+    model::Model floatModel;
+    auto floatInputNode = floatModel.AddNode<model::InputNode<ValueType>>(k * n);
+    auto weightsNode = floatModel.AddNode<nodes::ConstantNode<ValueType>>(weights);
+    auto floatMultiplyNode = floatModel.AddNode<nodes::MatrixMatrixMultiplyNode<ValueType>>(weightsNode->output, m, n, k, k, floatInputNode->output, n, n);
+    model::Map floatMap(floatModel, { { "input", floatInputNode } }, { { "output", floatMultiplyNode->output } });
+
+    const ValueType weightScale = nodes::GetInt8QuantizationScale<ValueType>(1);
+    std::vector<int8_t> quantizedWeights;
+    for (auto weight : weights)
+    {
+        quantizedWeights.push_back(nodes::QuantizeToInt8(weight, weightScale));
+    }
+    model::Model quantizedModel;
+    auto quantizedInputNode = quantizedModel.AddNode<model::InputNode<ValueType>>(k * n);
+    auto quantizedMultiplyNode = quantizedModel.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(quantizedInputNode->output, m, n, k, quantizedWeights, std::vector<ValueType>(m, weightScale), nodes::GetInt8QuantizationScale<ValueType>(1), false);
+    model::Map quantizedMap(quantizedModel, { { "input", quantizedInputNode } }, { { "output", quantizedMultiplyNode->output } });
+
+    auto floatBlasTime = TimeCompiledMap(floatMap, true, input, numIterations);
+    auto floatNativeTime = TimeCompiledMap(floatMap, false, input, numIterations);
+    auto quantizedTime = TimeCompiledMap(quantizedMap, false, input, numIterations);
+    std::cout << "Time to multiply " << m << "x" << k << " weights and " << k << "x" << n << " input: int8 " << quantizedTime << " ms, float (BLAS) " << floatBlasTime << " ms, float (native) " << floatNativeTime << " ms" << std::endl;
+}
+}
+
+//
+// Main driver function to call all the timing functions
+//
+void TimeQuantizedNodes()
+{
+    // Fully-connected layers
+    TimeQuantizedMatrixMultiply<float>(256, 1, 1024, 100);
+    TimeQuantizedMatrixMultiply<float>(1000, 1, 2048, 100);
+
+    // Unrolled convolutional layers (filters x (filter size * filter size * channels), times (filter size * filter size * channels) x pixels)
+    TimeQuantizedMatrixMultiply<float>(64, 196, 576, 20);
+    TimeQuantizedMatrixMultiply<float>(128, 784, 1152, 10);
+}
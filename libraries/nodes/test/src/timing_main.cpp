@@ -7,6 +7,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "DSPNodesTiming.h"
+#include "QuantizedNodesTiming.h"
 
 // testing
 #include "testing.h"
@@ -29,6 +30,7 @@ int main(int argc, char** argv)
     try
     {
         TimeDSPNodes();
+        TimeQuantizedNodes();
     }
     catch (const utilities::Exception& exception)
     {
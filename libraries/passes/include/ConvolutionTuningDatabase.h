@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// predictors
+#include "ConvolutionalLayer.h"
+
+// stl
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// The fastest measured convolution method for each convolution shape, keyed by a string describing the
+    /// shape and the CPU it was measured on. Stored as a text file with one `<key> <method>` entry per line,
+    /// so results measured by one compile can be reused by later ones.
+    /// </summary>
+    class ConvolutionTuningDatabase
+    {
+    public:
+        /// <summary> Default constructor, creating an empty database. </summary>
+        ConvolutionTuningDatabase() = default;
+
+        /// <summary> Looks up the convolution method for a key. </summary>
+        ///
+        /// <param name="key"> The key describing the convolution. </param>
+        /// <param name="method"> Set to the method stored for the key, if there is one. </param>
+        ///
+        /// <returns> `true` if the database has an entry for the key. </returns>
+        bool TryGetMethod(const std::string& key, predictors::neural::ConvolutionMethod& method) const;
+
+        /// <summary> Sets the convolution method for a key. </summary>
+        ///
+        /// <param name="key"> The key describing the convolution. It may not contain whitespace. </param>
+        /// <param name="method"> The method to use for the convolution. </param>
+        void SetMethod(const std::string& key, predictors::neural::ConvolutionMethod method);
+
+        /// <summary> Returns the number of entries in the database. </summary>
+        size_t NumEntries() const { return _methods.size(); }
+
+        /// <summary> Adds the entries read from a stream to the database. </summary>
+        ///
+        /// <param name="stream"> The stream to read from. </param>
+        void Read(std::istream& stream);
+
+        /// <summary> Writes all the entries of the database to a stream. </summary>
+        ///
+        /// <param name="stream"> The stream to write to. </param>
+        void Write(std::ostream& stream) const;
+
+        /// <summary> Adds the entries stored in a file to the database. A missing file is treated as empty. </summary>
+        ///
+        /// <param name="filename"> The name of the database file. </param>
+        void Load(const std::string& filename);
+
+        /// <summary> Writes the database to a file. </summary>
+        ///
+        /// <param name="filename"> The name of the database file. </param>
+        void Save(const std::string& filename) const;
+
+    private:
+        std::map<std::string, predictors::neural::ConvolutionMethod> _methods;
+    };
+}
+}
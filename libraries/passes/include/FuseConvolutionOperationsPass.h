@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseConvolutionOperationsPass.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// model
+#include "Node.h"
+
+// model/optimizer
+#include "ModelOptimizer.h"
+#include "OptimizationPass.h"
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary>
+    /// An optimization pass that fuses a convolutional layer with the per-channel linear functions (bias and batch
+    /// normalization) and activation function that follow it. The linear functions are folded into the convolution's
+    /// weights and bias, and the activation is applied in the convolution's output loop, yielding a single
+    /// `FusedConvolutionNode`. Depthwise-separable convolutions, and convolutions whose output is used elsewhere,
+    /// are left unchanged.
+    /// </summary>
+    class FuseConvolutionOperationsPass : public model::NodeLocalOptimizationPass
+    {
+    public:
+        /// <summary> Combine a linear function or activation node with the convolution that precedes it, if possible. </summary>
+        ///
+        /// <param name="node"> The current node being visited. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Add this pass type to the global pass registry. </summary>
+        static void AddToRegistry();
+    };
+}
+}
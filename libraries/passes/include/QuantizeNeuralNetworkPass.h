@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeNeuralNetworkPass.h (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// data
+#include "Dataset.h"
+
+// model
+#include "Map.h"
+#include "Node.h"
+
+// model/optimizer
+#include "ModelOptimizer.h"
+#include "OptimizationPass.h"
+
+// stl
+#include <unordered_map>
+
+namespace ell
+{
+namespace passes
+{
+    /// <summary> The ranges of the activations seen by the quantizable layers of a map, used to choose their input quantization scales. </summary>
+    struct QuantizationCalibration
+    {
+        /// <summary> The largest absolute input value seen by each layer node, keyed by the id of the node. </summary>
+        std::unordered_map<model::Node::NodeId, double> inputRanges;
+    };
+
+    /// <summary>
+    /// Computes the quantization calibration for a map by running it over examples from a dataset and recording
+    /// the range of the inputs to its fully-connected and convolutional layer nodes. The map must contain the
+    /// layer nodes themselves (i.e., any `NeuralNetworkPredictorNode` must have been refined first).
+    /// </summary>
+    ///
+    /// <param name="map"> The map to calibrate. </param>
+    /// <param name="dataset"> The calibration dataset. </param>
+    /// <param name="maxExamples"> The maximum number of examples to use, or 0 to use the whole dataset. </param>
+    ///
+    /// <returns> The calibration for the map. It is valid for the map it was computed from, and is used by `QuantizeNeuralNetworkPass`. </returns>
+    QuantizationCalibration CalibrateQuantization(const model::Map& map, const data::AutoSupervisedDataset& dataset, size_t maxExamples = 0);
+
+    /// <summary>
+    /// An optimization pass that replaces the fully-connected and (non-depthwise) convolutional layer nodes of a model
+    /// with int8 quantized equivalents. Weights are quantized with one scale per output channel, and the layer inputs
+    /// with a single scale derived from the calibration. Layers without calibration data are left unchanged.
+    /// Quantized convolutions are lowered to a `ReceptiveFieldMatrixNode`, which has no interpreted implementation, so a map
+    /// with quantized convolutional layers can only be compiled: `Map::Compute` throws for it.
+    /// </summary>
+    class QuantizeNeuralNetworkPass : public model::NodeLocalOptimizationPass
+    {
+    public:
+        /// <summary> Constructor. </summary>
+        ///
+        /// <param name="calibration"> The calibration for the model being optimized, from `CalibrateQuantization`. </param>
+        QuantizeNeuralNetworkPass(QuantizationCalibration calibration);
+
+        /// <summary> Replace a layer node with its quantized equivalent, if possible. </summary>
+        ///
+        /// <param name="node"> The current node being visited. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+    private:
+        QuantizationCalibration _calibration;
+    };
+}
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ConvolutionTuningDatabase.h"
+
 // model
 #include "Model.h"
 
@@ -22,18 +24,42 @@ namespace ell
 {
 namespace passes
 {
-    /// <summary> An optimization pass that fuses sequential `BroadcastLinearFunctionNode`s into one. </summary>
+    /// <summary>
+    /// An optimization pass that sets the convolution method of `ConvolutionalLayerNode`s to the preferred method.
+    /// If the preferred method is `autotune`, each compatible method is compiled and timed for each distinct convolution
+    /// (when compiling for the host), and the fastest is used. The winners are cached in the tuning database file
+    /// named by the optimizer settings, so later compiles can reuse them without measuring again.
+    /// </summary>
     class SetConvolutionMethodPass : public model::NodeLocalOptimizationPass
     {
     public:
-        /// <summary> Combine a linear function node with its predecessor if possible. </summary>
+        /// <summary> Loads the tuning database, if autotuning. </summary>
+        ///
+        /// <param name="model"> The model about to be optimized. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void Initialize(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
+        /// <summary> Set the convolution method of a convolutional layer node. </summary>
         ///
         /// <param name="node"> The current node being visited. </param>
-        /// <param name="transformer"> The transformer object operating on the model. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
         void OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
 
+        /// <summary> Saves the tuning database, if any new convolutions were tuned. </summary>
+        ///
+        /// <param name="model"> The (new) model that was the result of the optimization. </param>
+        /// <param name="settings"> The compiler settings for the model being optimized. </param>
+        /// <param name="context"> The optimization context object for this run of the optimizer. </param>
+        void Finalize(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const override;
+
         /// <summary> Add this pass type to the global pass registry. </summary>
         static void AddToRegistry();
+
+    private:
+        mutable ConvolutionTuningDatabase _tuningDatabase;
+        mutable bool _tuningDatabaseChanged = false;
     };
 }
 }
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvolutionTuningDatabase.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvolutionTuningDatabase.h"
+
+// utilities
+#include "Exception.h"
+#include "Files.h"
+
+// stl
+#include <sstream>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        using predictors::neural::ConvolutionMethod;
+
+        const std::map<std::string, ConvolutionMethod> methodNames = {
+            { "diagonal", ConvolutionMethod::diagonal },
+            { "simple", ConvolutionMethod::simple },
+            { "unrolled", ConvolutionMethod::unrolled },
+            { "winograd", ConvolutionMethod::winograd }
+        };
+
+        std::string GetMethodName(ConvolutionMethod method)
+        {
+            for (const auto& entry : methodNames)
+            {
+                if (entry.second == method)
+                {
+                    return entry.first;
+                }
+            }
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Convolution tuning database entries must specify a concrete convolution method");
+        }
+    }
+
+    bool ConvolutionTuningDatabase::TryGetMethod(const std::string& key, ConvolutionMethod& method) const
+    {
+        auto it = _methods.find(key);
+        if (it == _methods.end())
+        {
+            return false;
+        }
+
+        method = it->second;
+        return true;
+    }
+
+    void ConvolutionTuningDatabase::SetMethod(const std::string& key, ConvolutionMethod method)
+    {
+        GetMethodName(method); // validate the method
+        _methods[key] = method;
+    }
+
+    void ConvolutionTuningDatabase::Read(std::istream& stream)
+    {
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            std::istringstream lineStream(line);
+            std::string key;
+            std::string methodName;
+            if (!(lineStream >> key) || key[0] == '#')
+            {
+                continue; // blank line or comment
+            }
+
+            if (!(lineStream >> methodName))
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::badFormat, "Convolution tuning database entry is missing a method: " + line);
+            }
+
+            auto it = methodNames.find(methodName);
+            if (it == methodNames.end())
+            {
+                throw utilities::DataFormatException(utilities::DataFormatErrors::illegalValue, "Unknown convolution method in tuning database: " + methodName);
+            }
+            _methods[key] = it->second;
+        }
+    }
+
+    void ConvolutionTuningDatabase::Write(std::ostream& stream) const
+    {
+        stream << "# ELL convolution tuning database: <convolution key> <fastest method>\n";
+        for (const auto& entry : _methods)
+        {
+            stream << entry.first << ' ' << GetMethodName(entry.second) << '\n';
+        }
+    }
+
+    void ConvolutionTuningDatabase::Load(const std::string& filename)
+    {
+        if (!utilities::FileExists(filename))
+        {
+            return;
+        }
+
+        auto stream = utilities::OpenIfstream(filename);
+        Read(stream);
+    }
+
+    void ConvolutionTuningDatabase::Save(const std::string& filename) const
+    {
+        auto stream = utilities::OpenOfstream(filename);
+        Write(stream);
+    }
+}
+}
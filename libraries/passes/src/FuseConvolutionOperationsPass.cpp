@@ -0,0 +1,289 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FuseConvolutionOperationsPass.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FuseConvolutionOperationsPass.h"
+
+// model
+#include "ModelTransformer.h"
+#include "OptimizationPassRegistry.h"
+#include "PortMemoryLayout.h"
+
+// nodes
+#include "BroadcastFunctionNode.h"
+#include "CompiledActivationFunctions.h"
+#include "ConstantNode.h"
+#include "ConvolutionalLayerNode.h"
+#include "FusedConvolutionNode.h"
+
+// predictors
+#include "HardSigmoidActivation.h"
+#include "LeakyReLUActivation.h"
+#include "ReLUActivation.h"
+#include "SigmoidActivation.h"
+#include "TanhActivation.h"
+
+// utilities
+#include "Exception.h"
+
+namespace ell
+{
+namespace passes
+{
+    //
+    // Implementation
+    //
+    namespace
+    {
+        //
+        // Data structures
+        //
+
+        // The parts of a convolution (in the new model) that a following operation can be fused into
+        template <typename ValueType>
+        struct FusableConvolution
+        {
+            const model::OutputPort<ValueType>* input = nullptr;
+            model::PortMemoryLayout inputLayout;
+            model::PortMemoryLayout outputLayout;
+            typename nodes::FusedConvolutionNode<ValueType>::TensorType weights;
+            int stride = 1;
+            std::vector<ValueType> bias; // empty means no bias
+        };
+
+        //
+        // Functions
+        //
+
+        // Gets the convolution whose output feeds the given input port, if it can absorb more operations.
+        template <typename ValueType>
+        bool TryGetFusableConvolution(const model::InputPort<ValueType>& input, model::ModelTransformer& transformer, FusableConvolution<ValueType>& convolution)
+        {
+            // If the convolution's output is used anywhere else, fusing would just duplicate the work
+            if (input.GetReferencedPort().GetNode()->GetDependentNodes().size() != 1)
+            {
+                return false;
+            }
+
+            // Look at the node that has already replaced our input in the new model, since it may have been fused with an earlier operation
+            const auto& newInput = transformer.GetCorrespondingInputs(input);
+            const auto newInputNode = newInput.GetNode();
+            if (auto convolutionNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(newInputNode))
+            {
+                const auto& layer = convolutionNode->GetLayer();
+                if (layer.GetWeights().NumChannels() != static_cast<size_t>(convolutionNode->GetInputMemoryLayout().GetActiveSize(2)))
+                {
+                    return false; // depthwise-separable
+                }
+
+                convolution.input = &convolutionNode->input.GetReferencedPort();
+                convolution.inputLayout = convolutionNode->GetInputMemoryLayout();
+                convolution.outputLayout = convolutionNode->GetOutputMemoryLayout();
+                convolution.weights = layer.GetWeights();
+                convolution.stride = static_cast<int>(layer.GetConvolutionalParameters().stride);
+                convolution.bias = {};
+                return true;
+            }
+
+            if (auto fusedNode = dynamic_cast<const nodes::FusedConvolutionNode<ValueType>*>(newInputNode))
+            {
+                if (fusedNode->HasActivation())
+                {
+                    return false; // nothing can be fused after the activation
+                }
+
+                convolution.input = &fusedNode->input.GetReferencedPort();
+                convolution.inputLayout = fusedNode->GetInputMemoryLayout();
+                convolution.outputLayout = fusedNode->GetOutputMemoryLayout();
+                convolution.weights = fusedNode->GetFilterWeights();
+                convolution.stride = fusedNode->GetStride();
+                convolution.bias = fusedNode->GetBias();
+                return true;
+            }
+
+            return false;
+        }
+
+        // Gets the values of a linear function's coefficient input. Returns false if the input is present but not constant.
+        template <typename ValueType>
+        bool TryGetConstantCoefficients(const model::InputPort<ValueType>& input, std::vector<ValueType>& values)
+        {
+            values.clear();
+            if (input.Size() == 0)
+            {
+                return true;
+            }
+
+            auto constantNode = dynamic_cast<const nodes::ConstantNode<ValueType>*>(input.GetReferencedPort().GetNode());
+            if (constantNode == nullptr || constantNode->output.Size() != input.Size())
+            {
+                return false;
+            }
+
+            values = constantNode->GetValues();
+            return true;
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes
+        template <typename ValueType>
+        bool TryFuseLinearFunction(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            auto thisNode = dynamic_cast<const nodes::BroadcastLinearFunctionNode<ValueType>*>(&node);
+            if (thisNode == nullptr || thisNode->GetBroadcastDimension() != 2)
+            {
+                return false; // only per-channel functions can be folded into the filters
+            }
+
+            std::vector<ValueType> scale;
+            std::vector<ValueType> bias;
+            if (!TryGetConstantCoefficients(thisNode->secondaryInput1, scale) || !TryGetConstantCoefficients(thisNode->secondaryInput2, bias))
+            {
+                return false;
+            }
+
+            FusableConvolution<ValueType> convolution;
+            if (!TryGetFusableConvolution(thisNode->primaryInput, transformer, convolution) || thisNode->GetInputMemoryLayout() != convolution.outputLayout)
+            {
+                return false;
+            }
+
+            const auto numFilters = static_cast<size_t>(convolution.outputLayout.GetActiveSize(2));
+            if ((!scale.empty() && scale.size() != numFilters) || (!bias.empty() && bias.size() != numFilters))
+            {
+                return false;
+            }
+
+            // Here, the convolution computes c(x) = W*x + b1 and the linear function is f(x) = s*x + b2 (per channel),
+            // so f(c(x)) = (s*W)*x + (s*b1 + b2)
+            if (!scale.empty())
+            {
+                const auto filterSize = convolution.weights.NumColumns();
+                for (size_t filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+                {
+                    for (size_t row = filterIndex * filterSize; row < (filterIndex + 1) * filterSize; ++row)
+                    {
+                        for (size_t column = 0; column < convolution.weights.NumColumns(); ++column)
+                        {
+                            for (size_t channel = 0; channel < convolution.weights.NumChannels(); ++channel)
+                            {
+                                convolution.weights(row, column, channel) *= scale[filterIndex];
+                            }
+                        }
+                    }
+                }
+
+                for (size_t filterIndex = 0; filterIndex < convolution.bias.size(); ++filterIndex)
+                {
+                    convolution.bias[filterIndex] *= scale[filterIndex];
+                }
+            }
+
+            if (!bias.empty())
+            {
+                convolution.bias.resize(numFilters, 0);
+                for (size_t filterIndex = 0; filterIndex < numFilters; ++filterIndex)
+                {
+                    convolution.bias[filterIndex] += bias[filterIndex];
+                }
+            }
+
+            auto newNode = transformer.AddNode<nodes::FusedConvolutionNode<ValueType>>(*convolution.input, convolution.inputLayout, thisNode->GetOutputMemoryLayout(), convolution.weights, convolution.stride, convolution.bias);
+            transformer.MapNodeOutput(thisNode->output, newNode->output);
+            return true;
+        }
+
+        //
+        // Conversion from compiled activation functions back to the activations the fused node stores
+        //
+        template <typename ValueType>
+        predictors::neural::Activation<ValueType> GetActivation(const nodes::ReLUActivationFunction<ValueType>&)
+        {
+            return { new predictors::neural::ReLUActivation<ValueType>() };
+        }
+
+        template <typename ValueType>
+        predictors::neural::Activation<ValueType> GetActivation(const nodes::LeakyReLUActivationFunction<ValueType>& function)
+        {
+            return { new predictors::neural::LeakyReLUActivation<ValueType>(function.GetLeakyFactor()) };
+        }
+
+        template <typename ValueType>
+        predictors::neural::Activation<ValueType> GetActivation(const nodes::SigmoidActivationFunction<ValueType>&)
+        {
+            return { new predictors::neural::SigmoidActivation<ValueType>() };
+        }
+
+        template <typename ValueType>
+        predictors::neural::Activation<ValueType> GetActivation(const nodes::HardSigmoidActivationFunction<ValueType>&)
+        {
+            return { new predictors::neural::HardSigmoidActivation<ValueType>() };
+        }
+
+        template <typename ValueType>
+        predictors::neural::Activation<ValueType> GetActivation(const nodes::TanhActivationFunction<ValueType>&)
+        {
+            return { new predictors::neural::TanhActivation<ValueType>() };
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other function types
+        template <typename ValueType, typename FunctionType>
+        bool TryFuseActivationFunction(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            auto thisNode = dynamic_cast<const nodes::BroadcastUnaryFunctionNode<ValueType, FunctionType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            FusableConvolution<ValueType> convolution;
+            if (!TryGetFusableConvolution(thisNode->primaryInput, transformer, convolution) || thisNode->GetInputMemoryLayout() != convolution.outputLayout)
+            {
+                return false;
+            }
+
+            auto newNode = transformer.AddNode<nodes::FusedConvolutionNode<ValueType>>(*convolution.input, convolution.inputLayout, thisNode->GetOutputMemoryLayout(), convolution.weights, convolution.stride, convolution.bias, GetActivation(thisNode->GetFunction()));
+            transformer.MapNodeOutput(thisNode->output, newNode->output);
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryFuseConvolutionOperations(const model::Node& node, model::ModelTransformer& transformer)
+        {
+            return TryFuseLinearFunction<ValueType>(node, transformer) ||
+                   TryFuseActivationFunction<ValueType, nodes::ReLUActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivationFunction<ValueType, nodes::LeakyReLUActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivationFunction<ValueType, nodes::SigmoidActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivationFunction<ValueType, nodes::HardSigmoidActivationFunction<ValueType>>(node, transformer) ||
+                   TryFuseActivationFunction<ValueType, nodes::TanhActivationFunction<ValueType>>(node, transformer);
+        }
+    }
+
+    //
+    // FuseConvolutionOperationsPass methods
+    //
+    void FuseConvolutionOperationsPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        auto& transformer = context.GetTransformer();
+        if (TryFuseConvolutionOperations<float>(node, transformer) || TryFuseConvolutionOperations<double>(node, transformer))
+        {
+            return;
+        }
+
+        transformer.CopyNode(node);
+    }
+
+    void FuseConvolutionOperationsPass::AddToRegistry()
+    {
+        model::OptimizationPassInfo info = {
+            "FuseConvolutionOperationsPass",
+            [](const model::ModelOptimizerOptions& settings) { return settings.phase == model::OptimizerPhase::optimize && settings.fuseConvolutionNodes; },
+            []() { return std::make_unique<FuseConvolutionOperationsPass>(); }
+        };
+        model::OptimizationPassRegistry::AddPass(info);
+    }
+}
+}
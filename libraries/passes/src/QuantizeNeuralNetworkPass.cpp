@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     QuantizeNeuralNetworkPass.cpp (passes)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "QuantizeNeuralNetworkPass.h"
+
+// data
+#include "DenseDataVector.h"
+
+// model
+#include "ModelTransformer.h"
+#include "PortMemoryLayout.h"
+
+// nodes
+#include "ConvolutionalLayerNode.h"
+#include "FullyConnectedLayerNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
+#include "ReceptiveFieldMatrixNode.h"
+#include "ReorderDataNode.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ell
+{
+namespace passes
+{
+    namespace
+    {
+        //
+        // Calibration
+        //
+        template <typename ValueType>
+        const model::InputPort<ValueType>* GetQuantizableLayerInput(const model::Node& node)
+        {
+            if (auto fullyConnectedNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node))
+            {
+                return &fullyConnectedNode->input;
+            }
+
+            if (auto convolutionalNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node))
+            {
+                return &convolutionalNode->input;
+            }
+
+            return nullptr;
+        }
+
+        // returns 'true' if we handled the node, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryRecordInputRange(const model::Node& node, QuantizationCalibration& calibration)
+        {
+            auto input = GetQuantizableLayerInput<ValueType>(node);
+            if (input == nullptr)
+            {
+                return false;
+            }
+
+            double range = 0;
+            for (auto value : input->GetValue())
+            {
+                range = std::max(range, std::abs(static_cast<double>(value)));
+            }
+
+            auto& inputRange = calibration.inputRanges[node.GetId()];
+            inputRange = std::max(inputRange, range);
+            return true;
+        }
+
+        //
+        // Quantization
+        //
+
+        // Quantizes a row-major m x k matrix, using one scale per row
+        template <typename ValueType>
+        void QuantizeWeights(const std::vector<ValueType>& weights, size_t m, size_t k, std::vector<int8_t>& quantizedWeights, std::vector<ValueType>& weightScales)
+        {
+            quantizedWeights.resize(m * k);
+            weightScales.resize(m);
+            for (size_t i = 0; i < m; ++i)
+            {
+                auto rowBegin = weights.begin() + i * k;
+                auto rowRange = std::accumulate(rowBegin, rowBegin + k, static_cast<ValueType>(0), [](ValueType range, ValueType value) { return std::max(range, std::abs(value)); });
+                weightScales[i] = nodes::GetInt8QuantizationScale(rowRange);
+                for (size_t j = 0; j < k; ++j)
+                {
+                    quantizedWeights[i * k + j] = nodes::QuantizeToInt8(weights[i * k + j], weightScales[i]);
+                }
+            }
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeFullyConnectedLayer(const model::Node& node, model::ModelTransformer& transformer, ValueType inputScale)
+        {
+            auto thisNode = dynamic_cast<const nodes::FullyConnectedLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& weights = thisNode->GetLayer().GetWeights();
+            const auto m = weights.NumRows();
+            const auto k = weights.NumColumns();
+            if (thisNode->input.Size() != k || thisNode->output.Size() != m)
+            {
+                return false; // padded inputs or outputs aren't supported
+            }
+
+            std::vector<int8_t> quantizedWeights;
+            std::vector<ValueType> weightScales;
+            QuantizeWeights(weights.ToArray(), m, k, quantizedWeights, weightScales);
+
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            auto matrixMultiplyNode = transformer.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(newInput, static_cast<int>(m), 1, static_cast<int>(k), quantizedWeights, weightScales, inputScale, false);
+            transformer.MapNodeOutput(thisNode->output, matrixMultiplyNode->output);
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeConvolutionalLayer(const model::Node& node, model::ModelTransformer& transformer, ValueType inputScale)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            const auto& weights = thisNode->GetLayer().GetWeights();
+            if (weights.NumChannels() == 1)
+            {
+                return false; // depthwise-separable convolutions aren't quantized
+            }
+
+            const auto originalInputLayout = thisNode->GetInputMemoryLayout();
+            const auto originalOutputLayout = thisNode->GetOutputMemoryLayout();
+            const auto convInputLayout = originalInputLayout.ReorderedCopy({ utilities::RowMajorTensorOrder });
+            const auto convParams = thisNode->GetLayer().GetConvolutionalParameters();
+
+            const int filterSize = static_cast<int>(convParams.receptiveField);
+            const int stride = static_cast<int>(convParams.stride);
+            const int inputDepth = convInputLayout.GetActiveSize(2);
+            const int inputPadding = convInputLayout.GetOffset(0);
+            const int outputHeight = originalOutputLayout.GetActiveSize(0);
+            const int outputWidth = originalOutputLayout.GetActiveSize(1);
+            const int numFilters = originalOutputLayout.GetActiveSize(2);
+
+            // Reshape the weights into a numFilters x (filterSize * filterSize * inputDepth) matrix, in the
+            // (row, column, channel) order used by the receptive field matrix
+            const int m = numFilters;
+            const int n = outputHeight * outputWidth;
+            const int k = filterSize * filterSize * inputDepth;
+            std::vector<ValueType> weightsMatrix(m * k);
+            auto flattened = weights.ReferenceAsMatrix();
+            for (int filter = 0; filter < numFilters; ++filter)
+            {
+                for (int row = 0; row < filterSize; ++row)
+                {
+                    auto weightsVector = flattened.GetMajorVector(filter * filterSize + row);
+                    for (size_t i = 0; i < weightsVector.Size(); ++i)
+                    {
+                        weightsMatrix[filter * k + row * weightsVector.Size() + i] = weightsVector[i];
+                    }
+                }
+            }
+
+            std::vector<int8_t> quantizedWeights;
+            std::vector<ValueType> weightScales;
+            QuantizeWeights(weightsMatrix, m, k, quantizedWeights, weightScales);
+
+            const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
+            auto preConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(newInput, originalInputLayout, convInputLayout);
+            auto receptiveFieldMatrixNode = transformer.AddNode<nodes::ReceptiveFieldMatrixNode<ValueType>>(preConvReorderNode->output, convInputLayout, filterSize, stride, inputPadding, utilities::RowMajorTensorOrder, outputWidth, outputHeight);
+
+            // The output is transposed, giving an image in (row, column, channel) order without padding
+            auto matrixMultiplyNode = transformer.AddNode<nodes::QuantizedMatrixMultiplyNode<ValueType>>(receptiveFieldMatrixNode->output, m, n, k, quantizedWeights, weightScales, inputScale, true);
+            model::PortMemoryLayout convOutputLayout(model::MemoryShape{ outputHeight, outputWidth, numFilters });
+            auto postConvReorderNode = transformer.AddNode<nodes::ReorderDataNode<ValueType>>(matrixMultiplyNode->output, convOutputLayout, originalOutputLayout);
+            transformer.MapNodeOutput(thisNode->output, postConvReorderNode->output);
+            return true;
+        }
+
+        template <typename ValueType>
+        bool TryQuantizeLayer(const model::Node& node, model::ModelTransformer& transformer, double inputRange)
+        {
+            auto inputScale = nodes::GetInt8QuantizationScale(static_cast<ValueType>(inputRange));
+            return TryQuantizeFullyConnectedLayer<ValueType>(node, transformer, inputScale) || TryQuantizeConvolutionalLayer<ValueType>(node, transformer, inputScale);
+        }
+    }
+
+    QuantizationCalibration CalibrateQuantization(const model::Map& map, const data::AutoSupervisedDataset& dataset, size_t maxExamples)
+    {
+        QuantizationCalibration calibration;
+        auto numExamples = maxExamples == 0 ? dataset.NumExamples() : std::min(maxExamples, dataset.NumExamples());
+        for (size_t exampleIndex = 0; exampleIndex < numExamples; ++exampleIndex)
+        {
+            map.SetInputValue(0, dataset.GetExample(exampleIndex).GetDataVector());
+
+            // Computing the outputs leaves the intermediate values in the model's ports
+            for (size_t outputIndex = 0; outputIndex < map.GetNumOutputs(); ++outputIndex)
+            {
+                map.ComputeOutput<data::DoubleDataVector>(static_cast<int>(outputIndex));
+            }
+
+            map.GetModel().Visit([&calibration](const model::Node& node) {
+                TryRecordInputRange<float>(node, calibration) || TryRecordInputRange<double>(node, calibration);
+            });
+        }
+        return calibration;
+    }
+
+    //
+    // QuantizeNeuralNetworkPass methods
+    //
+    QuantizeNeuralNetworkPass::QuantizeNeuralNetworkPass(QuantizationCalibration calibration)
+        : _calibration(std::move(calibration))
+    {
+    }
+
+    void QuantizeNeuralNetworkPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        auto& transformer = context.GetTransformer();
+        auto it = _calibration.inputRanges.find(node.GetId());
+        if (it != _calibration.inputRanges.end())
+        {
+            if (TryQuantizeLayer<float>(node, transformer, it->second) || TryQuantizeLayer<double>(node, transformer, it->second))
+            {
+                return;
+            }
+        }
+
+        transformer.CopyNode(node);
+    }
+}
+}
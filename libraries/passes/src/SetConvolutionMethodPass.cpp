@@ -8,7 +8,14 @@
 
 #include "SetConvolutionMethodPass.h"
 
+// emitters
+#include "TargetDevice.h"
+
 // model
+#include "IRCompiledMap.h"
+#include "IRMapCompiler.h"
+#include "InputNode.h"
+#include "Map.h"
 #include "ModelTransformer.h"
 #include "OptimizationPassRegistry.h"
 
@@ -20,6 +27,15 @@
 
 // utilities
 #include "Exception.h"
+#include "Logger.h"
+#include "TypeName.h"
+
+// stl
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
 
 namespace ell
 {
@@ -60,9 +76,18 @@ namespace passes
             return true;
         }
 
+        template <typename ValueType>
+        predictors::neural::ConvolutionalLayer<ValueType> GetLayerWithMethod(const nodes::ConvolutionalLayerNode<ValueType>& node, predictors::neural::ConvolutionMethod method)
+        {
+            const auto& layer = node.GetLayer();
+            auto convolutionalParameters = layer.GetConvolutionalParameters();
+            convolutionalParameters.method = method;
+            return { layer.GetLayerParameters(), convolutionalParameters, layer.GetWeights() };
+        }
+
         // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
         template <typename ValueType>
-        bool TrySetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
+        bool TrySetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, predictors::neural::ConvolutionMethod method)
         {
             auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
             if (thisNode == nullptr)
@@ -70,35 +95,201 @@ namespace passes
                 return false;
             }
 
+            if(!IsMethodCompatible(method, thisNode->GetLayer().GetConvolutionalParameters()))
+            {
+                return false;
+            }
+
             const auto& newInput = transformer.GetCorrespondingInputs(thisNode->input);
-            const auto& layer = thisNode->GetLayer();
+            auto newNode = transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, GetLayerWithMethod(*thisNode, method));
 
-            auto layerParameters = layer.GetLayerParameters();
-            auto convolutionalParameters = layer.GetConvolutionalParameters();
+            transformer.MapNodeOutput(thisNode->output, newNode->output);
+            return true;
+        }
 
-            auto method = GetConvolutionMethod(preferredMethod);
-            convolutionalParameters.method = method;
-            if(!IsMethodCompatible(method, convolutionalParameters))
+        //
+        // Autotuning
+        //
+        const int numTuningRuns = 10;
+
+        // Checks the additional constraints the individual convolution implementations place on their inputs
+        template <typename ValueType>
+        bool CanTuneMethod(const nodes::ConvolutionalLayerNode<ValueType>& node, predictors::neural::ConvolutionMethod method)
+        {
+            using predictors::neural::ConvolutionMethod;
+
+            const auto& convolutionalParameters = node.GetLayer().GetConvolutionalParameters();
+            if (!IsMethodCompatible(method, convolutionalParameters))
+            {
+                return false;
+            }
+
+            const auto filterSize = static_cast<int>(convolutionalParameters.receptiveField);
+            const auto hasCenteredPadding = node.GetInputMemoryLayout().GetOffset(0) == filterSize / 2;
+            const auto hasOutputPadding = node.GetOutputMemoryLayout().GetOffset(0) != 0;
+            const auto isDepthwiseSeparable = node.GetLayer().GetWeights().NumChannels() == 1 && node.GetInputMemoryLayout().GetActiveSize(2) > 1;
+            switch (method)
             {
+            case ConvolutionMethod::simple:
+            case ConvolutionMethod::winograd:
+                return hasCenteredPadding;
+            case ConvolutionMethod::diagonal:
+                return hasCenteredPadding && !isDepthwiseSeparable;
+            case ConvolutionMethod::unrolled:
+                return !hasOutputPadding && !isDepthwiseSeparable;
+            default:
                 return false;
             }
-            predictors::neural::ConvolutionalLayer<ValueType> newLayer = { layerParameters, convolutionalParameters, layer.GetWeights() };
+        }
 
-            auto newNode = transformer.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(newInput, newLayer);
+        bool IsHostTarget(const model::MapCompilerOptions& settings)
+        {
+            const auto& deviceName = settings.compilerSettings.targetDevice.deviceName;
+            return deviceName.empty() || deviceName == "host";
+        }
 
-            transformer.MapNodeOutput(thisNode->output, newNode->output);
-            return true;
+        // The tuning database key: the CPU, the value type, and everything about the convolution's shape that affects its speed
+        template <typename ValueType>
+        std::string GetTuningKey(const nodes::ConvolutionalLayerNode<ValueType>& node, const model::MapCompilerOptions& settings)
+        {
+            const auto& targetDevice = settings.compilerSettings.targetDevice;
+            const auto cpu = IsHostTarget(settings) ? emitters::GetHostCPUName() : (targetDevice.cpu.empty() ? targetDevice.deviceName : targetDevice.cpu);
+            const auto& inputLayout = node.GetInputMemoryLayout();
+            const auto& outputLayout = node.GetOutputMemoryLayout();
+            const auto& convolutionalParameters = node.GetLayer().GetConvolutionalParameters();
+
+            std::stringstream key;
+            key << cpu << ';' << utilities::GetTypeName<ValueType>() << ';'
+                << inputLayout.GetActiveSize(0) << 'x' << inputLayout.GetActiveSize(1) << 'x' << inputLayout.GetActiveSize(2) << ';'
+                << "pad=" << inputLayout.GetOffset(0) << ',' << outputLayout.GetOffset(0) << ';'
+                << "filters=" << outputLayout.GetActiveSize(2) << 'x' << convolutionalParameters.receptiveField << 'x' << node.GetLayer().GetWeights().NumChannels() << ';'
+                << "stride=" << convolutionalParameters.stride;
+            return key.str();
+        }
+
+        // Compiles a model consisting of just the convolution, using the given method, and returns its best running time in milliseconds
+        template <typename ValueType>
+        double TimeConvolutionMethod(const nodes::ConvolutionalLayerNode<ValueType>& node, predictors::neural::ConvolutionMethod method, const model::MapCompilerOptions& settings)
+        {
+            model::Model model;
+            auto inputNode = model.AddNode<model::InputNode<ValueType>>(node.input.Size());
+            auto convolutionNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, GetLayerWithMethod(node, method));
+            model::Map map(model, { { "input", inputNode } }, { { "output", convolutionNode->output } });
+
+            // Compile with the same settings, but keeping the method we set, and without touching the JIT cache
+            auto tuningSettings = settings;
+            tuningSettings.moduleName = "ELLConvolutionTuning";
+            tuningSettings.optimizerSettings.preferredConvolutionMethod = model::PreferredConvolutionMethod::automatic;
+            tuningSettings.jitCacheDirectory = "";
+            tuningSettings.profile = false;
+            model::IRMapCompiler compiler(tuningSettings);
+            auto compiledMap = compiler.Compile(map);
+
+            std::vector<ValueType> input(node.input.Size());
+            for (size_t index = 0; index < input.size(); ++index)
+            {
+                input[index] = static_cast<ValueType>(std::sin(static_cast<double>(index)));
+            }
+            compiledMap.SetInputValue(0, input);
+            compiledMap.ComputeOutput<ValueType>(0); // warm up
+
+            double bestTime = std::numeric_limits<double>::max();
+            for (int run = 0; run < numTuningRuns; ++run)
+            {
+                auto start = std::chrono::steady_clock::now();
+                compiledMap.ComputeOutput<ValueType>(0);
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                bestTime = std::min(bestTime, elapsed.count());
+            }
+            return bestTime;
+        }
+
+        void LogTuningFailure(predictors::neural::ConvolutionMethod method, const std::exception& exception)
+        {
+            utilities::logging::Log() << "Timing convolution method " << static_cast<int>(method) << " failed: " << exception.what() << utilities::logging::EOL;
+        }
+
+        // Finds the fastest method for a convolution, returning 'false' if none of the methods can be used
+        template <typename ValueType>
+        bool TryTuneConvolutionMethod(const nodes::ConvolutionalLayerNode<ValueType>& node, const model::MapCompilerOptions& settings, predictors::neural::ConvolutionMethod& bestMethod)
+        {
+            using predictors::neural::ConvolutionMethod;
+
+            double bestTime = std::numeric_limits<double>::max();
+            for (auto method : { ConvolutionMethod::unrolled, ConvolutionMethod::simple, ConvolutionMethod::diagonal, ConvolutionMethod::winograd })
+            {
+                if (!CanTuneMethod(node, method))
+                {
+                    continue;
+                }
+
+                try
+                {
+                    auto time = TimeConvolutionMethod(node, method, settings);
+                    if (time < bestTime)
+                    {
+                        bestTime = time;
+                        bestMethod = method;
+                    }
+                }
+                catch (const utilities::InputException&)
+                {
+                    // The method can't handle this convolution, so it isn't a candidate
+                }
+                catch (const utilities::LogicException& exception)
+                {
+                    if (exception.GetErrorCode() != utilities::LogicExceptionErrors::notImplemented)
+                    {
+                        LogTuningFailure(method, exception);
+                        throw;
+                    }
+                }
+                catch (const std::exception& exception)
+                {
+                    LogTuningFailure(method, exception);
+                    throw;
+                }
+            }
+            return bestTime != std::numeric_limits<double>::max();
+        }
+
+        // returns 'true' if we handled the situation, else 'false'. If we return 'false', keep trying other ValueTypes.
+        template <typename ValueType>
+        bool TryAutotuneConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, const model::MapCompilerOptions& settings, ConvolutionTuningDatabase& database, bool& databaseChanged)
+        {
+            auto thisNode = dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node);
+            if (thisNode == nullptr)
+            {
+                return false;
+            }
+
+            auto key = GetTuningKey(*thisNode, settings);
+            predictors::neural::ConvolutionMethod method;
+            if (!database.TryGetMethod(key, method))
+            {
+                // We can only measure the methods if the compiled code can run here
+                if (!IsHostTarget(settings) || !TryTuneConvolutionMethod(*thisNode, settings, method))
+                {
+                    return false;
+                }
+
+                database.SetMethod(key, method);
+                databaseChanged = true;
+            }
+
+            return TrySetConvolutionMethod<ValueType>(node, transformer, method);
         }
 
         void SetConvolutionMethod(const model::Node& node, model::ModelTransformer& transformer, model::PreferredConvolutionMethod preferredMethod)
         {
             if (preferredMethod != model::PreferredConvolutionMethod::automatic)
             {
-                if (TrySetConvolutionMethod<float>(node, transformer, preferredMethod))
+                auto method = GetConvolutionMethod(preferredMethod);
+                if (TrySetConvolutionMethod<float>(node, transformer, method))
                 {
                     return;
                 }
-                if (TrySetConvolutionMethod<double>(node, transformer, preferredMethod))
+                if (TrySetConvolutionMethod<double>(node, transformer, method))
                 {
                     return;
                 }
@@ -111,12 +302,44 @@ namespace passes
     //
     // SetConvolutionMethodPass methods
     //
+    void SetConvolutionMethodPass::Initialize(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        _tuningDatabase = {};
+        _tuningDatabaseChanged = false;
+        const auto& filename = settings.optimizerSettings.convolutionTuningDatabase;
+        if (settings.optimizerSettings.preferredConvolutionMethod == model::PreferredConvolutionMethod::autotune && !filename.empty())
+        {
+            _tuningDatabase.Load(filename);
+        }
+    }
+
     void SetConvolutionMethodPass::OptimizeNode(const model::Node& node, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
     {
         auto preferredMethod = settings.optimizerSettings.preferredConvolutionMethod;
+        if (preferredMethod == model::PreferredConvolutionMethod::autotune)
+        {
+            auto& transformer = context.GetTransformer();
+            if (TryAutotuneConvolutionMethod<float>(node, transformer, settings, _tuningDatabase, _tuningDatabaseChanged) ||
+                TryAutotuneConvolutionMethod<double>(node, transformer, settings, _tuningDatabase, _tuningDatabaseChanged))
+            {
+                return;
+            }
+            transformer.CopyNode(node);
+            return;
+        }
+
         SetConvolutionMethod(node, context.GetTransformer(), preferredMethod);
     }
 
+    void SetConvolutionMethodPass::Finalize(const model::Model& model, const model::MapCompilerOptions& settings, model::ModelOptimizerContext& context) const
+    {
+        const auto& filename = settings.optimizerSettings.convolutionTuningDatabase;
+        if (_tuningDatabaseChanged && !filename.empty())
+        {
+            _tuningDatabase.Save(filename);
+        }
+    }
+
     void SetConvolutionMethodPass::AddToRegistry()
     {
         model::OptimizationPassInfo info = {
@@ -6,6 +6,7 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "FuseConvolutionOperationsPass.h"
 #include "FuseLinearOperationsPass.h"
 #include "OptimizeReorderDataNodes.h"
 #include "SetConvolutionMethodPass.h"
@@ -28,6 +29,7 @@ namespace passes
     {
         SetConvolutionMethodPass::AddToRegistry();
         FuseLinearOperationsPass::AddToRegistry();
+        FuseConvolutionOperationsPass::AddToRegistry();
         OptimizeReorderDataNodes::AddToRegistry();
     }
 }
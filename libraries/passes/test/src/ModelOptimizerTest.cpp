@@ -8,6 +8,9 @@
 
 // #include "ModelTestUtilities.h"
 
+// data
+#include "Dataset.h"
+
 // model
 #include "IRMapCompiler.h"
 #include "InputNode.h"
@@ -17,13 +20,28 @@
 #include "PortMemoryLayout.h"
 
 // nodes
+#include "ActivationLayerNode.h"
+#include "BatchNormalizationLayerNode.h"
+#include "BiasLayerNode.h"
 #include "BroadcastFunctionNode.h"
+#include "CompiledActivationFunctions.h"
 #include "ConstantNode.h"
+#include "ConvolutionalLayerNode.h"
+#include "FullyConnectedLayerNode.h"
+#include "FusedConvolutionNode.h"
 #include "MatrixMatrixMultiplyNode.h"
+#include "QuantizedMatrixMultiplyNode.h"
 #include "ReorderDataNode.h"
+#include "SimpleConvolutionNode.h"
+
+// predictors
+#include "ReLUActivation.h"
 
 // passes
+#include "ConvolutionTuningDatabase.h"
+#include "FuseConvolutionOperationsPass.h"
 #include "FuseLinearOperationsPass.h"
+#include "QuantizeNeuralNetworkPass.h"
 #include "StandardPasses.h"
 
 // testing
@@ -31,7 +49,10 @@
 
 // stl
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
 
 // set to 1 to print models
 #define PRINT_MODELS 0
@@ -404,3 +425,325 @@ void TestOptimizeReorderDataNodes4()
 
     testing::ProcessTest("Testing compiled model optimizer", oldSize == 9 && newSize == 4);
 }
+
+void TestQuantizeNeuralNetworkPass(bool includeConvolution)
+{
+    using ValueType = float;
+    using LayerParameters = typename predictors::neural::Layer<ValueType>::LayerParameters;
+    using TensorType = typename predictors::neural::Layer<ValueType>::TensorType;
+    using MatrixType = typename predictors::neural::Layer<ValueType>::MatrixType;
+
+    const size_t imageSize = 5;
+    const size_t numChannels = 3;
+    const size_t filterSize = 3;
+    const size_t numFilters = 4;
+    const size_t convOutputSize = imageSize - filterSize + 1;
+    const size_t numOutputs = 3;
+
+    // Create a model: an optional convolutional layer followed by a fully-connected layer
+    model::Model model;
+    TensorType imageTensor(imageSize, imageSize, numChannels);
+    TensorType convOutputTensor(convOutputSize, convOutputSize, numFilters);
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(imageTensor.Size());
+    const model::OutputPort<ValueType>* fullyConnectedInput = &inputNode->output;
+    if (includeConvolution)
+    {
+        LayerParameters convParameters{ imageTensor, predictors::neural::NoPadding(), { convOutputSize, convOutputSize, numFilters }, predictors::neural::NoPadding() };
+        predictors::neural::ConvolutionalParameters convolutionalParams{ filterSize, 1, predictors::neural::ConvolutionMethod::unrolled, 1 };
+        TensorType convWeights(filterSize * numFilters, filterSize, numChannels);
+        for (size_t i = 0; i < convWeights.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < convWeights.NumColumns(); ++j)
+            {
+                for (size_t k = 0; k < convWeights.NumChannels(); ++k)
+                {
+                    convWeights(i, j, k) = static_cast<ValueType>(std::sin(0.7 * i + 0.3 * j + 1.1 * k));
+                }
+            }
+        }
+        predictors::neural::ConvolutionalLayer<ValueType> convLayer(convParameters, convolutionalParams, convWeights);
+        auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, convLayer);
+        fullyConnectedInput = &convNode->output;
+    }
+
+    const auto& fullyConnectedInputTensor = includeConvolution ? convOutputTensor : imageTensor;
+    LayerParameters fullyConnectedParameters{ fullyConnectedInputTensor, predictors::neural::NoPadding(), { numOutputs, 1, 1 }, predictors::neural::NoPadding() };
+    MatrixType fullyConnectedWeights(numOutputs, fullyConnectedInputTensor.Size());
+    for (size_t i = 0; i < fullyConnectedWeights.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < fullyConnectedWeights.NumColumns(); ++j)
+        {
+            fullyConnectedWeights(i, j) = static_cast<ValueType>(std::cos(1.3 * i + 0.1 * j));
+        }
+    }
+    predictors::neural::FullyConnectedLayer<ValueType> fullyConnectedLayer(fullyConnectedParameters, fullyConnectedWeights);
+    auto fullyConnectedNode = model.AddNode<nodes::FullyConnectedLayerNode<ValueType>>(*fullyConnectedInput, fullyConnectedLayer);
+    model::Map map(model, { { "input", inputNode } }, { { "output", fullyConnectedNode->output } });
+
+    // Generate calibration data, and evaluate the unquantized map on it
+    data::AutoSupervisedDataset dataset;
+    std::vector<std::vector<ValueType>> testInputs;
+    std::vector<std::vector<ValueType>> referenceOutputs;
+    for (int exampleIndex = 0; exampleIndex < 8; ++exampleIndex)
+    {
+        std::vector<double> values(imageTensor.Size());
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            values[index] = std::sin(0.3 * index + exampleIndex);
+        }
+        dataset.AddExample(data::AutoSupervisedExample(data::AutoDataVector(values), data::WeightLabel{ 1.0, 0.0 }));
+        testInputs.emplace_back(values.begin(), values.end());
+        referenceOutputs.push_back(map.Compute<ValueType>(testInputs.back()));
+    }
+
+    // Calibrate and quantize the map
+    auto calibration = passes::CalibrateQuantization(map, dataset);
+    testing::ProcessTest("Testing quantization calibration", calibration.inputRanges.size() == (includeConvolution ? 2 : 1));
+
+    model::MapCompilerOptions settings;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::QuantizeNeuralNetworkPass>(calibration));
+    map.Optimize(optimizer);
+    auto numQuantizedNodes = map.GetModel().GetNodesByType<nodes::QuantizedMatrixMultiplyNode<ValueType>>().size();
+    testing::ProcessTest("Testing quantized node count", numQuantizedNodes == (includeConvolution ? 2 : 1));
+
+    // Compile the quantized model
+    passes::AddStandardPassesToRegistry();
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+
+    const double tolerance = 0.05;
+    bool compiledOk = true;
+    bool interpretedOk = true;
+    for (size_t exampleIndex = 0; exampleIndex < testInputs.size(); ++exampleIndex)
+    {
+        const auto& reference = referenceOutputs[exampleIndex];
+        auto range = std::abs(*std::max_element(reference.begin(), reference.end(), [](ValueType a, ValueType b) { return std::abs(a) < std::abs(b); }));
+
+        compiledMap.SetInputValue(0, testInputs[exampleIndex]);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+        for (size_t index = 0; index < reference.size(); ++index)
+        {
+            compiledOk = compiledOk && std::abs(compiledOutput[index] - reference[index]) <= tolerance * range;
+        }
+
+        // The receptive field matrix used by the quantized convolution can only be compiled
+        if (!includeConvolution)
+        {
+            auto interpretedOutput = map.Compute<ValueType>(testInputs[exampleIndex]);
+            interpretedOk = interpretedOk && testing::IsEqual(interpretedOutput, compiledOutput, static_cast<ValueType>(1e-5));
+        }
+    }
+    testing::ProcessTest("Testing compiled quantized result", compiledOk);
+    testing::ProcessTest("Testing interpreted quantized result", interpretedOk);
+}
+
+void TestFuseConvolutionOperationsPass()
+{
+    using ValueType = float;
+    using LayerParameters = typename predictors::neural::Layer<ValueType>::LayerParameters;
+    using TensorType = typename predictors::neural::Layer<ValueType>::TensorType;
+    using VectorType = typename predictors::neural::Layer<ValueType>::VectorType;
+
+    const size_t imageSize = 6;
+    const size_t numChannels = 3;
+    const size_t filterSize = 3;
+    const size_t numFilters = 4;
+    const size_t outputSize = imageSize - filterSize + 1;
+
+    // Create a model: convolution -> bias -> batch normalization -> ReLU
+    model::Model model;
+    TensorType imageTensor(imageSize, imageSize, numChannels);
+    TensorType outputTensor(outputSize, outputSize, numFilters);
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(imageTensor.Size());
+
+    LayerParameters convParameters{ imageTensor, predictors::neural::NoPadding(), { outputSize, outputSize, numFilters }, predictors::neural::NoPadding() };
+    predictors::neural::ConvolutionalParameters convolutionalParams{ filterSize, 1, predictors::neural::ConvolutionMethod::unrolled, 1 };
+    TensorType convWeights(filterSize * numFilters, filterSize, numChannels);
+    for (size_t i = 0; i < convWeights.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < convWeights.NumColumns(); ++j)
+        {
+            for (size_t k = 0; k < convWeights.NumChannels(); ++k)
+            {
+                convWeights(i, j, k) = static_cast<ValueType>(std::sin(0.7 * i + 0.3 * j + 1.1 * k));
+            }
+        }
+    }
+    predictors::neural::ConvolutionalLayer<ValueType> convLayer(convParameters, convolutionalParams, convWeights);
+    auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, convLayer);
+
+    LayerParameters channelParameters{ outputTensor, predictors::neural::NoPadding(), { outputSize, outputSize, numFilters }, predictors::neural::NoPadding() };
+    VectorType bias({ 0.5f, -0.25f, 0.1f, -1.0f });
+    predictors::neural::BiasLayer<ValueType> biasLayer(channelParameters, bias);
+    auto biasNode = model.AddNode<nodes::BiasLayerNode<ValueType>>(convNode->output, biasLayer);
+
+    VectorType mean({ 0.1f, 0.2f, -0.3f, 0.0f });
+    VectorType variance({ 1.5f, 0.5f, 2.0f, 0.25f });
+    predictors::neural::BatchNormalizationLayer<ValueType> batchNormLayer(channelParameters, mean, variance, 1.0e-3f, predictors::neural::EpsilonSummand::SqrtVariance);
+    auto batchNormNode = model.AddNode<nodes::BatchNormalizationLayerNode<ValueType>>(biasNode->output, batchNormLayer);
+
+    predictors::neural::ActivationLayer<ValueType> activationLayer(channelParameters, predictors::neural::Activation<ValueType>(new predictors::neural::ReLUActivation<ValueType>()));
+    auto activationNode = model.AddNode<nodes::ActivationLayerNode<ValueType>>(batchNormNode->output, activationLayer);
+    model::Map map(model, { { "input", inputNode } }, { { "output", activationNode->output } });
+
+    // Evaluate the unfused map
+    std::vector<std::vector<ValueType>> testInputs;
+    std::vector<std::vector<ValueType>> referenceOutputs;
+    for (int exampleIndex = 0; exampleIndex < 4; ++exampleIndex)
+    {
+        std::vector<ValueType> values(imageTensor.Size());
+        for (size_t index = 0; index < values.size(); ++index)
+        {
+            values[index] = static_cast<ValueType>(std::sin(0.3 * index + exampleIndex));
+        }
+        testInputs.push_back(values);
+        referenceOutputs.push_back(map.Compute<ValueType>(values));
+    }
+
+    // Refine everything but the convolution (as the compiler does before optimizing), then fuse
+    passes::AddStandardPassesToRegistry();
+    model::MapCompilerOptions settings;
+    settings.optimizerSettings.fuseConvolutionNodes = true;
+    model::ModelOptimizer optimizer(settings);
+    optimizer.AddPass(std::make_unique<passes::FuseLinearOperationsPass>());
+    optimizer.AddPass(std::make_unique<passes::FuseConvolutionOperationsPass>());
+    model::Map optimizedMap(map);
+    model::TransformContext context{ [](const model::Node& node) { return dynamic_cast<const nodes::ConvolutionalLayerNode<ValueType>*>(&node) == nullptr ? model::NodeAction::refine : model::NodeAction::compile; } };
+    optimizedMap.Refine(context);
+    optimizedMap.Optimize(optimizer);
+
+    const auto& optimizedModel = optimizedMap.GetModel();
+    auto fusedNodes = optimizedModel.GetNodesByType<nodes::FusedConvolutionNode<ValueType>>();
+    bool isFused = fusedNodes.size() == 1 && fusedNodes[0]->HasActivation() &&
+                   optimizedModel.GetNodesByType<nodes::ConvolutionalLayerNode<ValueType>>().empty() &&
+                   optimizedModel.GetNodesByType<nodes::BroadcastLinearFunctionNode<ValueType>>().empty() &&
+                   optimizedModel.GetNodesByType<nodes::BroadcastUnaryFunctionNode<ValueType, nodes::ReLUActivationFunction<ValueType>>>().empty();
+    testing::ProcessTest("Testing fused convolution node count", isFused);
+
+    // Compile the original map with fusion enabled
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    testing::ProcessTest("Testing compiled fused convolution node count", compiledMap.GetModel().GetNodesByType<nodes::FusedConvolutionNode<ValueType>>().size() == 1);
+
+    bool interpretedOk = true;
+    bool compiledOk = true;
+    for (size_t exampleIndex = 0; exampleIndex < testInputs.size(); ++exampleIndex)
+    {
+        auto interpretedOutput = optimizedMap.Compute<ValueType>(testInputs[exampleIndex]);
+        interpretedOk = interpretedOk && testing::IsEqual(interpretedOutput, referenceOutputs[exampleIndex], static_cast<ValueType>(1e-4));
+
+        compiledMap.SetInputValue(0, testInputs[exampleIndex]);
+        auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+        compiledOk = compiledOk && testing::IsEqual(compiledOutput, referenceOutputs[exampleIndex], static_cast<ValueType>(1e-4));
+    }
+    testing::ProcessTest("Testing interpreted fused convolution result", interpretedOk);
+    testing::ProcessTest("Testing compiled fused convolution result", compiledOk);
+}
+
+void TestConvolutionTuningDatabase()
+{
+    using predictors::neural::ConvolutionMethod;
+
+    passes::ConvolutionTuningDatabase database;
+    database.SetMethod("cpu;float;8x8x3;pad=1,0;filters=4x3x3;stride=1", ConvolutionMethod::winograd);
+    database.SetMethod("cpu;float;8x8x3;pad=0,0;filters=4x3x3;stride=2", ConvolutionMethod::unrolled);
+
+    std::stringstream stream;
+    database.Write(stream);
+
+    passes::ConvolutionTuningDatabase newDatabase;
+    newDatabase.Read(stream);
+    ConvolutionMethod method1 = ConvolutionMethod::automatic;
+    ConvolutionMethod method2 = ConvolutionMethod::automatic;
+    ConvolutionMethod method3 = ConvolutionMethod::automatic;
+    bool ok = newDatabase.NumEntries() == 2 &&
+              newDatabase.TryGetMethod("cpu;float;8x8x3;pad=1,0;filters=4x3x3;stride=1", method1) && method1 == ConvolutionMethod::winograd &&
+              newDatabase.TryGetMethod("cpu;float;8x8x3;pad=0,0;filters=4x3x3;stride=2", method2) && method2 == ConvolutionMethod::unrolled &&
+              !newDatabase.TryGetMethod("cpu;double;8x8x3;pad=0,0;filters=4x3x3;stride=2", method3);
+    testing::ProcessTest("Testing convolution tuning database round trip", ok);
+}
+
+void TestAutotuneConvolutionMethod()
+{
+    using ValueType = float;
+    using LayerParameters = typename predictors::neural::Layer<ValueType>::LayerParameters;
+    using TensorType = typename predictors::neural::Layer<ValueType>::TensorType;
+
+    const size_t imageSize = 6;
+    const size_t inputPadding = 1;
+    const size_t numChannels = 3;
+    const size_t filterSize = 3;
+    const size_t numFilters = 4;
+    const std::string databaseFilename = "convolutionTuningTest.db";
+    std::remove(databaseFilename.c_str());
+
+    // Create a model with a single "same" convolution, so all of the methods are candidates
+    model::Model model;
+    TensorType paddedImageTensor(imageSize + 2 * inputPadding, imageSize + 2 * inputPadding, numChannels);
+    auto inputNode = model.AddNode<model::InputNode<ValueType>>(paddedImageTensor.Size());
+    LayerParameters convParameters{ paddedImageTensor, predictors::neural::ZeroPadding(inputPadding), { imageSize, imageSize, numFilters }, predictors::neural::NoPadding() };
+    predictors::neural::ConvolutionalParameters convolutionalParams{ filterSize, 1, predictors::neural::ConvolutionMethod::unrolled, 1 };
+    TensorType convWeights(filterSize * numFilters, filterSize, numChannels);
+    for (size_t i = 0; i < convWeights.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < convWeights.NumColumns(); ++j)
+        {
+            for (size_t k = 0; k < convWeights.NumChannels(); ++k)
+            {
+                convWeights(i, j, k) = static_cast<ValueType>(std::sin(0.7 * i + 0.3 * j + 1.1 * k));
+            }
+        }
+    }
+    predictors::neural::ConvolutionalLayer<ValueType> convLayer(convParameters, convolutionalParams, convWeights);
+    auto convNode = model.AddNode<nodes::ConvolutionalLayerNode<ValueType>>(inputNode->output, convLayer);
+    model::Map map(model, { { "input", inputNode } }, { { "output", convNode->output } });
+
+    // The padding must be zero for the reference result
+    std::vector<ValueType> testInput(paddedImageTensor.Size());
+    for (size_t i = 0; i < imageSize; ++i)
+    {
+        for (size_t j = 0; j < imageSize; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                testInput[((i + inputPadding) * paddedImageTensor.NumColumns() + (j + inputPadding)) * numChannels + k] = static_cast<ValueType>(std::cos(0.5 * i + 0.2 * j + k));
+            }
+        }
+    }
+    auto referenceOutput = map.Compute<ValueType>(testInput);
+
+    passes::AddStandardPassesToRegistry();
+    model::MapCompilerOptions settings;
+    settings.optimizerSettings.preferredConvolutionMethod = model::PreferredConvolutionMethod::autotune;
+    settings.optimizerSettings.convolutionTuningDatabase = databaseFilename;
+
+    // The first compile measures the methods and records the winner
+    model::IRMapCompiler compiler(settings);
+    auto compiledMap = compiler.Compile(map);
+    compiledMap.SetInputValue(0, testInput);
+    auto compiledOutput = compiledMap.ComputeOutput<ValueType>(0);
+    testing::ProcessTest("Testing autotuned convolution result", testing::IsEqual(compiledOutput, referenceOutput, static_cast<ValueType>(1e-4)));
+
+    passes::ConvolutionTuningDatabase database;
+    database.Load(databaseFilename);
+    testing::ProcessTest("Testing autotuned convolution database", database.NumEntries() == 1);
+
+    // Later compiles reuse the stored method, even if it isn't the one measured
+    std::stringstream stream;
+    database.Write(stream);
+    auto entry = stream.str();
+    auto keyStart = entry.find('\n') + 1;
+    auto key = entry.substr(keyStart, entry.find(' ', keyStart) - keyStart);
+    database.SetMethod(key, predictors::neural::ConvolutionMethod::simple);
+    database.Save(databaseFilename);
+
+    model::IRMapCompiler secondCompiler(settings);
+    auto secondCompiledMap = secondCompiler.Compile(map);
+    secondCompiledMap.SetInputValue(0, testInput);
+    auto secondCompiledOutput = secondCompiledMap.ComputeOutput<ValueType>(0);
+    testing::ProcessTest("Testing cached autotuned convolution method", secondCompiledMap.GetModel().GetNodesByType<nodes::SimpleConvolutionComputeNode<ValueType>>().size() == 1);
+    testing::ProcessTest("Testing cached autotuned convolution result", testing::IsEqual(secondCompiledOutput, referenceOutput, static_cast<ValueType>(1e-4)));
+
+    std::remove(databaseFilename.c_str());
+}
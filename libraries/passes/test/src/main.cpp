@@ -33,6 +33,14 @@ int main()
         TestOptimizeReorderDataNodes2();
         TestOptimizeReorderDataNodes3();
         TestOptimizeReorderDataNodes4();
+
+        TestQuantizeNeuralNetworkPass(false);
+        TestQuantizeNeuralNetworkPass(true);
+
+        TestFuseConvolutionOperationsPass();
+
+        TestConvolutionTuningDatabase();
+        TestAutotuneConvolutionMethod();
     }
     catch (const utilities::Exception& exception)
     {
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictor.h (predictors)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ForestPredictor.h"
+#include "IPredictor.h"
+
+// data
+#include "DenseDataVector.h"
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace predictors
+{
+    /// <summary> An inference-only copy of a SimpleForestPredictor, stored as a structure of arrays. The
+    /// interior nodes of each tree are laid out depth-first in three contiguous arrays (split feature
+    /// indices, split thresholds, and pairs of child offsets), and each leaf stores the sum of the edge
+    /// outputs on its path, so a prediction reads one small node record per level and one leaf value
+    /// per tree. The batch functions walk several trees for several examples in lockstep, so the
+    /// memory accesses of the independent walks overlap. Features past the prefix of an input vector
+    /// are zero. </summary>
+    class FlatForestPredictor : public IPredictor<double>
+    {
+    public:
+        /// <summary> Type of the data vector expected by this predictor type. </summary>
+        using DataVectorType = data::FloatDataVector;
+
+        /// <summary> Default constructor, which creates a forest with no trees. </summary>
+        FlatForestPredictor() = default;
+
+        /// <summary> Constructs the flat representation of a trained forest. </summary>
+        ///
+        /// <param name="forest"> The forest. </param>
+        FlatForestPredictor(const SimpleForestPredictor& forest);
+
+        /// <summary> Gets the number of trees in the forest. </summary>
+        ///
+        /// <returns> The number of trees. </returns>
+        size_t NumTrees() const { return _rootIndices.size(); }
+
+        /// <summary> Gets the number of interior nodes in the forest. </summary>
+        ///
+        /// <returns> The number of interior nodes. </returns>
+        size_t NumInteriorNodes() const { return _splitFeatures.size(); }
+
+        /// <summary> Gets the number of input features the forest reads: one plus the largest split feature index. </summary>
+        ///
+        /// <returns> The number of features. </returns>
+        size_t NumFeatures() const { return _numFeatures; }
+
+        /// <summary> Gets the bias value. </summary>
+        ///
+        /// <returns> The bias. </returns>
+        double GetBias() const { return _bias; }
+
+        /// <summary> Returns the output of the forest (including all trees and the bias term) for a given input. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        ///
+        /// <returns> The prediction, which equals the prediction of the original forest. </returns>
+        double Predict(const DataVectorType& input) const;
+
+        /// <summary> Returns the output of the forest for a given input. </summary>
+        ///
+        /// <param name="input"> Pointer to the NumFeatures() values of the input. </param>
+        ///
+        /// <returns> The prediction. </returns>
+        double Predict(const float* input) const;
+
+        /// <summary> Returns the outputs of the forest for a batch of inputs. </summary>
+        ///
+        /// <param name="inputs"> The input vectors. </param>
+        ///
+        /// <returns> The predictions, one per input. </returns>
+        std::vector<double> PredictBatch(const std::vector<DataVectorType>& inputs) const;
+
+        /// <summary> Computes the outputs of the forest for a batch of inputs, stored as the rows of a row-major matrix. </summary>
+        ///
+        /// <param name="inputs"> Pointer to the first input. Each input has at least NumFeatures() values. </param>
+        /// <param name="numInputs"> The number of inputs. </param>
+        /// <param name="inputStride"> The distance between consecutive inputs, in elements. </param>
+        /// <param name="outputs"> Pointer to the numInputs predictions. </param>
+        void PredictBatch(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const;
+
+    private:
+        int AddSubtree(const SimpleForestPredictor& forest, size_t interiorNodeIndex, double pathValue);
+        void PredictBlock(const float* const* inputs, size_t numInputs, double* outputs) const;
+
+        // Leaves are stored in the child arrays as -1 - (index into _leafValues)
+        std::vector<int> _rootIndices;
+        std::vector<int> _splitFeatures;
+        std::vector<float> _splitThresholds;
+        std::vector<int> _children; // two per interior node: the child for input <= threshold, then the child for input > threshold
+        std::vector<double> _leafValues;
+        size_t _numFeatures = 0;
+        double _bias = 0.0;
+    };
+}
+}
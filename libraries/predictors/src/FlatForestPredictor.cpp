@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     FlatForestPredictor.cpp (predictors)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FlatForestPredictor.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ell
+{
+namespace predictors
+{
+    namespace
+    {
+        // The batch functions advance the walks of treeTileSize trees for exampleBlockSize examples together
+        const size_t exampleBlockSize = 8;
+        const size_t treeTileSize = 4;
+
+        // The original forest compares float inputs, widened to double, with double thresholds. The largest float that is
+        // at most the threshold gives the same result for every float input, so the flat forest can compare floats.
+        float GetFloatThreshold(double threshold)
+        {
+            auto result = static_cast<float>(threshold);
+            if (result > threshold)
+            {
+                result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+            }
+            return result;
+        }
+
+        int GetLeafCode(size_t leafIndex)
+        {
+            return -1 - static_cast<int>(leafIndex);
+        }
+
+        size_t GetLeafIndex(int leafCode)
+        {
+            return static_cast<size_t>(-1 - leafCode);
+        }
+    }
+
+    FlatForestPredictor::FlatForestPredictor(const SimpleForestPredictor& forest)
+        : _bias(forest.GetBias())
+    {
+        _splitFeatures.reserve(forest.NumInteriorNodes());
+        _splitThresholds.reserve(forest.NumInteriorNodes());
+        _children.reserve(2 * forest.NumInteriorNodes());
+        for (auto rootIndex : forest.GetRootIndices())
+        {
+            _rootIndices.push_back(AddSubtree(forest, rootIndex, 0.0));
+        }
+    }
+
+    int FlatForestPredictor::AddSubtree(const SimpleForestPredictor& forest, size_t interiorNodeIndex, double pathValue)
+    {
+        const auto& interiorNode = forest.GetInteriorNodes()[interiorNodeIndex];
+        const auto& edges = interiorNode.GetOutgoingEdges();
+        if (edges.size() != 2)
+        {
+            throw utilities::LogicException(utilities::LogicExceptionErrors::illegalState, "flat forests require binary splits");
+        }
+
+        // Reserve this node's record before visiting its children, so each tree is laid out depth-first
+        const auto& splitRule = interiorNode.GetSplitRule();
+        auto nodeIndex = static_cast<int>(_splitFeatures.size());
+        _splitFeatures.push_back(static_cast<int>(splitRule.GetElementIndex()));
+        _splitThresholds.push_back(GetFloatThreshold(splitRule.GetThreshold()));
+        _children.resize(_children.size() + 2);
+        _numFeatures = std::max(_numFeatures, splitRule.GetElementIndex() + 1);
+
+        for (size_t edgePosition = 0; edgePosition < 2; ++edgePosition)
+        {
+            // sum the edge outputs in the same order as ForestPredictor::Predict, so the predictions are identical
+            const auto& edge = edges[edgePosition];
+            auto edgePathValue = pathValue + edge.GetPredictor().GetValue();
+
+            int child = 0;
+            if (edge.IsTargetInterior())
+            {
+                child = AddSubtree(forest, edge.GetTargetNodeIndex(), edgePathValue);
+            }
+            else
+            {
+                child = GetLeafCode(_leafValues.size());
+                _leafValues.push_back(edgePathValue);
+            }
+            _children[2 * nodeIndex + edgePosition] = child;
+        }
+        return nodeIndex;
+    }
+
+    double FlatForestPredictor::Predict(const DataVectorType& input) const
+    {
+        const auto& values = input.GetValues();
+        if (values.size() >= _numFeatures)
+        {
+            return Predict(values.data());
+        }
+
+        std::vector<float> paddedValues(values.begin(), values.end());
+        paddedValues.resize(_numFeatures);
+        return Predict(paddedValues.data());
+    }
+
+    double FlatForestPredictor::Predict(const float* input) const
+    {
+        double output = _bias;
+        for (auto rootIndex : _rootIndices)
+        {
+            auto node = rootIndex;
+            while (node >= 0)
+            {
+                node = _children[2 * node + (input[_splitFeatures[node]] > _splitThresholds[node] ? 1 : 0)];
+            }
+            output += _leafValues[GetLeafIndex(node)];
+        }
+        return output;
+    }
+
+    std::vector<double> FlatForestPredictor::PredictBatch(const std::vector<DataVectorType>& inputs) const
+    {
+        std::vector<double> outputs(inputs.size());
+        std::vector<float> paddedValues(exampleBlockSize * _numFeatures);
+        const float* blockInputs[exampleBlockSize];
+        for (size_t blockBegin = 0; blockBegin < inputs.size(); blockBegin += exampleBlockSize)
+        {
+            auto blockSize = std::min(exampleBlockSize, inputs.size() - blockBegin);
+            for (size_t index = 0; index < blockSize; ++index)
+            {
+                const auto& values = inputs[blockBegin + index].GetValues();
+                if (values.size() >= _numFeatures)
+                {
+                    blockInputs[index] = values.data();
+                }
+                else
+                {
+                    auto padded = paddedValues.begin() + index * _numFeatures;
+                    std::fill(std::copy(values.begin(), values.end(), padded), padded + _numFeatures, 0.0f);
+                    blockInputs[index] = paddedValues.data() + index * _numFeatures;
+                }
+            }
+            PredictBlock(blockInputs, blockSize, outputs.data() + blockBegin);
+        }
+        return outputs;
+    }
+
+    void FlatForestPredictor::PredictBatch(const float* inputs, size_t numInputs, size_t inputStride, double* outputs) const
+    {
+        const float* blockInputs[exampleBlockSize];
+        for (size_t blockBegin = 0; blockBegin < numInputs; blockBegin += exampleBlockSize)
+        {
+            auto blockSize = std::min(exampleBlockSize, numInputs - blockBegin);
+            for (size_t index = 0; index < blockSize; ++index)
+            {
+                blockInputs[index] = inputs + (blockBegin + index) * inputStride;
+            }
+            PredictBlock(blockInputs, blockSize, outputs + blockBegin);
+        }
+    }
+
+    void FlatForestPredictor::PredictBlock(const float* const* inputs, size_t numInputs, double* outputs) const
+    {
+        std::fill(outputs, outputs + numInputs, _bias);
+
+        int nodes[treeTileSize * exampleBlockSize];
+        const auto numTrees = _rootIndices.size();
+        for (size_t tileBegin = 0; tileBegin < numTrees; tileBegin += treeTileSize)
+        {
+            auto tileSize = std::min(treeTileSize, numTrees - tileBegin);
+            for (size_t treeIndex = 0; treeIndex < tileSize; ++treeIndex)
+            {
+                std::fill(nodes + treeIndex * numInputs, nodes + (treeIndex + 1) * numInputs, _rootIndices[tileBegin + treeIndex]);
+            }
+
+            // Advance every walk by one level per pass, until they all reach leaves. The walks are independent, so their
+            // memory accesses overlap instead of waiting on each other.
+            bool isWalking = true;
+            while (isWalking)
+            {
+                isWalking = false;
+                for (size_t treeIndex = 0; treeIndex < tileSize; ++treeIndex)
+                {
+                    auto treeNodes = nodes + treeIndex * numInputs;
+                    for (size_t index = 0; index < numInputs; ++index)
+                    {
+                        auto node = treeNodes[index];
+                        if (node >= 0)
+                        {
+                            node = _children[2 * node + (inputs[index][_splitFeatures[node]] > _splitThresholds[node] ? 1 : 0)];
+                            treeNodes[index] = node;
+                            isWalking = isWalking || node >= 0;
+                        }
+                    }
+                }
+            }
+
+            // Add the tree outputs in tree order, as Predict does
+            for (size_t treeIndex = 0; treeIndex < tileSize; ++treeIndex)
+            {
+                for (size_t index = 0; index < numInputs; ++index)
+                {
+                    outputs[index] += _leafValues[GetLeafIndex(nodes[treeIndex * numInputs + index])];
+                }
+            }
+        }
+    }
+}
+}
@@ -12,3 +12,4 @@
 #include "testing.h"
 
 void ForestPredictorTest();
+void FlatForestPredictorTest();
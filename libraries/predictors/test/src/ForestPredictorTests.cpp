@@ -6,11 +6,16 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "FlatForestPredictor.h"
 #include "ForestPredictor.h"
 
 // testing
 #include "testing.h"
 
+// stl
+#include <random>
+#include <vector>
+
 using namespace ell;
 
 void ForestPredictorTest()
@@ -66,3 +71,80 @@ void ForestPredictorTest()
     auto edgeIndicator = forest.GetEdgeIndicatorVector(ExampleType{ 0.25, 0.7, 0.0 });
     testing::ProcessTest("Testing ForestPredictor, SetEdgeIndicatorVector()", testing::IsEqual(edgeIndicator, std::vector<bool>{ 1, 0, 0, 1, 0, 0, 0, 1 }));
 }
+
+void FlatForestPredictorTest()
+{
+    // define some abbreviations
+    using SplitAction = predictors::SimpleForestPredictor::SplitAction;
+    using SplitRule = predictors::SingleElementThresholdPredictor;
+    using EdgePredictorVector = std::vector<predictors::ConstantPredictor>;
+    using ExampleType = predictors::FlatForestPredictor::DataVectorType;
+
+    // grow trees of different shapes by splitting random leaves
+    std::default_random_engine engine(123);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    const size_t numFeatures = 6;
+    predictors::SimpleForestPredictor forest;
+    forest.AddToBias(0.25);
+    for (size_t treeIndex = 0; treeIndex < 11; ++treeIndex)
+    {
+        std::vector<predictors::SimpleForestPredictor::SplittableNodeId> leaves = { forest.GetNewRootId() };
+        for (size_t splitIndex = 0; splitIndex < 3 * treeIndex + 1; ++splitIndex)
+        {
+            auto leafPosition = engine() % leaves.size();
+            auto leaf = leaves[leafPosition];
+            leaves.erase(leaves.begin() + leafPosition);
+            auto nodeIndex = forest.Split(SplitAction{ leaf, SplitRule{ engine() % numFeatures, uniform(engine) }, EdgePredictorVector{ uniform(engine), uniform(engine) } });
+            leaves.push_back(forest.GetChildId(nodeIndex, 0));
+            leaves.push_back(forest.GetChildId(nodeIndex, 1));
+        }
+    }
+
+    predictors::FlatForestPredictor flatForest(forest);
+    testing::ProcessTest("Testing FlatForestPredictor, NumTrees()", flatForest.NumTrees() == forest.NumTrees());
+    testing::ProcessTest("Testing FlatForestPredictor, NumInteriorNodes()", flatForest.NumInteriorNodes() == forest.NumInteriorNodes());
+
+    // random inputs, inputs equal to the split thresholds, and inputs shorter than the number of features
+    std::vector<ExampleType> examples;
+    std::vector<float> rows;
+    for (size_t exampleIndex = 0; exampleIndex < 37; ++exampleIndex)
+    {
+        std::vector<float> row(numFeatures);
+        for (auto& value : row)
+        {
+            value = static_cast<float>(uniform(engine));
+        }
+        if (exampleIndex % 5 == 0)
+        {
+            const auto& splitRule = forest.GetInteriorNodes()[exampleIndex].GetSplitRule();
+            row[splitRule.GetElementIndex()] = static_cast<float>(splitRule.GetThreshold());
+        }
+        if (exampleIndex % 7 == 0)
+        {
+            std::fill(row.begin() + numFeatures / 2, row.end(), 0.0f);
+        }
+        rows.insert(rows.end(), row.begin(), row.end());
+        examples.emplace_back(row);
+    }
+
+    std::vector<double> expected;
+    bool predictMatches = true;
+    bool pointerPredictMatches = true;
+    for (size_t exampleIndex = 0; exampleIndex < examples.size(); ++exampleIndex)
+    {
+        // the original forest requires every feature it reads to be in the prefix of the input, so it gets padded copies
+        std::vector<double> paddedRow(rows.begin() + exampleIndex * numFeatures, rows.begin() + (exampleIndex + 1) * numFeatures);
+        paddedRow.push_back(1.0);
+        expected.push_back(forest.Predict(ExampleType(paddedRow)));
+        predictMatches = predictMatches && flatForest.Predict(examples[exampleIndex]) == expected.back();
+        pointerPredictMatches = pointerPredictMatches && flatForest.Predict(rows.data() + exampleIndex * numFeatures) == expected.back();
+    }
+    testing::ProcessTest("Testing FlatForestPredictor, Predict()", predictMatches);
+    testing::ProcessTest("Testing FlatForestPredictor, Predict(pointer)", pointerPredictMatches);
+
+    testing::ProcessTest("Testing FlatForestPredictor, PredictBatch()", flatForest.PredictBatch(examples) == expected);
+
+    std::vector<double> outputs(examples.size());
+    flatForest.PredictBatch(rows.data(), examples.size(), numFeatures, outputs.data());
+    testing::ProcessTest("Testing FlatForestPredictor, PredictBatch(pointer)", outputs == expected);
+}
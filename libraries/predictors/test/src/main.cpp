@@ -20,6 +20,7 @@ int main()
 {
     // ForestPredictor
     ForestPredictorTest();
+    FlatForestPredictorTest();
 
     // LinearPredictor
     LinearPredictorTest<double>();
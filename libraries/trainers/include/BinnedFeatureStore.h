@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedFeatureStore.h (trainers)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace trainers
+{
+    /// <summary>
+    /// A quantized, column-major copy of the features of a dataset. Each feature has a sorted list of thresholds
+    /// that divide its values into bins, and each feature value is replaced by the index of its bin. The bins
+    /// of a feature are stored contiguously, one byte per value when every feature has at most 256 bins, and two
+    /// bytes per value otherwise.
+    /// </summary>
+    class BinnedFeatureStore
+    {
+    public:
+        /// <summary> Default constructor, creating an empty store. </summary>
+        BinnedFeatureStore() = default;
+
+        /// <summary> Constructs a store for a given number of rows, with all values in bin 0. </summary>
+        ///
+        /// <param name="thresholds"> For each feature, the sorted thresholds between consecutive bins. Feature `f`
+        /// has `thresholds[f].size() + 1` bins, and a value belongs to the first bin whose threshold is not below it. </param>
+        /// <param name="numRows"> The number of rows. </param>
+        BinnedFeatureStore(std::vector<std::vector<double>> thresholds, size_t numRows);
+
+        /// <summary> Returns the number of rows. </summary>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Returns the number of features. </summary>
+        size_t NumFeatures() const { return _thresholds.size(); }
+
+        /// <summary> Returns the number of bins of a feature. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        size_t NumBins(size_t featureIndex) const { return _thresholds[featureIndex].size() + 1; }
+
+        /// <summary> Returns the total number of bins of all the features. </summary>
+        size_t NumBins() const { return _binOffsets.back(); }
+
+        /// <summary> Returns the position of the first bin of a feature, when the bins of all the features are laid out one after the other. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        size_t GetBinOffset(size_t featureIndex) const { return _binOffsets[featureIndex]; }
+
+        /// <summary> Returns the threshold that separates a bin from the next one. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="binIndex"> The bin index, which must be smaller than `NumBins(featureIndex) - 1`. </param>
+        double GetThreshold(size_t featureIndex, size_t binIndex) const { return _thresholds[featureIndex][binIndex]; }
+
+        /// <summary> Returns the bin that a value of a feature belongs to. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="value"> The feature value. </param>
+        size_t GetBinForValue(size_t featureIndex, double value) const;
+
+        /// <summary> Sets the value of a feature in a row, by storing the index of its bin. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="rowIndex"> The row index. </param>
+        /// <param name="value"> The feature value. </param>
+        void SetValue(size_t featureIndex, size_t rowIndex, double value);
+
+        /// <summary> Returns the bin of a feature in a row. </summary>
+        ///
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="rowIndex"> The row index. </param>
+        size_t GetBin(size_t featureIndex, size_t rowIndex) const;
+
+        /// <summary> Calls a function with a pointer to the bins of a feature, which are either `uint8_t` or `uint16_t` values indexed by row. </summary>
+        ///
+        /// <typeparam name="FunctionType"> The function type, which must accept both pointer types. </typeparam>
+        /// <param name="featureIndex"> The feature index. </param>
+        /// <param name="function"> The function. </param>
+        template <typename FunctionType>
+        void VisitColumn(size_t featureIndex, FunctionType&& function) const;
+
+    private:
+        std::vector<std::vector<double>> _thresholds;
+        std::vector<size_t> _binOffsets = { 0 };
+        size_t _numRows = 0;
+
+        // only one of these is used, depending on the number of bins
+        std::vector<uint8_t> _smallBins;
+        std::vector<uint16_t> _largeBins;
+    };
+}
+}
+
+#include "../tcc/BinnedFeatureStore.tcc"
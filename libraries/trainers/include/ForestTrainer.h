@@ -21,9 +21,12 @@
 #include "OutputStreamImpostor.h"
 
 // stl
+#include <algorithm>
+#include <future>
 #include <iostream> // For std::cout in VERBOSE_MODE
 #include <memory>
 #include <queue>
+#include <thread>
 
 namespace ell
 {
@@ -36,6 +39,7 @@ namespace trainers
         double minSplitGain = 0.0;
         size_t maxSplitsPerRound = 0;
         size_t numRounds = 0;
+        size_t numThreads = 1; // threads used to search for splits, 0 means one per hardware thread
     };
 
     /// <summary> Nontemplated base class for forest trainers, provides some reusable internal classes. </summary>
@@ -49,6 +53,7 @@ namespace trainers
             double sumWeightedLabels = 0;
 
             void Increment(const data::WeightLabel& weightLabel);
+            Sums operator+(const Sums& other) const;
             Sums operator-(const Sums& other) const;
             double GetMeanLabel() const;
             void Print(std::ostream& os) const;
@@ -88,6 +93,9 @@ namespace trainers
 
             // the output of the forest on this example
             double currentOutput = 0;
+
+            // the position of this example in the dataset given to SetDataset, which doesn't change when the examples are rearranged
+            size_t rowIndex = 0;
         };
 
         // keeps statistics about tree nodes
@@ -183,6 +191,10 @@ namespace trainers
         // after performing a split, we rearrange the data set to ensure that each node's examples occupy contiguous rows in the dataset
         void SortNodeDataset(Range range, const SplitRuleType& splitRule);
 
+        // calls function(index) for each index in [0, count), dividing the indices into contiguous blocks that run on separate threads
+        template <typename FunctionType>
+        void ParallelFor(size_t count, FunctionType function) const;
+
         //
         // implementation specific functions that must be implemented by a derived class
         //
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "BinnedFeatureStore.h"
 #include "ForestTrainer.h"
 #include "LogitBooster.h"
 
@@ -16,8 +17,9 @@
 #include "SingleElementThresholdPredictor.h"
 
 // stl
+#include <map>
 #include <random>
-#include <tuple>
+#include <utility>
 
 namespace ell
 {
@@ -31,7 +33,13 @@ namespace trainers
         size_t candidatesPerInput;
     };
 
-    /// <summary> A histogram trainer for binary decision forests with threshold split rules and constant outputs. </summary>
+    /// <summary>
+    /// A histogram trainer for binary decision forests with threshold split rules and constant outputs. When the
+    /// dataset is set, the threshold finder is run on a sample of the examples, and its thresholds (at most
+    /// `candidatesPerInput` per feature) are used to quantize the whole dataset into a `BinnedFeatureStore`. Splits
+    /// are then found by scanning per-node histograms of the weak weights and labels over those bins. The histogram
+    /// of the larger child of a split is computed by subtracting the smaller child's histogram from the parent's.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> The loss function type. </typeparam>
     /// <typeparam name="BoosterType"> The booster type. </typeparam>
@@ -56,21 +64,37 @@ namespace trainers
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Range;
         using typename ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::Sums;
 
+        /// <summary> Sets the trainer's dataset, and quantizes its features. </summary>
+        ///
+        /// <param name="anyDataset"> A dataset. </param>
+        void SetDataset(const data::AnyDataset& anyDataset) override;
+
     protected:
         using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_dataset;
+        using ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::_parameters;
         SplitCandidate GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) override;
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
-    private:
-        struct EvaluateSplitRuleResult
+        // the examples of a node whose feature values fall in a given bin
+        struct HistogramBin
         {
-            Sums sums0;
-            size_t size0;
+            Sums sums;
+            size_t count = 0;
         };
 
+        // the bins of all the features, laid out as in the feature store
+        using Histogram = std::vector<HistogramBin>;
+
+        Histogram GetNodeHistogram(Range range);
+        Histogram BuildHistogram(Range range) const;
+
+        // the histograms of nodes that may still be split, keyed by the first index and size of their range
+        std::map<std::pair<size_t, size_t>, Histogram> _nodeHistograms;
+
+    private:
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
-        std::vector<SplitRuleType> CallThresholdFinder(Range range);
-        std::tuple<Sums, size_t> EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const;
+        std::vector<std::vector<double>> CallThresholdFinder();
+        static void SubtractHistogram(Histogram& histogram, const Histogram& other);
 
         // member variables
         LossFunctionType _lossFunction;
@@ -78,6 +102,9 @@ namespace trainers
         std::default_random_engine _random;
         size_t _thresholdFinderSampleSize;
         size_t _candidatesPerInput;
+
+        // the quantized features, indexed by the examples' original row index
+        BinnedFeatureStore _featureStore;
     };
 
     /// <summary> Makes a simple forest trainer. </summary>
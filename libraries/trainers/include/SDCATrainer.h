@@ -35,6 +35,7 @@ namespace trainers
         size_t maxEpochs;
         bool permute;
         std::string randomSeedString;
+        size_t numThreads = 1;
     };
 
     /// <summary> Information about the result of an SDCA training session. </summary>
@@ -45,7 +46,13 @@ namespace trainers
         size_t numEpochsPerformed = 0;
     };
 
-    /// <summary> Implements the stochastic dual coordinate ascent linear trainer. </summary>
+    /// <summary>
+    /// Implements the stochastic dual coordinate ascent linear trainer. When the parameters ask for more than one thread
+    /// (zero means one per hardware thread), each epoch splits the dataset into shards and solves a local subproblem on
+    /// each shard concurrently, as in CoCoA+: every shard takes dual steps against its own copy of the model, with the
+    /// quadratic term of the dual scaled by the number of shards, and the shards' updates are added together at the
+    /// end of the epoch. The scaling keeps the combined update a dual ascent step, so the duality gap still converges.
+    /// </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="RegularizerType"> Regularizer type. </typeparam>
@@ -93,12 +100,31 @@ namespace trainers
             double dualVariable = 0;
         };
 
+        // the state of one shard during a parallel epoch
+        struct ShardState
+        {
+            // the model that the shard's dual steps are taken against, computed from v and d
+            predictors::LinearPredictor<double> predictor;
+            math::ColumnVector<double> v;
+            double d;
+
+            // the shard's contribution to the shared v and d
+            math::ColumnVector<double> deltaV;
+            double deltaD = 0;
+        };
+
         using DataVectorType = typename predictors::LinearPredictor<double>::DataVectorType;
         using TrainerExampleType = data::Example<DataVectorType, TrainerMetadata>;
 
         void Step(TrainerExampleType& x);
-        void ComputeObjectives();
+        void ShardStep(TrainerExampleType& x, ShardState& shard, size_t numShards);
+        void ParallelEpoch(size_t numShards);
+        void ComputeObjectives(size_t numShards);
         void ResizeTo(const data::AutoDataVector& x);
+        size_t GetNumShards() const;
+
+        template <typename FunctionType>
+        void ForEachShard(size_t numShards, FunctionType function);
 
         LossFunctionType _lossFunction;
         RegularizerType _regularizer;
@@ -19,6 +19,7 @@
 
 // stl
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <random>
 #include <string>
@@ -32,6 +33,13 @@ namespace trainers
     {
         double regularization;
         std::string randomSeedString;
+
+        /// <summary>
+        /// The number of threads that share each epoch, or zero to use one per hardware thread. The
+        /// sparse trainers update their shared state without locks (Hogwild), which is effective when
+        /// examples rarely share features; the other trainers always run serially.
+        /// </summary>
+        size_t numThreads = 1;
     };
 
     /// <summary>
@@ -58,14 +66,24 @@ namespace trainers
 
     protected:
         // Instances of the base class cannot be created directly
-        SGDTrainerBase(std::string randomSeedString);
+        SGDTrainerBase(std::string randomSeedString, size_t numThreads = 1);
         virtual void DoFirstStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual void DoNextStep(const data::AutoDataVector& x, double y, double weight) = 0;
         virtual const PredictorType& GetAveragedPredictor() const = 0;
 
+        // performs the steps for the examples from `fromIndex` to the end of the dataset, on several threads if the
+        // derived class supports it (the default implementation calls DoNextStep serially)
+        virtual void DoParallelSteps(size_t fromIndex, size_t numThreads);
+
+        // calls `shardFunction(shardIndex, numShards)` on its own thread for each of up to `numThreads` shards of the examples
+        // from `fromIndex` to the end of the dataset. Shard `i` holds every `numShards`-th example, starting at `fromIndex + i`,
+        // so that all of the threads progress through the epoch together
+        void ForEachShard(size_t fromIndex, size_t numThreads, std::function<void(size_t, size_t)> shardFunction) const;
+
         data::AutoSupervisedDataset _dataset;
         std::default_random_engine _random;
         bool _firstIteration = true;
+        size_t _numThreads;
     };
 
     //
@@ -144,6 +162,7 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoParallelSteps(size_t fromIndex, size_t numThreads) override;
 
     private:
         LossFunctionType _lossFunction;
@@ -197,6 +216,7 @@ namespace trainers
     protected:
         void DoFirstStep(const data::AutoDataVector& x, double y, double weight) override;
         void DoNextStep(const data::AutoDataVector& x, double y, double weight) override;
+        void DoParallelSteps(size_t fromIndex, size_t numThreads) override;
 
     private:
         LossFunctionType _lossFunction;
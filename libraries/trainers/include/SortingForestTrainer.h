@@ -25,7 +25,8 @@ namespace trainers
     };
 
     /// <summary> A trainer for binary decision forests with threshold split rules and constant outputs
-    /// that operates by sorting the data set by each feature. </summary>
+    /// that operates by sorting the data set by each feature. Features are searched in parallel when
+    /// the parameters specify more than one thread. </summary>
     ///
     /// <typeparam name="LossFunctionType"> Loss function type. </typeparam>
     /// <typeparam name="BoosterType"> Booster type. </typeparam>
@@ -58,7 +59,7 @@ namespace trainers
         std::vector<EdgePredictorType> GetEdgePredictors(const NodeStats& nodeStats) override;
 
     private:
-        void SortNodeDataset(Range range, size_t featureIndex);
+        SplitCandidate GetBestSplitRuleForFeature(SplittableNodeId nodeId, Range range, Sums sums, size_t inputIndex) const;
         double CalculateGain(const Sums& sums, const Sums& sums0, const Sums& sums1) const;
 
         // member variables
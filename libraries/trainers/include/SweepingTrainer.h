@@ -28,7 +28,10 @@ namespace ell
 {
 namespace trainers
 {
-    /// <summary> A class that runs multiple internal trainers and chooses the best performing predictor. </summary>
+    /// <summary>
+    /// A class that runs multiple internal trainers and chooses the best performing predictor. The internal trainers
+    /// are independent of each other, so each update runs them concurrently on a fixed number of worker threads.
+    /// </summary>
     ///
     /// <typeparam name="PredictorType"> The type of predictor returned by this trainer. </typeparam>
     template <typename PredictorType>
@@ -41,7 +44,8 @@ namespace trainers
         /// <summary> Constructs an instance of SweepingTrainer. </summary>
         ///
         /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
-        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers);
+        /// <param name="numThreads"> The number of internal trainers to update at once, or zero to use one per hardware thread. Defaults to one. </param>
+        SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads = 1);
 
         /// <summary> Sets the trainer's dataset. </summary>
         ///
@@ -57,18 +61,19 @@ namespace trainers
         const PredictorType& GetPredictor() const override;
 
     private:
-        data::Dataset<ExampleType> _dataset;
         std::vector<EvaluatingTrainerType> _evaluatingTrainers;
+        size_t _numThreads;
     };
 
     /// <summary> Makes an incremental trainer that runs multiple internal trainers and chooses the best performing predictor. </summary>
     ///
     /// <typeparam name="PredictorType"> Type of the predictor returned by this trainer. </typeparam>
     /// <param name="evaluatingTrainers"> A vector of evaluating trainers. </param>
+    /// <param name="numThreads"> The number of internal trainers to update at once, or zero to use one per hardware thread. Defaults to one. </param>
     ///
     /// <returns> A unique_ptr to a sweeping trainer. </returns>
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers);
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads = 1);
 }
 }
 
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedFeatureStore.cpp (trainers)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BinnedFeatureStore.h"
+
+// utilities
+#include "Exception.h"
+
+// stl
+#include <algorithm>
+#include <limits>
+
+namespace ell
+{
+namespace trainers
+{
+    BinnedFeatureStore::BinnedFeatureStore(std::vector<std::vector<double>> thresholds, size_t numRows)
+        : _thresholds(std::move(thresholds)), _numRows(numRows)
+    {
+        size_t maxNumBins = 1;
+        for (size_t featureIndex = 0; featureIndex < _thresholds.size(); ++featureIndex)
+        {
+            const auto& featureThresholds = _thresholds[featureIndex];
+            if (!std::is_sorted(featureThresholds.begin(), featureThresholds.end()))
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Bin thresholds must be sorted");
+            }
+
+            maxNumBins = std::max(maxNumBins, NumBins(featureIndex));
+            _binOffsets.push_back(_binOffsets.back() + NumBins(featureIndex));
+        }
+
+        auto numValues = _thresholds.size() * _numRows;
+        if (maxNumBins <= static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1)
+        {
+            _smallBins.resize(numValues);
+        }
+        else if (maxNumBins <= static_cast<size_t>(std::numeric_limits<uint16_t>::max()) + 1)
+        {
+            _largeBins.resize(numValues);
+        }
+        else
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Too many bins for a feature");
+        }
+    }
+
+    size_t BinnedFeatureStore::GetBinForValue(size_t featureIndex, double value) const
+    {
+        const auto& featureThresholds = _thresholds[featureIndex];
+        return std::lower_bound(featureThresholds.begin(), featureThresholds.end(), value) - featureThresholds.begin();
+    }
+
+    void BinnedFeatureStore::SetValue(size_t featureIndex, size_t rowIndex, double value)
+    {
+        auto bin = GetBinForValue(featureIndex, value);
+        auto index = featureIndex * _numRows + rowIndex;
+        if (_largeBins.empty())
+        {
+            _smallBins[index] = static_cast<uint8_t>(bin);
+        }
+        else
+        {
+            _largeBins[index] = static_cast<uint16_t>(bin);
+        }
+    }
+
+    size_t BinnedFeatureStore::GetBin(size_t featureIndex, size_t rowIndex) const
+    {
+        auto index = featureIndex * _numRows + rowIndex;
+        return _largeBins.empty() ? _smallBins[index] : _largeBins[index];
+    }
+}
+}
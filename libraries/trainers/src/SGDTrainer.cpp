@@ -8,6 +8,12 @@
 
 #include "SGDTrainer.h"
 
+// stl
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace ell
 {
 namespace trainers
@@ -27,6 +33,7 @@ namespace trainers
         auto exampleIterator = _dataset.GetExampleReferenceIterator();
 
         // first iteration handled separately
+        size_t fromIndex = 0;
         if (_firstIteration && exampleIterator.IsValid())
         {
             const auto& example = exampleIterator.Get();
@@ -39,6 +46,14 @@ namespace trainers
 
             exampleIterator.Next();
             _firstIteration = false;
+            fromIndex = 1;
+        }
+
+        auto numThreads = _numThreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : _numThreads;
+        if (numThreads > 1 && fromIndex < _dataset.NumExamples())
+        {
+            DoParallelSteps(fromIndex, numThreads);
+            return;
         }
 
         while (exampleIterator.IsValid())
@@ -56,7 +71,35 @@ namespace trainers
         }
     }
 
-    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString)
+    void SGDTrainerBase::DoParallelSteps(size_t fromIndex, size_t /*numThreads*/)
+    {
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
+        {
+            const auto& example = _dataset.GetExample(index);
+            DoNextStep(example.GetDataVector(), example.GetMetadata().label, example.GetMetadata().weight);
+        }
+    }
+
+    void SGDTrainerBase::ForEachShard(size_t fromIndex, size_t numThreads, std::function<void(size_t, size_t)> shardFunction) const
+    {
+        auto numShards = std::max(std::min(numThreads, _dataset.NumExamples() - fromIndex), size_t{ 1 });
+
+        std::vector<std::future<void>> tasks;
+        for (size_t shardIndex = 1; shardIndex < numShards; ++shardIndex)
+        {
+            tasks.emplace_back(std::async(std::launch::async, shardFunction, shardIndex, numShards));
+        }
+        shardFunction(0, numShards);
+
+        // wait for all the tasks, rethrowing any exception they threw
+        for (auto& task : tasks)
+        {
+            task.get();
+        }
+    }
+
+    SGDTrainerBase::SGDTrainerBase(std::string randomSeedString, size_t numThreads)
+        : _numThreads(numThreads)
     {
         std::seed_seq seed(randomSeedString.begin(), randomSeedString.end());
         _random = std::default_random_engine(seed);
@@ -0,0 +1,26 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     BinnedFeatureStore.tcc (trainers)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace ell
+{
+namespace trainers
+{
+    template <typename FunctionType>
+    void BinnedFeatureStore::VisitColumn(size_t featureIndex, FunctionType&& function) const
+    {
+        if (_largeBins.empty())
+        {
+            function(_smallBins.data() + featureIndex * _numRows);
+        }
+        else
+        {
+            function(_largeBins.data() + featureIndex * _numRows);
+        }
+    }
+}
+}
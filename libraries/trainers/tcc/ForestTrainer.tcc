@@ -33,6 +33,7 @@ namespace trainers
             auto& metadata = example.GetMetadata();
             metadata.currentOutput = prediction;
             metadata.weak = _booster.GetWeakWeightLabel(metadata.strong, prediction);
+            metadata.rowIndex = rowIndex;
         }
     }
 
@@ -58,7 +59,7 @@ namespace trainers
             auto rootSplit = GetBestSplitRuleAtNode(_forest.GetNewRootId(), Range{ 0, _dataset.NumExamples() }, sums);
 
             // check for positive gain
-            if (rootSplit.gain < _parameters.minSplitGain || _parameters.maxSplitsPerRound == 0)
+            if (rootSplit.gain <= _parameters.minSplitGain || _parameters.maxSplitsPerRound == 0)
             {
                 return;
             }
@@ -193,6 +194,50 @@ namespace trainers
         }
     }
 
+    template <typename SplitRuleType, typename EdgePredictorType, typename BoosterType>
+    template <typename FunctionType>
+    void ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::ParallelFor(size_t count, FunctionType function) const
+    {
+        size_t numThreads = _parameters.numThreads;
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        numThreads = std::min(numThreads, count);
+
+        if (numThreads <= 1)
+        {
+            for (size_t index = 0; index < count; ++index)
+            {
+                function(index);
+            }
+            return;
+        }
+
+        // each task handles a contiguous block of indices, so the work done for each index doesn't depend on the number of threads
+        auto blockSize = (count + numThreads - 1) / numThreads;
+        auto runBlock = [&function, blockSize, count](size_t blockIndex) {
+            auto end = std::min(count, (blockIndex + 1) * blockSize);
+            for (size_t index = blockIndex * blockSize; index < end; ++index)
+            {
+                function(index);
+            }
+        };
+
+        std::vector<std::future<void>> tasks;
+        for (size_t blockIndex = 1; blockIndex < numThreads; ++blockIndex)
+        {
+            tasks.emplace_back(std::async(std::launch::async, runBlock, blockIndex));
+        }
+        runBlock(0);
+
+        // wait for all the tasks, rethrowing any exception they threw
+        for (auto& task : tasks)
+        {
+            task.get();
+        }
+    }
+
     //
     // debugging code
     //
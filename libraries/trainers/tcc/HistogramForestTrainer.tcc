@@ -9,6 +9,9 @@
 // utilities
 #include "RandomEngines.h"
 
+// stl
+#include <algorithm>
+
 namespace ell
 {
 namespace trainers
@@ -19,33 +22,96 @@ namespace trainers
     {
     }
 
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SetDataset(const data::AnyDataset& anyDataset)
+    {
+        ForestTrainer<SplitRuleType, EdgePredictorType, BoosterType>::SetDataset(anyDataset);
+        _nodeHistograms.clear();
+
+        // quantize the features of every example, once
+        _featureStore = BinnedFeatureStore(CallThresholdFinder(), _dataset.NumExamples());
+        for (size_t index = 0; index < _dataset.NumExamples(); ++index)
+        {
+            const auto& example = _dataset[index];
+            const auto& dataVector = example.GetDataVector();
+            auto rowIndex = example.GetMetadata().rowIndex;
+            for (size_t featureIndex = 0; featureIndex < _featureStore.NumFeatures(); ++featureIndex)
+            {
+                _featureStore.SetValue(featureIndex, rowIndex, dataVector[featureIndex]);
+            }
+        }
+    }
+
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetBestSplitRuleAtNode(SplittableNodeId nodeId, Range range, Sums sums) -> SplitCandidate
     {
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
 
-        auto splitRuleCandidates = CallThresholdFinder(range);
+        auto histogram = GetNodeHistogram(range);
 
-        for (const auto& splitRuleCandidate : splitRuleCandidates)
+        // the best threshold of each feature
+        struct FeatureSplit
         {
-            Sums sums0;
-            size_t size0;
+            double gain = 0;
+            size_t binIndex = 0;
+            HistogramBin bin0;
+        };
 
-            std::tie(sums0, size0) = EvaluateSplitRule(splitRuleCandidate, range);
+        // scan the bins of each feature in parallel, then pick the gain maximizer in feature order so that the result doesn't depend on the number of threads
+        auto numFeatures = _featureStore.NumFeatures();
+        std::vector<FeatureSplit> featureSplits(numFeatures);
+        this->ParallelFor(numFeatures, [&](size_t featureIndex) {
+            auto& featureSplit = featureSplits[featureIndex];
+            auto featureBins = histogram.data() + _featureStore.GetBinOffset(featureIndex);
+
+            // bins [0, binIndex] go to child 0
+            HistogramBin bin0;
+            for (size_t binIndex = 0; binIndex + 1 < _featureStore.NumBins(featureIndex); ++binIndex)
+            {
+                bin0.sums = bin0.sums + featureBins[binIndex].sums;
+                bin0.count += featureBins[binIndex].count;
+                if (bin0.count == 0 || bin0.count == range.size)
+                {
+                    continue;
+                }
 
-            Sums sums1 = sums - sums0;
-            double gain = CalculateGain(sums, sums0, sums1);
+                double gain = CalculateGain(sums, bin0.sums, sums - bin0.sums);
+                if (gain > featureSplit.gain)
+                {
+                    featureSplit.gain = gain;
+                    featureSplit.binIndex = binIndex;
+                    featureSplit.bin0 = bin0;
+                }
+            }
+        });
+
+        size_t bestSize0 = 0;
+        for (size_t featureIndex = 0; featureIndex < numFeatures; ++featureIndex)
+        {
+            const auto& featureSplit = featureSplits[featureIndex];
 
             // find gain maximizer
-            if (gain > bestSplitCandidate.gain)
+            if (featureSplit.gain > bestSplitCandidate.gain)
             {
-                bestSplitCandidate.gain = gain;
-                bestSplitCandidate.splitRule = splitRuleCandidate;
-                bestSplitCandidate.ranges.SplitChildRange(0, size0);
-                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                bestSplitCandidate.gain = featureSplit.gain;
+                bestSplitCandidate.splitRule = SplitRuleType{ featureIndex, _featureStore.GetThreshold(featureIndex, featureSplit.binIndex) };
+                bestSplitCandidate.stats.SetChildSums({ featureSplit.bin0.sums, sums - featureSplit.bin0.sums });
+                bestSize0 = featureSplit.bin0.count;
             }
         }
 
+        // the child ranges can only be split once, so do it after the gain maximizer has been found
+        if (bestSize0 > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+        }
+
+        // keep the histogram if this node may be split, so that its children's histograms can be computed by subtraction
+        if (bestSplitCandidate.gain > _parameters.minSplitGain)
+        {
+            _nodeHistograms[{ range.firstIndex, range.size }] = std::move(histogram);
+        }
+
         return bestSplitCandidate;
     }
 
@@ -72,36 +138,129 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::CallThresholdFinder(Range range) -> std::vector<SplitRuleType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::CallThresholdFinder() -> std::vector<std::vector<double>>
     {
-        // uniformly choose _candidatesPerInput from the range, without replacement
-        _dataset.RandomPermute(_random, range.firstIndex, range.size, _thresholdFinderSampleSize);
+        // uniformly choose _thresholdFinderSampleSize examples from the dataset, without replacement
+        _dataset.RandomPermute(_random, _thresholdFinderSampleSize);
+        auto splitRules = _thresholdFinder.GetThresholds(_dataset.GetExampleReferenceIterator(0, _thresholdFinderSampleSize));
+
+        std::vector<std::vector<double>> thresholds(_dataset.NumFeatures());
+        for (const auto& splitRule : splitRules)
+        {
+            thresholds[splitRule.GetElementIndex()].push_back(splitRule.GetThreshold());
+        }
+
+        for (auto& featureThresholds : thresholds)
+        {
+            std::sort(featureThresholds.begin(), featureThresholds.end());
+            featureThresholds.erase(std::unique(featureThresholds.begin(), featureThresholds.end()), featureThresholds.end());
+
+            // keep at most _candidatesPerInput thresholds, evenly spaced in the sorted list
+            auto numThresholds = featureThresholds.size();
+            if (_candidatesPerInput > 0 && numThresholds > _candidatesPerInput)
+            {
+                std::vector<double> selectedThresholds;
+                for (size_t index = 0; index < _candidatesPerInput; ++index)
+                {
+                    selectedThresholds.push_back(featureThresholds[(2 * index + 1) * numThresholds / (2 * _candidatesPerInput)]);
+                }
+                featureThresholds = std::move(selectedThresholds);
+            }
+        }
 
-        auto thresholds = _thresholdFinder.GetThresholds(_dataset.GetExampleReferenceIterator(range.firstIndex, _thresholdFinderSampleSize));
         return thresholds;
     }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
-    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::EvaluateSplitRule(const SplitRuleType& splitRule, const Range& range) const -> std::tuple<Sums, size_t>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::GetNodeHistogram(Range range) -> Histogram
     {
-        Sums sums0;
-        size_t size0 = 0;
+        // each boosting round starts over at the root
+        if (range.firstIndex == 0 && range.size == _dataset.NumExamples())
+        {
+            _nodeHistograms.clear();
+            return BuildHistogram(range);
+        }
 
-        auto exampleIterator = _dataset.GetExampleIterator(range.firstIndex, range.size);
-        while (exampleIterator.IsValid())
+        // the histogram may have been computed along with the node's sibling
+        auto iter = _nodeHistograms.find({ range.firstIndex, range.size });
+        if (iter != _nodeHistograms.end())
         {
-            const auto& example = exampleIterator.Get();
-            auto prediction = splitRule.Predict(example.GetDataVector());
-            if (prediction == 0)
-            {
-                sums0.Increment(example.GetMetadata().weak);
-                ++size0;
-            }
-            exampleIterator.Next();
+            auto histogram = std::move(iter->second);
+            _nodeHistograms.erase(iter);
+            return histogram;
+        }
+
+        // the stored node that starts where this one does and is larger must be its parent, and this node its first child
+        iter = _nodeHistograms.lower_bound({ range.firstIndex, range.size + 1 });
+        if (iter == _nodeHistograms.end() || iter->first.first != range.firstIndex)
+        {
+            return BuildHistogram(range);
         }
 
-        return std::make_tuple(sums0, size0);
-    };
+        auto parentHistogram = std::move(iter->second);
+        Range siblingRange{ range.firstIndex + range.size, iter->first.second - range.size };
+        _nodeHistograms.erase(iter);
+
+        // build the histogram of the smaller child, and get the larger child's by subtracting it from the parent's
+        if (range.size <= siblingRange.size)
+        {
+            auto histogram = BuildHistogram(range);
+            SubtractHistogram(parentHistogram, histogram);
+            _nodeHistograms[{ siblingRange.firstIndex, siblingRange.size }] = std::move(parentHistogram);
+            return histogram;
+        }
+
+        auto siblingHistogram = BuildHistogram(siblingRange);
+        SubtractHistogram(parentHistogram, siblingHistogram);
+        _nodeHistograms[{ siblingRange.firstIndex, siblingRange.size }] = std::move(siblingHistogram);
+        return parentHistogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    auto HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::BuildHistogram(Range range) const -> Histogram
+    {
+        // gather the row indices and weak weights and labels of the node's examples, in row order so that the feature columns are read sequentially
+        struct NodeRow
+        {
+            size_t rowIndex;
+            data::WeightLabel weak;
+        };
+
+        std::vector<NodeRow> rows;
+        rows.reserve(range.size);
+        for (size_t index = range.firstIndex; index < range.firstIndex + range.size; ++index)
+        {
+            const auto& metadata = _dataset[index].GetMetadata();
+            rows.push_back({ metadata.rowIndex, metadata.weak });
+        }
+        std::sort(rows.begin(), rows.end(), [](const NodeRow& a, const NodeRow& b) { return a.rowIndex < b.rowIndex; });
+
+        // accumulate the bins of each feature in parallel
+        Histogram histogram(_featureStore.NumBins());
+        this->ParallelFor(_featureStore.NumFeatures(), [&](size_t featureIndex) {
+            auto featureBins = histogram.data() + _featureStore.GetBinOffset(featureIndex);
+            _featureStore.VisitColumn(featureIndex, [&](const auto* column) {
+                for (const auto& row : rows)
+                {
+                    auto& bin = featureBins[column[row.rowIndex]];
+                    bin.sums.Increment(row.weak);
+                    ++bin.count;
+                }
+            });
+        });
+
+        return histogram;
+    }
+
+    template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
+    void HistogramForestTrainer<LossFunctionType, BoosterType, ThresholdFinderType>::SubtractHistogram(Histogram& histogram, const Histogram& other)
+    {
+        for (size_t binIndex = 0; binIndex < histogram.size(); ++binIndex)
+        {
+            histogram[binIndex].sums = histogram[binIndex].sums - other[binIndex].sums;
+            histogram[binIndex].count -= other[binIndex].count;
+        }
+    }
 
     template <typename LossFunctionType, typename BoosterType, typename ThresholdFinderType>
     std::unique_ptr<ITrainer<predictors::SimpleForestPredictor>> MakeHistogramForestTrainer(const LossFunctionType& lossFunction, const BoosterType& booster, const ThresholdFinderType& thresholdFinder, const HistogramForestTrainerParameters& parameters)
@@ -11,10 +11,22 @@
 // utilities
 #include "RandomEngines.h"
 
+// stl
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace ell
 {
 namespace trainers
 {
+    namespace detail
+    {
+        // shards smaller than this aren't worth a thread of their own
+        constexpr size_t minSDCAShardSize = 256;
+    }
+
     template<typename LossFunctionType, typename RegularizerType>
     SDCATrainer<LossFunctionType, RegularizerType>::SDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters)
     : _lossFunction(lossFunction), _regularizer(regularizer), _parameters(parameters)
@@ -53,14 +65,23 @@ namespace trainers
             _dataset.RandomPermute(_random);
         }
 
+        auto numShards = GetNumShards();
+
         // Iterate
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        if (numShards > 1)
         {
-            Step(_dataset[i]);
+            ParallelEpoch(numShards);
+        }
+        else
+        {
+            for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+            {
+                Step(_dataset[i]);
+            }
         }
 
         // Finish
-        ComputeObjectives();
+        ComputeObjectives(numShards);
     }
 
     template<typename LossFunctionType, typename RegularizerType>
@@ -96,22 +117,93 @@ namespace trainers
     }
 
     template<typename LossFunctionType, typename RegularizerType>
-    void SDCATrainer<LossFunctionType, RegularizerType>::ComputeObjectives()
+    void SDCATrainer<LossFunctionType, RegularizerType>::ShardStep(TrainerExampleType& example, ShardState& shard, size_t numShards)
+    {
+        const auto& dataVector = example.GetDataVector();
+
+        auto weightLabel = example.GetMetadata().weightLabel;
+        auto norm2Squared = example.GetMetadata().norm2Squared + 1; // add one because of bias term
+        auto lipschitz = numShards * norm2Squared * _inverseScaledRegularization;
+        auto dual = example.GetMetadata().dualVariable;
+
+        if (lipschitz > 0)
+        {
+            auto prediction = shard.predictor.Predict(dataVector);
+
+            auto newDual = _lossFunction.ConjugateProx(1.0 / lipschitz, dual + prediction / lipschitz, weightLabel.label);
+            auto dualDiff = newDual - dual;
+
+            if (dualDiff != 0)
+            {
+                auto scaledDiff = -dualDiff * _inverseScaledRegularization;
+                shard.deltaV.Transpose() += scaledDiff * dataVector;
+                shard.deltaD += scaledDiff;
+
+                // the local model sees its own updates scaled by the number of shards
+                shard.v.Transpose() += (numShards * scaledDiff) * dataVector;
+                shard.d += numShards * scaledDiff;
+                _regularizer.ConjugateGradient(shard.v, shard.d, shard.predictor.GetWeights(), shard.predictor.GetBias());
+                example.GetMetadata().dualVariable = newDual;
+            }
+        }
+    }
+
+    template<typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ParallelEpoch(size_t numShards)
+    {
+        // the shards can't resize the shared state, so make it large enough for every example up front
+        auto numFeatures = _dataset.NumFeatures();
+        if (numFeatures > _predictor.Size())
+        {
+            _predictor.Resize(numFeatures);
+            _v.Resize(numFeatures);
+        }
+
+        // each shard updates the dual variables of its own examples, and its own copy of the model
+        std::vector<ShardState> shards(numShards, ShardState{ _predictor, _v, _d, math::ColumnVector<double>(_v.Size()) });
+        ForEachShard(numShards, [this, &shards, numShards](size_t shardIndex, size_t fromIndex, size_t toIndex) {
+            for (size_t i = fromIndex; i < toIndex; ++i)
+            {
+                ShardStep(_dataset[i], shards[shardIndex], numShards);
+            }
+        });
+
+        // add the shards' updates to the shared state
+        for (const auto& shard : shards)
+        {
+            _v += shard.deltaV;
+            _d += shard.deltaD;
+        }
+        _regularizer.ConjugateGradient(_v, _d, _predictor.GetWeights(), _predictor.GetBias());
+    }
+
+    template<typename LossFunctionType, typename RegularizerType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ComputeObjectives(size_t numShards)
     {
         double invSize = 1.0 / _dataset.NumExamples();
 
+        // each shard sums the objectives over its own examples
+        std::vector<double> primalObjectives(numShards, 0.0);
+        std::vector<double> dualObjectives(numShards, 0.0);
+        ForEachShard(numShards, [this, &primalObjectives, &dualObjectives, invSize](size_t shardIndex, size_t fromIndex, size_t toIndex) {
+            for (size_t i = fromIndex; i < toIndex; ++i)
+            {
+                const auto& example = _dataset.GetExample(i);
+                auto label = example.GetMetadata().weightLabel.label;
+                auto prediction = _predictor.Predict(example.GetDataVector());
+                auto dualVariable = example.GetMetadata().dualVariable;
+
+                primalObjectives[shardIndex] += invSize * _lossFunction(prediction, label);
+                dualObjectives[shardIndex] -= invSize * _lossFunction.Conjugate(dualVariable, label);
+            }
+        });
+
         _predictorInfo.primalObjective = 0;
         _predictorInfo.dualObjective = 0;
-
-        for (size_t i = 0; i < _dataset.NumExamples(); ++i)
+        for (size_t shardIndex = 0; shardIndex < numShards; ++shardIndex)
         {
-            const auto& example = _dataset.GetExample(i);
-            auto label = example.GetMetadata().weightLabel.label;
-            auto prediction = _predictor.Predict(example.GetDataVector());
-            auto dualVariable = example.GetMetadata().dualVariable;
-
-            _predictorInfo.primalObjective += invSize * _lossFunction(prediction, label);
-            _predictorInfo.dualObjective -= invSize * _lossFunction.Conjugate(dualVariable, label);
+            _predictorInfo.primalObjective += primalObjectives[shardIndex];
+            _predictorInfo.dualObjective += dualObjectives[shardIndex];
         }
 
         _predictorInfo.primalObjective += _parameters.regularization * _regularizer(_predictor.GetWeights(), _predictor.GetBias());
@@ -129,6 +221,41 @@ namespace trainers
         }
     }
 
+    template<typename LossFunctionType, typename RegularizerType>
+    size_t SDCATrainer<LossFunctionType, RegularizerType>::GetNumShards() const
+    {
+        auto numThreads = _parameters.numThreads;
+        if (numThreads == 0)
+        {
+            numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return std::min(numThreads, std::max(_dataset.NumExamples() / detail::minSDCAShardSize, size_t{ 1 }));
+    }
+
+    template<typename LossFunctionType, typename RegularizerType>
+    template <typename FunctionType>
+    void SDCATrainer<LossFunctionType, RegularizerType>::ForEachShard(size_t numShards, FunctionType function)
+    {
+        // shard k is the contiguous range of examples [k * n / numShards, (k + 1) * n / numShards)
+        auto numExamples = _dataset.NumExamples();
+        auto runShard = [&function, numShards, numExamples](size_t shardIndex) {
+            function(shardIndex, shardIndex * numExamples / numShards, (shardIndex + 1) * numExamples / numShards);
+        };
+
+        // run the shards after the first on other threads, and the first one on this thread
+        std::vector<std::future<void>> tasks;
+        for (size_t shardIndex = 1; shardIndex < numShards; ++shardIndex)
+        {
+            tasks.emplace_back(std::async(std::launch::async, runShard, shardIndex));
+        }
+        runShard(0);
+
+        for (auto& task : tasks)
+        {
+            task.get();
+        }
+    }
+
     template <typename LossFunctionType, typename RegularizerType>
     std::unique_ptr<trainers::ITrainer<predictors::LinearPredictor<double>>> MakeSDCATrainer(const LossFunctionType& lossFunction, const RegularizerType& regularizer, const SDCATrainerParameters& parameters)
     {
@@ -7,7 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // stl
+#include <atomic>
 #include <cmath>
+#include <vector>
 
 // data
 #include "DataVector.h"
@@ -23,13 +25,27 @@ namespace trainers
 {
     // the code in this file follows the notation and pseudocode in https://arxiv.org/abs/1612.09147
 
+    namespace detail
+    {
+        // the number of steps after which a thread adds the changes it made to the shared scalars of a parallel epoch
+        const size_t sharedScalarUpdateInterval = 16;
+
+        inline void AtomicAdd(std::atomic<double>& target, double value)
+        {
+            auto current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
     //
     // SGDTrainer
     //
 
     template <typename LossFunctionType>
     SGDTrainer<LossFunctionType>::SGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
-        : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters)
+        : SGDTrainerBase(parameters.randomSeedString, parameters.numThreads), _lossFunction(lossFunction), _parameters(parameters)
     {
     }
 
@@ -94,7 +110,7 @@ namespace trainers
 
     template<typename LossFunctionType>
     SparseDataSGDTrainer<LossFunctionType>::SparseDataSGDTrainer(const LossFunctionType& lossFunction, const SGDTrainerParameters& parameters)
-        : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters)
+        : SGDTrainerBase(parameters.randomSeedString, parameters.numThreads), _lossFunction(lossFunction), _parameters(parameters)
     {
     }
 
@@ -132,6 +148,84 @@ namespace trainers
         _h += 1.0 / _t;
     }
 
+    template<typename LossFunctionType>
+    void SparseDataSGDTrainer<LossFunctionType>::DoParallelSteps(size_t fromIndex, size_t numThreads)
+    {
+        // the threads share _v and _u without locks, so they must be large enough for every example before the threads start
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
+        {
+            ResizeTo(_dataset.GetExample(index).GetDataVector());
+        }
+
+        // each example keeps the step number it would have in a serial epoch, so the averaged predictor can still be computed
+        // from _v, _u and the scalars. The bias gradient sum, which every step reads, is shared between the threads, and the
+        // other scalars are summed by each thread and combined at the end: _c is the sum of _a / t over steps, which equals
+        // _a * _h - b, where b is the sum of the bias gradients weighted by the harmonic number
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        const double h0 = _h;
+        std::atomic<double> sharedA(_a);
+        std::vector<double> shardB(numThreads, 0.0);
+
+        ForEachShard(fromIndex, numThreads, [&](size_t shardIndex, size_t numShards) {
+            // the harmonic number before the first step of the shard
+            double h = h0;
+            for (size_t offset = 1; offset <= shardIndex; ++offset)
+            {
+                h += 1.0 / (t0 + static_cast<double>(offset));
+            }
+
+            double a = 0; // changes to the bias gradient sum that this thread hasn't shared yet
+            double b = 0;
+            size_t numUnsharedSteps = 0;
+            for (size_t index = fromIndex + shardIndex; index < _dataset.NumExamples(); index += numShards)
+            {
+                const auto& example = _dataset.GetExample(index);
+                const auto& x = example.GetDataVector();
+                double t = t0 + static_cast<double>(index - fromIndex + 1);
+
+                // apply the predictor, with whatever updates the other threads have made so far
+                double d = x * _v;
+                double p = -(d + sharedA.load(std::memory_order_relaxed) + a) / (lambda * (t - 1.0));
+
+                // get the derivative
+                double g = example.GetMetadata().weight * _lossFunction.GetDerivative(p, example.GetMetadata().label);
+
+                // update
+                _v.Transpose() += g * x;
+                _u.Transpose() += h * g * x;
+                a += g;
+                b += h * g;
+                for (size_t offset = 0; offset < numShards; ++offset)
+                {
+                    h += 1.0 / (t + static_cast<double>(offset));
+                }
+
+                if (++numUnsharedSteps == detail::sharedScalarUpdateInterval)
+                {
+                    detail::AtomicAdd(sharedA, a);
+                    a = 0;
+                    numUnsharedSteps = 0;
+                }
+            }
+            detail::AtomicAdd(sharedA, a);
+            shardB[shardIndex] = b;
+        });
+
+        double b = _a * _h - _c;
+        for (size_t shardIndex = 0; shardIndex < numThreads; ++shardIndex)
+        {
+            b += shardB[shardIndex];
+        }
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
+        {
+            ++_t;
+            _h += 1.0 / _t;
+        }
+        _a = sharedA.load();
+        _c = _a * _h - b;
+    }
+
     template<typename LossFunctionType>
     auto SparseDataSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -179,7 +273,7 @@ namespace trainers
 
     template<typename LossFunctionType>
     SparseDataCenteredSGDTrainer<LossFunctionType>::SparseDataCenteredSGDTrainer(const LossFunctionType& lossFunction, math::RowVector<double> center, const SGDTrainerParameters& parameters)
-        : SGDTrainerBase(parameters.randomSeedString), _lossFunction(lossFunction), _parameters(parameters), _center(std::move(center))
+        : SGDTrainerBase(parameters.randomSeedString, parameters.numThreads), _lossFunction(lossFunction), _parameters(parameters), _center(std::move(center))
     {
         _theta = 1 + _center.Norm2Squared();
     }
@@ -232,6 +326,101 @@ namespace trainers
         _s += _r / _t;
     }
 
+    template<typename LossFunctionType>
+    void SparseDataCenteredSGDTrainer<LossFunctionType>::DoParallelSteps(size_t fromIndex, size_t numThreads)
+    {
+        // the threads share _v and _u without locks, so they must be large enough for every example before the threads start
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
+        {
+            ResizeTo(_dataset.GetExample(index).GetDataVector());
+        }
+
+        // as in SparseDataSGDTrainer::DoParallelSteps, the scalars that every step reads (_a and _z) are shared between the
+        // threads, and the others are combined at the end. In addition, _s is the sum of _r / t over steps, which equals
+        // _theta * _c - (_z * _h - e), where e is the sum of the centering terms g * q weighted by the harmonic number
+        const double lambda = _parameters.regularization;
+        const double t0 = _t;
+        const double h0 = _h;
+        std::atomic<double> sharedA(_a);
+        std::atomic<double> sharedZ(_z);
+        std::vector<double> shardB(numThreads, 0.0);
+        std::vector<double> shardE(numThreads, 0.0);
+
+        ForEachShard(fromIndex, numThreads, [&](size_t shardIndex, size_t numShards) {
+            // the harmonic number before the first step of the shard
+            double h = h0;
+            for (size_t offset = 1; offset <= shardIndex; ++offset)
+            {
+                h += 1.0 / (t0 + static_cast<double>(offset));
+            }
+
+            double a = 0; // changes to _a and _z that this thread hasn't shared yet
+            double z = 0;
+            double b = 0;
+            double e = 0;
+            size_t numUnsharedSteps = 0;
+            for (size_t index = fromIndex + shardIndex; index < _dataset.NumExamples(); index += numShards)
+            {
+                const auto& example = _dataset.GetExample(index);
+                const auto& x = example.GetDataVector();
+                double t = t0 + static_cast<double>(index - fromIndex + 1);
+
+                // apply the predictor, with whatever updates the other threads have made so far
+                double d = x * _v;
+                double q = x * _center.Transpose();
+                double currentA = sharedA.load(std::memory_order_relaxed) + a;
+                double r = currentA * _theta - (sharedZ.load(std::memory_order_relaxed) + z);
+                double p = -(d + r - currentA * q) / (lambda * (t - 1.0));
+
+                // get the derivative
+                double g = example.GetMetadata().weight * _lossFunction.GetDerivative(p, example.GetMetadata().label);
+
+                // update
+                _v.Transpose() += g * x;
+                _u.Transpose() += h * g * x;
+                a += g;
+                z += g * q;
+                b += h * g;
+                e += h * g * q;
+                for (size_t offset = 0; offset < numShards; ++offset)
+                {
+                    h += 1.0 / (t + static_cast<double>(offset));
+                }
+
+                if (++numUnsharedSteps == detail::sharedScalarUpdateInterval)
+                {
+                    detail::AtomicAdd(sharedA, a);
+                    detail::AtomicAdd(sharedZ, z);
+                    a = 0;
+                    z = 0;
+                    numUnsharedSteps = 0;
+                }
+            }
+            detail::AtomicAdd(sharedA, a);
+            detail::AtomicAdd(sharedZ, z);
+            shardB[shardIndex] = b;
+            shardE[shardIndex] = e;
+        });
+
+        double b = _a * _h - _c;
+        double e = _z * _h - (_theta * _c - _s);
+        for (size_t shardIndex = 0; shardIndex < numThreads; ++shardIndex)
+        {
+            b += shardB[shardIndex];
+            e += shardE[shardIndex];
+        }
+        for (size_t index = fromIndex; index < _dataset.NumExamples(); ++index)
+        {
+            ++_t;
+            _h += 1.0 / _t;
+        }
+        _a = sharedA.load();
+        _z = sharedZ.load();
+        _c = _a * _h - b;
+        _r = _a * _theta - _z;
+        _s = _theta * _c - (_z * _h - e);
+    }
+
     template<typename LossFunctionType>
     auto SparseDataCenteredSGDTrainer<LossFunctionType>::GetLastPredictor() const -> const PredictorType&
     {
@@ -6,6 +6,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// stl
+#include <algorithm>
+#include <utility>
+
 namespace ell
 {
 namespace trainers
@@ -23,42 +27,18 @@ namespace trainers
 
         SplitCandidate bestSplitCandidate(nodeId, range, sums);
 
-        for (size_t inputIndex = 0; inputIndex < numFeatures; ++inputIndex)
-        {
-            // sort the relevant rows of data set in ascending order by inputIndex
-            SortNodeDataset(range, inputIndex);
-
-            Sums sums0;
+        // search each feature independently, in parallel
+        std::vector<SplitCandidate> featureSplitCandidates(numFeatures, bestSplitCandidate);
+        this->ParallelFor(numFeatures, [&](size_t inputIndex) {
+            featureSplitCandidates[inputIndex] = GetBestSplitRuleForFeature(nodeId, range, sums, inputIndex);
+        });
 
-            // consider all thresholds
-            double nextFeatureValue = _dataset[range.firstIndex].GetDataVector()[inputIndex];
-            for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size - 1; ++rowIndex)
+        // find gain maximizer, in feature order so that the result doesn't depend on the number of threads
+        for (const auto& featureSplitCandidate : featureSplitCandidates)
+        {
+            if (featureSplitCandidate.gain > bestSplitCandidate.gain)
             {
-                // get friendly names
-                double currentFeatureValue = nextFeatureValue;
-                nextFeatureValue = _dataset[rowIndex + 1].GetDataVector()[inputIndex];
-
-                // increment sums
-                sums0.Increment(_dataset[rowIndex].GetMetadata().weak);
-
-                // only split between rows with different feature values
-                if (currentFeatureValue == nextFeatureValue)
-                {
-                    continue;
-                }
-
-                // compute sums1 and gain
-                auto sums1 = sums - sums0;
-                double gain = CalculateGain(sums, sums0, sums1);
-
-                // find gain maximizer
-                if (gain > bestSplitCandidate.gain)
-                {
-                    bestSplitCandidate.gain = gain;
-                    bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
-                    bestSplitCandidate.ranges.SplitChildRange(0, rowIndex - range.firstIndex + 1);
-                    bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
-                }
+                bestSplitCandidate = featureSplitCandidate;
             }
         }
         return bestSplitCandidate;
@@ -74,11 +54,59 @@ namespace trainers
     }
 
     template <typename LossFunctionType, typename BoosterType>
-    void SortingForestTrainer<LossFunctionType, BoosterType>::SortNodeDataset(Range range, size_t inputIndex)
+    auto SortingForestTrainer<LossFunctionType, BoosterType>::GetBestSplitRuleForFeature(SplittableNodeId nodeId, Range range, Sums sums, size_t inputIndex) const -> SplitCandidate
     {
-        _dataset.Sort([inputIndex](const data::Example<DataVectorType, TrainerMetadata>& example) { return example.GetDataVector()[inputIndex]; },
-                      range.firstIndex,
-                      range.size);
+        SplitCandidate bestSplitCandidate(nodeId, range, sums);
+
+        // sort the relevant rows of data set in ascending order by inputIndex. The dataset itself is shared by all the
+        // features being searched, so sort (value, row) pairs instead; ties are broken by row, which keeps the order deterministic
+        std::vector<std::pair<double, size_t>> sortedRows;
+        sortedRows.reserve(range.size);
+        for (size_t rowIndex = range.firstIndex; rowIndex < range.firstIndex + range.size; ++rowIndex)
+        {
+            sortedRows.emplace_back(_dataset[rowIndex].GetDataVector()[inputIndex], rowIndex);
+        }
+        std::sort(sortedRows.begin(), sortedRows.end());
+
+        Sums sums0;
+        size_t bestSize0 = 0;
+
+        // consider all thresholds
+        for (size_t position = 0; position + 1 < sortedRows.size(); ++position)
+        {
+            // get friendly names
+            double currentFeatureValue = sortedRows[position].first;
+            double nextFeatureValue = sortedRows[position + 1].first;
+
+            // increment sums
+            sums0.Increment(_dataset[sortedRows[position].second].GetMetadata().weak);
+
+            // only split between rows with different feature values
+            if (currentFeatureValue == nextFeatureValue)
+            {
+                continue;
+            }
+
+            // compute sums1 and gain
+            auto sums1 = sums - sums0;
+            double gain = CalculateGain(sums, sums0, sums1);
+
+            // find gain maximizer
+            if (gain > bestSplitCandidate.gain)
+            {
+                bestSplitCandidate.gain = gain;
+                bestSplitCandidate.splitRule = SplitRuleType{ inputIndex, 0.5 * (currentFeatureValue + nextFeatureValue) };
+                bestSplitCandidate.stats.SetChildSums({ sums0, sums1 });
+                bestSize0 = position + 1;
+            }
+        }
+
+        // the child ranges can only be split once, so do it after the gain maximizer has been found
+        if (bestSize0 > 0)
+        {
+            bestSplitCandidate.ranges.SplitChildRange(0, bestSize0);
+        }
+        return bestSplitCandidate;
     }
 
     template <typename LossFunctionType, typename BoosterType>
@@ -6,29 +6,61 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// stl
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 namespace ell
 {
 namespace trainers
 {
     template <typename PredictorType>
-    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers)
-        : _evaluatingTrainers(std::move(evaluatingTrainers))
+    SweepingTrainer<PredictorType>::SweepingTrainer(std::vector<EvaluatingTrainerType>&& evaluatingTrainers, size_t numThreads)
+        : _evaluatingTrainers(std::move(evaluatingTrainers)), _numThreads(numThreads)
     {
         assert(_evaluatingTrainers.size() > 0);
+        if (_numThreads == 0)
+        {
+            _numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::SetDataset(const data::AnyDataset& anyDataset)
     {
-        _dataset = data::Dataset<ExampleType>(anyDataset);
+        for (auto& evaluatingTrainer : _evaluatingTrainers)
+        {
+            evaluatingTrainer.SetDataset(anyDataset);
+        }
     }
 
     template <typename PredictorType>
     void SweepingTrainer<PredictorType>::Update()
     {
-        for (size_t i = 0; i < _evaluatingTrainers.size(); ++i)
+        // each worker repeatedly takes the next internal trainer that no other worker has taken yet
+        std::atomic<size_t> nextIndex(0);
+        auto worker = [this, &nextIndex]() {
+            for (auto index = nextIndex++; index < _evaluatingTrainers.size(); index = nextIndex++)
+            {
+                _evaluatingTrainers[index].Update();
+            }
+        };
+
+        // run all the workers but one on other threads, and the last one on this thread
+        auto numWorkers = std::min(_numThreads, _evaluatingTrainers.size());
+        std::vector<std::future<void>> tasks;
+        for (size_t workerIndex = 1; workerIndex < numWorkers; ++workerIndex)
+        {
+            tasks.emplace_back(std::async(std::launch::async, worker));
+        }
+        worker();
+
+        // rethrow any exception thrown by an internal trainer
+        for (auto& task : tasks)
         {
-            _evaluatingTrainers[i].Update();
+            task.get();
         }
     }
 
@@ -51,9 +83,9 @@ namespace trainers
     }
 
     template <typename PredictorType>
-    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers)
+    std::unique_ptr<ITrainer<PredictorType>> MakeSweepingTrainer(std::vector<EvaluatingTrainer<PredictorType>>&& evaluatingTrainers, size_t numThreads)
     {
-        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers));
+        return std::make_unique<SweepingTrainer<PredictorType>>(std::move(evaluatingTrainers), numThreads);
     }
 }
 }
@@ -9,6 +9,11 @@
 // data
 #include "Dataset.h"
 
+// evaluators
+#include "AUCAggregator.h"
+#include "Evaluator.h"
+#include "LossAggregator.h"
+
 // functions
 #include "L2Regularizer.h"
 #include "LogLoss.h"
@@ -16,14 +21,25 @@
 
 
 // trainers
+#include "BinnedFeatureStore.h"
+#include "HistogramForestTrainer.h"
+#include "LogitBooster.h"
 #include "MeanCalculator.h"
 #include "SDCATrainer.h"
 #include "SGDTrainer.h"
+#include "SortingForestTrainer.h"
 #include "SquaredLoss.h"
+#include "SweepingTrainer.h"
+#include "ThresholdFinder.h"
 
 // utilities
 #include "testing.h"
 
+// stl
+#include <cmath>
+#include <string>
+#include <vector>
+
 using namespace ell;
 
 /// Runs all tests
@@ -137,9 +153,334 @@ void TestMeanCalculator()
     testing::ProcessTest("TestMeanCalculator", mean == r);
 }
 
+data::AutoSupervisedDataset GetSparseSGDTrainerDataset()
+{
+    // sparse examples with a few nonzeros out of many features, so that concurrent updates rarely touch the same feature
+    data::AutoSupervisedDataset dataset;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::vector<data::IndexValue> elements;
+        double score = 0;
+        for (size_t j = 0; j < 5; ++j)
+        {
+            size_t index = j * 100 + (i * 37 + j * 11) % 100;
+            double value = 1.0 + 0.1 * static_cast<double>((i + j) % 7);
+            score += (index % 3 == 0 ? 1.0 : -0.5) * value;
+            elements.push_back({ index, value });
+        }
+        dataset.AddExample({ data::AutoDataVector(elements), { 1.0, score > 0 ? 1.0 : -1.0 } });
+    }
+    return dataset;
+}
+
+trainers::SDCAPredictorInfo TrainSDCATrainer(size_t numThreads, const data::AutoSupervisedDataset& dataset, size_t numEpochs)
+{
+    trainers::SDCATrainer<functions::LogLoss, functions::L2Regularizer> trainer(functions::LogLoss(), functions::L2Regularizer(), { 1.0e-3, 1.0e-8, numEpochs, true, "XYZ", numThreads });
+    trainer.SetDataset(dataset.GetAnyDataset());
+    for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    {
+        trainer.Update();
+    }
+    return trainer.GetPredictorInfo();
+}
+
+void TestSDCATrainerThreads()
+{
+    // the parallel epochs take smaller steps than serial ones, but converge to the same optimum, so the duality gap still closes
+    auto dataset = GetSparseSGDTrainerDataset();
+    auto serial = TrainSDCATrainer(1, dataset, 50);
+    bool ok = serial.primalObjective - serial.dualObjective < 1.0e-6;
+    for (size_t numThreads : { 2, 4 })
+    {
+        auto parallel = TrainSDCATrainer(numThreads, dataset, 50);
+        auto dualityGap = parallel.primalObjective - parallel.dualObjective;
+        ok = ok && dualityGap >= 0 && dualityGap < 1.0e-6 && std::abs(parallel.primalObjective - serial.primalObjective) < 1.0e-6;
+    }
+    testing::ProcessTest("TestSDCATrainerThreads", ok);
+}
+
+template <typename TrainerFactoryType>
+std::pair<double, predictors::LinearPredictor<double>> TrainSparseSGDTrainer(TrainerFactoryType makeTrainer, size_t numThreads, const data::AutoSupervisedDataset& dataset)
+{
+    auto trainer = makeTrainer(trainers::SGDTrainerParameters{ 1.0e-3, "XYZ", numThreads });
+    trainer->SetDataset(dataset.GetAnyDataset());
+    for (int epoch = 0; epoch < 20; ++epoch)
+    {
+        trainer->Update();
+    }
+
+    functions::LogLoss lossFunction;
+    const auto& predictor = trainer->GetPredictor();
+    double loss = 0;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        loss += lossFunction(predictor.Predict(dataset[i].GetDataVector()), dataset[i].GetMetadata().label);
+    }
+    return { loss / static_cast<double>(dataset.NumExamples()), predictor };
+}
+
+template <typename TrainerFactoryType>
+void TestSparseSGDTrainerThreads(const std::string& trainerName, TrainerFactoryType makeTrainer)
+{
+    auto dataset = GetSparseSGDTrainerDataset();
+    auto serial = TrainSparseSGDTrainer(makeTrainer, 1, dataset);
+
+    // the lock-free trainer converges to nearly the same averaged predictor as the serial trainer, although the order in
+    // which its threads update the shared state is not deterministic
+    bool ok = serial.first < 0.1;
+    for (size_t numThreads : { 2, 4 })
+    {
+        auto parallel = TrainSparseSGDTrainer(makeTrainer, numThreads, dataset);
+        auto difference = parallel.second.GetWeights();
+        difference -= serial.second.GetWeights();
+        auto relativeDistance = difference.Norm2() / serial.second.GetWeights().Norm2();
+        ok = ok && parallel.first < 1.3 * serial.first && relativeDistance < 0.25;
+    }
+    testing::ProcessTest("TestSparseSGDTrainerThreads<" + trainerName + ">", ok);
+}
+
+void TestSparseSGDTrainerThreads()
+{
+    TestSparseSGDTrainerThreads("SparseDataSGDTrainer", [](const trainers::SGDTrainerParameters& parameters) {
+        return trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), parameters);
+    });
+    TestSparseSGDTrainerThreads("SparseDataCenteredSGDTrainer", [](const trainers::SGDTrainerParameters& parameters) {
+        math::RowVector<double> center(500);
+        center.Fill(0.1);
+        return trainers::MakeSparseDataCenteredSGDTrainer(functions::LogLoss(), std::move(center), parameters);
+    });
+}
+
+std::vector<double> GetSweepingTrainerWeights(size_t numThreads, const data::AutoSupervisedDataset& dataset)
+{
+    using PredictorType = predictors::LinearPredictor<double>;
+    std::vector<trainers::EvaluatingTrainer<PredictorType>> evaluatingTrainers;
+    for (double regularization : { 1.0e-1, 1.0e-2, 1.0e-3, 1.0e-4 })
+    {
+        auto trainer = trainers::MakeSparseDataSGDTrainer(functions::LogLoss(), trainers::SGDTrainerParameters{ regularization, "XYZ" });
+        auto evaluator = evaluators::MakeEvaluator<PredictorType>(dataset.GetAnyDataset(), evaluators::EvaluatorParameters{ 1, false, numThreads }, evaluators::AUCAggregator(), evaluators::MakeLossAggregator(functions::LogLoss()));
+        evaluatingTrainers.push_back(trainers::MakeEvaluatingTrainer(std::move(trainer), evaluator));
+    }
+
+    auto sweepingTrainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), numThreads);
+    sweepingTrainer->SetDataset(dataset.GetAnyDataset());
+    for (int epoch = 0; epoch < 3; ++epoch)
+    {
+        sweepingTrainer->Update();
+    }
+    return sweepingTrainer->GetPredictor().GetWeights().ToArray();
+}
+
+void TestSweepingTrainerThreads()
+{
+    // the internal trainers are independent of each other, so the choice of predictor doesn't depend on the number of threads
+    auto dataset = GetSparseSGDTrainerDataset();
+    auto serialWeights = GetSweepingTrainerWeights(1, dataset);
+    auto parallelWeights = GetSweepingTrainerWeights(3, dataset);
+
+    bool ok = serialWeights.size() == dataset.NumFeatures() && testing::IsEqual(serialWeights, parallelWeights);
+    testing::ProcessTest("TestSweepingTrainerThreads", ok);
+}
+
+data::AutoSupervisedDataset GetForestTrainerDataset()
+{
+    // features with many repeated values, so that ties have to be handled consistently. Feature values are nonzero, since
+    // the trailing zeros of a data vector are dropped
+    data::AutoSupervisedDataset dataset;
+    for (int i = 0; i < 64; ++i)
+    {
+        double x = 1 + (i * 7) % 16;
+        double y = 1 + (i * 5) % 9;
+        double z = 2 + std::sin(0.3 * i);
+        double label = (x + 2 * y > 10 + 4 * z) ? 1.0 : -1.0;
+        dataset.AddExample({ { x, y, z }, { 1.0, label } });
+    }
+    return dataset;
+}
+
+template <typename TrainerFactoryType>
+std::vector<double> GetForestTrainerPredictions(TrainerFactoryType makeTrainer, size_t numThreads, const data::AutoSupervisedDataset& dataset)
+{
+    auto trainer = makeTrainer(numThreads);
+    trainer->SetDataset(dataset.GetAnyDataset());
+    trainer->Update();
+
+    const auto& forest = trainer->GetPredictor();
+    std::vector<double> predictions;
+    for (size_t i = 0; i < dataset.NumExamples(); ++i)
+    {
+        predictions.push_back(forest.Predict(data::FloatDataVector(dataset[i].GetDataVector().ToArray())));
+    }
+    predictions.push_back(static_cast<double>(forest.NumInteriorNodes()));
+    return predictions;
+}
+
+template <typename TrainerFactoryType>
+void TestForestTrainerThreads(const std::string& trainerName, TrainerFactoryType makeTrainer)
+{
+    auto dataset = GetForestTrainerDataset();
+    auto serialPredictions = GetForestTrainerPredictions(makeTrainer, 1, dataset);
+
+    // the forest found with several threads must be exactly the one found with a single thread
+    bool ok = serialPredictions.back() > 0;
+    for (size_t numThreads : { 2, 3, 8 })
+    {
+        ok = ok && GetForestTrainerPredictions(makeTrainer, numThreads, dataset) == serialPredictions;
+    }
+    testing::ProcessTest("TestForestTrainerThreads<" + trainerName + ">", ok);
+}
+
+void TestForestTrainerThreads()
+{
+    TestForestTrainerThreads("SortingForestTrainer", [](size_t numThreads) {
+        trainers::SortingForestTrainerParameters parameters;
+        parameters.minSplitGain = 0.0;
+        parameters.maxSplitsPerRound = 8;
+        parameters.numRounds = 3;
+        parameters.numThreads = numThreads;
+        return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    });
+
+    TestForestTrainerThreads("HistogramForestTrainer", [](size_t numThreads) {
+        trainers::HistogramForestTrainerParameters parameters;
+        parameters.minSplitGain = 0.0;
+        parameters.maxSplitsPerRound = 8;
+        parameters.numRounds = 3;
+        parameters.numThreads = numThreads;
+        parameters.randomSeed = "123456";
+        parameters.thresholdFinderSampleSize = 32;
+        parameters.candidatesPerInput = 8;
+        return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    });
+}
+
+// exposes the histograms of a HistogramForestTrainer
+class HistogramForestTrainerTester : public trainers::HistogramForestTrainer<functions::SquaredLoss, trainers::LogitBooster, trainers::ExhaustiveThresholdFinder>
+{
+public:
+    using HistogramForestTrainer::HistogramForestTrainer;
+
+    // gets the histograms of two sibling nodes, the second one from the parent's histogram, and compares them to the histograms built directly
+    bool IsSiblingHistogramCorrect(Range parentRange, size_t firstChildSize)
+    {
+        Range firstChildRange{ parentRange.firstIndex, firstChildSize };
+        Range secondChildRange{ parentRange.firstIndex + firstChildSize, parentRange.size - firstChildSize };
+        _nodeHistograms[{ parentRange.firstIndex, parentRange.size }] = BuildHistogram(parentRange);
+        auto firstChildHistogram = GetNodeHistogram(firstChildRange);
+        auto secondChildHistogram = GetNodeHistogram(secondChildRange);
+        return _nodeHistograms.empty() && IsEqual(firstChildHistogram, BuildHistogram(firstChildRange)) && IsEqual(secondChildHistogram, BuildHistogram(secondChildRange));
+    }
+
+private:
+    static bool IsEqual(const Histogram& a, const Histogram& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (size_t index = 0; index < a.size(); ++index)
+        {
+            if (a[index].count != b[index].count || !testing::IsEqual(a[index].sums.sumWeights, b[index].sums.sumWeights, 1.0e-9) || !testing::IsEqual(a[index].sums.sumWeightedLabels, b[index].sums.sumWeightedLabels, 1.0e-9))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+void TestHistogramSubtraction()
+{
+    trainers::HistogramForestTrainerParameters parameters;
+    parameters.minSplitGain = 0.0;
+    parameters.maxSplitsPerRound = 8;
+    parameters.numRounds = 1;
+    parameters.numThreads = 1;
+    parameters.randomSeed = "123456";
+    parameters.thresholdFinderSampleSize = 32;
+    parameters.candidatesPerInput = 8;
+    HistogramForestTrainerTester trainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    auto dataset = GetForestTrainerDataset();
+    trainer.SetDataset(dataset.GetAnyDataset());
+
+    // the smaller child's histogram is built, and the larger one's is computed by subtraction, whichever comes first
+    bool ok = trainer.IsSiblingHistogramCorrect({ 0, 64 }, 10) && trainer.IsSiblingHistogramCorrect({ 0, 64 }, 50);
+    ok = ok && trainer.IsSiblingHistogramCorrect({ 8, 40 }, 5) && trainer.IsSiblingHistogramCorrect({ 8, 40 }, 30);
+    testing::ProcessTest("TestHistogramSubtraction", ok);
+}
+
+void TestHistogramForestTrainerMatchesSortingForestTrainer()
+{
+    // with a bin boundary between every pair of consecutive feature values, the histograms give the same candidate splits
+    // as sorting, so both trainers must grow the same forest
+    auto dataset = GetForestTrainerDataset();
+    auto makeSortingTrainer = [](size_t numThreads) {
+        trainers::SortingForestTrainerParameters parameters;
+        parameters.minSplitGain = 0.0;
+        parameters.maxSplitsPerRound = 8;
+        parameters.numRounds = 3;
+        parameters.numThreads = numThreads;
+        return trainers::MakeSortingForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), parameters);
+    };
+    auto makeHistogramTrainer = [&dataset](size_t numThreads) {
+        trainers::HistogramForestTrainerParameters parameters;
+        parameters.minSplitGain = 0.0;
+        parameters.maxSplitsPerRound = 8;
+        parameters.numRounds = 3;
+        parameters.numThreads = numThreads;
+        parameters.randomSeed = "123456";
+        parameters.thresholdFinderSampleSize = dataset.NumExamples();
+        parameters.candidatesPerInput = 0;
+        return trainers::MakeHistogramForestTrainer(functions::SquaredLoss(), trainers::LogitBooster(), trainers::ExhaustiveThresholdFinder(), parameters);
+    };
+
+    auto sortingPredictions = GetForestTrainerPredictions(makeSortingTrainer, 1, dataset);
+    auto histogramPredictions = GetForestTrainerPredictions(makeHistogramTrainer, 1, dataset);
+    testing::ProcessTest("TestHistogramForestTrainerMatchesSortingForestTrainer", testing::IsEqual(sortingPredictions, histogramPredictions, 1.0e-9));
+}
+
+void TestBinnedFeatureStore()
+{
+    trainers::BinnedFeatureStore store({ { 1.5, 2.5 }, {} }, 4);
+    std::vector<double> values = { 1.0, 2.0, 2.5, 7.0 };
+    for (size_t row = 0; row < values.size(); ++row)
+    {
+        store.SetValue(0, row, values[row]);
+        store.SetValue(1, row, values[row]);
+    }
+
+    std::vector<size_t> column0;
+    store.VisitColumn(0, [&](const auto* column) { column0.assign(column, column + store.NumRows()); });
+
+    bool ok = store.NumFeatures() == 2 && store.NumBins(0) == 3 && store.NumBins(1) == 1 && store.NumBins() == 4 && store.GetBinOffset(1) == 3;
+    ok = ok && column0 == std::vector<size_t>{ 0, 1, 1, 2 } && store.GetBin(1, 3) == 0;
+    testing::ProcessTest("TestBinnedFeatureStore", ok);
+
+    // more than 256 bins need two bytes per value
+    std::vector<double> manyThresholds;
+    for (int i = 0; i < 1000; ++i)
+    {
+        manyThresholds.push_back(i + 0.5);
+    }
+    trainers::BinnedFeatureStore largeStore({ manyThresholds }, 2);
+    largeStore.SetValue(0, 0, 3.0);
+    largeStore.SetValue(0, 1, 999.0);
+    size_t valueSize = 0;
+    largeStore.VisitColumn(0, [&](const auto* column) { valueSize = sizeof(*column); });
+    testing::ProcessTest("TestBinnedFeatureStore, large bins", valueSize == 2 && largeStore.GetBin(0, 0) == 3 && largeStore.GetBin(0, 1) == 999);
+}
+
 int main()
 {
     TestSDCATrainer();
     TestSGDTrainer();
+    TestSparseSGDTrainerThreads();
+    TestSDCATrainerThreads();
+    TestSweepingTrainerThreads();
     TestMeanCalculator();
+    TestBinnedFeatureStore();
+    TestForestTrainerThreads();
+    TestHistogramSubtraction();
+    TestHistogramForestTrainerMatchesSortingForestTrainer();
 }
@@ -60,6 +60,13 @@ namespace utilities
         /// <summary> Default Constructor. Constructs an empty list. </summary>
         CompressedIntegerList();
 
+        /// <summary> Constructs a list from its encoded representation, as returned by GetEncodedData. </summary>
+        ///
+        /// <param name="encodedData"> The encoded representation of the list. </param>
+        /// <param name="size"> The number of integers in the list. </param>
+        /// <param name="max"> The maximal integer in the list, ignored if the list is empty. </param>
+        CompressedIntegerList(std::vector<uint8_t> encodedData, size_t size, size_t max);
+
         CompressedIntegerList(CompressedIntegerList&& other) = default;
 
         CompressedIntegerList(const CompressedIntegerList&) = default;
@@ -96,6 +103,11 @@ namespace utilities
         /// <returns> The iterator. </returns>
         Iterator GetIterator() const { return Iterator(_data.data(), _data.data() + _data.size()); }
 
+        /// <summary> Returns the encoded representation of the list. </summary>
+        ///
+        /// <returns> The encoded bytes. </returns>
+        const std::vector<uint8_t>& GetEncodedData() const { return _data; }
+
     private:
         std::vector<uint8_t> _data;
         size_t _last;
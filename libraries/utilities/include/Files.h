@@ -27,9 +27,10 @@ namespace utilities
     /// <summary> Opens an std::ofstream and throws an exception if a problem occurs. </summary>
     ///
     /// <param name="filepath"> The path. </param>
+    /// <param name="mode"> The mode to open the file with, such as std::ios::binary for binary files. </param>
     ///
     /// <returns> The stream. </returns>
-    std::ofstream OpenOfstream(const std::string& filepath);
+    std::ofstream OpenOfstream(const std::string& filepath, std::ios::openmode mode = std::ios::out);
 
     /// <summary> Returns true if the file exists and can be opened for reading. </summary>
     ///
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.h (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// stl
+#include <cstddef>
+#include <string>
+
+namespace ell
+{
+namespace utilities
+{
+    /// <summary> A read-only view of the contents of a file, mapped into memory. </summary>
+    class MemoryMappedFile
+    {
+    public:
+        /// <summary> Maps a file into memory. </summary>
+        ///
+        /// <param name="filepath"> The path of the file. </param>
+        MemoryMappedFile(const std::string& filepath);
+
+        MemoryMappedFile(MemoryMappedFile&& other);
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+
+        ~MemoryMappedFile();
+
+        MemoryMappedFile& operator=(MemoryMappedFile&& other);
+
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /// <summary> Returns a pointer to the first character of the file. </summary>
+        const char* Begin() const { return _data; }
+
+        /// <summary> Returns a pointer one past the last character of the file. </summary>
+        const char* End() const { return _data + _size; }
+
+        /// <summary> Returns the size of the file, in bytes. </summary>
+        size_t Size() const { return _size; }
+
+    private:
+        void Unmap();
+
+        const char* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _mappingHandle = nullptr;
+#endif
+    };
+}
+}
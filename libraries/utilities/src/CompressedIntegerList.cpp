@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstring>
 #include <limits>
+#include <utility>
 
 namespace ell
 {
@@ -59,6 +60,11 @@ namespace utilities
     {
     }
 
+    CompressedIntegerList::CompressedIntegerList(std::vector<uint8_t> encodedData, size_t size, size_t max)
+        : _data(std::move(encodedData)), _last(size == 0 ? std::numeric_limits<size_t>::max() : max), _size(size)
+    {
+    }
+
     size_t CompressedIntegerList::Size() const
     {
         return _size;
@@ -46,7 +46,7 @@ namespace utilities
         return stream;
     }
 
-    std::ofstream OpenOfstream(const std::string& filepath)
+    std::ofstream OpenOfstream(const std::string& filepath, std::ios::openmode mode)
     {
 #ifdef WIN32
         auto path = fs::u8path(filepath);
@@ -54,7 +54,7 @@ namespace utilities
         const auto& path = filepath;
 #endif
         // open file
-        std::ofstream stream(path);
+        std::ofstream stream(path, mode | std::ios::out);
 
         // check that it opened
         if (!stream.is_open())
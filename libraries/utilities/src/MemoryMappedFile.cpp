@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     MemoryMappedFile.cpp (utilities)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemoryMappedFile.h"
+#include "Exception.h"
+
+// stl
+#include <utility>
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <filesystem>
+namespace fs = std::filesystem;
+#endif // WIN32
+
+namespace ell
+{
+namespace utilities
+{
+#ifndef WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        int fileDescriptor = open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor == -1)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) == -1)
+        {
+            close(fileDescriptor);
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+
+        // an empty file can't be mapped, and doesn't need to be
+        _size = static_cast<size_t>(fileStatus.st_size);
+        if (_size > 0)
+        {
+            auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fileDescriptor);
+                throw utilities::InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+            }
+
+            // the file is read from start to end
+            madvise(data, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the file is closed
+        close(fileDescriptor);
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            munmap(const_cast<char*>(_data), _size);
+        }
+        _data = nullptr;
+        _size = 0;
+    }
+#else
+    MemoryMappedFile::MemoryMappedFile(const std::string& filepath)
+    {
+        auto path = fs::u8path(filepath);
+        auto fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error opening file " + filepath);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            CloseHandle(fileHandle);
+            throw utilities::InputException(InputExceptionErrors::invalidArgument, "error reading the size of file " + filepath);
+        }
+
+        // an empty file can't be mapped, and doesn't need to be
+        _size = static_cast<size_t>(fileSize.QuadPart);
+        if (_size > 0)
+        {
+            _mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            auto data = _mappingHandle == nullptr ? nullptr : MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (data == nullptr)
+            {
+                if (_mappingHandle != nullptr)
+                {
+                    CloseHandle(_mappingHandle);
+                }
+                CloseHandle(fileHandle);
+                throw utilities::InputException(InputExceptionErrors::invalidArgument, "error mapping file " + filepath);
+            }
+            _data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the file is closed
+        CloseHandle(fileHandle);
+    }
+
+    void MemoryMappedFile::Unmap()
+    {
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+            CloseHandle(_mappingHandle);
+        }
+        _data = nullptr;
+        _size = 0;
+        _mappingHandle = nullptr;
+    }
+#endif // WIN32
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other)
+    {
+        *this = std::move(other);
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Unmap();
+    }
+
+    MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other)
+    {
+        if (this != &other)
+        {
+            Unmap();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+#ifdef WIN32
+            std::swap(_mappingHandle, other._mappingHandle);
+#endif
+        }
+        return *this;
+    }
+}
+}
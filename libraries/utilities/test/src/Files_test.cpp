@@ -10,8 +10,10 @@
 #include "Files_test.h"
 
 // utilities
+#include "Exception.h"
 #include "StringUtil.h"
 #include "Files.h"
+#include "MemoryMappedFile.h"
 
 // testing
 #include "testing.h"
@@ -107,4 +109,29 @@ namespace ell
         }
     }
 
+    void TestMemoryMappedFile(const std::string& basePath)
+    {
+        std::string testContent = "line 1\nline 2\n";
+        std::string testfile = utilities::JoinPaths(basePath, "memoryMappedFileTest.txt");
+        {
+            auto outputStream = utilities::OpenOfstream(testfile);
+            outputStream << testContent;
+        }
+
+        utilities::MemoryMappedFile file(testfile);
+        auto movedFile = std::move(file);
+        testing::ProcessTest("MemoryMappedFile", movedFile.Size() == testContent.size() && std::string(movedFile.Begin(), movedFile.End()) == testContent && file.Size() == 0);
+
+        bool exceptionThrown = false;
+        try
+        {
+            utilities::MemoryMappedFile missingFile(utilities::JoinPaths(basePath, "missingMemoryMappedFileTest.txt"));
+        }
+        catch (const utilities::InputException&)
+        {
+            exceptionThrown = true;
+        }
+        testing::ProcessTest("MemoryMappedFile of missing file", exceptionThrown);
+    }
+
 } // end namespace
@@ -96,6 +96,7 @@ int main(int argc, char* argv[])
         // File system tests
         TestStringf();
         TestJoinPaths(basePath);
+        TestMemoryMappedFile(basePath);
 #ifdef WIN32
         TestUnicodePaths(basePath);
 #endif
@@ -55,5 +55,11 @@ namespace ell
             "seed",
             "The random seed string",
             "ABCDEFG");
+
+        parser.AddOption(numThreads,
+            "numThreads",
+            "nt",
+            "The number of threads used by the sparse SGD and SDCA algorithms, or 0 to use all hardware threads",
+            1);
     }
 }
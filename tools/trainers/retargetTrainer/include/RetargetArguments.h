@@ -29,6 +29,7 @@ namespace ell
         size_t refineIterations;
         std::string randomSeedString;
         bool permute;
+        size_t numThreads;
         bool normalize;
         double regularization;
         bool verbose;
@@ -94,6 +94,12 @@ namespace ell
             "The random seed string",
             "ABCDEFG");
 
+        parser.AddOption(numThreads,
+            "numThreads",
+            "nt",
+            "The number of threads used by the SDCA trainer, or 0 to use all hardware threads",
+            1);
+
         parser.AddOption(
             verbose,
             "verbose",
@@ -177,7 +177,7 @@ void PrintEvaluation(double dualityGap, double desiredPrecision, evaluators::IEv
 template <typename LossFunctionType>
 PredictorType RetargetModelUsingLinearPredictor(ParsedRetargetArguments& retargetArguments, data::AutoSupervisedDataset& dataset)
 {
-    trainers::SDCATrainerParameters trainerParameters{ retargetArguments.regularization, retargetArguments.desiredPrecision, retargetArguments.maxEpochs, retargetArguments.permute, retargetArguments.randomSeedString };
+    trainers::SDCATrainerParameters trainerParameters{ retargetArguments.regularization, retargetArguments.desiredPrecision, retargetArguments.maxEpochs, retargetArguments.permute, retargetArguments.randomSeedString, retargetArguments.numThreads };
 
     auto trainer = trainers::SDCATrainer<LossFunctionType, functions::L2Regularizer>(LossFunctionType(), functions::L2Regularizer(), trainerParameters);
     if (retargetArguments.verbose) std::cout << "Created linear trainer ..." << std::endl;
@@ -440,8 +440,7 @@ int main(int argc, char* argv[])
         {
             // This is a multi-class dataset
             _timer.Start();            
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto multiclassDataset = common::GetMultiClassDataset(stream);
+            auto multiclassDataset = common::LoadMultiClassDataset(retargetArguments.inputDataFilename);
             if (retargetArguments.verbose) std::cout << "(" << _timer.Elapsed() << " ms)" << std::endl;
             
             // Obtain a new training dataset for the set of Linear Predictors by running the
@@ -477,8 +476,7 @@ int main(int argc, char* argv[])
         {
             // This is a binary classification dataset
             _timer.Start();            
-            auto stream = utilities::OpenIfstream(retargetArguments.inputDataFilename);
-            auto binaryDataset = common::GetDataset(stream);
+            auto binaryDataset = common::LoadDataset(retargetArguments.inputDataFilename);
             if (retargetArguments.verbose) std::cout << "Loading dataset took :" << _timer.Elapsed() << " ms" << std::endl;
             // Obtain a new training dataset for the Linear Predictor by running the
             // binaryDataset through the modified model
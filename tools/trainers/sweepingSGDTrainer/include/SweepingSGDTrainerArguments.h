@@ -0,0 +1,31 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.h (sweepingSGDTrainer)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// utilities
+#include "CommandLineParser.h"
+
+namespace ell
+{
+/// <summary> Arguments for the sweeping SGD trainer. </summary>
+struct SweepingSGDTrainerArguments
+{
+    size_t numThreads;
+    size_t numEvaluationThreads;
+};
+
+/// <summary> Parsed version of SweepingSGDTrainerArguments. </summary>
+struct ParsedSweepingSGDTrainerArguments : public SweepingSGDTrainerArguments, public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The command line parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+};
+}
@@ -0,0 +1,27 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     SweepingSGDTrainerArguments.cpp (sweepingSGDTrainer)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SweepingSGDTrainerArguments.h"
+
+namespace ell
+{
+    void ParsedSweepingSGDTrainerArguments::AddArgs(utilities::CommandLineParser& parser)
+    {
+        parser.AddOption(numThreads,
+            "numThreads",
+            "nt",
+            "The number of trainers in the sweep to run at once, or 0 to use all hardware threads",
+            1);
+
+        parser.AddOption(numEvaluationThreads,
+            "numEvaluationThreads",
+            "net",
+            "The number of threads that each evaluation splits the dataset between, or 0 to use all hardware threads",
+            1);
+    }
+}
@@ -6,6 +6,8 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "SweepingSGDTrainerArguments.h"
+
 // utilities
 #include "CommandLineParser.h"
 #include "Exception.h"
@@ -61,11 +63,13 @@ int main(int argc, char* argv[])
         common::ParsedDataLoadArguments dataLoadArguments;
         common::ParsedMapLoadArguments mapLoadArguments;
         common::ParsedModelSaveArguments modelSaveArguments;
+        ParsedSweepingSGDTrainerArguments sweepingSGDTrainerArguments;
 
         commandLineParser.AddOptionSet(trainerArguments);
         commandLineParser.AddOptionSet(dataLoadArguments);
         commandLineParser.AddOptionSet(mapLoadArguments);
         commandLineParser.AddOptionSet(modelSaveArguments);
+        commandLineParser.AddOptionSet(sweepingSGDTrainerArguments);
 
         // parse command line
         commandLineParser.Parse();
@@ -89,8 +93,7 @@ int main(int argc, char* argv[])
 
         // load dataset
         if (trainerArguments.verbose) std::cout << "Loading data ..." << std::endl;
-        auto stream = utilities::OpenIfstream(dataLoadArguments.inputDataFilename);
-        auto parsedDataset = common::GetDataset(stream);
+        auto parsedDataset = common::LoadDataset(dataLoadArguments.inputDataFilename);
         auto mappedDataset = common::TransformDataset(parsedDataset, map);
         auto mappedDatasetDimension = map.GetOutput(0).Size();
 
@@ -99,7 +102,7 @@ int main(int argc, char* argv[])
         using LinearPredictorNodeType = nodes::LinearPredictorNode<double>;
 
         // set up evaluators to only evaluate on the last update of the multi-epoch trainer
-        evaluators::EvaluatorParameters evaluatorParameters{ 1, false };
+        evaluators::EvaluatorParameters evaluatorParameters{ 1, false, sweepingSGDTrainerArguments.numEvaluationThreads };
 
         // create trainers
         auto generator = common::MakeParametersEnumerator<trainers::SGDTrainerParameters>(regularization, randomSeeds);
@@ -113,7 +116,7 @@ int main(int argc, char* argv[])
         }
 
         // create meta trainer
-        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers));
+        auto trainer = trainers::MakeSweepingTrainer(std::move(evaluatingTrainers), sweepingSGDTrainerArguments.numThreads);
 
         // train
         if (trainerArguments.verbose) std::cout << "Training ..." << std::endl;
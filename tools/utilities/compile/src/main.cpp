@@ -126,6 +126,19 @@ void ProduceMapOutput(ParsedCompileArguments& compileArguments, common::ParsedMa
     auto compiledMap = compiler.Compile(map);
     timer.Stop();
 
+    if (settings.compilerSettings.reportOptimizationPasses)
+    {
+        emitters::WriteOptimizationPassReport(std::cout, compiler.GetOptimizationPassStatistics());
+    }
+
+    if (compileArguments.verbose && settings.reusePortBuffers)
+    {
+        const auto& statistics = compiler.GetPortBufferStatistics();
+        timingOutput << "Port buffer memory: " << statistics.allocatedSize << " bytes ("
+                     << statistics.arenaSize << " bytes in " << statistics.numSlots << " shared slots), "
+                     << statistics.naiveSize << " bytes without reuse\n";
+    }
+
     if (compileArguments.outputCompiledMap)
     {
         TimingOutputCollector timer(timingOutput, "Time to save compiled map", compileArguments.verbose);
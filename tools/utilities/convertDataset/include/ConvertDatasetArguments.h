@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertDatasetArguments.h (convertDataset)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// utilities
+#include "CommandLineParser.h"
+
+// stl
+#include <string>
+
+namespace ell
+{
+/// <summary> A struct that holds command line parameters for converting datasets. </summary>
+struct ConvertDatasetArguments
+{
+    /// <summary> The filename of the binary output dataset. </summary>
+    std::string outputDataFilename;
+};
+
+/// <summary> A version of ConvertDatasetArguments that adds its members to the command line parser. </summary>
+struct ParsedConvertDatasetArguments : public ConvertDatasetArguments, public utilities::ParsedArgSet
+{
+    /// <summary> Adds the arguments to the command line parser. </summary>
+    ///
+    /// <param name="parser"> [in,out] The parser. </param>
+    void AddArgs(utilities::CommandLineParser& parser) override;
+
+    /// <summary> Checks the parsed arguments. </summary>
+    ///
+    /// <param name="parser"> The parser. </param>
+    ///
+    /// <returns> An utilities::CommandLineParseResult. </returns>
+    utilities::CommandLineParseResult PostProcess(const utilities::CommandLineParser& parser) override;
+};
+}
@@ -0,0 +1,30 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     ConvertDatasetArguments.cpp (convertDataset)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+// stl
+#include <vector>
+
+namespace ell
+{
+void ParsedConvertDatasetArguments::AddArgs(utilities::CommandLineParser& parser)
+{
+    parser.AddOption(outputDataFilename, "outputDataFilename", "odf", "Path to the output dataset, in the binary dataset format", "");
+}
+
+utilities::CommandLineParseResult ParsedConvertDatasetArguments::PostProcess(const utilities::CommandLineParser& parser)
+{
+    std::vector<std::string> parseErrorMessages;
+    if (outputDataFilename == "")
+    {
+        parseErrorMessages.push_back("-outputDataFilename (or -odf) is required");
+    }
+    return parseErrorMessages;
+}
+}
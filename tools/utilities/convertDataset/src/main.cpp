@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Project:  Embedded Learning Library (ELL)
+//  File:     main.cpp (convertDataset)
+//  Authors:  agent
+//
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ConvertDatasetArguments.h"
+
+// common
+#include "DataLoadArguments.h"
+#include "DataLoaders.h"
+
+// data
+#include "BinaryDataset.h"
+
+// utilities
+#include "CommandLineParser.h"
+#include "Exception.h"
+#include "Files.h"
+
+// stl
+#include <iostream>
+
+using namespace ell;
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // create a command line parser
+        utilities::CommandLineParser commandLineParser(argc, argv);
+
+        // add arguments to the command line parser
+        common::ParsedDataLoadArguments dataLoadArguments;
+        ParsedConvertDatasetArguments convertDatasetArguments;
+
+        commandLineParser.AddOptionSet(dataLoadArguments);
+        commandLineParser.AddOptionSet(convertDatasetArguments);
+
+        // parse command line
+        commandLineParser.Parse();
+
+        // load the text (or binary) dataset
+        std::cout << "Loading data ..." << std::endl;
+        auto dataset = common::LoadDataset(dataLoadArguments.inputDataFilename);
+
+        // write it in the binary dataset format
+        std::cout << "Writing " << dataset.NumExamples() << " examples ..." << std::endl;
+        auto stream = utilities::OpenOfstream(convertDatasetArguments.outputDataFilename, std::ios::binary);
+        data::WriteBinaryDataset(dataset, stream);
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (utilities::LogicException& exception)
+    {
+        std::cerr << "runtime error: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (utilities::InputException& exception)
+    {
+        std::cerr << "input error: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (utilities::DataFormatException& exception)
+    {
+        std::cerr << "data format error: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+    catch (std::exception& exception)
+    {
+        std::cerr << "unknown error: " << exception.what() << std::endl;
+        return 1;
+    }
+
+    // the end
+    return 0;
+}